@@ -2,6 +2,7 @@
 #include <functional>
 #include <filesystem>
 #include <memory>
+#include <vector>
 
 #include "GearsPYD/GearsAPI.hpp"
 
@@ -49,6 +50,11 @@ std::string GetGLSLResourcesForRandoms (const std::shared_ptr<Stimulus>& stimulu
 GEARS_API_TEST
 std::unique_ptr<SequenceAdapter> GetSequenceAdapterFromPyx (RG::VulkanEnvironment&, const std::filesystem::path&);
 
+// python files are executed one after another, the adapters are created and their shaders are compiled on worker threads meanwhile
+// the result has nullptr for files that could not be loaded
+GEARS_API_TEST
+std::vector<std::unique_ptr<SequenceAdapter>> GetSequenceAdaptersFromPyx (RG::VulkanEnvironment&, const std::vector<std::filesystem::path>&);
+
 GEARS_API_TEST
 std::shared_ptr<Sequence> GetSequenceFromPyx (const std::filesystem::path&);
 
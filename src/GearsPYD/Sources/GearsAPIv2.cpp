@@ -13,14 +13,23 @@
 #include "Sequence/SequenceAdapter.hpp"
 #include "Sequence/StimulusAdapter.hpp"
 #include "PySequence/core/PySequence.h"
+#include "Sequence/Pass.h"
 #include "Sequence/Stimulus.h"
 
+// from Utils
+#include "Utils/ThreadPool.hpp"
+#include "Utils/Trace.hpp"
+
 // from pybind11
 #include <pybind11/embed.h>
 
 // from spdlog
 #include "spdlog/spdlog.h"
 
+// from std
+#include <utility>
+#include <vector>
+
 namespace Gears {
 
 
@@ -156,6 +165,8 @@ std::string GetGLSLResourcesForRandoms (const std::shared_ptr<Stimulus>& stimulu
 #ifndef GEARS_RANDOMS_RESOURCES
 #define GEARS_RANDOMS_RESOURCES
 
+layout (constant_id = {}) const uint FRAMESINFLIGHT = 1;
+
 layout (binding = 201) readonly buffer RandomBuffer {{
     uvec4 randoms[FRAMESINFLIGHT][{}][{}];
 }};
@@ -166,23 +177,74 @@ layout (binding = 202) uniform RandomBufferConfig {{
     vec2  cellSize;
 }};
 
-#endif)", stimulus->rngCompute_workGroupSizeX, stimulus->rngCompute_workGroupSizeY);
+// every sub-frame of high frequency rendering reads its own layer of randoms
+#ifdef GEARS_SUBFRAME_INDEX
+#define randoms_layerIndex (randoms_layerIndex + uint (GEARS_SUBFRAME_INDEX))
+#endif
+
+#endif)", Pass::RandomLayerCountConstantId, stimulus->rngCompute_workGroupSizeX, stimulus->rngCompute_workGroupSizeY);
+}
+
+
+// Started by the first load and kept alive until the process exits, so loading a sequence does not start an interpreter.
+// The GIL is only held while python code runs, sequences can be loaded from any thread.
+class EmbeddedPython {
+private:
+    std::unique_ptr<pybind11::scoped_interpreter> interpreter;
+    std::unique_ptr<pybind11::gil_scoped_release> releasedGil;
+
+public:
+    EmbeddedPython ()
+    {
+        // the interpreter is already running when we are called from the Gears python module
+        if (!Py_IsInitialized ()) {
+            interpreter = std::make_unique<pybind11::scoped_interpreter> ();
+        }
+
+        {
+            pybind11::gil_scoped_acquire gil;
+
+            pybind11::module sys = pybind11::module::import ("sys");
+
+            sys.attr ("path").attr ("insert") (0, (std::filesystem::current_path ()).string ());
+
+            pybind11::module::import ("AppData").attr ("initConfigParams") ();
+        }
+
+        if (interpreter != nullptr) {
+            releasedGil = std::make_unique<pybind11::gil_scoped_release> ();
+        }
+    }
+
+    ~EmbeddedPython ()
+    {
+        // the GIL must be held to finalize the interpreter
+        releasedGil.reset ();
+        interpreter.reset ();
+    }
+};
+
+
+static void InitializePython ()
+{
+    static EmbeddedPython embeddedPython;
 }
 
 
 std::shared_ptr<Sequence> GetSequenceFromPyx (const std::filesystem::path& filePath)
 {
+    Utils::TraceScope traceScope ("Sequence load", "Sequence");
+
     if (GVK_ERROR (!std::filesystem::exists (filePath))) {
         return nullptr;
     }
 
-    pybind11::scoped_interpreter guard;
-    try {
-        pybind11::module sys = pybind11::module::import ("sys");
+    static const char* SequenceModuleName = "my_module";
 
-        sys.attr ("path").attr ("insert") (0, (std::filesystem::current_path ()).string ());
+    try {
+        InitializePython ();
 
-        pybind11::module::import ("AppData").attr ("initConfigParams") ();
+        pybind11::gil_scoped_acquire gil;
 
         pybind11::module sequenceLoader = pybind11::module::import ("SequenceLoaderCore");
 
@@ -191,7 +253,10 @@ std::shared_ptr<Sequence> GetSequenceFromPyx (const std::filesystem::path& fileP
         pybind11::module machinery        = pybind11::module::import ("importlib.machinery");
         pybind11::object sourceFileLoader = machinery.attr ("SourceFileLoader");
 
-        pybind11::object sequenceCreator = sourceFileLoader ("my_module", filePath.string ()).attr ("load_module") ();
+        pybind11::object sequenceCreator = sourceFileLoader (SequenceModuleName, filePath.string ()).attr ("load_module") ();
+
+        // the interpreter is reused, the next file must not see the globals of this one
+        pybind11::module::import ("sys").attr ("modules").attr ("pop") (SequenceModuleName, pybind11::none ());
 
         pybind11::object sequence = sequenceCreator.attr ("create") (pybind11::none ());
 
@@ -209,11 +274,46 @@ std::shared_ptr<Sequence> GetSequenceFromPyx (const std::filesystem::path& fileP
 
 std::unique_ptr<SequenceAdapter> GetSequenceAdapterFromPyx (RG::VulkanEnvironment& environment, const std::filesystem::path& filePath)
 {
+    Utils::TraceScope traceScope ("Sequence adapter creation", "Sequence");
+
     std::shared_ptr<Sequence> sequence = GetSequenceFromPyx (filePath);
     return std::make_unique<SequenceAdapter> (environment, sequence, filePath.filename ().string ());
 }
 
 
+std::vector<std::unique_ptr<SequenceAdapter>> GetSequenceAdaptersFromPyx (RG::VulkanEnvironment& environment, const std::vector<std::filesystem::path>& filePaths)
+{
+    Utils::TraceScope traceScope ("Sequence adapter creation for multiple files", "Sequence");
+
+    std::vector<std::unique_ptr<SequenceAdapter>> result (filePaths.size ());
+
+    // python code runs on this thread only, the next file is executed while the pool deduplicates the stimuli
+    // and compiles the shaders of the previous ones
+    Utils::TaskGroup adapterCreation;
+
+    for (size_t index = 0; index < filePaths.size (); ++index) {
+        std::shared_ptr<Sequence> sequence = GetSequenceFromPyx (filePaths[index]);
+        if (sequence == nullptr) {
+            continue;
+        }
+
+        adapterCreation.Run ([&, index, sequence] {
+            try {
+                std::unique_ptr<SequenceAdapter> sequenceAdapter = std::make_unique<SequenceAdapter> (environment, sequence, filePaths[index].filename ().string ());
+                sequenceAdapter->PrecompileShaders ();
+                result[index] = std::move (sequenceAdapter);
+            } catch (std::exception& e) {
+                spdlog::error ("Failed to create sequence adapter for \"{}\": {}", filePaths[index].string (), e.what ());
+            }
+        });
+    }
+
+    adapterCreation.Wait ();
+
+    return result;
+}
+
+
 void SetCurrentPresentable (std::shared_ptr<RG::Presentable>& p)
 {
     currentSeq->SetCurrentPresentable (p);
@@ -17,6 +17,7 @@
 namespace GVK {
 enum class ShaderKind : uint8_t;
 class ShaderModule;
+class SpecializationConstants;
 class RenderPass;
 class ComputePipeline;
 class PipelineLayout;
@@ -25,6 +26,10 @@ class DescriptorSetLayout;
 
 namespace RG {
 
+namespace FromShaderReflection {
+class IDescriptorWriteInfoProvider;
+}
+
 class GVK_RENDERER_API ComputeShaderPipeline {
 private:
     const VkDevice device;
@@ -38,6 +43,9 @@ public:
         std::vector<VkAttachmentReference>     attachmentReferences;
         std::vector<VkAttachmentReference>     inputAttachmentReferences;
         std::vector<VkAttachmentDescription>   attachmentDescriptions;
+
+        // optional
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
     };
 
     struct GVK_RENDERER_API CompileResult {
@@ -57,11 +65,14 @@ public:
 
     ~ComputeShaderPipeline ();
 
+    // must be called before compiling
+    void SetSpecializationConstants (const GVK::SpecializationConstants& values);
+
     void Compile (CompileSettings&& settings);
 
     void IterateShaders (const std::function<void(const GVK::ShaderModule&)> iterator) const;
 
-    std::unique_ptr<GVK::DescriptorSetLayout> CreateDescriptorSetLayout (VkDevice device) const;
+    std::unique_ptr<GVK::DescriptorSetLayout> CreateDescriptorSetLayout (VkDevice device, FromShaderReflection::IDescriptorWriteInfoProvider& infoProvider) const;
 };
 
 } // namespace RG
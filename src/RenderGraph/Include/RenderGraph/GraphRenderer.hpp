@@ -8,10 +8,14 @@
 #include "Utils/Event.hpp"
 #include "Utils/Time.hpp"
 
+#include <chrono>
 #include <memory>
+#include <vector>
 
 namespace GVK {
+class CommandBuffer;
 class DeviceExtra;
+class Image;
 class Semaphore;
 class Swapchain;
 class Fence;
@@ -23,6 +27,19 @@ class RenderGraph;
 class GraphSettings;
 
 
+// CPU timestamps of one frame presented by SynchronizedSwapchainGraphRenderer
+struct FrameTiming {
+    using Clock = std::chrono::steady_clock;
+
+    uint32_t          resourceIndex;
+    uint32_t          imageIndex;
+    Clock::time_point acquireStarted;
+    Clock::time_point imageAvailable; // the presentation engine released the image, follows the vertical blank with fifo presenting
+    Clock::time_point submitted;
+    Clock::time_point presented; // vkQueuePresentKHR returned
+};
+
+
 class GVK_RENDERER_API IFrameDisplayObserver {
 public:
     virtual ~IFrameDisplayObserver () = default;
@@ -35,6 +52,7 @@ public:
     virtual void OnImageAcquisitionEnded (uint32_t) {}
     virtual void OnRenderStarted (uint32_t) {}
     virtual void OnPresentStarted (uint32_t) {}
+    virtual void OnFramePresented (const FrameTiming&) {}
 };
 
 extern GVK_RENDERER_API IFrameDisplayObserver noOpFrameDisplayObserver;
@@ -63,10 +81,15 @@ public:
     RecreatableGraphRenderer (GVK::Swapchain& swapchain);
     virtual ~RecreatableGraphRenderer () = default;
 
+    // the graph is compiled again only if the image count or the format of the swapchain changed, see RenderGraph::RecompileSwapchainImages
     void Recreate (RenderGraph& graph);
 
     uint32_t         RenderNextFrame (RenderGraph& graph, IFrameDisplayObserver& observer = noOpFrameDisplayObserver) override;
     virtual uint32_t RenderNextRecreatableFrame (RenderGraph& graph, IFrameDisplayObserver& observer = noOpFrameDisplayObserver) = 0;
+
+protected:
+    // called by Recreate after the swapchain and the graph are recreated, the device is idle
+    virtual void OnSwapchainRecreated () {}
 };
 
 
@@ -84,7 +107,16 @@ public:
 
 
 class GVK_RENDERER_API SynchronizedSwapchainGraphRenderer final : public RecreatableGraphRenderer {
+public:
+    struct FrameStats {
+        uint32_t submittedGraphs; // frames rendered by executing a graph
+        uint32_t retainedFrames;  // rendered frames copied to the retained image
+        uint32_t repeatedFrames;  // frames presented again from the retained image, see RepeatLastFrame
+    };
+
 private:
+    const GVK::DeviceExtra& device;
+
     // number of render operations able to run simultaneously
     // optimally equal to imageCount, but may be lower.
     // doesnt make sense to be higher than imageCount
@@ -111,8 +143,19 @@ private:
     GVK::Swapchain& swapchain;
     GVK::TimePoint  lastDrawTime;
 
+    // copy of the last rendered swapchain image, only when retaining frames
+    const bool                                       retainLastFrame;
+    std::unique_ptr<GVK::Image>                      retainedImage;
+    bool                                             hasRetainedFrame;
+    std::vector<std::unique_ptr<GVK::CommandBuffer>> retainCommandBuffers; // size is imageCount, copies a swapchain image to retainedImage
+    std::vector<std::unique_ptr<GVK::CommandBuffer>> repeatCommandBuffers; // size is imageCount, copies retainedImage to a swapchain image
+    std::vector<std::unique_ptr<GVK::Fence>>         retainFences;         // size is framesInFlight, signaled by the copy submitted after the graph
+
+    FrameStats frameStats;
+
 public:
-    SynchronizedSwapchainGraphRenderer (const GVK::DeviceExtra& device, GVK::Swapchain& swapchain);
+    // retainLastFrame copies every rendered frame to an offscreen image, so RepeatLastFrame can present it again
+    SynchronizedSwapchainGraphRenderer (const GVK::DeviceExtra& device, GVK::Swapchain& swapchain, bool retainLastFrame = false);
 
     ~SynchronizedSwapchainGraphRenderer ();
 
@@ -122,6 +165,20 @@ public:
     uint32_t         GetFramesInFlight () { return framesInFlight; }
 
     uint32_t         RenderNextRecreatableFrame (RenderGraph& graph, IFrameDisplayObserver& observer = noOpFrameDisplayObserver) override;
+
+    // presents the last rendered frame on the next swapchain image without executing a graph
+    uint32_t RepeatLastFrame (IFrameDisplayObserver& observer = noOpFrameDisplayObserver);
+
+    // counted since the renderer was created
+    const FrameStats& GetFrameStats () const { return frameStats; }
+
+private:
+    // fills acquireStarted and imageAvailable
+    uint32_t AcquireNextImage (IFrameDisplayObserver& observer, FrameTiming& timing);
+    void     CreateRetainedImage ();
+
+    // the retained image and the copies refer to the previous swapchain images
+    virtual void OnSwapchainRecreated () override;
 };
 
 } // namespace RG
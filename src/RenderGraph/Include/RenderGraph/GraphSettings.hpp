@@ -6,13 +6,27 @@
 #include "RenderGraph/Node.hpp"
 #include "VulkanWrapper/DeviceExtra.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include <vulkan/vulkan.h>
 
 
+namespace GVK {
+class DescriptorAllocator;
+}
+
+
 namespace RG {
 
+class Operation;
+class Resource;
+
+
 class GVK_RENDERER_API NodeConnection {
 public:
     std::shared_ptr<Node> from;
@@ -27,13 +41,27 @@ public:
 };
 
 class GVK_RENDERER_API ConnectionSet final : public Noncopyable {
+public:
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
 private:
+    // the neighbours of a node, by node index, in the order of the connections
+    struct Adjacency {
+        std::vector<uint32_t> operations;
+        std::vector<uint32_t> resources;
+    };
 
-    std::vector<NodeConnection> connections;
-    
-    std::set<std::shared_ptr<Node>> nodeSet;
-    
-    std::vector<std::shared_ptr<Node>> insertionOrder;
+    // nodes are indexed densely in insertion order
+    std::vector<std::shared_ptr<Node>>        insertionOrder;
+    std::unordered_map<const Node*, uint32_t> nodeIndices;
+    std::vector<bool>                         isOperation;
+    std::vector<Adjacency>                    pointingTo;
+    std::vector<Adjacency>                    pointingHere;
+
+    // names can change after insertion, rebuilt when a lookup misses or finds a renamed node
+    mutable std::unordered_map<std::string, uint32_t> nameIndices;
+
+    std::set<const Node*> pinnedNodes;
 
 public:
     
@@ -54,58 +82,91 @@ public:
     template<typename T>
     std::vector<std::shared_ptr<T>> GetPointingTo (const Node* node) const
     {
-        std::vector<std::shared_ptr<T>> result;
-
-        for (const NodeConnection& c : connections) {
-            if (c.from.get () == node) {
-                if (auto asCasted = std::dynamic_pointer_cast<T> (c.to)) {
-                    result.push_back (asCasted);
-                }
-            }
-        }
-
-        return result;
+        return GetNeighbours<T> (pointingTo, node);
     }
+
     template<typename T>
     std::vector<std::shared_ptr<T>> GetPointingHere (const Node* node) const
     {
-        std::vector<std::shared_ptr<T>> result;
+        return GetNeighbours<T> (pointingHere, node);
+    }
 
-        for (const NodeConnection& c : connections) {
-            if (c.to.get () == node) {
-                if (auto asCasted = std::dynamic_pointer_cast<T> (c.from)) {
-                    result.push_back (asCasted);
-                }
-            }
-        }
+    void Add (const NodeConnection& connection);
 
-        return result;
+    void Add (const std::shared_ptr<Node>& from, const std::shared_ptr<Node>& to)
+    {
+        Add ({ from, to });
     }
 
-    void Add (const NodeConnection& connection)
-    {
-        Add (connection.from);
-        Add (connection.to);
+    void Add (const std::shared_ptr<Node>& node);
 
-        connections.push_back (connection);
+    const std::vector<std::shared_ptr<Node>>& GetNodesByInsertionOrder () const
+    {
+        return insertionOrder;
     }
 
-    void Add (const std::shared_ptr<Node>& from, const std::shared_ptr<Node>& to)
+    uint32_t GetNodeCount () const { return static_cast<uint32_t> (insertionOrder.size ()); }
+
+    // the position in GetNodesByInsertionOrder, InvalidIndex if the node is not in the set
+    uint32_t GetNodeIndex (const Node* node) const;
+
+    const std::shared_ptr<Node>& GetNodeByIndex (uint32_t nodeIndex) const { return insertionOrder[nodeIndex]; }
+
+    bool IsOperation (uint32_t nodeIndex) const { return isOperation[nodeIndex]; }
+
+    // indices of the neighbours, in the order of the connections
+    const std::vector<uint32_t>& GetOperationIndicesPointingTo (uint32_t nodeIndex) const { return pointingTo[nodeIndex].operations; }
+    const std::vector<uint32_t>& GetResourceIndicesPointingTo (uint32_t nodeIndex) const { return pointingTo[nodeIndex].resources; }
+    const std::vector<uint32_t>& GetOperationIndicesPointingHere (uint32_t nodeIndex) const { return pointingHere[nodeIndex].operations; }
+    const std::vector<uint32_t>& GetResourceIndicesPointingHere (uint32_t nodeIndex) const { return pointingHere[nodeIndex].resources; }
+
+    // pinned resources are kept with the operations writing them, even if the graph does not read them
+    void Pin (const std::shared_ptr<Node>& node)
     {
-        Add ({ from, to });
+        Add (node);
+        pinnedNodes.insert (node.get ());
     }
 
-    void Add (const std::shared_ptr<Node>& node)
+    bool IsPinned (const Node* node) const
     {
-        if (nodeSet.insert (node).second)
-            insertionOrder.push_back (node);
+        return pinnedNodes.count (node) != 0;
     }
 
-    const std::vector<std::shared_ptr<Node>>& GetNodesByInsertionOrder () const
+private:
+    uint32_t AddNode (const std::shared_ptr<Node>& node);
+
+    void RebuildNameIndices () const;
+
+    template<typename T>
+    std::vector<std::shared_ptr<T>> GetNeighbours (const std::vector<Adjacency>& adjacency, const Node* node) const
     {
-        return insertionOrder;
-    }
+        std::vector<std::shared_ptr<T>> result;
+
+        const uint32_t nodeIndex = GetNodeIndex (node);
+        if (nodeIndex == InvalidIndex) {
+            return result;
+        }
 
+        const auto Collect = [&] (const std::vector<uint32_t>& indices) {
+            for (const uint32_t index : indices) {
+                if (auto asCasted = std::dynamic_pointer_cast<T> (insertionOrder[index])) {
+                    result.push_back (asCasted);
+                }
+            }
+        };
+
+        // only the neighbours that can be a T are cast
+        if constexpr (std::is_base_of_v<Operation, T>) {
+            Collect (adjacency[nodeIndex].operations);
+        } else if constexpr (std::is_base_of_v<Resource, T>) {
+            Collect (adjacency[nodeIndex].resources);
+        } else {
+            Collect (adjacency[nodeIndex].operations);
+            Collect (adjacency[nodeIndex].resources);
+        }
+
+        return result;
+    }
 };
 
 
@@ -114,6 +175,14 @@ public:
     ConnectionSet           connectionSet;
     const GVK::DeviceExtra* device;
     uint32_t                framesInFlight;
+    bool                    useAsyncCompute; // only has effect if the device has an async compute queue
+    bool                    profileOperations;
+    bool                    aliasTransientImages; // intermediate images used in disjoint passes share memory, see RenderGraph
+    bool                    mergeRenderOperations; // render operations reading the previous ones as input attachments become subpasses, see MergedRenderPass
+    bool                    useDynamicRendering;   // only has effect if the device supports VK_KHR_dynamic_rendering, see RenderOperation
+
+    // set by RenderGraph::Compile, operations allocate their descriptor sets from it
+    GVK::DescriptorAllocator* descriptorAllocator;
 
     GraphSettings (const GVK::DeviceExtra& device, ConnectionSet&& connectionSet, uint32_t framesInFlight);
     GraphSettings (const GVK::DeviceExtra& device, uint32_t framesInFlight);
@@ -0,0 +1,63 @@
+#ifndef IMAGELOADER_HPP
+#define IMAGELOADER_HPP
+
+#include "RenderGraph/RenderGraphAPI.hpp"
+
+#include "Utils/Noncopyable.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace GVK {
+class DeviceExtra;
+}
+
+namespace RG {
+
+class ReadOnlyImageResource;
+
+// Loads image files into sampled RGBA textures.
+// Files are decoded on worker threads, then every new image is uploaded from one staging buffer with a single submit.
+// Images are cached by path and modification time, so a texture is shared by every user until the file changes.
+class GVK_RENDERER_API ImageLoader : public Noncopyable {
+public:
+    struct Statistics {
+        uint32_t requestCount;
+        uint32_t decodedCount;
+        uint32_t uploadSubmitCount;
+        uint64_t uploadedBytes;
+    };
+
+private:
+    using Key = std::pair<std::filesystem::path, std::filesystem::file_time_type>;
+
+    const GVK::DeviceExtra& device;
+    const bool              generateMipLevels;
+
+    std::map<Key, std::shared_ptr<ReadOnlyImageResource>> images;
+
+    Statistics statistics;
+
+public:
+    ImageLoader (const GVK::DeviceExtra& device, bool generateMipLevels = true);
+
+    // loads all images not in the cache yet
+    void Load (const std::vector<std::filesystem::path>& paths);
+
+    // returns nullptr if the file cannot be read
+    std::shared_ptr<ReadOnlyImageResource> Get (const std::filesystem::path& path);
+
+    const Statistics& GetStatistics () const { return statistics; }
+
+private:
+    static std::optional<Key> GetKey (const std::filesystem::path& path);
+};
+
+} // namespace RG
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef RG_MERGEDRENDERPASS_HPP
+#define RG_MERGEDRENDERPASS_HPP
+
+#include "RenderGraph/RenderGraphAPI.hpp"
+
+#include "Utils/Noncopyable.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace GVK {
+class CommandBuffer;
+class Framebuffer;
+class RenderPass;
+} // namespace GVK
+
+namespace RG {
+
+class GraphSettings;
+class Operation;
+class OperationProfiler;
+class RenderOperation;
+class Resource;
+class WritableImageResource;
+
+
+// Consecutive RenderOperations recorded as the subpasses of one render pass.
+// Later operations read the color attachments of earlier ones only as input attachments (at the same pixel),
+// so on tiled GPUs the attachments used only inside the render pass never have to leave the tile memory.
+class GVK_RENDERER_API MergedRenderPass : public Noncopyable {
+public:
+    struct ImageLayer {
+        WritableImageResource* resource;
+        uint32_t               layerIndex;
+    };
+
+    // the attachments of an operation in the order of its own render pass, color attachments first
+    struct OperationAttachments {
+        std::vector<ImageLayer>              colorAttachments;
+        std::vector<ImageLayer>              inputAttachments;
+        std::vector<VkAttachmentDescription> colorDescriptions;
+        std::vector<VkAttachmentDescription> inputDescriptions;
+    };
+
+    // nullopt if an attachment is not in imageViews
+    static std::optional<OperationAttachments> GetOperationAttachments (RenderOperation& op, const std::unordered_map<VkImageView, ImageLayer>& imageViews);
+
+private:
+    struct Attachment {
+        ImageLayer              image;
+        VkAttachmentDescription description;
+        bool                    internal;
+    };
+
+    std::vector<RenderOperation*>      operations; // in subpass order
+    std::vector<OperationAttachments>  operationAttachments;
+    std::vector<Attachment>            attachments;
+    std::vector<std::vector<uint32_t>> colorAttachmentIndices; // per subpass, into attachments
+    std::vector<std::vector<uint32_t>> inputAttachmentIndices; // per subpass, into attachments
+
+    std::unordered_set<const Resource*> internalResources;
+
+    uint32_t                                       width;
+    uint32_t                                       height;
+    std::shared_ptr<GVK::RenderPass>               renderPass;
+    std::vector<std::shared_ptr<GVK::Framebuffer>> framebuffers; // per frame in flight
+
+public:
+    // internal resources are not used outside of the render pass, their contents are neither loaded nor stored
+    MergedRenderPass (const std::vector<RenderOperation*>&       operations,
+                      std::vector<OperationAttachments>&&        operationAttachments,
+                      const std::unordered_set<const Resource*>& internalResources);
+
+    virtual ~MergedRenderPass () override;
+
+    const std::vector<RenderOperation*>& GetOperations () const { return operations; }
+
+    RenderOperation* GetFirstOperation () const { return operations.front (); }
+
+    uint32_t GetSubpassCount () const { return static_cast<uint32_t> (operations.size ()); }
+
+    bool IsAttachment (const Resource* res) const;
+    bool IsInternal (const Resource* res) const;
+
+    // without duplicates, in the order of the attachments
+    std::vector<WritableImageResource*> GetAttachmentResources () const;
+
+    // layouts expected by the first and left by the last subpass using the attachment
+    VkImageLayout GetLayoutAtStart (WritableImageResource& res) const;
+    VkImageLayout GetLayoutAtEnd (WritableImageResource& res) const;
+
+    // the operations are compiled for their subpasses, the images have to be compiled before this
+    void Compile (const GraphSettings& graphSettings);
+
+    // records every operation, profiler may be nullptr
+    void Record (uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer, OperationProfiler* profiler);
+
+private:
+    uint32_t GetAttachmentIndex (const ImageLayer& image) const;
+
+    bool IsColorAttachmentOfSubpass (uint32_t subpassIndex, const Resource* res) const;
+    bool IsInputAttachmentOfSubpass (uint32_t subpassIndex, const Resource* res) const;
+
+    std::vector<VkSubpassDependency> GetSubpassDependencies () const;
+};
+
+} // namespace RG
+
+#endif
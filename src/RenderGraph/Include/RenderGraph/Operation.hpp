@@ -21,11 +21,13 @@
 
 
 namespace GVK {
+struct DynamicRenderingFunctions;
 class DeviceExtra;
 class DescriptorPool;
 class DescriptorSet;
 class DescriptorSetLayout;
 class Framebuffer;
+class RenderPass;
 class ImageView2D;
 class CommandBuffer;
 } // namespace GVK
@@ -46,7 +48,11 @@ public:
     struct GVK_RENDERER_API Descriptors {
         std::unique_ptr<GVK::DescriptorPool>             descriptorPool;
         std::unique_ptr<GVK::DescriptorSetLayout>        descriptorSetLayout;
-        std::vector<std::unique_ptr<GVK::DescriptorSet>> descriptorSets;
+        std::vector<std::unique_ptr<GVK::DescriptorSet>> descriptorSets; // per frame in flight, or one if every frame writes the same descriptors
+        std::vector<std::vector<uint32_t>>               dynamicOffsets; // per frame in flight, in the order of the bindings
+
+        VkDescriptorSet              GetDescriptorSet (uint32_t resourceIndex) const;
+        const std::vector<uint32_t>& GetDynamicOffsets (uint32_t resourceIndex) const;
     };
 
     virtual ~Operation () override = default;
@@ -56,6 +62,9 @@ public:
 
     virtual void Record (const ConnectionSet& connectionSet, uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer) = 0;
 
+    // descriptor counts of a single descriptor set, used for sizing the shared descriptor pools of the graph
+    virtual std::vector<VkDescriptorPoolSize> GetDescriptorPoolSizes () const = 0;
+
     // when record called, input images will be in GetImageLayoutAtStartForInputs ()
     // output images will be in GetImageLayoutAtStartForOutputs () layouts.
     // recorded commands will put the input images in GetImageLayoutAtEndForInputs ()
@@ -101,6 +110,8 @@ public:
     virtual void CompileWithExtent (const GraphSettings&, uint32_t width, uint32_t height) override;
 
     virtual void Record (const ConnectionSet& connectionSet, uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer) override;
+
+    virtual std::vector<VkDescriptorPoolSize> GetDescriptorPoolSizes () const override;
     
     virtual VkImageLayout GetImageLayoutAtStartForInputs (Resource&)  override { GVK_BREAK (); throw std::runtime_error ("Compute shaders do not operate on images."); }
     virtual VkImageLayout GetImageLayoutAtEndForInputs (Resource&)    override { GVK_BREAK (); throw std::runtime_error ("Compute shaders do not operate on images."); }
@@ -150,15 +161,23 @@ public:
         std::optional<glm::vec4> clearColor;   // (0, 0, 0, 1) by default
         std::optional<bool>      blendEnabled; // true by default
 
+        // viewport and scissor, the whole extent by default
+        // attachments are still cleared on the whole extent, only the drawing is restricted
+        std::optional<VkRect2D> renderArea;
+
         std::unique_ptr<RG::FromShaderReflection::DescriptorWriteInfoTable> descriptorWriteProvider;
         std::unique_ptr<RG::FromShaderReflection::AttachmentDataTable>      attachmentProvider;
     };
 
     struct GVK_RENDERER_API CompileResult {
-        uint32_t                                         width;
-        uint32_t                                         height;
-        Descriptors                                      descriptors;
-        std::vector<std::unique_ptr<GVK::Framebuffer>>   framebuffers;
+        uint32_t                                               width;
+        uint32_t                                               height;
+        Descriptors                                            descriptors;
+        std::vector<std::shared_ptr<GVK::Framebuffer>>         framebuffers; // shared through the device's object cache, empty with dynamic rendering
+
+        // set when recorded with VK_KHR_dynamic_rendering instead of a render pass and framebuffers, points into the device
+        const GVK::DynamicRenderingFunctions*                  dynamicRendering = nullptr;
+        std::vector<std::vector<VkRenderingAttachmentInfoKHR>> renderingAttachments; // per frame in flight, in the order of the color attachments
     };
 
     CompileSettings compileSettings;
@@ -172,9 +191,35 @@ public:
     virtual void CompileWithExtent (const GraphSettings&, uint32_t width, uint32_t height) override;
     virtual void Record (const ConnectionSet& connectionSet, uint32_t imageIndex, GVK::CommandBuffer& commandBuffer) override;
 
+    // with VK_KHR_dynamic_rendering (see GraphSettings::useDynamicRendering) no render pass and no framebuffers are created,
+    // except for operations reading input attachments, these can only be recorded in a render pass
+    bool UsesDynamicRendering () const { return compileResult.dynamicRendering != nullptr; }
+
+    // the pipeline is created for a subpass of a render pass shared with other operations, see MergedRenderPass
+    // Record cannot be used after this, the render pass is begun by the MergedRenderPass
+    void CompileForSubpass (const GraphSettings&, uint32_t width, uint32_t height, const std::shared_ptr<GVK::RenderPass>& renderPass, uint32_t subpassIndex);
+
+    // recreates only the framebuffers (or the attachments of dynamic rendering) for a new extent, e.g. after the swapchain is resized
+    // viewport and scissor are dynamic state, so the pipeline compiled by CompileWithExtent can be kept
+    void CompileFramebuffers (const GraphSettings&, uint32_t width, uint32_t height);
+
+    // records the drawing into the current subpass of a begun render pass
+    void RecordSubpass (uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer);
+
+    VkClearValue GetClearValue () const;
+
+    virtual std::vector<VkDescriptorPoolSize> GetDescriptorPoolSizes () const override;
+
     const std::unique_ptr<ShaderPipeline>& GetShaderPipeline () const { return compileSettings.pipeline; }
 
+    // renderArea clipped to the compiled extent
+    VkRect2D GetRenderArea () const;
+
 private:
+    void CompilePipeline (const GraphSettings&, uint32_t width, uint32_t height, const std::shared_ptr<GVK::RenderPass>& renderPass, uint32_t subpassIndex);
+
+    void RecordDynamicRendering (const ConnectionSet& connectionSet, uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer);
+
     virtual VkImageLayout GetImageLayoutAtStartForInputs (Resource&) override;
     virtual VkImageLayout GetImageLayoutAtEndForInputs (Resource&) override;
     virtual VkImageLayout GetImageLayoutAtStartForOutputs (Resource&) override;
@@ -0,0 +1,145 @@
+#ifndef OPERATIONPROFILER_HPP
+#define OPERATIONPROFILER_HPP
+
+#include "RenderGraph/RenderGraphAPI.hpp"
+
+#include "Utils/Noncopyable.hpp"
+#include "Utils/Time.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace GVK {
+class CommandBuffer;
+class DeviceExtra;
+class Fence;
+class QueryPool;
+} // namespace GVK
+
+namespace RG {
+
+class Operation;
+
+
+struct GVK_RENDERER_API TimingStatistics {
+    double   minMilliseconds;
+    double   meanMilliseconds;
+    double   p99Milliseconds;
+    uint32_t sampleCount;
+};
+
+
+// keeps the last capacity samples
+class GVK_RENDERER_API TimingHistory {
+private:
+    std::vector<double> samples;
+    size_t              capacity;
+    size_t              nextIndex;
+
+public:
+    TimingHistory (size_t capacity = 256);
+
+    void Add (double milliseconds);
+
+    TimingStatistics GetStatistics () const;
+};
+
+
+class GVK_RENDERER_API IOperationTimingObserver {
+public:
+    virtual ~IOperationTimingObserver () = default;
+
+    virtual void OnOperationTimed (const Operation&, double, const TimingStatistics&) {}
+    virtual void OnFrameTimed (uint32_t, double, const TimingStatistics&) {}
+};
+
+extern GVK_RENDERER_API IOperationTimingObserver noOpOperationTimingObserver;
+
+
+// Measures the GPU time of every operation with timestamp queries, one query pool per frame in flight and queue.
+// Results are only read back after the fence of the submission is seen signaled, collecting never waits for the GPU.
+// Until the reset recorded in the submission is executed, the pools still hold the results of the previous one.
+// When the device has no timestamp support, only the frame times are measured on the CPU,
+// from submission until the fence of the frame is seen signaled.
+class GVK_RENDERER_API OperationProfiler : public Noncopyable {
+public:
+    enum class SubmitQueue {
+        Graphics,
+        AsyncCompute,
+    };
+
+    struct QueryIndex {
+        SubmitQueue queue;
+        uint32_t    begin;
+        uint32_t    end;
+    };
+
+private:
+    struct FrameQueries {
+        std::unique_ptr<GVK::QueryPool> graphicsPool;
+        std::unique_ptr<GVK::QueryPool> computePool;
+
+        bool           pending;
+        VkFence        fence;
+        GVK::TimePoint submitTime;
+
+        // signaled by submissions without a fence
+        std::unique_ptr<GVK::Fence> ownFence;
+    };
+
+    const GVK::DeviceExtra& device;
+    const bool              useTimestamps;
+
+    std::vector<Operation*> graphicsOperations;
+    std::vector<Operation*> computeOperations;
+
+    std::vector<FrameQueries> frames;
+
+    std::unordered_map<const Operation*, TimingHistory> operationHistories;
+    TimingHistory                                       frameHistory;
+
+    std::vector<uint64_t> graphicsResults;
+    std::vector<uint64_t> computeResults;
+
+public:
+    OperationProfiler (const GVK::DeviceExtra&        device,
+                       uint32_t                       framesInFlight,
+                       const std::vector<Operation*>& graphicsOperations,
+                       const std::vector<Operation*>& computeOperations);
+
+    virtual ~OperationProfiler () override;
+
+    bool UsesTimestamps () const { return useTimestamps; }
+
+    std::optional<QueryIndex> GetQueryIndex (const Operation* op) const;
+
+    // recorded at the beginning of the command buffer, outside of render passes
+    void RecordReset (uint32_t frameIndex, SubmitQueue queue, GVK::CommandBuffer& commandBuffer);
+    void RecordBegin (uint32_t frameIndex, const Operation* op, GVK::CommandBuffer& commandBuffer);
+    void RecordEnd (uint32_t frameIndex, const Operation* op, GVK::CommandBuffer& commandBuffer);
+
+    // the fence to signal by the submission of the frame, an own fence of the profiler if the submission has none
+    // waits for the previous submission of the frame before reusing the own fence
+    VkFence GetFenceToSignal (uint32_t frameIndex, VkFence fence);
+
+    void OnSubmitted (uint32_t frameIndex, VkFence fence);
+
+    // reads back the results of every finished frame
+    void Collect (IOperationTimingObserver& observer);
+
+    TimingStatistics GetStatistics (const Operation* op) const;
+    TimingStatistics GetFrameStatistics () const;
+
+private:
+    GVK::QueryPool* GetQueryPool (uint32_t frameIndex, SubmitQueue queue) const;
+    double          GetMilliseconds (uint64_t beginTimestamp, uint64_t endTimestamp) const;
+    void            CollectTimestamps (uint32_t frameIndex, IOperationTimingObserver& observer);
+};
+
+} // namespace RG
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef PRESENTTIMINGLOG_HPP
+#define PRESENTTIMINGLOG_HPP
+
+#include "RenderGraph/RenderGraphAPI.hpp"
+#include "RenderGraph/GraphRenderer.hpp"
+
+#include "Utils/Noncopyable.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+
+namespace RG {
+
+// Detects missed vertical blanks from the frame timings of a run.
+// The interval between two images becoming available is a multiple of the refresh interval with fifo presenting,
+// a longer interval means the previous frame stayed on the screen for more than one refresh (a dropped frame).
+// Optionally writes every frame to a compact binary log, see BinaryRecord.
+class GVK_RENDERER_API PresentTimingLog : public Noncopyable {
+public:
+    static constexpr uint32_t                  HistogramBucketCount = 9;
+    static constexpr std::chrono::microseconds HistogramBucketWidth { 250 };
+
+    struct Summary {
+        uint32_t frameCount;
+        uint32_t droppedFrameCount; // frames displayed for more than one refresh
+        uint32_t missedVblankCount;
+        uint32_t lateFrameCount; // frames that took longer than a refresh interval from acquire to present
+        double   meanIntervalMilliseconds;
+        double   maxIntervalMilliseconds;
+
+        // difference from the nearest multiple of the refresh interval, the last bucket has everything above
+        std::array<uint32_t, HistogramBucketCount> jitterHistogram;
+    };
+
+    // the log file starts with "GVPT", a uint32 version and the uint64 expected interval in nanoseconds
+    // times are in nanoseconds since the first image became available
+    struct BinaryRecord {
+        uint32_t presentIndex;
+        uint32_t missedVblanks;
+        uint64_t acquireStarted;
+        uint64_t imageAvailable;
+        uint64_t submitted;
+        uint64_t presented;
+    };
+
+    static constexpr uint32_t BinaryLogVersion = 1;
+
+private:
+    const std::chrono::nanoseconds expectedInterval;
+
+    std::optional<std::ofstream> binaryLog;
+
+    Summary summary;
+
+    std::optional<FrameTiming::Clock::time_point> firstImageAvailable;
+    std::optional<FrameTiming::Clock::time_point> lastImageAvailable;
+    double                                        intervalSumMilliseconds;
+
+public:
+    PresentTimingLog (std::chrono::nanoseconds expectedInterval);
+    PresentTimingLog (std::chrono::nanoseconds expectedInterval, const std::filesystem::path& binaryLogPath);
+
+    // returns the number of vertical blanks missed before this frame
+    uint32_t Add (const FrameTiming& timing);
+
+    const Summary& GetSummary () const { return summary; }
+
+    std::string GetSummaryString () const;
+};
+
+} // namespace RG
+
+#endif
@@ -4,60 +4,206 @@
 #include "RenderGraph/RenderGraphAPI.hpp"
 
 #include "Utils/Event.hpp"
+#include "VulkanWrapper/Allocator.hpp"
 #include "VulkanWrapper/Utils/VulkanUtils.hpp"
 #include <memory>
 
 #include "RenderGraph/GraphSettings.hpp"
 #include "RenderGraph/RenderGraphPass.hpp"
+#include "RenderGraph/TransientMemory.hpp"
 
+#include <map>
+#include <optional>
 #include <set>
+#include <string>
 #include <unordered_set>
 
 
 namespace GVK {
 class CommandBuffer;
+class DescriptorAllocator;
+class SharedAllocation;
 class Swapchain;
+class TimelineSemaphore;
 }
 
 namespace RG {
+class MergedRenderPass;
 class Operation;
 class Resource;
+class WritableImageResource;
 class GraphSettings;
+class OperationProfiler;
+class IOperationTimingObserver;
 }
 
 
 namespace RG {
 
+// operations that do not contribute to any sink resource, and the resources used only by them, in insertion order
+// sinks are swapchain images, pinned resources (see ConnectionSet::Pin) and resources that no operation reads
+// after writing them, these are presented or read back after submitting
+GVK_RENDERER_API std::vector<std::shared_ptr<Node>> GetDeadNodes (const ConnectionSet& connectionSet);
+
+// the operations grouped into levels in the order of their dependencies, operations are in insertion order in a level
+// an operation is in a later level than the writers of its inputs, and operations writing the same resource are in different levels
+// skippedNodes is by node index (see ConnectionSet::GetNodeIndex), skipped operations are not in any level
+GVK_RENDERER_API std::vector<std::vector<Operation*>> GetDependencyLevels (const ConnectionSet& connectionSet, const std::vector<bool>& skippedNodes = {});
+
+
 class GVK_RENDERER_API RenderGraph final : public Noncopyable {
+public:
+    struct TransientMemoryStats {
+        uint32_t     imageCount;    // of one frame in flight
+        VkDeviceSize unaliasedSize; // of all frames in flight
+        VkDeviceSize allocatedSize; // of all frames in flight
+    };
+
+    // objects recreated by the last Compile or Recompile call
+    struct CompileStats {
+        uint32_t compiledResources;
+        uint32_t compiledPipelines;      // operations compiled with their descriptors and pipelines
+        uint32_t compiledFramebuffers;   // render operations with only their framebuffers recreated
+        uint32_t recordedCommandBuffers; // of all frames in flight
+    };
+
+    // the memory of the compiled resources, see Resource::GetAllocations
+    struct MemoryReport {
+        struct ResourceMemory {
+            const Resource* resource;
+            std::string     name; // the allocations are tagged with this
+            std::string     type;
+            uint32_t        allocationCount;
+            VkDeviceSize    size;
+        };
+
+        std::vector<ResourceMemory>         resources; // in insertion order, without the culled ones
+        std::map<std::string, VkDeviceSize> sizeByType;
+        VkDeviceSize                        resourceSize;  // of the allocations owned by the resources
+        VkDeviceSize                        transientSize; // of the blocks shared by the transient images
+        VkDeviceSize                        totalSize;
+
+        // of the whole allocator, shared with every other graph on the device
+        GVK::Allocator::Statistics allocator;
+    };
+
 public:// TODO
     bool                       compiled;
     std::vector<Pass>          passes;
     std::vector<GVK::CommandBuffer> commandBuffers;
+
+    // one arena per frame in flight, shared by all operations of the graph
+    std::unique_ptr<GVK::DescriptorAllocator> descriptorAllocator;
+
+    // compute operations submitted to the async compute queue, recorded into computeCommandBuffers instead of commandBuffers
+    std::vector<Operation*>                 asyncComputeOperations;
+    std::vector<GVK::CommandBuffer>         computeCommandBuffers;
+    std::unique_ptr<GVK::TimelineSemaphore> computeTimeline;
+    std::unique_ptr<GVK::TimelineSemaphore> graphicsTimeline;
+    uint64_t                                computeTimelineValue;
+    uint64_t                                graphicsTimelineValue;
+    std::vector<uint64_t>                   lastGraphicsTimelineValues; // per frame in flight
+
+    // only created when profiling is enabled, timings are collected when submitting
+    std::unique_ptr<OperationProfiler> profiler;
+    IOperationTimingObserver*          operationTimingObserver;
     
     std::unordered_map<VkImage, std::vector<VkImageLayout>> imageLayoutSequence;
 
+    // not compiled and not recorded, see GetDeadNodes
+    std::vector<std::shared_ptr<Node>> culledNodes;
+    std::vector<bool>                  culledNodeFlags; // by node index
+
+    // intermediate images sharing memory with each other, see GraphSettings::aliasTransientImages
+    // their contents are discarded before the first pass using them, and do not survive between frames
+    std::vector<std::optional<ResourceLifetime>>        transientLifetimes; // by node index
+    std::vector<std::unique_ptr<GVK::SharedAllocation>> transientAllocations; // blocks of every frame in flight
+    TransientMemoryStats                                transientMemoryStats;
+
+    CompileStats compileStats;
+
+    // chains of render operations recorded as the subpasses of one render pass, see GraphSettings::mergeRenderOperations
+    // the operations of a chain are in the pass of the first one
+    std::vector<std::unique_ptr<MergedRenderPass>> mergedRenderPasses;
+    std::vector<MergedRenderPass*>                 mergedRenderPassOfNode; // by node index, nullptr if not merged
+    std::vector<bool>                              internalAttachments;    // by node index, used only inside one merged render pass
+
 public:
     GraphSettings graphSettings;
 
 public:
     RenderGraph ();
+    ~RenderGraph ();
 
     void Compile (GraphSettings&& settings);
 
+    // after the swapchains are recreated with the same image count and format, e.g. resized
+    // the swapchain images and the framebuffers of the operations writing them are recreated, the operations reading them are recompiled
+    // the other resources, the pipelines of the writers (viewport and scissor are dynamic state) and the passes are kept
+    void RecompileSwapchainImages ();
+
+    // after the shaders of the operations are reloaded, see ShaderPipeline::Reload
+    // only their descriptor set layouts, descriptor sets and pipelines are recreated, the operations of a merged render pass are recompiled together
+    // the previous descriptor sets stay allocated until the next Compile
+    void RecompileOperations (const std::vector<Operation*>& operations);
+
     void Submit (uint32_t frameIndex, const std::vector<VkSemaphore>& waitSemaphores = {}, const std::vector<VkSemaphore>& signalSemaphores = {}, VkFence fence = VK_NULL_HANDLE);
     void Present (uint32_t imageIndex, GVK::Swapchain& swapchain, const std::vector<VkSemaphore>& waitSemaphores = {});
 
     uint32_t GetPassCount () const;
 
+    bool UsesAsyncCompute () const;
+
+    const std::vector<std::shared_ptr<Node>>& GetCulledNodes () const { return culledNodes; }
+
+    bool IsCulled (const Node* node) const;
+
+    bool IsTransient (const Resource* res) const;
+
+    const TransientMemoryStats& GetTransientMemoryStats () const { return transientMemoryStats; }
+
+    const CompileStats& GetCompileStats () const { return compileStats; }
+
+    MemoryReport GetMemoryReport () const;
+
+    // moves the allocations of the uniform buffers (see CPUBufferResource and UniformArena) to fill the gaps left by freed allocations,
+    // e.g. between stimuli, the operations using the moved buffers are recompiled
+    GVK::Allocator::DefragmentationResult DefragmentMemory ();
+
+    uint32_t GetMergedRenderPassCount () const { return static_cast<uint32_t> (mergedRenderPasses.size ()); }
+
+    // nullptr if the operation is recorded in its own render pass
+    MergedRenderPass* GetMergedRenderPass (const Operation* op) const;
+
+    void SetOperationTimingObserver (IOperationTimingObserver& observer);
+
     RG::ConnectionSet& GetConnectionSet () { return graphSettings.connectionSet; }
 
 private:
+    // the position of the node in the connection set, the per-node state of the graph is stored in vectors by this
+    uint32_t GetNodeIndex (const Node* node) const;
+    bool     IsInternalAttachment (const Resource* res) const;
+
+    void CullDeadNodes ();
+    void CollectTransientResources ();
     void CompileResources ();
-    void CompileOperations ();
-    Pass GetNextPass (const Pass& lastPass) const;
-    Pass GetFirstPass () const;
+    void CompileTransientImages ();
+    void AllocateTransientImages (const std::vector<WritableImageResource*>& transientImages);
+    void NameAllocations () const;
+    std::string GetAllocationName (const Resource& res) const;
+    bool IsFirstUseOfTransient (const Resource* res, uint32_t passIndex) const;
+    void PrepareDescriptorAllocator ();
+    // selectedOperations is by node index, empty compiles every operation
+    // the operations of a merged render pass are compiled together when the first one is selected
+    void CompileOperations (const std::vector<bool>& selectedOperations = {});
+    void CompileOperation (Operation& op);
+    void RecordCommandBuffers ();
     void CreatePasses ();
-    void SeparatePasses ();
+    void MergeRenderOperations ();
+    void CollectAsyncComputeOperations ();
+    void RecordAsyncComputeCommandBuffers ();
+    void CreateProfiler ();
+    bool IsAsyncComputeOperation (const Operation* op) const;
     void DebugPrint ();
 };
 
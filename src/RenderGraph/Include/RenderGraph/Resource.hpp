@@ -34,12 +34,16 @@ class Sampler;
 class ImageTransferable;
 class BufferTransferable;
 class InheritedImage;
+class AliasedImage2D;
+class SharedAllocation;
+class CommandBuffer;
 }
 
 namespace RG {
 
 class GraphSettings;
 class Operation;
+class UniformArena;
 
 
 class GVK_RENDERER_API Resource : public Node {
@@ -53,6 +57,9 @@ public:
     virtual void OnPostWrite (uint32_t resourceIndex, GVK::CommandBuffer&) {};
     virtual void OnGraphExecutionStarted (uint32_t resourceIndex, GVK::CommandBuffer&) {};
     virtual void OnGraphExecutionEnded (uint32_t resourceIndex, GVK::CommandBuffer&) {};
+
+    // the memory owned by the resource after Compile, for memory reports, see RenderGraph::GetMemoryReport
+    virtual std::vector<VmaAllocation> GetAllocations () const { return {}; }
 };
 
 
@@ -105,7 +112,13 @@ protected:
         std::unique_ptr<GVK::Image>                    image;
         std::vector<std::unique_ptr<GVK::ImageView2D>> imageViews;
 
-        SingleImageResource (const GVK::DeviceExtra& device, uint32_t width, uint32_t height, uint32_t arrayLayers, VkFormat format = FormatRGBA, VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL);
+        // a transient attachment can only be used as a color or input attachment, its memory is lazily allocated if the device supports it
+        SingleImageResource (const GVK::DeviceExtra& device, uint32_t width, uint32_t height, uint32_t arrayLayers, VkFormat format = FormatRGBA, VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL, bool transientAttachment = false);
+
+        // without memory, the image views are created by BindMemory
+        SingleImageResource (std::unique_ptr<GVK::AliasedImage2D>&& aliasedImage);
+
+        void BindMemory (const GVK::DeviceExtra& device, const GVK::SharedAllocation& allocation, VkDeviceSize offset);
     };
 
 public:
@@ -119,7 +132,7 @@ public:
     VkImageLayout finalLayout;   // TODO temporary
 
     std::vector<std::unique_ptr<SingleImageResource>> images;
-    std::unique_ptr<GVK::Sampler>                     sampler;
+    std::shared_ptr<GVK::Sampler>                     sampler;
 
 public:
     WritableImageResource (VkFilter filter, uint32_t width, uint32_t height, uint32_t arrayLayers, VkFormat format = SingleImageResource::FormatRGBA);
@@ -130,6 +143,20 @@ public:
 
     virtual void Compile (const GraphSettings& graphSettings) override;
 
+    // intermediate images can share memory with other intermediates used in different passes, see RenderGraph
+    virtual bool CanBeAliased () const { return true; }
+
+    // like Compile, but the images are created without memory
+    void CompileAliased (const GraphSettings& graphSettings);
+
+    // like Compile, for images used only inside one render pass, see MergedRenderPass
+    void CompileTransientAttachment (const GraphSettings& graphSettings);
+
+    // of one image, every frame in flight has the same
+    VkMemoryRequirements GetMemoryRequirements () const;
+
+    void BindAliasedMemory (const GVK::DeviceExtra& device, uint32_t resourceIndex, const GVK::SharedAllocation& allocation, VkDeviceSize offset);
+
     // overriding ImageResource
     virtual VkImageLayout GetInitialLayout () const override;
 
@@ -145,6 +172,9 @@ public:
     // overriding DescriptorBindableImage
     virtual VkImageView GetImageViewForFrame (uint32_t resourceIndex, uint32_t layerIndex) override;
     virtual VkSampler   GetSampler () override;
+
+    // empty for aliased images, their memory is owned by the RenderGraph
+    virtual std::vector<VmaAllocation> GetAllocations () const override;
 };
 
 
@@ -157,6 +187,9 @@ public:
 
     virtual void Compile (const GraphSettings& graphSettings) override;
 
+    // the event is waited for in the next frame
+    virtual bool CanBeAliased () const override { return false; }
+
     virtual void OnPreRead (uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer) override;
 
     virtual void OnPreWrite (uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer) override;
@@ -186,6 +219,8 @@ public:
     void TransferFromCPUToGPU (uint32_t resourceIndex, const void* data, size_t size) const;
 
     void TransferFromGPUToCPU (uint32_t resourceIndex) const;
+
+    virtual std::vector<VmaAllocation> GetAllocations () const override;
 };
 
 
@@ -193,7 +228,7 @@ class GVK_RENDERER_API ReadOnlyImageResource : public OneTimeCompileResource, pu
 public:
     std::unique_ptr<GVK::ImageTransferable> image;
     std::unique_ptr<GVK::ImageViewBase>     imageView;
-    std::unique_ptr<GVK::Sampler>           sampler;
+    std::shared_ptr<GVK::Sampler>           sampler;
 
     const VkFormat format;
     const VkFilter filter;
@@ -201,9 +236,11 @@ public:
     const uint32_t height;
     const uint32_t depth;
     const uint32_t layerCount;
+    const uint32_t mipLevels;
 
 public:
-    ReadOnlyImageResource (VkFormat format, VkFilter filter, uint32_t width, uint32_t height = 1, uint32_t depth = 1, uint32_t layerCount = 1);
+    // mip levels are only supported for single layer 2D images, the levels above 0 are filled by GenerateMipLevels
+    ReadOnlyImageResource (VkFormat format, VkFilter filter, uint32_t width, uint32_t height = 1, uint32_t depth = 1, uint32_t layerCount = 1, uint32_t mipLevels = 1);
 
     ReadOnlyImageResource (VkFormat format, uint32_t width, uint32_t height = 1, uint32_t depth = 1, uint32_t layerCount = 1);
 
@@ -226,6 +263,12 @@ public:
     virtual VkImageView GetImageViewForFrame (uint32_t, uint32_t) override;
     virtual VkSampler   GetSampler () override;
 
+    virtual std::vector<VmaAllocation> GetAllocations () const override;
+
+    // records the blits filling every mip level from level 0, the image is expected in transfer dst layout
+    // and left in shader read only layout
+    void RecordMipLevelGeneration (GVK::CommandBuffer& commandBuffer) const;
+
     template<typename T>
     void CopyTransitionTransfer (const std::vector<T>& pixelData)
     {
@@ -290,6 +333,42 @@ public:
     virtual uint32_t GetBufferSize () override;
 
     GVK::MemoryMapping& GetMapping (uint32_t resourceIndex);
+
+    virtual std::vector<VmaAllocation> GetAllocations () const override;
+
+    // moved is by frame in flight, the buffers of the moved allocations are recreated and mapped again
+    // the operations using them have to be recompiled, see RenderGraph::DefragmentMemory
+    void BindMovedAllocations (const GraphSettings& graphSettings, const std::vector<bool>& moved);
+};
+
+
+// A uniform block in a UniformArena, the arena is compiled by the first of its blocks compiled.
+// Bound as a dynamic uniform buffer, the descriptors are the same for every frame in flight.
+class GVK_RENDERER_API UniformArenaBufferResource : public DescriptorBindableBufferResource {
+public:
+    const std::shared_ptr<UniformArena> arena;
+    const uint32_t                      blockIndex;
+
+public:
+    UniformArenaBufferResource (const std::shared_ptr<UniformArena>& arena, uint32_t blockIndex);
+
+    virtual ~UniformArenaBufferResource ();
+
+    // overriding Resource
+    virtual void Compile (const GraphSettings& graphSettings) override;
+
+    // overriding DescriptorBindableBuffer
+    virtual VkBuffer GetBufferForFrame (uint32_t resourceIndex) override;
+    virtual uint32_t GetBufferSize () override;
+
+    uint32_t GetDynamicOffset (uint32_t resourceIndex) const;
+
+    std::function<uint32_t (uint32_t)> GetDynamicOffsetProvider ();
+
+    void Copy (uint32_t resourceIndex, const void* data, size_t size) const;
+
+    // the allocation of the whole arena, every block of the arena returns the same
+    virtual std::vector<VmaAllocation> GetAllocations () const override;
 };
 
 
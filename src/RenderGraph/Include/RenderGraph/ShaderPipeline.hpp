@@ -17,14 +17,20 @@
 namespace GVK {
 enum class ShaderKind : uint8_t;
 class ShaderModule;
+class SpecializationConstants;
 class RenderPass;
 class GraphicsPipeline;
 class PipelineLayout;
 class DescriptorSetLayout;
+class ObjectCache;
 }
 
 namespace RG {
 
+namespace FromShaderReflection {
+class IDescriptorWriteInfoProvider;
+}
+
 class GVK_RENDERER_API ShaderPipeline {
 private:
     const VkDevice device;
@@ -53,11 +59,26 @@ public:
         VkPrimitiveTopology                    topology;
 
         std::optional<bool> blendEnabled;
+
+        // optional, when set the render pass is shared with other pipelines using the same attachments
+        GVK::ObjectCache* objectCache = nullptr;
+
+        // optional
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+        // optional, when set the pipeline is created for a subpass of this render pass, and attachmentReferences
+        // and attachmentDescriptions are only used for the blend states
+        std::shared_ptr<GVK::RenderPass> renderPass;
+        uint32_t                         subpassIndex = 0;
+
+        // optional, when set no render pass is created, the pipeline is used with VK_KHR_dynamic_rendering
+        // and only the formats of attachmentDescriptions are used, there can be no input attachments
+        bool dynamicRendering = false;
     };
 
 
     struct CompileResult {
-        std::unique_ptr<GVK::RenderPass>       renderPass;
+        std::shared_ptr<GVK::RenderPass>       renderPass; // nullptr with dynamic rendering
         std::unique_ptr<GVK::PipelineLayout>   pipelineLayout;
         std::unique_ptr<GVK::GraphicsPipeline> pipeline;
 
@@ -82,6 +103,9 @@ public:
     void SetShaderFromSourceFile (const std::filesystem::path& shaderPath);
     void SetShadersFromSourceFiles (const std::vector<std::filesystem::path>& shaderPath);
 
+    // set on every shader, must be called before compiling, the values are kept when the shaders are reloaded
+    void SetSpecializationConstants (const GVK::SpecializationConstants& values);
+
     void Compile (CompileSettings&& settings);
 
     void Reload ();
@@ -90,7 +114,8 @@ public:
 
     std::vector<VkPipelineShaderStageCreateInfo> GetShaderStages () const;
 
-    std::unique_ptr<GVK::DescriptorSetLayout> CreateDescriptorSetLayout (VkDevice device) const;
+    // uniform blocks are dynamic uniform buffers if infoProvider says so
+    std::unique_ptr<GVK::DescriptorSetLayout> CreateDescriptorSetLayout (VkDevice device, FromShaderReflection::IDescriptorWriteInfoProvider& infoProvider) const;
 };
 
 } // namespace RG
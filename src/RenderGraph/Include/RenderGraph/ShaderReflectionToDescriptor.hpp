@@ -9,6 +9,7 @@
 
 #include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 #include <cstdint>
 
@@ -22,6 +23,10 @@ public:
 
     virtual std::vector<VkDescriptorImageInfo>  GetDescriptorImageInfos (const std::string& name, GVK::ShaderKind shaderKind, uint32_t layerIndex, uint32_t frameIndex) = 0;
     virtual std::vector<VkDescriptorBufferInfo> GetDescriptorBufferInfos (const std::string& name, GVK::ShaderKind shaderKind, uint32_t frameIndex)                     = 0;
+
+    // uniform blocks written as VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, the offset of a frame is given when binding the descriptor set
+    virtual bool     IsDynamicUniformBuffer (const std::string&, GVK::ShaderKind) { return false; }
+    virtual uint32_t GetDynamicOffset (const std::string&, GVK::ShaderKind, uint32_t) { return 0; }
 };
 
 
@@ -41,6 +46,9 @@ public:
         std::function<VkBuffer (uint32_t)> buffer;
         VkDeviceSize                       offset;
         VkDeviceSize                       range;
+
+        // by frame in flight, set for uniform blocks bound with dynamic offsets (see UniformArena)
+        std::function<uint32_t (uint32_t)> dynamicOffset;
     };
 
     std::vector<ImageEntry> imageInfos;
@@ -51,6 +59,9 @@ public:
     virtual std::vector<VkDescriptorImageInfo> GetDescriptorImageInfos (const std::string& name, GVK::ShaderKind shaderKind, uint32_t layerIndex, uint32_t frameIndex) override;
 
     virtual std::vector<VkDescriptorBufferInfo> GetDescriptorBufferInfos (const std::string& name, GVK::ShaderKind shaderKind, uint32_t frameIndex) override;
+
+    virtual bool     IsDynamicUniformBuffer (const std::string& name, GVK::ShaderKind shaderKind) override;
+    virtual uint32_t GetDynamicOffset (const std::string& name, GVK::ShaderKind shaderKind, uint32_t frameIndex) override;
 };
 
 
@@ -71,8 +82,16 @@ void WriteDescriptors (const GVK::ShaderModule::Reflection& reflection,
                        IUpdateDescriptorSets&               updateInterface);
 
 
+// the offsets of the dynamic uniform buffers with their bindings
+GVK_RENDERER_API
+std::vector<std::pair<uint32_t, uint32_t>> GetDynamicOffsets (const GVK::ShaderModule::Reflection& reflection,
+                                                               uint32_t                             frameIndex,
+                                                               GVK::ShaderKind                      shaderKind,
+                                                               IDescriptorWriteInfoProvider&        infoProvider);
+
+
 GVK_RENDERER_API
-std::vector<VkDescriptorSetLayoutBinding> GetLayout (const GVK::ShaderModule::Reflection& reflection, GVK::ShaderKind shaderKind);
+std::vector<VkDescriptorSetLayoutBinding> GetLayout (const GVK::ShaderModule::Reflection& reflection, GVK::ShaderKind shaderKind, IDescriptorWriteInfoProvider& infoProvider);
 
 } // namespace FromShaderReflection
 } // namespace RG
@@ -0,0 +1,54 @@
+#ifndef TRANSIENTMEMORY_HPP
+#define TRANSIENTMEMORY_HPP
+
+#include "RenderGraph/RenderGraphAPI.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace RG {
+
+// pass indices of the first and the last use of a resource, inclusive
+struct GVK_RENDERER_API ResourceLifetime {
+    uint32_t firstPass;
+    uint32_t lastPass;
+
+    bool Overlaps (const ResourceLifetime& other) const { return firstPass <= other.lastPass && other.firstPass <= lastPass; }
+};
+
+
+// Places resources used in disjoint pass ranges at the same memory.
+// Resources following each other share a slot, the slots are packed into blocks with compatible memory types,
+// one allocation is made for every block.
+class GVK_RENDERER_API TransientMemoryLayout {
+public:
+    struct Block {
+        VkDeviceSize size;
+        VkDeviceSize alignment;
+        uint32_t     memoryTypeBits;
+
+        VkMemoryRequirements GetMemoryRequirements () const { return { size, alignment, memoryTypeBits }; }
+    };
+
+    struct Placement {
+        uint32_t     blockIndex;
+        VkDeviceSize offset;
+    };
+
+    std::vector<Block>     blocks;
+    std::vector<Placement> placements; // in the order of the resources
+
+public:
+    TransientMemoryLayout (const std::vector<ResourceLifetime>& lifetimes, const std::vector<VkMemoryRequirements>& requirements);
+
+    // without aliasing every resource would have its own memory
+    static VkDeviceSize GetUnaliasedSize (const std::vector<VkMemoryRequirements>& requirements);
+
+    VkDeviceSize GetAllocatedSize () const;
+};
+
+} // namespace RG
+
+#endif
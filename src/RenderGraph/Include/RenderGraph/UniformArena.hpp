@@ -0,0 +1,89 @@
+#ifndef UNIFORMARENA_HPP
+#define UNIFORMARENA_HPP
+
+#include "RenderGraph/RenderGraphAPI.hpp"
+
+#include "Utils/Noncopyable.hpp"
+
+#pragma warning (push, 0)
+#include "vk_mem_alloc.h"
+#pragma warning(pop)
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace GVK {
+class Buffer;
+class MemoryMapping;
+} // namespace GVK
+
+namespace RG {
+
+class GraphSettings;
+
+
+// One persistently mapped buffer for many small uniform blocks, partitioned per frame in flight.
+// Every block has the same aligned range in each partition. The descriptors point to the block in the first partition,
+// the partition of a frame is selected with a dynamic offset when binding the descriptor set,
+// so the descriptor sets do not depend on the frame and updating the uniforms of a frame writes one mapped range.
+class GVK_RENDERER_API UniformArena : public Noncopyable {
+public:
+    // the minimum of maxDescriptorSetUniformBuffersDynamic guaranteed by the specification
+    static constexpr uint32_t MaxDynamicBlocksPerOperation = 8;
+
+private:
+    struct Block {
+        uint32_t     size;
+        VkDeviceSize offset; // in a partition, set by Compile
+    };
+
+    std::vector<Block> blocks;
+
+    VkDevice                            device;
+    uint32_t                            framesInFlight;
+    size_t                              compiledBlockCount;
+    VkDeviceSize                        partitionSize;
+    std::unique_ptr<GVK::Buffer>        buffer;
+    std::unique_ptr<GVK::MemoryMapping> mapping;
+
+public:
+    UniformArena ();
+
+    virtual ~UniformArena () override;
+
+    // the blocks bound by one operation are limited to MaxDynamicBlocksPerOperation, see UniformReflection
+    uint32_t Allocate (uint32_t size);
+
+    // the block keeps its index, but takes no space when compiled
+    void Free (uint32_t blockIndex);
+
+    // creates the buffer on the first call, later only if the blocks or the frames in flight changed
+    // a recreated buffer invalidates the descriptors of every graph using the arena, so an arena should belong to one graph
+    void Compile (const GraphSettings& graphSettings);
+
+    bool IsCompiled () const { return buffer != nullptr; }
+
+    // recreates the buffer on its moved memory and maps it again, see RenderGraph::DefragmentMemory
+    // the descriptors of every block have to be written again
+    void BindMovedAllocation (const GraphSettings& graphSettings);
+
+    VkBuffer      GetBuffer () const;
+    VmaAllocation GetAllocation () const;
+    VkDeviceSize  GetBufferSize () const { return partitionSize * framesInFlight; }
+    VkDeviceSize  GetPartitionSize () const { return partitionSize; }
+    uint32_t      GetBlockCount () const { return static_cast<uint32_t> (blocks.size ()); }
+    uint32_t      GetBlockSize (uint32_t blockIndex) const { return blocks[blockIndex].size; }
+
+    // from the start of the buffer, aligned to minUniformBufferOffsetAlignment
+    uint32_t GetDynamicOffset (uint32_t blockIndex, uint32_t frameIndex) const;
+
+    // writes the block of the frame in the mapped memory, the frame must not be in use by the device
+    void Copy (uint32_t blockIndex, uint32_t frameIndex, const void* data, size_t size) const;
+};
+
+} // namespace RG
+
+#endif
@@ -5,6 +5,7 @@
 #include "RenderGraph/BufferView.hpp"
 #include "RenderGraph/Operation.hpp"
 #include "RenderGraph/Resource.hpp"
+#include "RenderGraph/UniformArena.hpp"
 
 #include "VulkanWrapper/ShaderModule.hpp"
 #include "VulkanWrapper/ShaderReflection.hpp"
@@ -89,6 +90,9 @@ public:
         return std::make_unique<RG::CPUBufferResource> (bufferObject->GetFullSize ());
     }
 
+    // uniform blocks are placed in arena and bound with dynamic offsets, storage buffers get their own buffers
+    static ResourceCreator UniformArenaResourceCreator (const std::shared_ptr<UniformArena>& arena);
+
     static std::shared_ptr<RG::DescriptorBindableBufferResource> GPUBufferResourceCreator (const std::shared_ptr<RG::Operation>&, const GVK::ShaderModule&, const std::shared_ptr<SR::BufferObject>& bufferObject, bool&)
     {
         return std::make_unique<RG::GPUBufferResource> (bufferObject->GetFullSize ());
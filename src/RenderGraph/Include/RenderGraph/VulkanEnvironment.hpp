@@ -38,6 +38,9 @@ public:
     Presentable (VulkanEnvironment& env, Window& window, std::unique_ptr<GVK::SwapchainSettingsProvider>&& settingsProvider);
     Presentable (VulkanEnvironment& env, std::unique_ptr<Window>&& window, std::unique_ptr<GVK::SwapchainSettingsProvider>&& settingsProvider);
 
+    // offscreen presentable without a window or surface, e.g. for a FakeSwapchain
+    Presentable (std::unique_ptr<GVK::Swapchain>&& swapchain);
+
     virtual GVK::Swapchain& GetSwapchain () override;
 
     const GVK::Surface& GetSurface () const;
@@ -62,7 +65,9 @@ public:
     std::unique_ptr<GVK::Device>              device;
     std::unique_ptr<GVK::Queue>               graphicsQueue;
     std::unique_ptr<GVK::Queue>               presentQueue;
+    std::unique_ptr<GVK::Queue>               computeQueue;
     std::unique_ptr<GVK::CommandPool>         commandPool;
+    std::unique_ptr<GVK::CommandPool>         computeCommandPool;
     std::unique_ptr<GVK::DeviceExtra>         deviceExtra;
     std::unique_ptr<GVK::Allocator>           allocator;
 
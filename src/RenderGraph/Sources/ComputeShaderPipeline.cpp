@@ -48,6 +48,14 @@ ComputeShaderPipeline::ComputeShaderPipeline (VkDevice device, const std::string
 }
 
 
+void ComputeShaderPipeline::SetSpecializationConstants (const GVK::SpecializationConstants& values)
+{
+    if (GVK_VERIFY (computeShader != nullptr)) {
+        computeShader->SetSpecializationConstants (values);
+    }
+}
+
+
 void ComputeShaderPipeline::Compile (CompileSettings&& settings_)
 {
     compileSettings = std::move (settings_);
@@ -58,7 +66,8 @@ void ComputeShaderPipeline::Compile (CompileSettings&& settings_)
     compileResult.pipeline = std::unique_ptr<GVK::ComputePipeline> (new GVK::ComputePipeline (
         device,
         *compileResult.pipelineLayout,
-        *computeShader));
+        *computeShader,
+        compileSettings.pipelineCache));
 }
 
 
@@ -69,9 +78,9 @@ void ComputeShaderPipeline::IterateShaders (const std::function<void(const GVK::
 }
 
 
-std::unique_ptr<GVK::DescriptorSetLayout> ComputeShaderPipeline::CreateDescriptorSetLayout (VkDevice device) const
+std::unique_ptr<GVK::DescriptorSetLayout> ComputeShaderPipeline::CreateDescriptorSetLayout (VkDevice device, FromShaderReflection::IDescriptorWriteInfoProvider& infoProvider) const
 {
-    return std::make_unique<GVK::DescriptorSetLayout> (device, RG::FromShaderReflection::GetLayout (computeShader->GetReflection (), computeShader->GetShaderKind ()));
+    return std::make_unique<GVK::DescriptorSetLayout> (device, RG::FromShaderReflection::GetLayout (computeShader->GetReflection (), computeShader->GetShaderKind (), infoProvider));
 }
 
 } // namespace RG
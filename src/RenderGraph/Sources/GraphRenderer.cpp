@@ -7,6 +7,8 @@
 #include "Resource.hpp"
 #include "DrawRecordable.hpp"
 
+#include "VulkanWrapper/CommandBuffer.hpp"
+#include "VulkanWrapper/Commands.hpp"
 #include "VulkanWrapper/DescriptorSet.hpp"
 #include "VulkanWrapper/DescriptorSetLayout.hpp"
 #include "VulkanWrapper/DeviceExtra.hpp"
@@ -19,6 +21,7 @@
 #include "VulkanWrapper/Semaphore.hpp"
 #include "VulkanWrapper/ShaderModule.hpp"
 #include "VulkanWrapper/Swapchain.hpp"
+#include "VulkanWrapper/Utils/SingleTimeCommand.hpp"
 
 
 namespace RG {
@@ -80,13 +83,17 @@ uint32_t BlockingGraphRenderer::RenderNextRecreatableFrame (RenderGraph& graph,
 }
 
 
-SynchronizedSwapchainGraphRenderer::SynchronizedSwapchainGraphRenderer (const GVK::DeviceExtra& device, GVK::Swapchain& swapchain)
+SynchronizedSwapchainGraphRenderer::SynchronizedSwapchainGraphRenderer (const GVK::DeviceExtra& device, GVK::Swapchain& swapchain, bool retainLastFrame)
     : RecreatableGraphRenderer { swapchain }
+    , device { device }
     , framesInFlight { swapchain.GetImageCount () }
     , imageCount { swapchain.GetImageCount () }
     , currentResourceIndex { 0 }
     , swapchain { swapchain }
     , presentationEngineFence { std::make_unique<GVK::Fence> (device, false) }
+    , retainLastFrame { retainLastFrame }
+    , hasRetainedFrame { false }
+    , frameStats { 0, 0, 0 }
 {
     presentationEngineFence->SetName (device, "presentationEngineFence");
     
@@ -97,28 +104,108 @@ SynchronizedSwapchainGraphRenderer::SynchronizedSwapchainGraphRenderer (const GV
         renderFinishedSemaphore.push_back (std::make_unique<GVK::Semaphore> (device));
         inFlightFences.push_back (std::make_unique<GVK::Fence> (device));
         inFlightFences.back ()->SetName (device, std::string ("inFlightFence ") + std::to_string (i));
+        if (retainLastFrame) {
+            retainFences.push_back (std::make_unique<GVK::Fence> (device));
+            retainFences.back ()->SetName (device, std::string ("retainFence ") + std::to_string (i));
+        }
     }
 
     for (uint32_t i = 0; i < imageCount; ++i) {
         imageToFrameMapping.push_back (UINT32_MAX);
     }
+
+    if (retainLastFrame) {
+        CreateRetainedImage ();
+    }
+}
+
+
+void SynchronizedSwapchainGraphRenderer::CreateRetainedImage ()
+{
+    retainCommandBuffers.clear ();
+    repeatCommandBuffers.clear ();
+
+    retainedImage = std::make_unique<GVK::Image2D> (device.GetAllocator (), GVK::Image::MemoryLocation::GPU,
+                                                    swapchain.GetWidth (), swapchain.GetHeight (),
+                                                    swapchain.GetImageFormat (), VK_IMAGE_TILING_OPTIMAL,
+                                                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+
+    {
+        GVK::SingleTimeCommand s (device);
+        s.Record<GVK::CommandTranstionImage> (*retainedImage, GVK::Image::INITIAL_LAYOUT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    }
+
+    VkImageCopy region                   = {};
+    region.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.srcSubresource.mipLevel       = 0;
+    region.srcSubresource.baseArrayLayer = 0;
+    region.srcSubresource.layerCount     = 1;
+    region.srcOffset                     = { 0, 0, 0 };
+    region.dstSubresource                = region.srcSubresource;
+    region.dstOffset                     = { 0, 0, 0 };
+    region.extent                        = { swapchain.GetWidth (), swapchain.GetHeight (), 1 };
+
+    // the swapchain images stay in present layout between frames, the retained image in transfer source layout
+    // the copies of an image are submitted again only after the fences of the frame that last used it are waited for
+    const std::vector<std::unique_ptr<GVK::InheritedImage>> swapchainImages = swapchain.GetImageObjects ();
+
+    for (const std::unique_ptr<GVK::InheritedImage>& swapchainImage : swapchainImages) {
+        std::unique_ptr<GVK::CommandBuffer> retain = std::make_unique<GVK::CommandBuffer> (device);
+        retain->Begin ();
+        retain->Record<GVK::CommandTranstionImage> (*swapchainImage, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        retain->Record<GVK::CommandTranstionImage> (*retainedImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        retain->Record<GVK::CommandCopyImage> (*swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *retainedImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, std::vector<VkImageCopy> { region });
+        retain->Record<GVK::CommandTranstionImage> (*retainedImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        retain->Record<GVK::CommandTranstionImage> (*swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        retain->End ();
+
+        std::unique_ptr<GVK::CommandBuffer> repeat = std::make_unique<GVK::CommandBuffer> (device);
+        repeat->Begin ();
+        repeat->Record<GVK::CommandTranstionImage> (*swapchainImage, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        repeat->Record<GVK::CommandCopyImage> (*retainedImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, std::vector<VkImageCopy> { region });
+        repeat->Record<GVK::CommandTranstionImage> (*swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        repeat->End ();
+
+        retainCommandBuffers.push_back (std::move (retain));
+        repeatCommandBuffers.push_back (std::move (repeat));
+    }
 }
 
 
 void RecreatableGraphRenderer::Recreate (RenderGraph& graph)
 {
-    GraphSettings settings = std::move (graph.graphSettings);
+    const GVK::DeviceExtra& device = graph.graphSettings.GetDevice ();
+
+    vkDeviceWaitIdle (device);
+    vkQueueWaitIdle (device.GetGraphicsQueue ());
 
-    vkDeviceWaitIdle (settings.GetDevice ());
-    vkQueueWaitIdle (settings.GetDevice ().GetGraphicsQueue ());
+    const VkFormat previousFormat = swapchain.GetImageFormat ();
 
     swapchain.Recreate ();
 
-    settings.framesInFlight = swapchain.GetImageCount ();
+    // only the extent changed, the passes and the pipelines can be kept
+    if (graph.compiled && swapchain.GetImageCount () == graph.graphSettings.framesInFlight && swapchain.GetImageFormat () == previousFormat) {
+        graph.RecompileSwapchainImages ();
+        OnSwapchainRecreated ();
+        return;
+    }
 
-    //graph.CompileResources (settings);
+    GraphSettings settings = std::move (graph.graphSettings);
+
+    settings.framesInFlight = swapchain.GetImageCount ();
 
     graph.Compile (std::move (settings));
+
+    OnSwapchainRecreated ();
+}
+
+
+void SynchronizedSwapchainGraphRenderer::OnSwapchainRecreated ()
+{
+    if (retainLastFrame) {
+        CreateRetainedImage ();
+        hasRetainedFrame = false;
+    }
 }
 
 
@@ -133,7 +220,7 @@ uint32_t RecreatableGraphRenderer::RenderNextFrame (RenderGraph& graph, IFrameDi
 }
 
 
-uint32_t SynchronizedSwapchainGraphRenderer::RenderNextRecreatableFrame (RenderGraph& graph, IFrameDisplayObserver& frameDisplayObserver)
+uint32_t SynchronizedSwapchainGraphRenderer::AcquireNextImage (IFrameDisplayObserver& frameDisplayObserver, FrameTiming& timing)
 {
     frameDisplayObserver.OnImageFenceWaitStarted (currentResourceIndex);
     //inFlightFences[currentResourceIndex]->Wait ();
@@ -141,11 +228,13 @@ uint32_t SynchronizedSwapchainGraphRenderer::RenderNextRecreatableFrame (RenderG
     frameDisplayObserver.OnImageFenceWaitEnded (currentResourceIndex);
 
     frameDisplayObserver.OnImageAcquisitionStarted ();
+    timing.acquireStarted = FrameTiming::Clock::now ();
     const uint32_t currentImageIndex = swapchain.GetNextImageIndex (*imageAvailableSemaphore[currentResourceIndex], *presentationEngineFence);
     //std::cout << "got img for      " << currentResourceIndex<< " at " << std::fixed << GVK::TimePoint::SinceEpoch ().AsMilliseconds () << std::endl;
     frameDisplayObserver.OnImageAcquisitionReturned (currentResourceIndex);
 
     presentationEngineFence->Wait ();
+    timing.imageAvailable = FrameTiming::Clock::now ();
     frameDisplayObserver.OnImageAcquisitionFenceSignaled (currentResourceIndex);
     presentationEngineFence->Reset ();
 
@@ -153,6 +242,9 @@ uint32_t SynchronizedSwapchainGraphRenderer::RenderNextRecreatableFrame (RenderG
     const uint32_t previousFrameIndex = imageToFrameMapping[currentImageIndex];
     if (previousFrameIndex != UINT32_MAX) {
         inFlightFences[previousFrameIndex]->Wait ();
+        if (retainLastFrame) {
+            retainFences[previousFrameIndex]->Wait ();
+        }
     }
 
     frameDisplayObserver.OnImageAcquisitionEnded (currentResourceIndex);
@@ -160,12 +252,25 @@ uint32_t SynchronizedSwapchainGraphRenderer::RenderNextRecreatableFrame (RenderG
     // update mapping
     imageToFrameMapping[currentImageIndex] = currentResourceIndex;
 
+    inFlightFences[currentResourceIndex]->Reset ();
+
+    timing.resourceIndex = currentResourceIndex;
+    timing.imageIndex    = currentImageIndex;
+
+    return currentImageIndex;
+}
+
+
+uint32_t SynchronizedSwapchainGraphRenderer::RenderNextRecreatableFrame (RenderGraph& graph, IFrameDisplayObserver& frameDisplayObserver)
+{
+    FrameTiming timing;
+
+    const uint32_t currentImageIndex = AcquireNextImage (frameDisplayObserver, timing);
+
     const std::vector<VkSemaphore> submitWaitSemaphores   = { *imageAvailableSemaphore[currentResourceIndex] };
     const std::vector<VkSemaphore> submitSignalSemaphores = { *renderFinishedSemaphore[currentResourceIndex] };
     const std::vector<VkSemaphore> presentWaitSemaphores  = submitSignalSemaphores;
 
-    inFlightFences[currentResourceIndex]->Reset ();
-
     {
         const GVK::TimePoint currentTime = GVK::TimePoint::SinceApplicationStart ();
         preSubmitEvent.Notify (graph, currentResourceIndex, currentTime - lastDrawTime);
@@ -173,14 +278,69 @@ uint32_t SynchronizedSwapchainGraphRenderer::RenderNextRecreatableFrame (RenderG
     }
 
     frameDisplayObserver.OnRenderStarted (currentResourceIndex);
-    graph.Submit (currentResourceIndex, submitWaitSemaphores, submitSignalSemaphores, *inFlightFences[currentResourceIndex]);
+
+    if (retainLastFrame) {
+        // the copy is submitted after the graph on the same queue, presenting waits for the copy
+        // the frame fence is kept for the graph, the profiler reads its queries after it
+        retainFences[currentResourceIndex]->Wait ();
+        retainFences[currentResourceIndex]->Reset ();
+        graph.Submit (currentResourceIndex, submitWaitSemaphores, {}, *inFlightFences[currentResourceIndex]);
+        device.GetGraphicsQueue ().Submit ({}, {}, { retainCommandBuffers[currentImageIndex].get () }, submitSignalSemaphores, *retainFences[currentResourceIndex]);
+        hasRetainedFrame = true;
+        ++frameStats.retainedFrames;
+    } else {
+        graph.Submit (currentResourceIndex, submitWaitSemaphores, submitSignalSemaphores, *inFlightFences[currentResourceIndex]);
+    }
+
+    ++frameStats.submittedGraphs;
     //graph.Submit (currentResourceIndex, submitWaitSemaphores, submitSignalSemaphores);
 
+    timing.submitted = FrameTiming::Clock::now ();
+
     GVK_ASSERT (swapchain.SupportsPresenting ());
 
     frameDisplayObserver.OnPresentStarted (currentResourceIndex);
     graph.Present (currentImageIndex, swapchain, presentWaitSemaphores);
 
+    timing.presented = FrameTiming::Clock::now ();
+    frameDisplayObserver.OnFramePresented (timing);
+
+    const uint32_t usedResourceIndex = currentResourceIndex;
+
+    currentResourceIndex = (currentResourceIndex + 1) % framesInFlight;
+
+    return usedResourceIndex;
+}
+
+
+uint32_t SynchronizedSwapchainGraphRenderer::RepeatLastFrame (IFrameDisplayObserver& frameDisplayObserver)
+{
+    if (GVK_ERROR (!retainLastFrame || !hasRetainedFrame)) {
+        throw std::runtime_error ("no retained frame to repeat");
+    }
+
+    FrameTiming timing;
+
+    const uint32_t currentImageIndex = AcquireNextImage (frameDisplayObserver, timing);
+
+    frameDisplayObserver.OnRenderStarted (currentResourceIndex);
+
+    const std::vector<VkSemaphore> presentWaitSemaphores = { *renderFinishedSemaphore[currentResourceIndex] };
+
+    device.GetGraphicsQueue ().Submit ({ *imageAvailableSemaphore[currentResourceIndex] }, { VK_PIPELINE_STAGE_TRANSFER_BIT }, { repeatCommandBuffers[currentImageIndex].get () }, presentWaitSemaphores, *inFlightFences[currentResourceIndex]);
+
+    ++frameStats.repeatedFrames;
+
+    timing.submitted = FrameTiming::Clock::now ();
+
+    GVK_ASSERT (swapchain.SupportsPresenting ());
+
+    frameDisplayObserver.OnPresentStarted (currentResourceIndex);
+    swapchain.Present (device.GetGraphicsQueue (), currentImageIndex, presentWaitSemaphores);
+
+    timing.presented = FrameTiming::Clock::now ();
+    frameDisplayObserver.OnFramePresented (timing);
+
     const uint32_t usedResourceIndex = currentResourceIndex;
 
     currentResourceIndex = (currentResourceIndex + 1) % framesInFlight;
@@ -199,6 +359,9 @@ void SynchronizedSwapchainGraphRenderer::Wait ()
     for (auto& fence : inFlightFences) {
         fence->Wait ();
     }
+    for (auto& fence : retainFences) {
+        fence->Wait ();
+    }
 }
 
 } // namespace RG
@@ -1,11 +1,10 @@
 #include "GraphSettings.hpp"
+#include "Operation.hpp"
 #include "Resource.hpp"
 
 #include "VulkanWrapper/Image.hpp"
 #include "VulkanWrapper/ImageView.hpp"
 
-#include <unordered_set>
-
 namespace RG {
 
 
@@ -15,6 +14,12 @@ ConnectionSet::~ConnectionSet () = default;
 GraphSettings::GraphSettings (const GVK::DeviceExtra& device, ConnectionSet&& connectionSet, uint32_t framesInFlight)
     : device (&device)
     , framesInFlight (framesInFlight)
+    , useAsyncCompute (true)
+    , profileOperations (false)
+    , aliasTransientImages (true)
+    , mergeRenderOperations (true)
+    , useDynamicRendering (true)
+    , descriptorAllocator (nullptr)
     , connectionSet (std::move (connectionSet))
 {
 }
@@ -24,6 +29,12 @@ GraphSettings::GraphSettings (const GVK::DeviceExtra& device, ConnectionSet&& co
 GraphSettings::GraphSettings (const GVK::DeviceExtra& device, uint32_t framesInFlight)
     : device (&device)
     , framesInFlight (framesInFlight)
+    , useAsyncCompute (true)
+    , profileOperations (false)
+    , aliasTransientImages (true)
+    , mergeRenderOperations (true)
+    , useDynamicRendering (true)
+    , descriptorAllocator (nullptr)
 {
 }
 
@@ -31,6 +42,12 @@ GraphSettings::GraphSettings (const GVK::DeviceExtra& device, uint32_t framesInF
 GraphSettings::GraphSettings ()
     : device (nullptr)
     , framesInFlight (0)
+    , useAsyncCompute (true)
+    , profileOperations (false)
+    , aliasTransientImages (true)
+    , mergeRenderOperations (true)
+    , useDynamicRendering (true)
+    , descriptorAllocator (nullptr)
 {
 }
 
@@ -57,21 +74,35 @@ GraphSettings::GraphSettings (GraphSettings&& other)
     : connectionSet (std::move (other.connectionSet))
     , device (other.device)
     , framesInFlight (other.framesInFlight)
+    , useAsyncCompute (other.useAsyncCompute)
+    , profileOperations (other.profileOperations)
+    , aliasTransientImages (other.aliasTransientImages)
+    , mergeRenderOperations (other.mergeRenderOperations)
+    , useDynamicRendering (other.useDynamicRendering)
+    , descriptorAllocator (other.descriptorAllocator)
 {
-    other.device         = nullptr;
-    other.framesInFlight = 0;
+    other.device              = nullptr;
+    other.framesInFlight      = 0;
+    other.descriptorAllocator = nullptr;
 }
 
 
 GraphSettings& GraphSettings::operator= (GraphSettings&& other)
 {
     if (this != &other) {
-        connectionSet  = std::move (other.connectionSet);
-        device         = other.device;
-        framesInFlight = other.framesInFlight;
-
-        other.device         = nullptr;
-        other.framesInFlight = 0;
+        connectionSet         = std::move (other.connectionSet);
+        device                = other.device;
+        framesInFlight        = other.framesInFlight;
+        useAsyncCompute       = other.useAsyncCompute;
+        profileOperations     = other.profileOperations;
+        aliasTransientImages  = other.aliasTransientImages;
+        mergeRenderOperations = other.mergeRenderOperations;
+        useDynamicRendering   = other.useDynamicRendering;
+        descriptorAllocator   = other.descriptorAllocator;
+
+        other.device              = nullptr;
+        other.framesInFlight      = 0;
+        other.descriptorAllocator = nullptr;
     }
 
     return *this;
@@ -82,52 +113,127 @@ ConnectionSet::ConnectionSet () = default;
 
 
 ConnectionSet::ConnectionSet (ConnectionSet&& other)
-    : connections (std::move (other.connections))
-    , nodeSet (std::move (other.nodeSet))
-    , insertionOrder (std::move (other.insertionOrder))
+    : insertionOrder (std::move (other.insertionOrder))
+    , nodeIndices (std::move (other.nodeIndices))
+    , isOperation (std::move (other.isOperation))
+    , pointingTo (std::move (other.pointingTo))
+    , pointingHere (std::move (other.pointingHere))
+    , nameIndices (std::move (other.nameIndices))
+    , pinnedNodes (std::move (other.pinnedNodes))
 {
-    other.connections.clear ();
-    other.nodeSet.clear ();
     other.insertionOrder.clear ();
+    other.nodeIndices.clear ();
+    other.isOperation.clear ();
+    other.pointingTo.clear ();
+    other.pointingHere.clear ();
+    other.nameIndices.clear ();
+    other.pinnedNodes.clear ();
 }
 
 
 ConnectionSet& ConnectionSet::operator= (ConnectionSet&& other)
 {
     if (this != &other) {
-        connections    = std::move (other.connections);
-        nodeSet        = std::move (other.nodeSet);
         insertionOrder = std::move (other.insertionOrder);
+        nodeIndices    = std::move (other.nodeIndices);
+        isOperation    = std::move (other.isOperation);
+        pointingTo     = std::move (other.pointingTo);
+        pointingHere   = std::move (other.pointingHere);
+        nameIndices    = std::move (other.nameIndices);
+        pinnedNodes    = std::move (other.pinnedNodes);
 
-        other.connections.clear ();
-        other.nodeSet.clear ();
         other.insertionOrder.clear ();
+        other.nodeIndices.clear ();
+        other.isOperation.clear ();
+        other.pointingTo.clear ();
+        other.pointingHere.clear ();
+        other.nameIndices.clear ();
+        other.pinnedNodes.clear ();
     }
 
     return *this;
 }
 
 
-std::shared_ptr<Node> ConnectionSet::GetNodeByName (std::string_view name) const
+void ConnectionSet::Add (const NodeConnection& connection)
 {
-    if constexpr (IsDebugBuild) {
-        std::unordered_set<std::string> nameSet;
-        for (const auto& node : insertionOrder) {
-            if (node->GetName ().empty ())
-                continue;
+    const uint32_t fromIndex = AddNode (connection.from);
+    const uint32_t toIndex   = AddNode (connection.to);
 
-            GVK_ASSERT (nameSet.count (node->GetName ()) == 0);
-            nameSet.insert (node->GetName ());
+    std::vector<uint32_t>& to   = isOperation[toIndex] ? pointingTo[fromIndex].operations : pointingTo[fromIndex].resources;
+    std::vector<uint32_t>& from = isOperation[fromIndex] ? pointingHere[toIndex].operations : pointingHere[toIndex].resources;
+
+    to.push_back (toIndex);
+    from.push_back (fromIndex);
+}
+
+
+void ConnectionSet::Add (const std::shared_ptr<Node>& node)
+{
+    AddNode (node);
+}
+
+
+uint32_t ConnectionSet::AddNode (const std::shared_ptr<Node>& node)
+{
+    const uint32_t nodeIndex = static_cast<uint32_t> (insertionOrder.size ());
+
+    const auto inserted = nodeIndices.emplace (node.get (), nodeIndex);
+    if (!inserted.second) {
+        return inserted.first->second;
+    }
+
+    insertionOrder.push_back (node);
+    isOperation.push_back (dynamic_cast<const Operation*> (node.get ()) != nullptr);
+    pointingTo.emplace_back ();
+    pointingHere.emplace_back ();
+
+    if (!node->GetName ().empty ()) {
+        nameIndices.emplace (node->GetName (), nodeIndex);
+    }
+
+    return nodeIndex;
+}
+
+
+uint32_t ConnectionSet::GetNodeIndex (const Node* node) const
+{
+    auto it = nodeIndices.find (node);
+    return it != nodeIndices.end () ? it->second : InvalidIndex;
+}
+
+
+void ConnectionSet::RebuildNameIndices () const
+{
+    nameIndices.clear ();
+
+    // names should be unique, the first node wins if they are not
+    for (uint32_t nodeIndex = 0; nodeIndex < insertionOrder.size (); ++nodeIndex) {
+        const std::string& name = insertionOrder[nodeIndex]->GetName ();
+        if (!name.empty ()) {
+            GVK_VERIFY (nameIndices.emplace (name, nodeIndex).second);
         }
     }
+}
+
 
-    for (const auto& node : insertionOrder) {
-        if (node->GetName () == name) {
-            return node;
+std::shared_ptr<Node> ConnectionSet::GetNodeByName (std::string_view name) const
+{
+    const auto Find = [&] () -> std::shared_ptr<Node> {
+        auto it = nameIndices.find (std::string (name));
+        if (it != nameIndices.end () && insertionOrder[it->second]->GetName () == name) {
+            return insertionOrder[it->second];
         }
+        return nullptr;
+    };
+
+    if (std::shared_ptr<Node> node = Find ()) {
+        return node;
     }
 
-    return nullptr;
+    RebuildNameIndices ();
+
+    return Find ();
 }
 
 } // namespace RG
@@ -0,0 +1,205 @@
+#include "ImageLoader.hpp"
+#include "GraphSettings.hpp"
+#include "Resource.hpp"
+
+#include "VulkanWrapper/Buffer.hpp"
+#include "VulkanWrapper/Commands.hpp"
+#include "VulkanWrapper/DeviceExtra.hpp"
+#include "VulkanWrapper/Utils/BufferTransferable.hpp"
+#include "VulkanWrapper/Utils/ImageData.hpp"
+#include "VulkanWrapper/Utils/MemoryMapping.hpp"
+#include "VulkanWrapper/Utils/SingleTimeCommand.hpp"
+
+#include "Utils/Assert.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "Utils/Trace.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace RG {
+
+// stb decodes 8 bit sRGB encoded pixels
+static constexpr VkFormat ImageFormat = VK_FORMAT_R8G8B8A8_SRGB;
+static constexpr uint32_t ImageComponents = 4;
+
+
+static uint32_t GetMipLevelCount (uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    while ((width >> levels) > 0 || (height >> levels) > 0) {
+        ++levels;
+    }
+    return levels;
+}
+
+
+ImageLoader::ImageLoader (const GVK::DeviceExtra& device, bool generateMipLevels)
+    : device { device }
+    , generateMipLevels { generateMipLevels }
+    , statistics { 0, 0, 0, 0 }
+{
+}
+
+
+std::optional<ImageLoader::Key> ImageLoader::GetKey (const std::filesystem::path& path)
+{
+    std::error_code ec;
+
+    const std::filesystem::path canonicalPath = std::filesystem::canonical (path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+
+    const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time (canonicalPath, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+
+    return Key { canonicalPath, lastWriteTime };
+}
+
+
+void ImageLoader::Load (const std::vector<std::filesystem::path>& paths)
+{
+    Utils::TraceScope traceScope ("ImageLoader::Load", "Resource");
+
+    std::vector<Key> missingKeys;
+
+    for (const std::filesystem::path& path : paths) {
+        const std::optional<Key> key = GetKey (path);
+        if (GVK_ERROR (!key.has_value ())) {
+            spdlog::error ("Image file \"{}\" does not exist.", path.string ());
+            continue;
+        }
+
+        if (images.find (*key) == images.end () && std::find (missingKeys.begin (), missingKeys.end (), *key) == missingKeys.end ()) {
+            missingKeys.push_back (*key);
+        }
+    }
+
+    if (missingKeys.empty ()) {
+        return;
+    }
+
+    // decoding
+
+    std::vector<std::unique_ptr<GVK::ImageData>> decoded (missingKeys.size ());
+
+    Utils::ParallelFor (0, static_cast<uint32_t> (missingKeys.size ()), 1, [&] (uint32_t i) {
+        decoded[i] = std::make_unique<GVK::ImageData> (missingKeys[i].first, ImageComponents);
+    });
+
+    // creating resources and packing the pixels into one staging buffer
+
+    std::vector<std::shared_ptr<ReadOnlyImageResource>> created (missingKeys.size ());
+    std::vector<size_t>                                 offsets (missingKeys.size (), 0);
+
+    size_t stagingSize = 0;
+
+    for (size_t i = 0; i < missingKeys.size (); ++i) {
+        const GVK::ImageData& imageData = *decoded[i];
+        if (GVK_ERROR (imageData.width == 0 || imageData.height == 0)) {
+            spdlog::error ("Failed to decode image file \"{}\".", missingKeys[i].first.string ());
+            continue;
+        }
+
+        const uint32_t width     = static_cast<uint32_t> (imageData.width);
+        const uint32_t height    = static_cast<uint32_t> (imageData.height);
+        const uint32_t mipLevels = (generateMipLevels && std::max (width, height) > 1) ? GetMipLevelCount (width, height) : 1;
+
+        created[i] = std::make_shared<ReadOnlyImageResource> (ImageFormat, VK_FILTER_LINEAR, width, height, 1, 1, mipLevels);
+        created[i]->SetName (missingKeys[i].first.filename ().string ());
+        created[i]->SetDebugInfo ("Loaded by ImageLoader.");
+
+        // this is a one time compile resource, which doesnt use framesinflight attrib
+        created[i]->Compile (GraphSettings (device, 0));
+
+        // buffer offsets for image copies must be a multiple of the texel size
+        stagingSize = (stagingSize + ImageComponents - 1) / ImageComponents * ImageComponents;
+        offsets[i]  = stagingSize;
+        stagingSize += imageData.data.size ();
+    }
+
+    if (stagingSize == 0) {
+        return;
+    }
+
+    // uploading
+
+    GVK::Buffer        stagingBuffer (device.GetAllocator (), stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, GVK::Buffer::MemoryLocation::CPU);
+    GVK::MemoryMapping stagingMapping (device.GetAllocator (), stagingBuffer);
+
+    for (size_t i = 0; i < missingKeys.size (); ++i) {
+        if (created[i] != nullptr) {
+            memcpy (static_cast<uint8_t*> (stagingMapping.Get ()) + offsets[i], decoded[i]->data.data (), decoded[i]->data.size ());
+        }
+    }
+
+    {
+        GVK::SingleTimeCommand commandBuffer (device);
+
+        for (size_t i = 0; i < missingKeys.size (); ++i) {
+            if (created[i] == nullptr) {
+                continue;
+            }
+
+            const GVK::Image& image = *created[i]->image->imageGPU;
+
+            VkBufferImageCopy region               = {};
+            region.bufferOffset                    = offsets[i];
+            region.bufferRowLength                 = 0;
+            region.bufferImageHeight               = 0;
+            region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel       = 0;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount     = 1;
+            region.imageOffset                     = { 0, 0, 0 };
+            region.imageExtent                     = { image.GetWidth (), image.GetHeight (), 1 };
+
+            commandBuffer.Record<GVK::CommandTranstionImage> (image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            commandBuffer.Record<GVK::CommandCopyBufferToImage> (stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, std::vector<VkBufferImageCopy> { region });
+            created[i]->RecordMipLevelGeneration (commandBuffer);
+        }
+    }
+
+    ++statistics.uploadSubmitCount;
+
+    for (size_t i = 0; i < missingKeys.size (); ++i) {
+        if (created[i] != nullptr) {
+            images[missingKeys[i]] = created[i];
+            ++statistics.decodedCount;
+            statistics.uploadedBytes += decoded[i]->data.size ();
+        }
+    }
+
+    spdlog::info ("ImageLoader: {} image(s) uploaded, {} bytes.", missingKeys.size (), stagingSize);
+}
+
+
+std::shared_ptr<ReadOnlyImageResource> ImageLoader::Get (const std::filesystem::path& path)
+{
+    ++statistics.requestCount;
+
+    const std::optional<Key> key = GetKey (path);
+    if (!key.has_value ()) {
+        return nullptr;
+    }
+
+    auto it = images.find (*key);
+    if (it == images.end ()) {
+        Load ({ path });
+        it = images.find (*key);
+    }
+
+    if (it == images.end ()) {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+} // namespace RG
@@ -0,0 +1,388 @@
+#include "MergedRenderPass.hpp"
+
+#include "GraphSettings.hpp"
+#include "Operation.hpp"
+#include "OperationProfiler.hpp"
+#include "Resource.hpp"
+#include "ShaderPipeline.hpp"
+#include "ShaderReflectionToAttachment.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include "VulkanWrapper/CommandBuffer.hpp"
+#include "VulkanWrapper/Commands.hpp"
+#include "VulkanWrapper/Framebuffer.hpp"
+#include "VulkanWrapper/Image.hpp"
+#include "VulkanWrapper/ObjectCache.hpp"
+#include "VulkanWrapper/RenderPass.hpp"
+#include "VulkanWrapper/ShaderModule.hpp"
+
+#include <algorithm>
+
+
+namespace RG {
+
+std::optional<MergedRenderPass::OperationAttachments> MergedRenderPass::GetOperationAttachments (RenderOperation& op, const std::unordered_map<VkImageView, ImageLayer>& imageViews)
+{
+    const GVK::ShaderModule::Reflection& reflection = op.GetShaderPipeline ()->fragmentShader->GetReflection ();
+
+    FromShaderReflection::IAttachmentProvider& attachmentProvider = *op.compileSettings.attachmentProvider;
+
+    const std::vector<VkImageView>             views        = FromShaderReflection::GetImageViews (reflection, GVK::ShaderKind::Fragment, 0, attachmentProvider);
+    const std::vector<VkAttachmentDescription> descriptions = FromShaderReflection::GetAttachmentDescriptions (reflection, GVK::ShaderKind::Fragment, attachmentProvider);
+    const size_t                               colorCount   = FromShaderReflection::GetAttachmentReferences (reflection, GVK::ShaderKind::Fragment, attachmentProvider).size ();
+
+    if (GVK_ERROR (views.size () != descriptions.size () || colorCount > views.size ())) {
+        return std::nullopt;
+    }
+
+    OperationAttachments result;
+
+    for (size_t index = 0; index < views.size (); ++index) {
+        auto it = imageViews.find (views[index]);
+        if (it == imageViews.end ()) {
+            return std::nullopt;
+        }
+
+        if (index < colorCount) {
+            result.colorAttachments.push_back (it->second);
+            result.colorDescriptions.push_back (descriptions[index]);
+        } else {
+            result.inputAttachments.push_back (it->second);
+            result.inputDescriptions.push_back (descriptions[index]);
+        }
+    }
+
+    return result;
+}
+
+
+MergedRenderPass::MergedRenderPass (const std::vector<RenderOperation*>&       operations,
+                                    std::vector<OperationAttachments>&&        operationAttachments_,
+                                    const std::unordered_set<const Resource*>& internalResources)
+    : operations (operations)
+    , operationAttachments (std::move (operationAttachments_))
+    , internalResources (internalResources)
+    , width (0)
+    , height (0)
+{
+    GVK_ASSERT (!operations.empty ());
+    GVK_ASSERT (operations.size () == operationAttachments.size ());
+
+    const auto EnsureAttachment = [&] (const ImageLayer& image, const VkAttachmentDescription& description) -> uint32_t {
+        const uint32_t existing = GetAttachmentIndex (image);
+        if (existing != UINT32_MAX) {
+            // the last subpass using the attachment decides its final layout
+            attachments[existing].description.finalLayout = description.finalLayout;
+            return existing;
+        }
+
+        const bool internal = IsInternal (image.resource);
+
+        Attachment attachment;
+        attachment.image       = image;
+        attachment.description = description;
+        attachment.internal    = internal;
+
+        // the contents of internal attachments are discarded before the first and after the last subpass
+        if (internal) {
+            attachment.description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            attachment.description.storeOp       = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        }
+
+        attachments.push_back (attachment);
+        return static_cast<uint32_t> (attachments.size () - 1);
+    };
+
+    for (const OperationAttachments& opAttachments : operationAttachments) {
+        std::vector<uint32_t>& colorIndices = colorAttachmentIndices.emplace_back ();
+        std::vector<uint32_t>& inputIndices = inputAttachmentIndices.emplace_back ();
+
+        for (size_t i = 0; i < opAttachments.colorAttachments.size (); ++i) {
+            colorIndices.push_back (EnsureAttachment (opAttachments.colorAttachments[i], opAttachments.colorDescriptions[i]));
+        }
+        for (size_t i = 0; i < opAttachments.inputAttachments.size (); ++i) {
+            inputIndices.push_back (EnsureAttachment (opAttachments.inputAttachments[i], opAttachments.inputDescriptions[i]));
+        }
+    }
+}
+
+
+MergedRenderPass::~MergedRenderPass () = default;
+
+
+uint32_t MergedRenderPass::GetAttachmentIndex (const ImageLayer& image) const
+{
+    for (uint32_t index = 0; index < attachments.size (); ++index) {
+        if (attachments[index].image.resource == image.resource && attachments[index].image.layerIndex == image.layerIndex) {
+            return index;
+        }
+    }
+
+    return UINT32_MAX;
+}
+
+
+bool MergedRenderPass::IsAttachment (const Resource* res) const
+{
+    return std::any_of (attachments.begin (), attachments.end (), [&] (const Attachment& attachment) {
+        return attachment.image.resource == res;
+    });
+}
+
+
+bool MergedRenderPass::IsInternal (const Resource* res) const
+{
+    return internalResources.count (res) != 0;
+}
+
+
+std::vector<WritableImageResource*> MergedRenderPass::GetAttachmentResources () const
+{
+    std::vector<WritableImageResource*> result;
+    for (const Attachment& attachment : attachments) {
+        if (std::find (result.begin (), result.end (), attachment.image.resource) == result.end ()) {
+            result.push_back (attachment.image.resource);
+        }
+    }
+    return result;
+}
+
+
+bool MergedRenderPass::IsColorAttachmentOfSubpass (uint32_t subpassIndex, const Resource* res) const
+{
+    for (const uint32_t index : colorAttachmentIndices[subpassIndex]) {
+        if (attachments[index].image.resource == res) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool MergedRenderPass::IsInputAttachmentOfSubpass (uint32_t subpassIndex, const Resource* res) const
+{
+    for (const uint32_t index : inputAttachmentIndices[subpassIndex]) {
+        if (attachments[index].image.resource == res) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+VkImageLayout MergedRenderPass::GetLayoutAtStart (WritableImageResource& res) const
+{
+    for (uint32_t subpassIndex = 0; subpassIndex < operations.size (); ++subpassIndex) {
+        Operation& op = *operations[subpassIndex];
+        if (IsColorAttachmentOfSubpass (subpassIndex, &res)) {
+            return op.GetImageLayoutAtStartForOutputs (res);
+        }
+        if (IsInputAttachmentOfSubpass (subpassIndex, &res)) {
+            return op.GetImageLayoutAtStartForInputs (res);
+        }
+    }
+
+    GVK_BREAK ();
+    return VK_IMAGE_LAYOUT_UNDEFINED;
+}
+
+
+VkImageLayout MergedRenderPass::GetLayoutAtEnd (WritableImageResource& res) const
+{
+    for (uint32_t subpassIndex = static_cast<uint32_t> (operations.size ()); subpassIndex-- > 0;) {
+        Operation& op = *operations[subpassIndex];
+        if (IsColorAttachmentOfSubpass (subpassIndex, &res)) {
+            return op.GetImageLayoutAtEndForOutputs (res);
+        }
+        if (IsInputAttachmentOfSubpass (subpassIndex, &res)) {
+            return op.GetImageLayoutAtEndForInputs (res);
+        }
+    }
+
+    GVK_BREAK ();
+    return VK_IMAGE_LAYOUT_UNDEFINED;
+}
+
+
+std::vector<VkSubpassDependency> MergedRenderPass::GetSubpassDependencies () const
+{
+    const VkAccessFlags fullMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+                                   VK_ACCESS_INDEX_READ_BIT |
+                                   VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                                   VK_ACCESS_UNIFORM_READ_BIT |
+                                   VK_ACCESS_INPUT_ATTACHMENT_READ_BIT |
+                                   VK_ACCESS_SHADER_READ_BIT |
+                                   VK_ACCESS_SHADER_WRITE_BIT |
+                                   VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                   VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                   VK_ACCESS_TRANSFER_READ_BIT |
+                                   VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    std::vector<VkSubpassDependency> result;
+
+    VkSubpassDependency external = {};
+    external.srcSubpass          = VK_SUBPASS_EXTERNAL;
+    external.dstSubpass          = 0;
+    external.srcStageMask        = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
+    external.dstStageMask        = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
+    external.srcAccessMask       = fullMask;
+    external.dstAccessMask       = fullMask;
+    external.dependencyFlags     = 0;
+    result.push_back (external);
+
+    external.srcSubpass = static_cast<uint32_t> (operations.size () - 1);
+    external.dstSubpass = VK_SUBPASS_EXTERNAL;
+    result.push_back (external);
+
+    // only the same pixel is read, so the dependencies are by region
+    for (uint32_t dstSubpass = 1; dstSubpass < operations.size (); ++dstSubpass) {
+        for (uint32_t srcSubpass = 0; srcSubpass < dstSubpass; ++srcSubpass) {
+            const bool dependsOnSrc = std::any_of (colorAttachmentIndices[srcSubpass].begin (), colorAttachmentIndices[srcSubpass].end (), [&] (uint32_t index) {
+                return IsInputAttachmentOfSubpass (dstSubpass, attachments[index].image.resource) || IsColorAttachmentOfSubpass (dstSubpass, attachments[index].image.resource);
+            });
+
+            if (!dependsOnSrc) {
+                continue;
+            }
+
+            VkSubpassDependency dependency = {};
+            dependency.srcSubpass          = srcSubpass;
+            dependency.dstSubpass          = dstSubpass;
+            dependency.srcStageMask        = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependency.dstStageMask        = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependency.srcAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            dependency.dstAccessMask       = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            dependency.dependencyFlags     = VK_DEPENDENCY_BY_REGION_BIT;
+            result.push_back (dependency);
+        }
+    }
+
+    return result;
+}
+
+
+void MergedRenderPass::Compile (const GraphSettings& graphSettings)
+{
+    const GVK::DeviceExtra& device = graphSettings.GetDevice ();
+
+    GVK_ASSERT (!colorAttachmentIndices[0].empty ());
+
+    const GVK::Image& firstImage = *attachments[colorAttachmentIndices[0][0]].image.resource->GetImages ()[0];
+
+    width  = firstImage.GetWidth ();
+    height = firstImage.GetHeight ();
+
+    std::vector<VkAttachmentDescription> attachmentDescriptions;
+    for (const Attachment& attachment : attachments) {
+        attachmentDescriptions.push_back (attachment.description);
+    }
+
+    // the references have to stay alive until the render pass is created
+    std::vector<std::vector<VkAttachmentReference>> colorReferences (operations.size ());
+    std::vector<std::vector<VkAttachmentReference>> inputReferences (operations.size ());
+    std::vector<std::vector<uint32_t>>              preserveAttachments (operations.size ());
+    std::vector<VkSubpassDescription>               subpasses;
+
+    for (uint32_t subpassIndex = 0; subpassIndex < operations.size (); ++subpassIndex) {
+        for (const uint32_t index : colorAttachmentIndices[subpassIndex]) {
+            colorReferences[subpassIndex].push_back ({ index, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL });
+        }
+        for (const uint32_t index : inputAttachmentIndices[subpassIndex]) {
+            inputReferences[subpassIndex].push_back ({ index, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+        }
+
+        // attachments written before and read after this subpass have to be kept
+        for (uint32_t index = 0; index < attachments.size (); ++index) {
+            const Resource* res = attachments[index].image.resource;
+
+            if (IsColorAttachmentOfSubpass (subpassIndex, res) || IsInputAttachmentOfSubpass (subpassIndex, res)) {
+                continue;
+            }
+
+            bool usedBefore = false;
+            bool usedAfter  = false;
+            for (uint32_t other = 0; other < operations.size (); ++other) {
+                const bool used = IsColorAttachmentOfSubpass (other, res) || IsInputAttachmentOfSubpass (other, res);
+                usedBefore      = usedBefore || (used && other < subpassIndex);
+                usedAfter       = usedAfter || (used && other > subpassIndex);
+            }
+
+            if (usedBefore && usedAfter) {
+                preserveAttachments[subpassIndex].push_back (index);
+            }
+        }
+
+        VkSubpassDescription subpass    = {};
+        subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount    = static_cast<uint32_t> (colorReferences[subpassIndex].size ());
+        subpass.pColorAttachments       = colorReferences[subpassIndex].data ();
+        subpass.inputAttachmentCount    = static_cast<uint32_t> (inputReferences[subpassIndex].size ());
+        subpass.pInputAttachments       = inputReferences[subpassIndex].data ();
+        subpass.preserveAttachmentCount = static_cast<uint32_t> (preserveAttachments[subpassIndex].size ());
+        subpass.pPreserveAttachments    = preserveAttachments[subpassIndex].empty () ? nullptr : preserveAttachments[subpassIndex].data ();
+        subpasses.push_back (subpass);
+    }
+
+    renderPass = device.GetObjectCache ().GetRenderPass (attachmentDescriptions, subpasses, GetSubpassDependencies ());
+
+    for (uint32_t subpassIndex = 0; subpassIndex < operations.size (); ++subpassIndex) {
+        operations[subpassIndex]->CompileForSubpass (graphSettings, width, height, renderPass, subpassIndex);
+    }
+
+    framebuffers.clear ();
+    for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
+        std::vector<VkImageView> imageViews;
+        for (const Attachment& attachment : attachments) {
+            imageViews.push_back (attachment.image.resource->GetImageViewForFrame (resourceIndex, attachment.image.layerIndex));
+        }
+
+        framebuffers.push_back (device.GetObjectCache ().GetFramebuffer (renderPass, imageViews, width, height));
+    }
+}
+
+
+void MergedRenderPass::Record (uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer, OperationProfiler* profiler)
+{
+    GVK_ASSERT (renderPass != nullptr);
+
+    // every attachment is cleared with the color of the first operation using it
+    std::vector<VkClearValue> clearValues;
+    for (const Attachment& attachment : attachments) {
+        for (uint32_t subpassIndex = 0; subpassIndex < operations.size (); ++subpassIndex) {
+            if (IsColorAttachmentOfSubpass (subpassIndex, attachment.image.resource) || IsInputAttachmentOfSubpass (subpassIndex, attachment.image.resource)) {
+                clearValues.push_back (operations[subpassIndex]->GetClearValue ());
+                break;
+            }
+        }
+    }
+
+    commandBuffer.Record<GVK::CommandBeginRenderPass> (*renderPass,
+                                                       *framebuffers[resourceIndex],
+                                                       VkRect2D { { 0, 0 }, { width, height } },
+                                                       clearValues,
+                                                       VK_SUBPASS_CONTENTS_INLINE)
+        .SetName ("MergedRenderPass - Renderpass Begin");
+
+    for (uint32_t subpassIndex = 0; subpassIndex < operations.size (); ++subpassIndex) {
+        if (subpassIndex > 0) {
+            commandBuffer.Record<GVK::CommandNextSubpass> (VK_SUBPASS_CONTENTS_INLINE).SetName ("MergedRenderPass - Next Subpass");
+        }
+
+        if (profiler != nullptr) {
+            profiler->RecordBegin (resourceIndex, operations[subpassIndex], commandBuffer);
+        }
+
+        operations[subpassIndex]->RecordSubpass (resourceIndex, commandBuffer);
+
+        if (profiler != nullptr) {
+            profiler->RecordEnd (resourceIndex, operations[subpassIndex], commandBuffer);
+        }
+    }
+
+    commandBuffer.Record<GVK::CommandEndRenderPass> ().SetName ("MergedRenderPass - Renderpass End");
+}
+
+} // namespace RG
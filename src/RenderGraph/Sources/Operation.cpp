@@ -9,12 +9,15 @@
 
 #include "VulkanWrapper/CommandBuffer.hpp"
 #include "VulkanWrapper/Commands.hpp"
+#include "VulkanWrapper/DescriptorAllocator.hpp"
 #include "VulkanWrapper/DescriptorSet.hpp"
 #include "VulkanWrapper/DescriptorSetLayout.hpp"
 #include "VulkanWrapper/ShaderModule.hpp"
 #include "VulkanWrapper/DescriptorSetLayout.hpp"
+#include "VulkanWrapper/DeviceExtra.hpp"
 #include "VulkanWrapper/Event.hpp"
 #include "VulkanWrapper/Framebuffer.hpp"
+#include "VulkanWrapper/ObjectCache.hpp"
 #include "VulkanWrapper/Image.hpp"
 #include "VulkanWrapper/ImageView.hpp"
 #include "VulkanWrapper/GraphicsPipeline.hpp"
@@ -24,6 +27,7 @@
 
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
 #include <memory>
 
 
@@ -192,6 +196,111 @@ public:
 };
 
 
+// the written descriptors one by one, frames in flight writing the same descriptors can share a descriptor set
+class DescriptorRecorder : public RG::FromShaderReflection::IUpdateDescriptorSets {
+public:
+    struct Descriptor {
+        uint32_t               binding;
+        uint32_t               arrayElement;
+        VkDescriptorType       type;
+        VkDescriptorImageInfo  imageInfo;
+        VkDescriptorBufferInfo bufferInfo;
+
+        bool operator== (const Descriptor& other) const
+        {
+            return binding == other.binding &&
+                   arrayElement == other.arrayElement &&
+                   type == other.type &&
+                   imageInfo.sampler == other.imageInfo.sampler &&
+                   imageInfo.imageView == other.imageInfo.imageView &&
+                   imageInfo.imageLayout == other.imageInfo.imageLayout &&
+                   bufferInfo.buffer == other.bufferInfo.buffer &&
+                   bufferInfo.offset == other.bufferInfo.offset &&
+                   bufferInfo.range == other.bufferInfo.range;
+        }
+    };
+
+    std::vector<Descriptor> descriptors;
+
+    virtual void UpdateDescriptorSets (const std::vector<VkWriteDescriptorSet>& writes) override
+    {
+        for (const VkWriteDescriptorSet& write : writes) {
+            for (uint32_t i = 0; i < write.descriptorCount; ++i) {
+                Descriptor descriptor   = {};
+                descriptor.binding      = write.dstBinding;
+                descriptor.arrayElement = write.dstArrayElement + i;
+                descriptor.type         = write.descriptorType;
+                if (write.pImageInfo != nullptr) {
+                    descriptor.imageInfo = write.pImageInfo[i];
+                }
+                if (write.pBufferInfo != nullptr) {
+                    descriptor.bufferInfo = write.pBufferInfo[i];
+                }
+                descriptors.push_back (descriptor);
+            }
+        }
+    }
+};
+
+
+template<typename ShaderPipelineType>
+static bool WritesSameDescriptorsForEveryFrame (const GraphSettings&                                    graphSettings,
+                                                RG::FromShaderReflection::IDescriptorWriteInfoProvider& writeInfoProvider,
+                                                const ShaderPipelineType&                               shaderPipeline)
+{
+    std::vector<DescriptorRecorder::Descriptor> firstFrameDescriptors;
+
+    for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
+        DescriptorRecorder descriptorRecorder;
+        shaderPipeline.IterateShaders ([&] (const GVK::ShaderModule& shaderModule) {
+            RG::FromShaderReflection::WriteDescriptors (shaderModule.GetReflection (), VK_NULL_HANDLE, resourceIndex, shaderModule.GetShaderKind (), writeInfoProvider, descriptorRecorder);
+        });
+
+        if (resourceIndex == 0) {
+            firstFrameDescriptors = std::move (descriptorRecorder.descriptors);
+        } else if (descriptorRecorder.descriptors != firstFrameDescriptors) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+template<typename ShaderPipelineType>
+static std::vector<uint32_t> GetOperationDynamicOffsets (RG::FromShaderReflection::IDescriptorWriteInfoProvider& writeInfoProvider,
+                                                          const ShaderPipelineType&                               shaderPipeline,
+                                                          uint32_t                                                resourceIndex)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> bindingOffsets;
+    shaderPipeline.IterateShaders ([&] (const GVK::ShaderModule& shaderModule) {
+        const std::vector<std::pair<uint32_t, uint32_t>> shaderOffsets = RG::FromShaderReflection::GetDynamicOffsets (shaderModule.GetReflection (), resourceIndex, shaderModule.GetShaderKind (), writeInfoProvider);
+        bindingOffsets.insert (bindingOffsets.end (), shaderOffsets.begin (), shaderOffsets.end ());
+    });
+
+    // vkCmdBindDescriptorSets expects them in the order of the bindings
+    std::sort (bindingOffsets.begin (), bindingOffsets.end ());
+
+    std::vector<uint32_t> result;
+    for (const auto& [binding, offset] : bindingOffsets) {
+        result.push_back (offset);
+    }
+    return result;
+}
+
+
+template<typename ShaderPipelineType>
+static std::vector<VkDescriptorPoolSize> GetOperationDescriptorPoolSizes (RG::FromShaderReflection::IDescriptorWriteInfoProvider& writeInfoProvider,
+                                                                          const ShaderPipelineType&                               shaderPipeline)
+{
+    DescriptorCounter descriptorCounter;
+    shaderPipeline.IterateShaders ([&] (const GVK::ShaderModule& shaderModule) {
+        RG::FromShaderReflection::WriteDescriptors (shaderModule.GetReflection (), VK_NULL_HANDLE, 0, shaderModule.GetShaderKind (), writeInfoProvider, descriptorCounter);
+    });
+    return descriptorCounter.poolSizes;
+}
+
+
 template<typename ShaderPipelineType>
 static Operation::Descriptors CompileOperationDescriptors (const GraphSettings&                                    graphSettings,
                                                            RG::FromShaderReflection::IDescriptorWriteInfoProvider& writeInfoProvider,
@@ -199,7 +308,11 @@ static Operation::Descriptors CompileOperationDescriptors (const GraphSettings&
 {
     Operation::Descriptors result;
 
-    result.descriptorSetLayout = shaderPipeline.CreateDescriptorSetLayout (graphSettings.GetDevice ());
+    result.descriptorSetLayout = shaderPipeline.CreateDescriptorSetLayout (graphSettings.GetDevice (), writeInfoProvider);
+
+    for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
+        result.dynamicOffsets.push_back (GetOperationDynamicOffsets (writeInfoProvider, shaderPipeline, resourceIndex));
+    }
 
     DescriptorCounter descriptorCounter;
     descriptorCounter.multiplier = graphSettings.framesInFlight;
@@ -208,13 +321,25 @@ static Operation::Descriptors CompileOperationDescriptors (const GraphSettings&
     });
 
     if (!descriptorCounter.poolSizes.empty ()) {
-        result.descriptorPool = std::make_unique<GVK::DescriptorPool> (graphSettings.GetDevice (), descriptorCounter.poolSizes, graphSettings.framesInFlight);
+        // without a shared allocator (operations compiled outside of a RenderGraph) each operation gets its own pool
+        GVK::DescriptorAllocator* descriptorAllocator = graphSettings.descriptorAllocator;
+
+        GVK_ASSERT (descriptorAllocator == nullptr || descriptorAllocator->GetArenaCount () == graphSettings.framesInFlight);
+
+        if (descriptorAllocator == nullptr) {
+            result.descriptorPool = std::make_unique<GVK::DescriptorPool> (graphSettings.GetDevice (), descriptorCounter.poolSizes, graphSettings.framesInFlight);
+        }
 
         DescriptorWriter descriptorWriter;
         descriptorWriter.device = graphSettings.GetDevice ();
 
-        for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
-            std::unique_ptr<GVK::DescriptorSet> descriptorSet = std::make_unique<GVK::DescriptorSet> (graphSettings.GetDevice (), *result.descriptorPool, *result.descriptorSetLayout);
+        // e.g. uniform blocks in a UniformArena are the same buffer range for every frame, only their dynamic offsets differ
+        const uint32_t descriptorSetCount = WritesSameDescriptorsForEveryFrame (graphSettings, writeInfoProvider, shaderPipeline) ? 1 : graphSettings.framesInFlight;
+
+        for (uint32_t resourceIndex = 0; resourceIndex < descriptorSetCount; ++resourceIndex) {
+            std::unique_ptr<GVK::DescriptorSet> descriptorSet = (descriptorAllocator != nullptr)
+                                                                    ? std::make_unique<GVK::DescriptorSet> (*descriptorAllocator, resourceIndex, *result.descriptorSetLayout)
+                                                                    : std::make_unique<GVK::DescriptorSet> (graphSettings.GetDevice (), *result.descriptorPool, *result.descriptorSetLayout);
 
             shaderPipeline.IterateShaders ([&] (const GVK::ShaderModule& shaderModule) {
                 RG::FromShaderReflection::WriteDescriptors (shaderModule.GetReflection (), *descriptorSet, resourceIndex, shaderModule.GetShaderKind (), writeInfoProvider, descriptorWriter);
@@ -230,6 +355,18 @@ static Operation::Descriptors CompileOperationDescriptors (const GraphSettings&
 } // namespace
 
 
+VkDescriptorSet Operation::Descriptors::GetDescriptorSet (uint32_t resourceIndex) const
+{
+    GVK_ASSERT (!descriptorSets.empty ());
+    return *descriptorSets[(descriptorSets.size () == 1) ? 0 : resourceIndex];
+}
+
+
+const std::vector<uint32_t>& Operation::Descriptors::GetDynamicOffsets (uint32_t resourceIndex) const
+{
+    return dynamicOffsets[resourceIndex];
+}
+
 
 void RenderOperation::Compile (const GraphSettings& graphSettings)
 {
@@ -240,12 +377,83 @@ void RenderOperation::Compile (const GraphSettings& graphSettings)
 
 void RenderOperation::CompileWithExtent (const GraphSettings& graphSettings, uint32_t width, uint32_t height)
 {
-    compileResult.descriptors = CompileOperationDescriptors (graphSettings, *compileSettings.descriptorWriteProvider, *compileSettings.pipeline);
+    const GVK::DeviceExtra& device = graphSettings.GetDevice ();
+
+    // input attachments can only be read in a render pass
+    const bool dynamicRendering = graphSettings.useDynamicRendering && device.SupportsDynamicRendering () && GetShaderPipeline ()->fragmentShader->GetReflection ().subpassInputs.empty ();
+
+    compileResult.dynamicRendering = dynamicRendering ? &device.GetDynamicRenderingFunctions () : nullptr;
+
+    CompilePipeline (graphSettings, width, height, nullptr, 0);
+
+    CompileFramebuffers (graphSettings, width, height);
+}
+
+
+void RenderOperation::CompileFramebuffers (const GraphSettings& graphSettings, uint32_t width, uint32_t height)
+{
+    GVK_ASSERT (UsesDynamicRendering () || GetShaderPipeline ()->compileResult.renderPass != nullptr);
+
+    const GVK::ShaderModule::Reflection& reflection = GetShaderPipeline ()->fragmentShader->GetReflection ();
 
     std::vector<std::vector<VkImageView>> imageViews;
     for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
-        imageViews.push_back (RG::FromShaderReflection::GetImageViews (GetShaderPipeline ()->fragmentShader->GetReflection (), GVK::ShaderKind::Fragment, resourceIndex, *compileSettings.attachmentProvider));
+        imageViews.push_back (RG::FromShaderReflection::GetImageViews (reflection, GVK::ShaderKind::Fragment, resourceIndex, *compileSettings.attachmentProvider));
+    }
+
+    compileResult.framebuffers.clear ();
+    compileResult.renderingAttachments.clear ();
+
+    compileResult.width  = width;
+    compileResult.height = height;
+
+    if (UsesDynamicRendering ()) {
+        const std::vector<VkAttachmentReference>   attachmentReferences   = RG::FromShaderReflection::GetAttachmentReferences (reflection, GVK::ShaderKind::Fragment, *compileSettings.attachmentProvider);
+        const std::vector<VkAttachmentDescription> attachmentDescriptions = RG::FromShaderReflection::GetAttachmentDescriptions (reflection, GVK::ShaderKind::Fragment, *compileSettings.attachmentProvider);
+
+        // no objects are created, the image views are given when recording
+        for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
+            std::vector<VkRenderingAttachmentInfoKHR>& attachments = compileResult.renderingAttachments.emplace_back ();
+            for (const VkAttachmentReference& reference : attachmentReferences) {
+                VkRenderingAttachmentInfoKHR attachment = {};
+                attachment.sType                        = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+                attachment.imageView                    = imageViews[resourceIndex][reference.attachment];
+                attachment.imageLayout                  = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                attachment.resolveMode                  = VK_RESOLVE_MODE_NONE;
+                attachment.loadOp                       = attachmentDescriptions[reference.attachment].loadOp;
+                attachment.storeOp                      = attachmentDescriptions[reference.attachment].storeOp;
+                attachment.clearValue                   = GetClearValue ();
+                attachments.push_back (attachment);
+            }
+        }
+        return;
+    }
+
+    for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
+        compileResult.framebuffers.push_back (graphSettings.GetDevice ().GetObjectCache ().GetFramebuffer (GetShaderPipeline ()->compileResult.renderPass,
+                                                                                                        imageViews[resourceIndex],
+                                                                                                        width,
+                                                                                                        height));
     }
+}
+
+
+void RenderOperation::CompileForSubpass (const GraphSettings& graphSettings, uint32_t width, uint32_t height, const std::shared_ptr<GVK::RenderPass>& renderPass, uint32_t subpassIndex)
+{
+    GVK_ASSERT (renderPass != nullptr);
+
+    compileResult.dynamicRendering = nullptr;
+
+    CompilePipeline (graphSettings, width, height, renderPass, subpassIndex);
+
+    // the framebuffers are owned by the MergedRenderPass
+    compileResult.framebuffers.clear ();
+}
+
+
+void RenderOperation::CompilePipeline (const GraphSettings& graphSettings, uint32_t width, uint32_t height, const std::shared_ptr<GVK::RenderPass>& renderPass, uint32_t subpassIndex)
+{
+    compileResult.descriptors = CompileOperationDescriptors (graphSettings, *compileSettings.descriptorWriteProvider, *compileSettings.pipeline);
 
     const std::vector<VkAttachmentReference>   attachmentReferences      = RG::FromShaderReflection::GetAttachmentReferences (GetShaderPipeline ()->fragmentShader->GetReflection (), GVK::ShaderKind::Fragment, *compileSettings.attachmentProvider);
     const std::vector<VkAttachmentReference>   inputAttachmentReferences = RG::FromShaderReflection::GetInputAttachmentReferences (GetShaderPipeline ()->fragmentShader->GetReflection (), GVK::ShaderKind::Fragment, *compileSettings.attachmentProvider, attachmentReferences.size ());
@@ -258,45 +466,78 @@ void RenderOperation::CompileWithExtent (const GraphSettings& graphSettings, uin
                                                        inputAttachmentReferences,
                                                        attachmentDescriptions,
                                                        compileSettings.topology,
-                                                       compileSettings.blendEnabled };
+                                                       compileSettings.blendEnabled,
+                                                       &graphSettings.GetDevice ().GetObjectCache (),
+                                                       graphSettings.GetDevice ().GetPipelineCache (),
+                                                       renderPass,
+                                                       subpassIndex,
+                                                       UsesDynamicRendering () };
 
     GetShaderPipeline ()->Compile (std::move (pipelineSettings));
 
-    for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
-        compileResult.framebuffers.push_back (std::make_unique<GVK::Framebuffer> (graphSettings.GetDevice (),
-                                                                                  *GetShaderPipeline ()->compileResult.renderPass,
-                                                                                  imageViews[resourceIndex],
-                                                                                  width,
-                                                                                  height));
-    }
-
     compileResult.width  = width;
     compileResult.height = height;
 }
 
 
+std::vector<VkDescriptorPoolSize> RenderOperation::GetDescriptorPoolSizes () const
+{
+    return GetOperationDescriptorPoolSizes (*compileSettings.descriptorWriteProvider, *compileSettings.pipeline);
+}
+
+
+VkRect2D RenderOperation::GetRenderArea () const
+{
+    const VkRect2D wholeExtent = { { 0, 0 }, { compileResult.width, compileResult.height } };
+
+    if (!compileSettings.renderArea.has_value ()) {
+        return wholeExtent;
+    }
+
+    const VkRect2D& area = *compileSettings.renderArea;
+
+    const int64_t left   = std::clamp<int64_t> (area.offset.x, 0, compileResult.width);
+    const int64_t top    = std::clamp<int64_t> (area.offset.y, 0, compileResult.height);
+    const int64_t right  = std::clamp<int64_t> (static_cast<int64_t> (area.offset.x) + area.extent.width, 0, compileResult.width);
+    const int64_t bottom = std::clamp<int64_t> (static_cast<int64_t> (area.offset.y) + area.extent.height, 0, compileResult.height);
+
+    VkRect2D result      = {};
+    result.offset.x      = static_cast<int32_t> (left);
+    result.offset.y      = static_cast<int32_t> (top);
+    result.extent.width  = static_cast<uint32_t> (right - left);
+    result.extent.height = static_cast<uint32_t> (bottom - top);
+    return result;
+}
+
+
+VkClearValue RenderOperation::GetClearValue () const
+{
+    if (!compileSettings.clearColor.has_value ()) {
+        return VkClearValue { 0.0f, 0.0f, 0.0f, 1.0f };
+    }
+
+    return VkClearValue {
+        compileSettings.clearColor->x,
+        compileSettings.clearColor->y,
+        compileSettings.clearColor->z,
+        compileSettings.clearColor->w
+    };
+}
+
+
 void RenderOperation::Record (const ConnectionSet& connectionSet, uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer)
 {
+    if (UsesDynamicRendering ()) {
+        RecordDynamicRendering (connectionSet, resourceIndex, commandBuffer);
+        return;
+    }
+
     uint32_t outputCount = 0;
     for (const auto& output : GetShaderPipeline ()->fragmentShader->GetReflection ().outputs) {
         outputCount += output.arraySize;
     }
 
-    VkClearValue clearColor     = {};
-    clearColor.color.float32[0] = 0.0f;
-    clearColor.color.float32[1] = 0.0f;
-    clearColor.color.float32[2] = 0.0f;
-    clearColor.color.float32[3] = 1.0f;
-    clearColor                  = compileSettings.clearColor.has_value ()
-                                      ? VkClearValue {
-                           compileSettings.clearColor->x,
-                           compileSettings.clearColor->y,
-                           compileSettings.clearColor->z,
-                           compileSettings.clearColor->w
-                       }
-                                      : VkClearValue { 0.0f, 0.0f, 0.0f, 1.0f };
-
-    std::vector<VkClearValue> clearValues (outputCount, clearColor);
+    std::vector<VkClearValue> clearValues (outputCount, GetClearValue ());
 
     GVK_ASSERT (GetShaderPipeline () != nullptr);
 
@@ -307,24 +548,78 @@ void RenderOperation::Record (const ConnectionSet& connectionSet, uint32_t resou
                                                        VK_SUBPASS_CONTENTS_INLINE)
         .SetName ("RenderOperation - Renderpass Begin");
 
+    RecordSubpass (resourceIndex, commandBuffer);
+
+    commandBuffer.Record<GVK::CommandEndRenderPass> ().SetName ("RenderOperation - Renderpass End");
+}
+
+
+void RenderOperation::RecordDynamicRendering (const ConnectionSet& connectionSet, uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer)
+{
+    commandBuffer.Record<GVK::CommandBeginRendering> (compileResult.dynamicRendering->cmdBeginRendering,
+                                                      VkRect2D { { 0, 0 }, { compileResult.width, compileResult.height } },
+                                                      compileResult.renderingAttachments[resourceIndex])
+        .SetName ("RenderOperation - Rendering Begin");
+
+    RecordSubpass (resourceIndex, commandBuffer);
+
+    commandBuffer.Record<GVK::CommandEndRendering> (compileResult.dynamicRendering->cmdEndRendering).SetName ("RenderOperation - Rendering End");
+
+    // there is no render pass to transition the attachments to their final layouts, e.g. swapchain images to present
+    std::unique_ptr<GVK::CommandPipelineBarrier> barrier = std::make_unique<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                                                                                          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+    bool transitionsImages = false;
+    for (const std::shared_ptr<ImageResource>& img : connectionSet.GetPointingTo<ImageResource> (this)) {
+        const VkImageLayout finalLayout = GetImageLayoutAtEndForOutputs (*img);
+        if (finalLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+            continue;
+        }
+        for (GVK::Image* image : img->GetImages (resourceIndex)) {
+            barrier->AddImageMemoryBarrier (image->GetBarrier (VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, finalLayout, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, 0));
+            transitionsImages = true;
+        }
+    }
+
+    if (transitionsImages) {
+        commandBuffer.RecordCommand (std::move (barrier)).SetName ("RenderOperation - Transition to final layout");
+    }
+}
+
+
+void RenderOperation::RecordSubpass (uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer)
+{
     commandBuffer.Record<GVK::CommandBindPipeline> (VK_PIPELINE_BIND_POINT_GRAPHICS, *GetShaderPipeline ()->compileResult.pipeline).SetName ("RenderOperation - Bind");
 
+    const VkRect2D renderArea = GetRenderArea ();
+
+    VkViewport viewport = {};
+    viewport.x          = static_cast<float> (renderArea.offset.x);
+    viewport.y          = static_cast<float> (renderArea.offset.y);
+    viewport.width      = static_cast<float> (renderArea.extent.width);
+    viewport.height     = static_cast<float> (renderArea.extent.height);
+    viewport.minDepth   = 0.0f;
+    viewport.maxDepth   = 1.0f;
+
+    commandBuffer.Record<GVK::CommandSetViewport> (viewport).SetName ("RenderOperation - Viewport");
+    commandBuffer.Record<GVK::CommandSetScissor> (renderArea).SetName ("RenderOperation - Scissor");
+
     if (!compileResult.descriptors.descriptorSets.empty ()) {
-        VkDescriptorSet dsHandle = *compileResult.descriptors.descriptorSets[resourceIndex];
+        VkDescriptorSet dsHandle = compileResult.descriptors.GetDescriptorSet (resourceIndex);
 
         commandBuffer.Record<GVK::CommandBindDescriptorSets> (
                          VK_PIPELINE_BIND_POINT_GRAPHICS,
                          *GetShaderPipeline ()->compileResult.pipelineLayout,
                          0,
                          std::vector<VkDescriptorSet> { dsHandle },
-                         std::vector<uint32_t> {})
+                         compileResult.descriptors.GetDynamicOffsets (resourceIndex))
             .SetName ("RenderOperation - DescriptionSet");
     }
 
     GVK_ASSERT (compileSettings.drawRecordable != nullptr);
-    compileSettings.drawRecordable->Record (commandBuffer);
-
-    commandBuffer.Record<GVK::CommandEndRenderPass> ().SetName ("RenderOperation - Renderpass End");
+    if (renderArea.extent.width > 0 && renderArea.extent.height > 0) {
+        compileSettings.drawRecordable->Record (commandBuffer);
+    }
 }
 
 
@@ -342,6 +637,11 @@ VkImageLayout RenderOperation::GetImageLayoutAtEndForInputs (Resource&)
 
 VkImageLayout RenderOperation::GetImageLayoutAtStartForOutputs (Resource& res)
 {
+    // the attachments of dynamic rendering are not transitioned by a render pass
+    if (UsesDynamicRendering ()) {
+        return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
+
     if (auto sw = dynamic_cast<SwapchainImageResource*> (&res)) {
         return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
     } else {
@@ -383,7 +683,8 @@ void ComputeOperation::Compile (const GraphSettings& graphSettings)
     ComputeShaderPipeline::CompileSettings pipelineSettings { compileResult.descriptors.descriptorSetLayout->operator VkDescriptorSetLayout (),
                                                               attachmentReferences,
                                                               inputAttachmentReferences,
-                                                              attachmentDescriptions };
+                                                              attachmentDescriptions,
+                                                              graphSettings.GetDevice ().GetPipelineCache () };
 
     compileSettings.computeShaderPipeline->Compile (std::move (pipelineSettings));
 }
@@ -396,19 +697,25 @@ void ComputeOperation::CompileWithExtent (const GraphSettings&, uint32_t, uint32
 }
 
 
+std::vector<VkDescriptorPoolSize> ComputeOperation::GetDescriptorPoolSizes () const
+{
+    return GetOperationDescriptorPoolSizes (*compileSettings.descriptorWriteProvider, *compileSettings.computeShaderPipeline);
+}
+
+
 void ComputeOperation::Record (const ConnectionSet& connectionSet, uint32_t resourceIndex, GVK::CommandBuffer& commandBuffer)
 {
     commandBuffer.Record<GVK::CommandBindPipeline> (VK_PIPELINE_BIND_POINT_COMPUTE, *compileSettings.computeShaderPipeline->compileResult.pipeline).SetName ("ComputeOperation - Bind");
 
     if (!compileResult.descriptors.descriptorSets.empty ()) {
-        VkDescriptorSet dsHandle = *compileResult.descriptors.descriptorSets[resourceIndex];
+        VkDescriptorSet dsHandle = compileResult.descriptors.GetDescriptorSet (resourceIndex);
 
         commandBuffer.Record<GVK::CommandBindDescriptorSets> (
                          VK_PIPELINE_BIND_POINT_COMPUTE,
                          *compileSettings.computeShaderPipeline->compileResult.pipelineLayout,
                          0,
                          std::vector<VkDescriptorSet> { dsHandle },
-                         std::vector<uint32_t> {})
+                         compileResult.descriptors.GetDynamicOffsets (resourceIndex))
             .SetName ("ComputeOperation - DescriptionSet");
     }
 
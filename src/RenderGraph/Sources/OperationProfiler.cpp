@@ -0,0 +1,302 @@
+#include "OperationProfiler.hpp"
+
+#include "Operation.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include "VulkanWrapper/CommandBuffer.hpp"
+#include "VulkanWrapper/Commands.hpp"
+#include "VulkanWrapper/DeviceExtra.hpp"
+#include "VulkanWrapper/Fence.hpp"
+#include "VulkanWrapper/QueryPool.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+
+namespace RG {
+
+IOperationTimingObserver noOpOperationTimingObserver;
+
+
+TimingHistory::TimingHistory (size_t capacity)
+    : capacity (capacity)
+    , nextIndex (0)
+{
+    GVK_ASSERT (capacity > 0);
+    samples.reserve (capacity);
+}
+
+
+void TimingHistory::Add (double milliseconds)
+{
+    if (samples.size () < capacity) {
+        samples.push_back (milliseconds);
+    } else {
+        samples[nextIndex] = milliseconds;
+    }
+
+    nextIndex = (nextIndex + 1) % capacity;
+}
+
+
+TimingStatistics TimingHistory::GetStatistics () const
+{
+    TimingStatistics result = {};
+
+    if (samples.empty ()) {
+        return result;
+    }
+
+    std::vector<double> sorted = samples;
+    std::sort (sorted.begin (), sorted.end ());
+
+    const size_t p99Index = static_cast<size_t> (std::ceil (0.99 * sorted.size ())) - 1;
+
+    result.minMilliseconds  = sorted.front ();
+    result.meanMilliseconds = std::accumulate (sorted.begin (), sorted.end (), 0.0) / sorted.size ();
+    result.p99Milliseconds  = sorted[p99Index];
+    result.sampleCount      = static_cast<uint32_t> (sorted.size ());
+    return result;
+}
+
+
+OperationProfiler::OperationProfiler (const GVK::DeviceExtra&        device,
+                                      uint32_t                       framesInFlight,
+                                      const std::vector<Operation*>& graphicsOperations,
+                                      const std::vector<Operation*>& computeOperations)
+    : device (device)
+    , useTimestamps (device.SupportsTimestamps ())
+    , graphicsOperations (graphicsOperations)
+    , computeOperations (computeOperations)
+    , frames (framesInFlight)
+{
+    if (!useTimestamps) {
+        spdlog::info ("Timestamp queries are not supported, measuring frame times on the CPU.");
+    }
+
+    for (Operation* op : graphicsOperations) {
+        operationHistories.emplace (op, TimingHistory ());
+    }
+    for (Operation* op : computeOperations) {
+        operationHistories.emplace (op, TimingHistory ());
+    }
+
+    for (FrameQueries& frame : frames) {
+        frame.pending  = false;
+        frame.fence    = VK_NULL_HANDLE;
+        frame.ownFence = std::make_unique<GVK::Fence> (device);
+
+        if (!useTimestamps) {
+            continue;
+        }
+
+        // two timestamps for every operation
+        if (!graphicsOperations.empty ()) {
+            frame.graphicsPool = std::make_unique<GVK::QueryPool> (device, VK_QUERY_TYPE_TIMESTAMP, static_cast<uint32_t> (graphicsOperations.size () * 2));
+        }
+        if (!computeOperations.empty ()) {
+            frame.computePool = std::make_unique<GVK::QueryPool> (device, VK_QUERY_TYPE_TIMESTAMP, static_cast<uint32_t> (computeOperations.size () * 2));
+        }
+    }
+}
+
+
+OperationProfiler::~OperationProfiler () = default;
+
+
+std::optional<OperationProfiler::QueryIndex> OperationProfiler::GetQueryIndex (const Operation* op) const
+{
+    auto graphicsIt = std::find (graphicsOperations.begin (), graphicsOperations.end (), op);
+    if (graphicsIt != graphicsOperations.end ()) {
+        const uint32_t index = static_cast<uint32_t> (std::distance (graphicsOperations.begin (), graphicsIt));
+        return QueryIndex { SubmitQueue::Graphics, index * 2, index * 2 + 1 };
+    }
+
+    auto computeIt = std::find (computeOperations.begin (), computeOperations.end (), op);
+    if (computeIt != computeOperations.end ()) {
+        const uint32_t index = static_cast<uint32_t> (std::distance (computeOperations.begin (), computeIt));
+        return QueryIndex { SubmitQueue::AsyncCompute, index * 2, index * 2 + 1 };
+    }
+
+    return std::nullopt;
+}
+
+
+GVK::QueryPool* OperationProfiler::GetQueryPool (uint32_t frameIndex, SubmitQueue queue) const
+{
+    GVK_ASSERT (frameIndex < frames.size ());
+
+    return (queue == SubmitQueue::Graphics) ? frames[frameIndex].graphicsPool.get () : frames[frameIndex].computePool.get ();
+}
+
+
+void OperationProfiler::RecordReset (uint32_t frameIndex, SubmitQueue queue, GVK::CommandBuffer& commandBuffer)
+{
+    GVK::QueryPool* queryPool = GetQueryPool (frameIndex, queue);
+    if (queryPool == nullptr) {
+        return;
+    }
+
+    commandBuffer.Record<GVK::CommandResetQueryPool> (*queryPool, 0, queryPool->GetQueryCount ()).SetName ("Reset timestamps");
+}
+
+
+void OperationProfiler::RecordBegin (uint32_t frameIndex, const Operation* op, GVK::CommandBuffer& commandBuffer)
+{
+    const std::optional<QueryIndex> queryIndex = GetQueryIndex (op);
+    if (!useTimestamps || GVK_ERROR (!queryIndex.has_value ())) {
+        return;
+    }
+
+    commandBuffer.Record<GVK::CommandWriteTimestamp> (VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, *GetQueryPool (frameIndex, queryIndex->queue), queryIndex->begin).SetName ("Operation begin timestamp");
+}
+
+
+void OperationProfiler::RecordEnd (uint32_t frameIndex, const Operation* op, GVK::CommandBuffer& commandBuffer)
+{
+    const std::optional<QueryIndex> queryIndex = GetQueryIndex (op);
+    if (!useTimestamps || GVK_ERROR (!queryIndex.has_value ())) {
+        return;
+    }
+
+    commandBuffer.Record<GVK::CommandWriteTimestamp> (VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *GetQueryPool (frameIndex, queryIndex->queue), queryIndex->end).SetName ("Operation end timestamp");
+}
+
+
+VkFence OperationProfiler::GetFenceToSignal (uint32_t frameIndex, VkFence fence)
+{
+    GVK_ASSERT (frameIndex < frames.size ());
+
+    if (fence != VK_NULL_HANDLE) {
+        return fence;
+    }
+
+    const GVK::Fence& ownFence = *frames[frameIndex].ownFence;
+    ownFence.Wait ();
+    ownFence.Reset ();
+    return ownFence;
+}
+
+
+void OperationProfiler::OnSubmitted (uint32_t frameIndex, VkFence fence)
+{
+    GVK_ASSERT (frameIndex < frames.size ());
+
+    FrameQueries& frame = frames[frameIndex];
+    frame.pending       = true;
+    frame.fence         = fence;
+    frame.submitTime    = GVK::TimePoint::SinceApplicationStart ();
+}
+
+
+double OperationProfiler::GetMilliseconds (uint64_t beginTimestamp, uint64_t endTimestamp) const
+{
+    const uint32_t validBits = device.GetTimestampValidBits ();
+    const uint64_t mask      = (validBits >= 64) ? std::numeric_limits<uint64_t>::max () : ((uint64_t (1) << validBits) - 1);
+
+    const uint64_t ticks = (endTimestamp - beginTimestamp) & mask;
+
+    return static_cast<double> (ticks) * device.GetTimestampPeriod () * 1.0e-6;
+}
+
+
+void OperationProfiler::CollectTimestamps (uint32_t frameIndex, IOperationTimingObserver& observer)
+{
+    FrameQueries& frame = frames[frameIndex];
+
+    // the submission has finished, every query was reset and written again
+    if (frame.graphicsPool != nullptr && GVK_ERROR (!frame.graphicsPool->GetResults (0, frame.graphicsPool->GetQueryCount (), graphicsResults))) {
+        return;
+    }
+
+    if (frame.computePool != nullptr && GVK_ERROR (!frame.computePool->GetResults (0, frame.computePool->GetQueryCount (), computeResults))) {
+        return;
+    }
+
+    uint64_t frameBegin = std::numeric_limits<uint64_t>::max ();
+    uint64_t frameEnd   = 0;
+
+    const auto processResults = [&] (const std::vector<Operation*>& operations, const std::vector<uint64_t>& results) {
+        for (size_t i = 0; i < operations.size (); ++i) {
+            const uint64_t begin = results[i * 2];
+            const uint64_t end   = results[i * 2 + 1];
+
+            const double milliseconds = GetMilliseconds (begin, end);
+
+            TimingHistory& history = operationHistories.at (operations[i]);
+            history.Add (milliseconds);
+            observer.OnOperationTimed (*operations[i], milliseconds, history.GetStatistics ());
+
+            frameBegin = std::min (frameBegin, begin);
+            frameEnd   = std::max (frameEnd, end);
+        }
+    };
+
+    if (frame.graphicsPool != nullptr) {
+        processResults (graphicsOperations, graphicsResults);
+    }
+
+    if (frame.computePool != nullptr) {
+        processResults (computeOperations, computeResults);
+    }
+
+    if (frameBegin <= frameEnd) {
+        const double milliseconds = GetMilliseconds (frameBegin, frameEnd);
+        frameHistory.Add (milliseconds);
+        observer.OnFrameTimed (frameIndex, milliseconds, frameHistory.GetStatistics ());
+    }
+}
+
+
+void OperationProfiler::Collect (IOperationTimingObserver& observer)
+{
+    for (uint32_t frameIndex = 0; frameIndex < frames.size (); ++frameIndex) {
+        FrameQueries& frame = frames[frameIndex];
+
+        if (!frame.pending) {
+            continue;
+        }
+
+        // the graphics submission waits for the async compute one, so its fence covers both queues
+        // a fence reset by the caller before it was seen signaled drops the frame, its results are never read stale
+        if (frame.fence == VK_NULL_HANDLE || vkGetFenceStatus (device, frame.fence) != VK_SUCCESS) {
+            continue;
+        }
+
+        if (useTimestamps) {
+            CollectTimestamps (frameIndex, observer);
+            frame.pending = false;
+            continue;
+        }
+
+        // completion is only noticed when collecting, so these timings are an upper bound
+        const double milliseconds = (GVK::TimePoint::SinceApplicationStart () - frame.submitTime).AsMilliseconds ();
+        frameHistory.Add (milliseconds);
+        observer.OnFrameTimed (frameIndex, milliseconds, frameHistory.GetStatistics ());
+        frame.pending = false;
+    }
+}
+
+
+TimingStatistics OperationProfiler::GetStatistics (const Operation* op) const
+{
+    auto it = operationHistories.find (op);
+    if (GVK_ERROR (it == operationHistories.end ())) {
+        return {};
+    }
+
+    return it->second.GetStatistics ();
+}
+
+
+TimingStatistics OperationProfiler::GetFrameStatistics () const
+{
+    return frameHistory.GetStatistics ();
+}
+
+} // namespace RG
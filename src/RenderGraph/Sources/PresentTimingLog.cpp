@@ -0,0 +1,124 @@
+#include "PresentTimingLog.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace RG {
+
+static_assert (sizeof (PresentTimingLog::BinaryRecord) == 40, "binary log records must not have padding");
+
+
+PresentTimingLog::PresentTimingLog (std::chrono::nanoseconds expectedInterval)
+    : expectedInterval { expectedInterval }
+    , summary {}
+    , intervalSumMilliseconds { 0.0 }
+{
+    GVK_ASSERT (expectedInterval.count () > 0);
+}
+
+
+PresentTimingLog::PresentTimingLog (std::chrono::nanoseconds expectedInterval, const std::filesystem::path& binaryLogPath)
+    : PresentTimingLog (expectedInterval)
+{
+    binaryLog.emplace (binaryLogPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!binaryLog->is_open ()) {
+        throw std::runtime_error ("failed to open present timing log \"" + binaryLogPath.string () + "\"");
+    }
+
+    const uint64_t expectedIntervalNanoseconds = expectedInterval.count ();
+
+    binaryLog->write ("GVPT", 4);
+    binaryLog->write (reinterpret_cast<const char*> (&BinaryLogVersion), sizeof (BinaryLogVersion));
+    binaryLog->write (reinterpret_cast<const char*> (&expectedIntervalNanoseconds), sizeof (expectedIntervalNanoseconds));
+}
+
+
+uint32_t PresentTimingLog::Add (const FrameTiming& timing)
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    uint32_t missedVblanks = 0;
+
+    if (lastImageAvailable.has_value ()) {
+        const std::chrono::nanoseconds interval = timing.imageAvailable - *lastImageAvailable;
+
+        const double   refreshes      = static_cast<double> (interval.count ()) / expectedInterval.count ();
+        const uint32_t refreshesShown = static_cast<uint32_t> (std::max (std::llround (refreshes), 1ll));
+
+        missedVblanks = refreshesShown - 1;
+        if (missedVblanks > 0) {
+            ++summary.droppedFrameCount;
+            summary.missedVblankCount += missedVblanks;
+        }
+
+        const std::chrono::nanoseconds jitter      = std::chrono::abs (interval - expectedInterval * refreshesShown);
+        const size_t                   bucketIndex = std::min<size_t> (jitter / HistogramBucketWidth, HistogramBucketCount - 1);
+        ++summary.jitterHistogram[bucketIndex];
+
+        const double intervalMilliseconds = Milliseconds (interval).count ();
+        intervalSumMilliseconds += intervalMilliseconds;
+        summary.maxIntervalMilliseconds  = std::max (summary.maxIntervalMilliseconds, intervalMilliseconds);
+        summary.meanIntervalMilliseconds = intervalSumMilliseconds / summary.frameCount;
+    }
+
+    if (timing.presented - timing.imageAvailable > expectedInterval) {
+        ++summary.lateFrameCount;
+    }
+
+    if (!firstImageAvailable.has_value ()) {
+        firstImageAvailable = timing.imageAvailable;
+    }
+
+    if (binaryLog.has_value ()) {
+        const auto sinceStart = [&] (FrameTiming::Clock::time_point time) -> uint64_t {
+            return std::max<int64_t> (std::chrono::duration_cast<std::chrono::nanoseconds> (time - *firstImageAvailable).count (), 0);
+        };
+
+        BinaryRecord record;
+        record.presentIndex   = summary.frameCount;
+        record.missedVblanks  = missedVblanks;
+        record.acquireStarted = sinceStart (timing.acquireStarted);
+        record.imageAvailable = sinceStart (timing.imageAvailable);
+        record.submitted      = sinceStart (timing.submitted);
+        record.presented      = sinceStart (timing.presented);
+
+        binaryLog->write (reinterpret_cast<const char*> (&record), sizeof (record));
+    }
+
+    lastImageAvailable = timing.imageAvailable;
+    ++summary.frameCount;
+
+    return missedVblanks;
+}
+
+
+std::string PresentTimingLog::GetSummaryString () const
+{
+    std::stringstream ss;
+
+    ss << "Present timing: " << summary.frameCount << " frames, "
+       << summary.droppedFrameCount << " dropped (" << summary.missedVblankCount << " missed vblanks), "
+       << summary.lateFrameCount << " late, interval mean " << summary.meanIntervalMilliseconds << " ms, max " << summary.maxIntervalMilliseconds << " ms, expected "
+       << std::chrono::duration<double, std::milli> (expectedInterval).count () << " ms" << std::endl;
+
+    ss << "Jitter histogram:" << std::endl;
+    for (uint32_t i = 0; i < HistogramBucketCount; ++i) {
+        const auto bucketBegin = HistogramBucketWidth * i;
+        ss << "\t" << bucketBegin.count () << " us";
+        if (i + 1 < HistogramBucketCount) {
+            ss << " - " << (bucketBegin + HistogramBucketWidth).count () << " us";
+        } else {
+            ss << " -";
+        }
+        ss << ": " << summary.jitterHistogram[i] << std::endl;
+    }
+
+    return ss.str ();
+}
+
+} // namespace RG
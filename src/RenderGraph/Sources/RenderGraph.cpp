@@ -1,13 +1,18 @@
 #include "RenderGraph.hpp"
 
 #include "GraphSettings.hpp"
+#include "MergedRenderPass.hpp"
 #include "Operation.hpp"
+#include "OperationProfiler.hpp"
 #include "DrawRecordable.hpp"
 #include "Resource.hpp"
 #include "ShaderPipeline.hpp"
+#include "TransientMemory.hpp"
+#include "UniformArena.hpp"
 
 #include "Utils/Utils.hpp"
 #include "Utils/CommandLineFlag.hpp"
+#include "Utils/Trace.hpp"
 
 #include "VulkanWrapper/Swapchain.hpp"
 #include "VulkanWrapper/CommandBuffer.hpp"
@@ -17,215 +22,1087 @@
 #include "VulkanWrapper/RenderPass.hpp"
 #include "VulkanWrapper/ShaderModule.hpp"
 #include "VulkanWrapper/PipelineLayout.hpp"
+#include "VulkanWrapper/DescriptorAllocator.hpp"
 #include "VulkanWrapper/DescriptorSet.hpp"
 #include "VulkanWrapper/DescriptorSetLayout.hpp"
+#include "VulkanWrapper/TimelineSemaphore.hpp"
+#include "VulkanWrapper/SharedAllocation.hpp"
 
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
 #include <iostream>
+#include <optional>
 #include <sstream>
+#include <unordered_set>
 
 
 namespace RG {
     
 RenderGraph::RenderGraph ()
     : compiled (false)
+    , computeTimelineValue (0)
+    , graphicsTimelineValue (0)
+    , operationTimingObserver (&noOpOperationTimingObserver)
+    , transientMemoryStats { 0, 0, 0 }
+    , compileStats { 0, 0, 0, 0 }
 {
 }
 
 
+RenderGraph::~RenderGraph () = default;
+
+
+static bool IsSinkResource (const ConnectionSet& connectionSet, uint32_t resourceIndex)
+{
+    const Node* res = connectionSet.GetNodeByIndex (resourceIndex).get ();
+    if (dynamic_cast<const SwapchainImageResource*> (res) != nullptr || connectionSet.IsPinned (res)) {
+        return true;
+    }
+
+    const std::vector<uint32_t>& writers = connectionSet.GetOperationIndicesPointingHere (resourceIndex);
+    const std::vector<uint32_t>& readers = connectionSet.GetOperationIndicesPointingTo (resourceIndex);
+
+    // operations reading and writing the same resource do not consume it
+    return !writers.empty () && std::all_of (readers.begin (), readers.end (), [&] (uint32_t reader) {
+        return std::find (writers.begin (), writers.end (), reader) != writers.end ();
+    });
+}
+
+
+static bool IsSinkResource (const ConnectionSet& connectionSet, const Resource& res)
+{
+    return IsSinkResource (connectionSet, connectionSet.GetNodeIndex (&res));
+}
+
+
+std::vector<std::shared_ptr<Node>> GetDeadNodes (const ConnectionSet& connectionSet)
+{
+    const uint32_t nodeCount = connectionSet.GetNodeCount ();
+
+    std::vector<bool>     liveNodes (nodeCount, false);
+    std::vector<uint32_t> liveResourcesToVisit;
+
+    for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+        if (!connectionSet.IsOperation (nodeIndex) && IsSinkResource (connectionSet, nodeIndex)) {
+            liveNodes[nodeIndex] = true;
+            liveResourcesToVisit.push_back (nodeIndex);
+        }
+    }
+
+    // backwards from the sinks: the writers of a live resource are live, the inputs of a live operation are live
+    while (!liveResourcesToVisit.empty ()) {
+        const uint32_t res = liveResourcesToVisit.back ();
+        liveResourcesToVisit.pop_back ();
+
+        for (const uint32_t writer : connectionSet.GetOperationIndicesPointingHere (res)) {
+            if (liveNodes[writer]) {
+                continue;
+            }
+            liveNodes[writer] = true;
+
+            for (const uint32_t input : connectionSet.GetResourceIndicesPointingHere (writer)) {
+                if (!liveNodes[input]) {
+                    liveNodes[input] = true;
+                    liveResourcesToVisit.push_back (input);
+                }
+            }
+
+            // every output of a live operation is written, but they do not make other writers live
+            for (const uint32_t output : connectionSet.GetResourceIndicesPointingTo (writer)) {
+                liveNodes[output] = true;
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<Node>> deadNodes;
+    for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+        if (!liveNodes[nodeIndex]) {
+            deadNodes.push_back (connectionSet.GetNodeByIndex (nodeIndex));
+        }
+    }
+
+    return deadNodes;
+}
+
+
+std::vector<std::vector<Operation*>> GetDependencyLevels (const ConnectionSet& connectionSet, const std::vector<bool>& skippedNodes)
+{
+    const uint32_t nodeCount = connectionSet.GetNodeCount ();
+
+    const auto IsScheduled = [&] (uint32_t nodeIndex) {
+        return connectionSet.IsOperation (nodeIndex) && (nodeIndex >= skippedNodes.size () || !skippedNodes[nodeIndex]);
+    };
+
+    // operations depend on the writers of their inputs, an operation reading and writing a resource does not depend on itself
+    const auto ForEachDependent = [&] (uint32_t op, const auto& func) {
+        for (const uint32_t output : connectionSet.GetResourceIndicesPointingTo (op)) {
+            for (const uint32_t reader : connectionSet.GetOperationIndicesPointingTo (output)) {
+                if (reader != op && IsScheduled (reader)) {
+                    func (reader);
+                }
+            }
+        }
+    };
+
+    std::vector<uint32_t> dependencyCount (nodeCount, 0);
+    uint32_t              scheduledCount = 0;
+    for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+        if (IsScheduled (nodeIndex)) {
+            ForEachDependent (nodeIndex, [&] (uint32_t dependent) { ++dependencyCount[dependent]; });
+            ++scheduledCount;
+        }
+    }
+
+    // Kahn's algorithm, the operations are ordered after every operation they depend on
+    std::vector<uint32_t> order;
+    std::vector<bool>     ordered (nodeCount, false);
+    std::vector<uint32_t> ready;
+
+    order.reserve (scheduledCount);
+
+    for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+        if (IsScheduled (nodeIndex) && dependencyCount[nodeIndex] == 0) {
+            ready.push_back (nodeIndex);
+        }
+    }
+
+    while (order.size () < scheduledCount) {
+        if (ready.empty ()) {
+            // the operations depend on each other in a cycle, it is broken at the first remaining operation
+            GVK_BREAK_STR ("dependency cycle in the render graph");
+            for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+                if (IsScheduled (nodeIndex) && !ordered[nodeIndex]) {
+                    ready.push_back (nodeIndex);
+                    break;
+                }
+            }
+        }
+
+        // in insertion order among the operations that became ready together
+        std::sort (ready.begin (), ready.end ());
+
+        std::vector<uint32_t> nextReady;
+        for (const uint32_t op : ready) {
+            ordered[op] = true;
+            order.push_back (op);
+            ForEachDependent (op, [&] (uint32_t dependent) {
+                if (!ordered[dependent] && --dependencyCount[dependent] == 0) {
+                    nextReady.push_back (dependent);
+                }
+            });
+        }
+        ready = std::move (nextReady);
+    }
+
+    // the level of an operation is after the levels of the writers of its inputs,
+    // and operations writing the same resource are in different levels, in the order above
+    constexpr uint32_t NoLevel = UINT32_MAX;
+
+    std::vector<uint32_t> levels (nodeCount, NoLevel);
+    std::vector<uint32_t> firstWritableLevel (nodeCount, 0); // by resource
+    uint32_t              levelCount = 0;
+
+    for (const uint32_t op : order) {
+        uint32_t level = 0;
+        for (const uint32_t input : connectionSet.GetResourceIndicesPointingHere (op)) {
+            for (const uint32_t writer : connectionSet.GetOperationIndicesPointingHere (input)) {
+                if (writer != op && levels[writer] != NoLevel) {
+                    level = std::max (level, levels[writer] + 1);
+                }
+            }
+        }
+        for (const uint32_t output : connectionSet.GetResourceIndicesPointingTo (op)) {
+            level = std::max (level, firstWritableLevel[output]);
+        }
+
+        levels[op] = level;
+        for (const uint32_t output : connectionSet.GetResourceIndicesPointingTo (op)) {
+            firstWritableLevel[output] = level + 1;
+        }
+
+        levelCount = std::max (levelCount, level + 1);
+    }
+
+    std::vector<std::vector<Operation*>> result (levelCount);
+    for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+        if (levels[nodeIndex] != NoLevel) {
+            result[levels[nodeIndex]].push_back (static_cast<Operation*> (connectionSet.GetNodeByIndex (nodeIndex).get ()));
+        }
+    }
+
+    return result;
+}
+
+
+uint32_t RenderGraph::GetNodeIndex (const Node* node) const
+{
+    return graphSettings.connectionSet.GetNodeIndex (node);
+}
+
+
+void RenderGraph::CullDeadNodes ()
+{
+    culledNodes = GetDeadNodes (graphSettings.connectionSet);
+
+    culledNodeFlags.assign (graphSettings.connectionSet.GetNodeCount (), false);
+    for (const std::shared_ptr<Node>& node : culledNodes) {
+        culledNodeFlags[GetNodeIndex (node.get ())] = true;
+    }
+}
+
+
+bool RenderGraph::IsCulled (const Node* node) const
+{
+    const uint32_t nodeIndex = GetNodeIndex (node);
+    return nodeIndex < culledNodeFlags.size () && culledNodeFlags[nodeIndex];
+}
+
+
+void RenderGraph::CollectTransientResources ()
+{
+    const ConnectionSet& connectionSet = graphSettings.connectionSet;
+
+    transientLifetimes.assign (connectionSet.GetNodeCount (), std::nullopt);
+
+    if (!graphSettings.aliasTransientImages) {
+        return;
+    }
+
+    std::vector<std::optional<ResourceLifetime>> lifetimes (connectionSet.GetNodeCount ());
+
+    for (uint32_t passIndex = 0; passIndex < passes.size (); ++passIndex) {
+        const auto UpdateLifetime = [&] (const Resource* res) {
+            std::optional<ResourceLifetime>& lifetime = lifetimes[GetNodeIndex (res)];
+            if (!lifetime.has_value ()) {
+                lifetime = ResourceLifetime { passIndex, passIndex };
+            } else {
+                lifetime->lastPass = passIndex;
+            }
+        };
+
+        for (Resource* res : passes[passIndex].GetAllInputs ()) {
+            UpdateLifetime (res);
+        }
+        for (Resource* res : passes[passIndex].GetAllOutputs ()) {
+            UpdateLifetime (res);
+        }
+    }
+
+    // sinks are used after the graph, and images read in their first pass would need the contents of the previous frame
+    for (uint32_t nodeIndex = 0; nodeIndex < connectionSet.GetNodeCount (); ++nodeIndex) {
+        const std::optional<ResourceLifetime>& lifetime = lifetimes[nodeIndex];
+        if (!lifetime.has_value ()) {
+            continue;
+        }
+
+        auto img = dynamic_cast<WritableImageResource*> (connectionSet.GetNodeByIndex (nodeIndex).get ());
+        if (img == nullptr || !img->CanBeAliased () || IsSinkResource (connectionSet, nodeIndex)) {
+            continue;
+        }
+
+        // attachments of merged render passes are not aliased, see MergeRenderOperations
+        const bool isMergedAttachment = std::any_of (mergedRenderPasses.begin (), mergedRenderPasses.end (), [&] (const std::unique_ptr<MergedRenderPass>& merged) {
+            return merged->IsAttachment (img);
+        });
+        if (isMergedAttachment) {
+            continue;
+        }
+
+        const std::vector<Resource*> firstPassInputs = passes[lifetime->firstPass].GetAllInputs ();
+        if (std::find (firstPassInputs.begin (), firstPassInputs.end (), img) != firstPassInputs.end ()) {
+            continue;
+        }
+
+        transientLifetimes[nodeIndex] = lifetime;
+    }
+}
+
+
+bool RenderGraph::IsTransient (const Resource* res) const
+{
+    const uint32_t nodeIndex = GetNodeIndex (res);
+    return nodeIndex < transientLifetimes.size () && transientLifetimes[nodeIndex].has_value ();
+}
+
+
+bool RenderGraph::IsFirstUseOfTransient (const Resource* res, uint32_t passIndex) const
+{
+    const uint32_t nodeIndex = GetNodeIndex (res);
+    return nodeIndex < transientLifetimes.size () && transientLifetimes[nodeIndex].has_value () && transientLifetimes[nodeIndex]->firstPass == passIndex;
+}
+
+
 void RenderGraph::CompileResources ()
 {
     Utils::ForEach<Resource> (graphSettings.connectionSet.GetNodesByInsertionOrder (), [&] (std::shared_ptr<Resource>& res) {
+        if (IsCulled (res.get ()) || IsTransient (res.get ())) {
+            return;
+        }
+
         res->Compile (graphSettings);
+        ++compileStats.compiledResources;
     });
+
+    CompileTransientImages ();
 }
 
 
-void RenderGraph::CompileOperations ()
-{
+void RenderGraph::CompileTransientImages ()
+{
+    std::vector<WritableImageResource*> transientImages;
+
+    Utils::ForEach<WritableImageResource> (graphSettings.connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<WritableImageResource>& img) {
+        if (IsTransient (img.get ())) {
+            img->CompileAliased (graphSettings);
+            transientImages.push_back (img.get ());
+            ++compileStats.compiledResources;
+        }
+    });
+
+    AllocateTransientImages (transientImages);
+}
+
+
+void RenderGraph::AllocateTransientImages (const std::vector<WritableImageResource*>& transientImages)
+{
+    transientAllocations.clear ();
+    transientMemoryStats = { 0, 0, 0 };
+
+    if (transientImages.empty ()) {
+        return;
+    }
+
+    std::vector<ResourceLifetime>     lifetimes;
+    std::vector<VkMemoryRequirements> requirements;
+    for (WritableImageResource* img : transientImages) {
+        lifetimes.push_back (*transientLifetimes[GetNodeIndex (img)]);
+        requirements.push_back (img->GetMemoryRequirements ());
+    }
+
+    const TransientMemoryLayout layout (lifetimes, requirements);
+
+    const GVK::DeviceExtra& device = graphSettings.GetDevice ();
+
+    // the frames in flight can be executed at the same time, every frame has its own blocks
+    for (uint32_t frameIndex = 0; frameIndex < graphSettings.framesInFlight; ++frameIndex) {
+        const size_t firstBlockIndex = transientAllocations.size ();
+
+        for (const TransientMemoryLayout::Block& block : layout.blocks) {
+            transientAllocations.push_back (std::make_unique<GVK::SharedAllocation> (device.GetAllocator (), block.GetMemoryRequirements ()));
+        }
+
+        for (size_t imageIndex = 0; imageIndex < transientImages.size (); ++imageIndex) {
+            const TransientMemoryLayout::Placement& placement = layout.placements[imageIndex];
+            transientImages[imageIndex]->BindAliasedMemory (device, frameIndex, *transientAllocations[firstBlockIndex + placement.blockIndex], placement.offset);
+        }
+    }
+
+    transientMemoryStats.imageCount    = static_cast<uint32_t> (transientImages.size ());
+    transientMemoryStats.unaliasedSize = TransientMemoryLayout::GetUnaliasedSize (requirements) * graphSettings.framesInFlight;
+    transientMemoryStats.allocatedSize = layout.GetAllocatedSize () * graphSettings.framesInFlight;
+
+    spdlog::info ("Render graph transient images: {}, memory without aliasing: {} bytes, allocated: {} bytes in {} blocks.",
+                  transientMemoryStats.imageCount,
+                  transientMemoryStats.unaliasedSize,
+                  transientMemoryStats.allocatedSize,
+                  transientAllocations.size ());
+}
+
+
+static std::string GetResourceTypeName (const Resource& res)
+{
+    if (dynamic_cast<const SwapchainImageResource*> (&res) != nullptr) {
+        return "SwapchainImageResource";
+    } else if (dynamic_cast<const WritableImageResource*> (&res) != nullptr) {
+        return "WritableImageResource";
+    } else if (dynamic_cast<const ReadOnlyImageResource*> (&res) != nullptr) {
+        return "ReadOnlyImageResource";
+    } else if (dynamic_cast<const GPUBufferResource*> (&res) != nullptr) {
+        return "GPUBufferResource";
+    } else if (dynamic_cast<const CPUBufferResource*> (&res) != nullptr) {
+        return "CPUBufferResource";
+    } else if (dynamic_cast<const UniformArenaBufferResource*> (&res) != nullptr) {
+        return "UniformArenaBufferResource";
+    } else {
+        return "Resource";
+    }
+}
+
+
+std::string RenderGraph::GetAllocationName (const Resource& res) const
+{
+    return res.GetName ().empty () ? fmt::format ("{} {}", GetResourceTypeName (res), GetNodeIndex (&res)) : res.GetName ();
+}
+
+
+void RenderGraph::NameAllocations () const
+{
+    const GVK::Allocator& allocator = graphSettings.GetDevice ().GetAllocatorObject ();
+
+    // resources sharing an allocation (the blocks of a uniform arena) are named after the first of them
+    std::unordered_set<VmaAllocation> namedAllocations;
+
+    Utils::ForEach<Resource> (graphSettings.connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<Resource>& res) {
+        if (IsCulled (res.get ())) {
+            return;
+        }
+
+        const std::string name = GetAllocationName (*res);
+        for (VmaAllocation allocation : res->GetAllocations ()) {
+            if (namedAllocations.insert (allocation).second) {
+                allocator.SetAllocationName (allocation, name);
+            }
+        }
+    });
+
+    for (size_t blockIndex = 0; blockIndex < transientAllocations.size (); ++blockIndex) {
+        allocator.SetAllocationName (*transientAllocations[blockIndex], fmt::format ("Transient images {}", blockIndex));
+    }
+}
+
+
+RenderGraph::MemoryReport RenderGraph::GetMemoryReport () const
+{
+    GVK_ASSERT (compiled);
+
+    const GVK::Allocator& allocator = graphSettings.GetDevice ().GetAllocatorObject ();
+
+    MemoryReport report  = {};
+    report.resourceSize  = 0;
+    report.transientSize = 0;
+
+    // a shared allocation (the buffer of a uniform arena) is counted for the first resource using it
+    std::unordered_set<VmaAllocation> reportedAllocations;
+
+    Utils::ForEach<Resource> (graphSettings.connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<Resource>& res) {
+        if (IsCulled (res.get ())) {
+            return;
+        }
+
+        MemoryReport::ResourceMemory resourceMemory = { res.get (), GetAllocationName (*res), GetResourceTypeName (*res), 0, 0 };
+        for (VmaAllocation allocation : res->GetAllocations ()) {
+            if (!reportedAllocations.insert (allocation).second) {
+                continue;
+            }
+
+            ++resourceMemory.allocationCount;
+            resourceMemory.size += allocator.GetAllocationSize (allocation);
+        }
+
+        report.sizeByType[resourceMemory.type] += resourceMemory.size;
+        report.resourceSize += resourceMemory.size;
+        report.resources.push_back (resourceMemory);
+    });
+
+    for (const std::unique_ptr<GVK::SharedAllocation>& allocation : transientAllocations) {
+        report.transientSize += allocator.GetAllocationSize (*allocation);
+    }
+
+    report.totalSize = report.resourceSize + report.transientSize;
+    report.allocator = allocator.GetStatistics ();
+
+    return report;
+}
+
+
+GVK::Allocator::DefragmentationResult RenderGraph::DefragmentMemory ()
+{
+    Utils::TraceScope traceScope ("RenderGraph::DefragmentMemory", "RenderGraph");
+
+    GVK_ASSERT (compiled);
+
+    graphSettings.GetDevice ().Wait ();
+    graphSettings.GetDevice ().GetGraphicsQueue ().Wait ();
+
+    const ConnectionSet& connectionSet = graphSettings.connectionSet;
+
+    // the other resources are in device local memory, only host visible memory is moved
+    std::vector<CPUBufferResource*> bufferResources;
+    std::vector<UniformArena*>      arenas;
+    std::vector<VmaAllocation>      allocations;
+
+    Utils::ForEach<CPUBufferResource> (connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<CPUBufferResource>& res) {
+        if (IsCulled (res.get ())) {
+            return;
+        }
+
+        const std::vector<VmaAllocation> resourceAllocations = res->GetAllocations ();
+        allocations.insert (allocations.end (), resourceAllocations.begin (), resourceAllocations.end ());
+        bufferResources.push_back (res.get ());
+    });
+
+    // one allocation per arena, after the buffers
+    Utils::ForEach<UniformArenaBufferResource> (connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<UniformArenaBufferResource>& res) {
+        if (IsCulled (res.get ()) || !res->arena->IsCompiled ()) {
+            return;
+        }
+
+        if (std::find (arenas.begin (), arenas.end (), res->arena.get ()) != arenas.end ()) {
+            return;
+        }
+
+        allocations.push_back (res->arena->GetAllocation ());
+        arenas.push_back (res->arena.get ());
+    });
+
+    const GVK::Allocator::DefragmentationResult result = graphSettings.GetDevice ().GetAllocatorObject ().Defragment (allocations);
+
+    std::vector<Operation*> recompiledOperations;
+
+    size_t firstAllocationIndex = 0;
+    for (CPUBufferResource* res : bufferResources) {
+        const auto              first = result.moved.begin () + firstAllocationIndex;
+        const std::vector<bool> moved (first, first + res->buffers.size ());
+
+        firstAllocationIndex += res->buffers.size ();
+
+        if (std::none_of (moved.begin (), moved.end (), [] (bool m) { return m; })) {
+            continue;
+        }
+
+        res->BindMovedAllocations (graphSettings, moved);
+
+        // the descriptor sets refer to the previous buffers
+        for (const std::shared_ptr<Operation>& op : connectionSet.GetPointingTo<Operation> (res)) {
+            recompiledOperations.push_back (op.get ());
+        }
+        for (const std::shared_ptr<Operation>& op : connectionSet.GetPointingHere<Operation> (res)) {
+            recompiledOperations.push_back (op.get ());
+        }
+    }
+
+    for (UniformArena* arena : arenas) {
+        const bool moved = result.moved[firstAllocationIndex++];
+        if (!moved) {
+            continue;
+        }
+
+        arena->BindMovedAllocation (graphSettings);
+
+        // every block of the arena is in the recreated buffer
+        Utils::ForEach<UniformArenaBufferResource> (connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<UniformArenaBufferResource>& res) {
+            if (res->arena.get () != arena) {
+                return;
+            }
+
+            for (const std::shared_ptr<Operation>& op : connectionSet.GetPointingTo<Operation> (res.get ())) {
+                recompiledOperations.push_back (op.get ());
+            }
+            for (const std::shared_ptr<Operation>& op : connectionSet.GetPointingHere<Operation> (res.get ())) {
+                recompiledOperations.push_back (op.get ());
+            }
+        });
+    }
+
+    if (!recompiledOperations.empty ()) {
+        RecompileOperations (recompiledOperations);
+    }
+
+    return result;
+}
+
+
+void RenderGraph::PrepareDescriptorAllocator ()
+{
+    const VkDevice device = graphSettings.GetDevice ();
+
+    if (descriptorAllocator == nullptr || descriptorAllocator->GetDevice () != device || descriptorAllocator->GetArenaCount () != graphSettings.framesInFlight) {
+        descriptorAllocator = std::make_unique<GVK::DescriptorAllocator> (device, graphSettings.framesInFlight);
+    } else {
+        // the device is idle when compiling, the descriptor sets of the previous compilation are not in use
+        descriptorAllocator->Reset ();
+    }
+
+    // every operation allocates one descriptor set per frame in flight, so one arena has to fit one set of each operation
+    std::vector<VkDescriptorPoolSize> aggregatePoolSizes;
+    uint32_t                          setCount = 0;
+
+    for (Pass& pass : passes) {
+        for (Operation* op : pass.GetAllOperations ()) {
+            const std::vector<VkDescriptorPoolSize> opPoolSizes = op->GetDescriptorPoolSizes ();
+            if (opPoolSizes.empty ()) {
+                continue;
+            }
+
+            aggregatePoolSizes.insert (aggregatePoolSizes.end (), opPoolSizes.begin (), opPoolSizes.end ());
+            ++setCount;
+        }
+    }
+
+    descriptorAllocator->SetPoolSizes (aggregatePoolSizes, setCount);
+
+    graphSettings.descriptorAllocator = descriptorAllocator.get ();
+}
+
+
+// the extent of the image outputs of the operation, nullopt if it has none
+static std::optional<VkExtent2D> GetOutputExtent (const ConnectionSet& connectionSet, const Operation& op)
+{
+    std::optional<VkExtent2D> extent;
+
+    Utils::ForEach<ImageResource> (connectionSet.GetPointingTo<Resource> (&op), [&] (const std::shared_ptr<ImageResource>& imgres) {
+        const VkExtent2D currentExtent = { imgres->GetImages ()[0]->GetWidth (), imgres->GetImages ()[0]->GetHeight () };
+
+        if (!extent.has_value ()) {
+            extent = currentExtent;
+        } else if (extent->width != currentExtent.width || extent->height != currentExtent.height) {
+            throw std::runtime_error ("inconsistent output image extents");
+        }
+    });
+
+    return extent;
+}
+
+
+void RenderGraph::CompileOperations (const std::vector<bool>& selectedOperations)
+{
+    for (Pass& pass : passes) {
+        for (Operation* op : pass.GetAllOperations ()) {
+            MergedRenderPass* merged = GetMergedRenderPass (op);
+            if (merged != nullptr && merged->GetFirstOperation () != op) {
+                continue;
+            }
+
+            if (selectedOperations.empty () || selectedOperations[GetNodeIndex (op)]) {
+                CompileOperation (*op);
+            }
+        }
+    }
+}
+
+
+void RenderGraph::CompileOperation (Operation& op)
+{
+    // the operations of a merged render pass are compiled together, with the extent of their attachments
+    if (MergedRenderPass* merged = GetMergedRenderPass (&op)) {
+        merged->Compile (graphSettings);
+        compileStats.compiledPipelines += merged->GetSubpassCount ();
+        return;
+    }
+
+    if (const std::optional<VkExtent2D> extent = GetOutputExtent (graphSettings.connectionSet, op)) {
+        op.CompileWithExtent (graphSettings, extent->width, extent->height);
+    } else {
+        op.Compile (graphSettings);
+    }
+
+    ++compileStats.compiledPipelines;
+}
+
+
+void RenderGraph::CreatePasses ()
+{
+    passes.clear ();
+
+    // operations in the same level do not depend on each other, the barriers are recorded between the levels
+    for (const std::vector<Operation*>& level : GetDependencyLevels (graphSettings.connectionSet, culledNodeFlags)) {
+        Pass pass;
+        for (Operation* op : level) {
+            for (const std::shared_ptr<Resource>& input : graphSettings.connectionSet.GetPointingHere<Resource> (op)) {
+                pass.AddInput (op, input.get ());
+            }
+            for (const std::shared_ptr<Resource>& output : graphSettings.connectionSet.GetPointingTo<Resource> (op)) {
+                pass.AddOutput (op, output.get ());
+            }
+        }
+        if (!pass.IsEmpty ()) {
+            passes.push_back (std::move (pass));
+        }
+    }
+}
+
+
+MergedRenderPass* RenderGraph::GetMergedRenderPass (const Operation* op) const
+{
+    const uint32_t nodeIndex = GetNodeIndex (op);
+    return nodeIndex < mergedRenderPassOfNode.size () ? mergedRenderPassOfNode[nodeIndex] : nullptr;
+}
+
+
+bool RenderGraph::IsInternalAttachment (const Resource* res) const
+{
+    const uint32_t nodeIndex = GetNodeIndex (res);
+    return nodeIndex < internalAttachments.size () && internalAttachments[nodeIndex];
+}
+
+
+static bool ContainsImage (const std::vector<MergedRenderPass::ImageLayer>& images, const Resource* res)
+{
+    return std::any_of (images.begin (), images.end (), [&] (const MergedRenderPass::ImageLayer& image) {
+        return image.resource == res;
+    });
+}
+
+
+void RenderGraph::MergeRenderOperations ()
+{
+    const ConnectionSet& connectionSet = graphSettings.connectionSet;
+    const uint32_t       nodeCount     = connectionSet.GetNodeCount ();
+
+    mergedRenderPasses.clear ();
+    mergedRenderPassOfNode.assign (nodeCount, nullptr);
+    internalAttachments.assign (nodeCount, false);
+
+    if (!graphSettings.mergeRenderOperations) {
+        return;
+    }
+
+    // the attachments of the operations are found by their image views
+    std::unordered_map<VkImageView, MergedRenderPass::ImageLayer> imageViews;
+    Utils::ForEach<WritableImageResource> (connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<WritableImageResource>& img) {
+        if (IsCulled (img.get ()) || !img->CanBeAliased ()) {
+            return;
+        }
+        for (uint32_t layerIndex = 0; layerIndex < img->GetLayerCount (); ++layerIndex) {
+            imageViews[img->GetImageViewForFrame (0, layerIndex)] = { img.get (), layerIndex };
+        }
+    });
+
+    // by node index
+    std::vector<uint32_t> passIndices (nodeCount, ConnectionSet::InvalidIndex);
+    for (uint32_t passIndex = 0; passIndex < passes.size (); ++passIndex) {
+        for (Operation* op : passes[passIndex].GetAllOperations ()) {
+            passIndices[GetNodeIndex (op)] = passIndex;
+        }
+    }
+
+    const auto GetPassIndex = [&] (const Operation* op) {
+        return passIndices[GetNodeIndex (op)];
+    };
+
+    // by node index, filled when first needed
+    std::vector<std::optional<MergedRenderPass::OperationAttachments>> attachmentsOfOperations (nodeCount);
+    std::vector<bool>                                                  attachmentsCollected (nodeCount, false);
+
+    // nullptr if the operation cannot be a subpass
+    const auto GetAttachments = [&] (RenderOperation& op) -> const MergedRenderPass::OperationAttachments* {
+        const uint32_t opIndex = GetNodeIndex (&op);
+        if (!attachmentsCollected[opIndex]) {
+            std::optional<MergedRenderPass::OperationAttachments> attachments = MergedRenderPass::GetOperationAttachments (op, imageViews);
+
+            const std::vector<std::shared_ptr<Resource>> inputs  = connectionSet.GetPointingHere<Resource> (&op);
+            const std::vector<std::shared_ptr<Resource>> outputs = connectionSet.GetPointingTo<Resource> (&op);
+
+            const auto IsInput = [&] (const MergedRenderPass::ImageLayer& image) {
+                return std::find_if (inputs.begin (), inputs.end (), [&] (const std::shared_ptr<Resource>& res) { return res.get () == image.resource; }) != inputs.end ();
+            };
+            const auto IsOutput = [&] (const MergedRenderPass::ImageLayer& image) {
+                return std::find_if (outputs.begin (), outputs.end (), [&] (const std::shared_ptr<Resource>& res) { return res.get () == image.resource; }) != outputs.end ();
+            };
+
+            // the graph has to know about every attachment, and reading and writing the same image would be a feedback loop
+            const bool valid = attachments.has_value () &&
+                               !attachments->colorAttachments.empty () &&
+                               std::all_of (attachments->colorAttachments.begin (), attachments->colorAttachments.end (), [&] (const MergedRenderPass::ImageLayer& image) { return IsOutput (image) && !IsInput (image); }) &&
+                               std::all_of (attachments->inputAttachments.begin (), attachments->inputAttachments.end (), [&] (const MergedRenderPass::ImageLayer& image) { return IsInput (image) && !IsOutput (image); });
+
+            if (!valid) {
+                attachments.reset ();
+            }
+
+            attachmentsOfOperations[opIndex] = std::move (attachments);
+            attachmentsCollected[opIndex]    = true;
+        }
+        return attachmentsOfOperations[opIndex].has_value () ? &*attachmentsOfOperations[opIndex] : nullptr;
+    };
+
+    // images read by the operation with a sampler, these cannot be attachments in the same render pass
+    const auto IsSampledBy = [&] (RenderOperation& op, const Resource* res) {
+        const std::vector<std::shared_ptr<Resource>> inputs = connectionSet.GetPointingHere<Resource> (&op);
+
+        const bool isInput = std::find_if (inputs.begin (), inputs.end (), [&] (const std::shared_ptr<Resource>& input) { return input.get () == res; }) != inputs.end ();
+        return isInput && !ContainsImage (GetAttachments (op)->inputAttachments, res);
+    };
+
+    const auto IsAttachmentOf = [&] (RenderOperation& op, const Resource* res) {
+        const MergedRenderPass::OperationAttachments& attachments = *GetAttachments (op);
+        return ContainsImage (attachments.colorAttachments, res) || ContainsImage (attachments.inputAttachments, res);
+    };
+
+    const auto CanAppend = [&] (const std::vector<RenderOperation*>& chain, RenderOperation& next) {
+        if (GetPassIndex (&next) != GetPassIndex (chain.back ()) + 1 || GetAttachments (next) == nullptr) {
+            return false;
+        }
+
+        const MergedRenderPass::OperationAttachments& nextAttachments = *GetAttachments (next);
+        const MergedRenderPass::OperationAttachments& headAttachments = *GetAttachments (*chain.front ());
+
+        const WritableImageResource& headImage = *headAttachments.colorAttachments[0].resource;
+        const WritableImageResource& nextImage = *nextAttachments.colorAttachments[0].resource;
+        if (headImage.width != nextImage.width || headImage.height != nextImage.height) {
+            return false;
+        }
+
+        const auto InChain = [&] (const Operation* op) {
+            return std::find (chain.begin (), chain.end (), op) != chain.end ();
+        };
+
+        const uint32_t headPassIndex = GetPassIndex (chain.front ());
+
+        bool readsChain = false;
+        for (const std::shared_ptr<Resource>& input : connectionSet.GetPointingHere<Resource> (&next)) {
+            for (const std::shared_ptr<Operation>& writer : connectionSet.GetPointingHere<Operation> (input.get ())) {
+                if (IsCulled (writer.get ())) {
+                    continue;
+                }
+
+                if (InChain (writer.get ())) {
+                    // written in the render pass, it can only be read at the same pixel
+                    if (!ContainsImage (nextAttachments.inputAttachments, input.get ())) {
+                        return false;
+                    }
+                    readsChain = true;
+                } else if (GetPassIndex (writer.get ()) >= headPassIndex) {
+                    // the writer would be recorded after the render pass
+                    return false;
+                }
+            }
+        }
+
+        if (!readsChain) {
+            return false;
+        }
+
+        for (const std::shared_ptr<Resource>& output : connectionSet.GetPointingTo<Resource> (&next)) {
+            for (const std::shared_ptr<Operation>& writer : connectionSet.GetPointingHere<Operation> (output.get ())) {
+                if (writer.get () != &next && !IsCulled (writer.get ())) {
+                    return false;
+                }
+            }
+        }
+
+        // images are either attachments or sampled in the whole render pass
+        for (RenderOperation* op : chain) {
+            for (const std::shared_ptr<Resource>& input : connectionSet.GetPointingHere<Resource> (&next)) {
+                if (IsSampledBy (next, input.get ()) && IsAttachmentOf (*op, input.get ())) {
+                    return false;
+                }
+            }
+            for (const std::shared_ptr<Resource>& input : connectionSet.GetPointingHere<Resource> (op)) {
+                if (IsSampledBy (*op, input.get ()) && IsAttachmentOf (next, input.get ())) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    };
+
+    std::vector<std::vector<RenderOperation*>> chains;
+    std::vector<bool>                          chainedOperations (nodeCount, false); // by node index
+
     for (Pass& pass : passes) {
         for (Operation* op : pass.GetAllOperations ()) {
-            ImageResource* firstImgRes = nullptr;
-
-            for (Resource* res : pass.GetAllOutputs ()) {
-                if (ImageResource* imgres = dynamic_cast<ImageResource*> (res)) {
-                    if (firstImgRes == nullptr) {
-                        firstImgRes = imgres;
-                    } else {
-                        const uint32_t firstWidth  = firstImgRes->GetImages ()[0]->GetWidth ();
-                        const uint32_t firstHeight = firstImgRes->GetImages ()[0]->GetHeight ();
+            RenderOperation* head = dynamic_cast<RenderOperation*> (op);
+            if (head == nullptr || chainedOperations[GetNodeIndex (head)] || GetAttachments (*head) == nullptr) {
+                continue;
+            }
 
-                        const uint32_t currentWidth  = imgres->GetImages ()[0]->GetWidth ();
-                        const uint32_t currentHeight = imgres->GetImages ()[0]->GetHeight ();
+            std::vector<RenderOperation*> chain { head };
 
-                        if (firstWidth != currentWidth || firstHeight != currentHeight) {
-                            throw std::runtime_error ("inconsistent output image extents");
+            bool appended = true;
+            while (appended) {
+                appended = false;
+                for (const std::shared_ptr<Resource>& output : connectionSet.GetPointingTo<Resource> (chain.back ())) {
+                    for (const std::shared_ptr<RenderOperation>& reader : connectionSet.GetPointingTo<RenderOperation> (output.get ())) {
+                        if (!appended && !IsCulled (reader.get ()) && !chainedOperations[GetNodeIndex (reader.get ())] && CanAppend (chain, *reader)) {
+                            chain.push_back (reader.get ());
+                            appended = true;
                         }
                     }
                 }
             }
 
-            if (firstImgRes == nullptr) {
-                op->Compile (graphSettings);
-            } else {
-                op->CompileWithExtent (graphSettings, firstImgRes->GetImages ()[0]->GetWidth (), firstImgRes->GetImages ()[0]->GetHeight ());
+            if (chain.size () > 1) {
+                for (RenderOperation* chained : chain) {
+                    chainedOperations[GetNodeIndex (chained)] = true;
+                }
+                chains.push_back (std::move (chain));
             }
         }
     }
-}
 
-
-Pass RenderGraph::GetNextPass (const Pass& lastPass) const
-{
-    Pass result;
-
-    for (Operation* op : lastPass.GetAllOperations ()) {
-        for (const std::shared_ptr<Resource>& res : graphSettings.connectionSet.GetPointingTo<Resource> (op)) {
-            for (const std::shared_ptr<Operation>& nextOp : graphSettings.connectionSet.GetPointingTo<Operation> (res.get ())) {
-                result.AddInput (nextOp.get (), res.get ());
-            }
-        }
+    if (chains.empty ()) {
+        return;
     }
 
-    for (auto& op : result.GetAllOperations ()) {
-        std::vector<std::shared_ptr<Resource>> allInputs  = graphSettings.connectionSet.GetPointingHere<Resource> (op);
-        std::vector<std::shared_ptr<Resource>> allOutputs = graphSettings.connectionSet.GetPointingTo<Resource> (op);
-        for (std::shared_ptr<Resource> input : allInputs) {
-            result.AddInput (op, input.get ());
-        }
-        for (std::shared_ptr<Resource> output : allOutputs) {
-            result.AddOutput (op, output.get ());
+    for (const std::vector<RenderOperation*>& chain : chains) {
+        const auto InChain = [&] (const Operation* op) {
+            return std::find (chain.begin (), chain.end (), op) != chain.end ();
+        };
+
+        std::vector<MergedRenderPass::OperationAttachments> chainAttachments;
+        for (RenderOperation* op : chain) {
+            chainAttachments.push_back (*GetAttachments (*op));
         }
-    }
 
-    return result;
-}
+        // images written first and read only in the render pass do not need memory outside of it
+        std::unordered_set<const Resource*> internalResources;
+        for (RenderOperation* op : chain) {
+            for (const MergedRenderPass::ImageLayer& image : GetAttachments (*op)->colorAttachments) {
+                WritableImageResource* img = image.resource;
 
+                const std::vector<std::shared_ptr<Operation>> writers = connectionSet.GetPointingHere<Operation> (img);
+                const std::vector<std::shared_ptr<Operation>> readers = connectionSet.GetPointingTo<Operation> (img);
 
-Pass RenderGraph::GetFirstPass () const
-{
-    std::set<Operation*>    allOpSet;
-    std::vector<Operation*> allOp;
+                const auto IsUsedOnlyInChain = [&] (const std::shared_ptr<Operation>& user) {
+                    return IsCulled (user.get ()) || InChain (user.get ());
+                };
 
-    Utils::ForEach<Operation> (graphSettings.connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<Operation>& op) {
-        const std::vector<std::shared_ptr<Resource>> opInputs = graphSettings.connectionSet.GetPointingHere<Resource> (op.get ());
+                const bool readInChainFirst = std::any_of (chain.begin (), std::find (chain.begin (), chain.end (), op), [&] (RenderOperation* previous) {
+                    return IsAttachmentOf (*previous, img);
+                });
 
-        const bool allInputsAreFirstWrittenByThisOp = std::all_of (opInputs.begin (), opInputs.end (), [&] (const std::shared_ptr<Resource>& res) {
-            return graphSettings.connectionSet.GetPointingHere<Node> (res.get ()).empty ();
-        });
+                if (img->CanBeAliased () && !IsSinkResource (connectionSet, *img) && !readInChainFirst &&
+                    std::all_of (writers.begin (), writers.end (), IsUsedOnlyInChain) &&
+                    std::all_of (readers.begin (), readers.end (), IsUsedOnlyInChain)) {
+                    internalResources.insert (img);
+                }
+            }
+        }
 
-        if (allInputsAreFirstWrittenByThisOp || opInputs.empty ())
-            if (allOpSet.insert (op.get ()).second)
-                allOp.push_back (op.get ());
-    });
+        std::unique_ptr<MergedRenderPass> merged = std::make_unique<MergedRenderPass> (chain, std::move (chainAttachments), internalResources);
+        for (RenderOperation* op : chain) {
+            mergedRenderPassOfNode[GetNodeIndex (op)] = merged.get ();
+        }
+        for (const Resource* res : internalResources) {
+            internalAttachments[GetNodeIndex (res)] = true;
+        }
+        mergedRenderPasses.push_back (std::move (merged));
 
-    Pass actualResult;
+        // the subpasses are recorded in the pass of the first operation
+        const uint32_t headPassIndex = GetPassIndex (chain.front ());
+        for (size_t i = 1; i < chain.size (); ++i) {
+            Pass&              fromPass = passes[GetPassIndex (chain[i])];
+            Pass::OperationIO* toMove   = fromPass.GetOperationIO (chain[i]);
 
-    for (Operation* op : allOp) {
-        std::vector<std::shared_ptr<Resource>> allInputs  = graphSettings.connectionSet.GetPointingHere<Resource> (op);
-        std::vector<std::shared_ptr<Resource>> allOutputs = graphSettings.connectionSet.GetPointingTo<Resource> (op);
-        for (std::shared_ptr<Resource> input : allInputs) {
-            actualResult.AddInput (op, input.get ());
-        }
-        for (std::shared_ptr<Resource> output : allOutputs) {
-            actualResult.AddOutput (op, output.get ());
+            Pass::OperationIO moved = *toMove;
+            fromPass.RemoveOperationIO (toMove);
+            passes[headPassIndex].AddOperationIO (&moved);
         }
     }
 
-    return actualResult;
-}
+    passes.erase (std::remove_if (passes.begin (), passes.end (), [] (const Pass& pass) { return pass.IsEmpty (); }), passes.end ());
 
+    // the lifetimes changed, and the attachments of the render passes are created for them
+    const std::vector<std::optional<ResourceLifetime>> previousTransientLifetimes = transientLifetimes;
 
-void RenderGraph::CreatePasses ()
-{
-    passes.clear ();
-    
-    Pass nextPass = GetFirstPass ();
-    do {
-        passes.push_back (nextPass);
-        nextPass = GetNextPass (nextPass);
-    } while (!nextPass.GetAllOperations ().empty ());
+    CollectTransientResources ();
 
-    SeparatePasses ();
-}
+    Utils::ForEach<WritableImageResource> (connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<WritableImageResource>& img) {
+        if (IsInternalAttachment (img.get ())) {
+            img->CompileTransientAttachment (graphSettings);
+        } else if (previousTransientLifetimes[GetNodeIndex (img.get ())].has_value () && !IsTransient (img.get ())) {
+            img->Compile (graphSettings);
+        }
+    });
 
+    CompileTransientImages ();
+}
 
-struct OutputHitCount {
-    std::unordered_map<Resource*, std::vector<Operation*>> hitCount;
-    std::vector<Resource*>                                 insertionOrder;
-};
 
-static OutputHitCount GetOutputHitCount (Pass pass)
+void RenderGraph::CollectAsyncComputeOperations ()
 {
-    const std::vector<Operation*> operations = pass.GetAllOperations ();
+    asyncComputeOperations.clear ();
 
-    OutputHitCount result;
+    if (!graphSettings.useAsyncCompute || !graphSettings.GetDevice ().HasAsyncComputeQueue () || passes.empty ()) {
+        return;
+    }
 
-    for (const auto op : operations) {
-        const auto opIO = pass.GetOperationIO (op);
-        for (Resource* output : opIO->outputs) {
-            const bool contains = result.hitCount.find (output) != result.hitCount.end ();
-            result.hitCount[output].push_back (op);
-            if (!contains) {
-                result.insertionOrder.push_back (output);
-            }
+    // operations in the first pass do not depend on any other operation, so they can run ahead on the compute queue
+    // image layout transitions are recorded on the graphics queue, only compute operations using buffers are moved
+    for (Operation* op : passes[0].GetAllOperations ()) {
+        if (dynamic_cast<ComputeOperation*> (op) == nullptr) {
+            continue;
         }
-    }
 
-    return result;
+        bool usesImages = false;
+        Utils::ForEach<ImageResource> (graphSettings.connectionSet.GetPointingHere<Resource> (op), [&] (const std::shared_ptr<ImageResource>&) {
+            usesImages = true;
+        });
+        Utils::ForEach<ImageResource> (graphSettings.connectionSet.GetPointingTo<Resource> (op), [&] (const std::shared_ptr<ImageResource>&) {
+            usesImages = true;
+        });
+
+        if (!usesImages) {
+            asyncComputeOperations.push_back (op);
+        }
+    }
 }
 
 
-static bool HasMultipleOperationsToOneOutput (Pass pass)
+bool RenderGraph::IsAsyncComputeOperation (const Operation* op) const
 {
-    const OutputHitCount outputCount = GetOutputHitCount (pass);
+    return std::find (asyncComputeOperations.begin (), asyncComputeOperations.end (), op) != asyncComputeOperations.end ();
+}
 
-    for (const auto& oc : outputCount.hitCount) {
-        if (oc.second.size () > 1) {
-            return true;
-        }
+
+void RenderGraph::RecordAsyncComputeCommandBuffers ()
+{
+    computeCommandBuffers.clear ();
+    computeTimeline.reset ();
+    graphicsTimeline.reset ();
+    computeTimelineValue  = 0;
+    graphicsTimelineValue = 0;
+    lastGraphicsTimelineValues.clear ();
+
+    if (asyncComputeOperations.empty ()) {
+        return;
     }
 
-    return false;
-}
+    const GVK::DeviceExtra& device = graphSettings.GetDevice ();
 
+    // a compute only queue does not support the graphics stages, so the barriers are narrower than on the graphics queue
+    const VkAccessFlags computeMask = VK_ACCESS_UNIFORM_READ_BIT |
+                                      VK_ACCESS_SHADER_READ_BIT |
+                                      VK_ACCESS_SHADER_WRITE_BIT |
+                                      VK_ACCESS_TRANSFER_READ_BIT |
+                                      VK_ACCESS_TRANSFER_WRITE_BIT;
 
-void RenderGraph::SeparatePasses ()
-{
-    std::vector<Pass> newPasses { passes };
+    VkMemoryBarrier flushComputeMemory = {};
+    flushComputeMemory.sType           = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    flushComputeMemory.srcAccessMask   = computeMask;
+    flushComputeMemory.dstAccessMask   = computeMask;
 
-    bool seperationHappened = false;
+    for (uint32_t frameIndex = 0; frameIndex < graphSettings.framesInFlight; ++frameIndex) {
+        GVK::CommandBuffer& currentCmdbuffer = computeCommandBuffers.emplace_back (device, device.GetComputeCommandPool ());
 
-    for (size_t i = 0; i < newPasses.size (); ++i) {
-        const bool needsSeperation = HasMultipleOperationsToOneOutput (newPasses[i]);
-        if (needsSeperation) {
-            const OutputHitCount hitCount = GetOutputHitCount (newPasses[i]);
+        currentCmdbuffer.SetName (device, fmt::format ("Compute CommandBuffer {}/{}", frameIndex, graphSettings.framesInFlight));
 
-            if (i == newPasses.size () - 1) {
-                newPasses.emplace_back ();
-            }
+        currentCmdbuffer.Begin ();
 
-            Resource*               firstResourceToSplitOn = hitCount.insertionOrder[0];
-            std::vector<Operation*> operationsToSplit      = hitCount.hitCount.find (firstResourceToSplitOn)->second;
+        if (profiler != nullptr) {
+            profiler->RecordReset (frameIndex, OperationProfiler::SubmitQueue::AsyncCompute, currentCmdbuffer);
+        }
 
-            Operation* firstOperation  = operationsToSplit[0];
-            Operation* secondOperation = operationsToSplit[1];
+        for (Operation* op : asyncComputeOperations) {
+            std::unique_ptr<GVK::CommandPipelineBarrier> barrier = std::make_unique<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                                                                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+            barrier->AddMemoryBarrier (flushComputeMemory);
+            currentCmdbuffer.RecordCommand (std::move (barrier))
+                .SetName ("Barrier for async compute");
 
-            Pass::OperationIO* toMove = newPasses[i].GetOperationIO (secondOperation);
+            if (profiler != nullptr) {
+                profiler->RecordBegin (frameIndex, op, currentCmdbuffer);
+            }
 
-            newPasses[i + 1].AddOperationIO (toMove);
-            newPasses[i].RemoveOperationIO (toMove);
+            op->Record (graphSettings.connectionSet, frameIndex, currentCmdbuffer);
 
-            seperationHappened = true;
-            break;
+            if (profiler != nullptr) {
+                profiler->RecordEnd (frameIndex, op, currentCmdbuffer);
+            }
         }
+
+        currentCmdbuffer.End ();
     }
 
-    passes = newPasses;
+    computeTimeline  = std::make_unique<GVK::TimelineSemaphore> (device);
+    graphicsTimeline = std::make_unique<GVK::TimelineSemaphore> (device);
+    computeTimeline->SetName (device, "RenderGraph Compute Timeline");
+    graphicsTimeline->SetName (device, "RenderGraph Graphics Timeline");
 
-    if (seperationHappened)
-        SeparatePasses ();
+    lastGraphicsTimelineValues.resize (graphSettings.framesInFlight, 0);
 }
 
 
@@ -236,7 +1113,11 @@ void RenderGraph::DebugPrint ()
         const Pass& pass = passes[i];
         logString << "Pass " << i << std::endl;
         for (const Operation* op : pass.GetAllOperations ()) {
-            logString << "\tOperation \"" << op->GetName () << "\" (debugInfo: \"" << op->GetDebugInfo () << "\", " << op->GetUUID ().GetValue () << ")" << std::endl;
+            const MergedRenderPass* merged = GetMergedRenderPass (op);
+            const std::string       subpass = (merged != nullptr)
+                                                  ? fmt::format (" [subpass {} of {}]", std::find (merged->GetOperations ().begin (), merged->GetOperations ().end (), op) - merged->GetOperations ().begin (), merged->GetSubpassCount ())
+                                                  : "";
+            logString << "\tOperation \"" << op->GetName () << "\" (debugInfo: \"" << op->GetDebugInfo () << "\", " << op->GetUUID ().GetValue () << ")" << (IsAsyncComputeOperation (op) ? " [async compute]" : "") << subpass << std::endl;
             logString << "\tInputs:" << std::endl;
             auto resinp = graphSettings.connectionSet.GetPointingHere<Resource> (op);
             for (auto res : resinp) {
@@ -250,6 +1131,38 @@ void RenderGraph::DebugPrint ()
         }
     }
 
+    const bool hasTransients = std::any_of (transientLifetimes.begin (), transientLifetimes.end (), [] (const std::optional<ResourceLifetime>& lifetime) {
+        return lifetime.has_value ();
+    });
+
+    if (hasTransients) {
+        logString << "Transient" << std::endl;
+        for (uint32_t nodeIndex = 0; nodeIndex < transientLifetimes.size (); ++nodeIndex) {
+            const std::optional<ResourceLifetime>& lifetime = transientLifetimes[nodeIndex];
+            if (lifetime.has_value ()) {
+                const std::shared_ptr<Node>& res = graphSettings.connectionSet.GetNodeByIndex (nodeIndex);
+                logString << "\tResource \"" << res->GetName () << "\" (debugInfo: \"" << res->GetDebugInfo () << "\", id: " << res->GetUUID ().GetValue () << ") passes " << lifetime->firstPass << " - " << lifetime->lastPass << std::endl;
+            }
+        }
+    }
+
+    if (std::find (internalAttachments.begin (), internalAttachments.end (), true) != internalAttachments.end ()) {
+        logString << "Internal attachments" << std::endl;
+        for (uint32_t nodeIndex = 0; nodeIndex < internalAttachments.size (); ++nodeIndex) {
+            if (internalAttachments[nodeIndex]) {
+                const std::shared_ptr<Node>& res = graphSettings.connectionSet.GetNodeByIndex (nodeIndex);
+                logString << "\tResource \"" << res->GetName () << "\" (debugInfo: \"" << res->GetDebugInfo () << "\", id: " << res->GetUUID ().GetValue () << ")" << std::endl;
+            }
+        }
+    }
+
+    if (!culledNodes.empty ()) {
+        logString << "Culled" << std::endl;
+        for (const std::shared_ptr<Node>& node : culledNodes) {
+            logString << "\t" << (dynamic_cast<const Operation*> (node.get ()) != nullptr ? "Operation" : "Resource") << " \"" << node->GetName () << "\" (debugInfo: \"" << node->GetDebugInfo () << "\", id: " << node->GetUUID ().GetValue () << ")" << std::endl;
+        }
+    }
+
     spdlog::info ("======= Render graph begin =======");
     spdlog::info ("{}", logString.str ());
     spdlog::info ("======= Render graph end =========");
@@ -257,25 +1170,175 @@ void RenderGraph::DebugPrint ()
 
 
 Utils::CommandLineOnOffFlag printRenderGraphFlag { "--printRenderGraph", "Prints render graph passes, operatins, resources." };
+Utils::CommandLineOnOffFlag profileOperationsFlag { "--profileOperations", "Measures the GPU time of every render graph operation." };
+
+
+void RenderGraph::CreateProfiler ()
+{
+    profiler.reset ();
+
+    if (!graphSettings.profileOperations && !profileOperationsFlag.IsFlagOn ()) {
+        return;
+    }
+
+    // in the order they are recorded
+    std::vector<Operation*> graphicsOperations;
+    for (Pass& pass : passes) {
+        for (Operation* op : pass.GetAllOperations ()) {
+            if (!IsAsyncComputeOperation (op)) {
+                graphicsOperations.push_back (op);
+            }
+        }
+    }
+
+    profiler = std::make_unique<OperationProfiler> (graphSettings.GetDevice (), graphSettings.framesInFlight, graphicsOperations, asyncComputeOperations);
+}
 
 
 void RenderGraph::Compile (GraphSettings&& graphSettings_)
 {
+    Utils::TraceScope traceScope ("RenderGraph::Compile", "RenderGraph");
+
     graphSettings = std::move (graphSettings_);
 
     graphSettings.GetDevice ().Wait ();
     graphSettings.GetDevice ().GetGraphicsQueue ().Wait ();
 
+    compileStats = { 0, 0, 0, 0 };
+
+    CullDeadNodes ();
+
     CreatePasses ();
 
+    mergedRenderPasses.clear ();
+    mergedRenderPassOfNode.clear ();
+    internalAttachments.clear ();
+
+    CollectTransientResources ();
+
+    CompileResources ();
+
+    // needs the compiled images to find the attachments
+    MergeRenderOperations ();
+
+    CollectAsyncComputeOperations ();
+
     if (printRenderGraphFlag.IsFlagOn ()) {
         DebugPrint ();
     }
 
-    CompileResources ();
+    PrepareDescriptorAllocator ();
 
     CompileOperations ();
 
+    CreateProfiler ();
+
+    RecordCommandBuffers ();
+
+    NameAllocations ();
+
+    compiled = true;
+}
+
+
+void RenderGraph::RecompileSwapchainImages ()
+{
+    Utils::TraceScope traceScope ("RenderGraph::RecompileSwapchainImages", "RenderGraph");
+
+    GVK_ASSERT (compiled);
+
+    graphSettings.GetDevice ().Wait ();
+    graphSettings.GetDevice ().GetGraphicsQueue ().Wait ();
+
+    compileStats = { 0, 0, 0, 0 };
+
+    const ConnectionSet& connectionSet = graphSettings.connectionSet;
+    const uint32_t       nodeCount     = connectionSet.GetNodeCount ();
+
+    std::vector<bool> swapchainImages (nodeCount, false); // by node index
+
+    Utils::ForEach<SwapchainImageResource> (connectionSet.GetNodesByInsertionOrder (), [&] (const std::shared_ptr<SwapchainImageResource>& res) {
+        if (IsCulled (res.get ())) {
+            return;
+        }
+
+        // the passes, the profiler and the descriptor allocator are created for this many frames in flight
+        GVK_ASSERT (res->swapchainProv.GetSwapchain ().GetImageCount () == graphSettings.framesInFlight);
+
+        res->Compile (graphSettings);
+        swapchainImages[GetNodeIndex (res.get ())] = true;
+        ++compileStats.compiledResources;
+    });
+
+    const auto UsesSwapchainImage = [&] (const std::vector<uint32_t>& resourceIndices) {
+        return std::any_of (resourceIndices.begin (), resourceIndices.end (), [&] (uint32_t resourceIndex) {
+            return swapchainImages[resourceIndex];
+        });
+    };
+
+    std::vector<bool> recompiledOperations (nodeCount, false); // by node index
+
+    for (Pass& pass : passes) {
+        for (Operation* op : pass.GetAllOperations ()) {
+            const uint32_t opIndex = GetNodeIndex (op);
+            const bool     reads   = UsesSwapchainImage (connectionSet.GetResourceIndicesPointingHere (opIndex));
+            const bool     writes  = UsesSwapchainImage (connectionSet.GetResourceIndicesPointingTo (opIndex));
+
+            if (!reads && !writes) {
+                continue;
+            }
+
+            MergedRenderPass* merged   = GetMergedRenderPass (op);
+            RenderOperation*  renderOp = dynamic_cast<RenderOperation*> (op);
+
+            if (!reads && merged == nullptr && renderOp != nullptr) {
+                // viewport and scissor are dynamic state, only the attachments depend on the extent
+                const std::optional<VkExtent2D> extent = GetOutputExtent (connectionSet, *op);
+                renderOp->CompileFramebuffers (graphSettings, extent->width, extent->height);
+                ++compileStats.compiledFramebuffers;
+            } else {
+                // the descriptors refer to the image views of the swapchain images
+                recompiledOperations[GetNodeIndex (merged != nullptr ? merged->GetFirstOperation () : op)] = true;
+            }
+        }
+    }
+
+    CompileOperations (recompiledOperations);
+
+    RecordCommandBuffers ();
+}
+
+
+void RenderGraph::RecompileOperations (const std::vector<Operation*>& operations)
+{
+    Utils::TraceScope traceScope ("RenderGraph::RecompileOperations", "RenderGraph");
+
+    GVK_ASSERT (compiled);
+
+    graphSettings.GetDevice ().Wait ();
+    graphSettings.GetDevice ().GetGraphicsQueue ().Wait ();
+
+    compileStats = { 0, 0, 0, 0 };
+
+    std::vector<bool> recompiledOperations (graphSettings.connectionSet.GetNodeCount (), false); // by node index
+
+    for (Operation* op : operations) {
+        if (IsCulled (op)) {
+            continue;
+        }
+
+        MergedRenderPass* merged = GetMergedRenderPass (op);
+        recompiledOperations[GetNodeIndex (merged != nullptr ? merged->GetFirstOperation () : op)] = true;
+    }
+
+    CompileOperations (recompiledOperations);
+
+    RecordCommandBuffers ();
+}
+
+
+void RenderGraph::RecordCommandBuffers ()
+{
     imageLayoutSequence.clear ();
 
     for (Pass& p : passes) {
@@ -319,50 +1382,141 @@ void RenderGraph::Compile (GraphSettings&& graphSettings_)
 
         currentCmdbuffer.Begin ();
 
-        for (Pass& p : passes) {
-            for (auto op : p.GetAllOperations ()) {
-                auto allInputs  = graphSettings.connectionSet.GetPointingHere<Resource> (op);
-                auto allOutputs = graphSettings.connectionSet.GetPointingTo<Resource> (op);
+        if (profiler != nullptr) {
+            profiler->RecordReset (frameIndex, OperationProfiler::SubmitQueue::Graphics, currentCmdbuffer);
+        }
+
+        for (uint32_t passIndex = 0; passIndex < passes.size (); ++passIndex) {
+            Pass& p = passes[passIndex];
+
+            for (auto headOp : p.GetAllOperations ()) {
+                if (IsAsyncComputeOperation (headOp)) {
+                    continue;
+                }
+
+                // the attachments of a merged render pass are transitioned only before its first subpass
+                MergedRenderPass* merged = GetMergedRenderPass (headOp);
+                if (merged != nullptr && merged->GetFirstOperation () != headOp) {
+                    continue;
+                }
+
+                const std::vector<Operation*> subpassOps = (merged != nullptr)
+                                                               ? std::vector<Operation*> (merged->GetOperations ().begin (), merged->GetOperations ().end ())
+                                                               : std::vector<Operation*> { headOp };
+
+                const auto IsMergedAttachment = [&] (const std::shared_ptr<ImageResource>& img) {
+                    return merged != nullptr && merged->IsAttachment (img.get ());
+                };
 
                 std::unique_ptr<GVK::CommandPipelineBarrier> barrier = std::make_unique<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,  // TODO maybe VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT?
                                                                                                                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT); // TODO maybe VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT?
                 barrier->AddMemoryBarrier (flushAllMemory);
-                Utils::ForEach<ImageResource> (allInputs, [&] (const std::shared_ptr<ImageResource>& img) {
-                    for (GVK::Image* image : img->GetImages (frameIndex)) {
-                        const VkImageLayout currentLayout = imageLayoutSequence[*image].back ();
-                        const VkImageLayout newLayout     = op->GetImageLayoutAtStartForInputs (*img);
-                        barrier->AddImageMemoryBarrier (image->GetBarrier (currentLayout, newLayout, fullMask, fullMask));
-                        imageLayoutSequence[*image].push_back (newLayout);
-                    }
-                });
 
-                Utils::ForEach<ImageResource> (allOutputs, [&] (const std::shared_ptr<ImageResource>& img) {
-                    for (GVK::Image* image : img->GetImages (frameIndex)) {
-                        const VkImageLayout currentLayout = imageLayoutSequence[*image].back ();
-                        const VkImageLayout newLayout     = op->GetImageLayoutAtStartForOutputs (*img);
-                        barrier->AddImageMemoryBarrier (image->GetBarrier (currentLayout, newLayout, fullMask, fullMask));
-                        imageLayoutSequence[*image].push_back (newLayout);
+                for (Operation* op : subpassOps) {
+                    auto allInputs  = graphSettings.connectionSet.GetPointingHere<Resource> (op);
+                    auto allOutputs = graphSettings.connectionSet.GetPointingTo<Resource> (op);
+
+                    Utils::ForEach<ImageResource> (allInputs, [&] (const std::shared_ptr<ImageResource>& img) {
+                        if (IsMergedAttachment (img)) {
+                            return;
+                        }
+                        for (GVK::Image* image : img->GetImages (frameIndex)) {
+                            const VkImageLayout currentLayout = imageLayoutSequence[*image].back ();
+                            const VkImageLayout newLayout     = op->GetImageLayoutAtStartForInputs (*img);
+                            barrier->AddImageMemoryBarrier (image->GetBarrier (currentLayout, newLayout, fullMask, fullMask));
+                            imageLayoutSequence[*image].push_back (newLayout);
+                        }
+                    });
+
+                    Utils::ForEach<ImageResource> (allOutputs, [&] (const std::shared_ptr<ImageResource>& img) {
+                        if (IsMergedAttachment (img)) {
+                            return;
+                        }
+
+                        // the memory of a transient image was used by other images before, the barrier flushing all memory
+                        // orders their accesses before this, and the contents are discarded by the transition from undefined
+                        const bool discardContents = IsFirstUseOfTransient (img.get (), passIndex);
+
+                        for (GVK::Image* image : img->GetImages (frameIndex)) {
+                            const VkImageLayout currentLayout = discardContents ? VK_IMAGE_LAYOUT_UNDEFINED : imageLayoutSequence[*image].back ();
+                            const VkImageLayout newLayout     = op->GetImageLayoutAtStartForOutputs (*img);
+                            barrier->AddImageMemoryBarrier (image->GetBarrier (currentLayout, newLayout, fullMask, fullMask));
+                            imageLayoutSequence[*image].push_back (newLayout);
+                        }
+                    });
+                }
+
+                if (merged != nullptr) {
+                    for (WritableImageResource* img : merged->GetAttachmentResources ()) {
+                        // internal attachments start from undefined in the render pass
+                        if (merged->IsInternal (img)) {
+                            continue;
+                        }
+                        for (GVK::Image* image : img->GetImages (frameIndex)) {
+                            const VkImageLayout currentLayout = imageLayoutSequence[*image].back ();
+                            const VkImageLayout newLayout     = merged->GetLayoutAtStart (*img);
+                            barrier->AddImageMemoryBarrier (image->GetBarrier (currentLayout, newLayout, fullMask, fullMask));
+                            imageLayoutSequence[*image].push_back (newLayout);
+                        }
                     }
-                });
+                }
 
                 currentCmdbuffer.RecordCommand (std::move (barrier))
                     .SetName ("Transition for next Pass");
 
-                Utils::ForEach<ImageResource> (allInputs, [&] (const std::shared_ptr<ImageResource>& img) {
-                    for (GVK::Image* image : img->GetImages (frameIndex)) {
-                        imageLayoutSequence[*image].push_back (op->GetImageLayoutAtEndForInputs (*img)); // TODO VkAttachmentDescription.finalLayout
-                    }
-                });
+                for (Operation* op : subpassOps) {
+                    auto allInputs  = graphSettings.connectionSet.GetPointingHere<Resource> (op);
+                    auto allOutputs = graphSettings.connectionSet.GetPointingTo<Resource> (op);
 
-                Utils::ForEach<ImageResource> (allOutputs, [&] (const std::shared_ptr<ImageResource>& img) {
-                    for (GVK::Image* image : img->GetImages (frameIndex)) {
-                        imageLayoutSequence[*image].push_back (op->GetImageLayoutAtEndForOutputs (*img)); // TODO VkAttachmentDescription.finalLayout
+                    Utils::ForEach<ImageResource> (allInputs, [&] (const std::shared_ptr<ImageResource>& img) {
+                        if (IsMergedAttachment (img)) {
+                            return;
+                        }
+                        for (GVK::Image* image : img->GetImages (frameIndex)) {
+                            imageLayoutSequence[*image].push_back (op->GetImageLayoutAtEndForInputs (*img)); // TODO VkAttachmentDescription.finalLayout
+                        }
+                    });
+
+                    Utils::ForEach<ImageResource> (allOutputs, [&] (const std::shared_ptr<ImageResource>& img) {
+                        if (IsMergedAttachment (img)) {
+                            return;
+                        }
+                        for (GVK::Image* image : img->GetImages (frameIndex)) {
+                            imageLayoutSequence[*image].push_back (op->GetImageLayoutAtEndForOutputs (*img)); // TODO VkAttachmentDescription.finalLayout
+                        }
+                    });
+                }
+
+                if (merged != nullptr) {
+                    for (WritableImageResource* img : merged->GetAttachmentResources ()) {
+                        for (GVK::Image* image : img->GetImages (frameIndex)) {
+                            imageLayoutSequence[*image].push_back (merged->GetLayoutAtEnd (*img));
+                        }
                     }
-                });
+                }
             }
 
             for (auto op : p.GetAllOperations ()) {
+                if (IsAsyncComputeOperation (op)) {
+                    continue;
+                }
+
+                if (MergedRenderPass* merged = GetMergedRenderPass (op)) {
+                    if (merged->GetFirstOperation () == op) {
+                        merged->Record (frameIndex, currentCmdbuffer, profiler.get ());
+                    }
+                    continue;
+                }
+
+                if (profiler != nullptr) {
+                    profiler->RecordBegin (frameIndex, op, currentCmdbuffer);
+                }
+
                 op->Record (graphSettings.connectionSet, frameIndex, currentCmdbuffer);
+
+                if (profiler != nullptr) {
+                    profiler->RecordEnd (frameIndex, op, currentCmdbuffer);
+                }
             }
         }
 
@@ -372,6 +1526,10 @@ void RenderGraph::Compile (GraphSettings&& graphSettings_)
             barrier->AddMemoryBarrier (flushAllMemory);
             for (Pass& p : passes) {
                 Utils::ForEach<ImageResource*> (p.GetAllInputs (), [&] (ImageResource* img) {
+                    // transient images and internal attachments start from undefined in the next frame
+                    if (IsTransient (img) || IsInternalAttachment (img)) {
+                        return;
+                    }
                     for (GVK::Image* image : img->GetImages (frameIndex)) {
                         const VkImageLayout currentLayout = imageLayoutSequence[*image].back ();
                         barrier->AddImageMemoryBarrier (image->GetBarrier (currentLayout, img->GetInitialLayout (), fullMask, fullMask));
@@ -384,12 +1542,16 @@ void RenderGraph::Compile (GraphSettings&& graphSettings_)
         currentCmdbuffer.End ();
     }
 
-    compiled = true;
+    RecordAsyncComputeCommandBuffers ();
+
+    compileStats.recordedCommandBuffers = static_cast<uint32_t> (commandBuffers.size () + computeCommandBuffers.size ());
 }
 
 
 void RenderGraph::Submit (uint32_t frameIndex, const std::vector<VkSemaphore>& waitSemaphores, const std::vector<VkSemaphore>& signalSemaphores, VkFence fenceToSignal)
 {
+    Utils::TraceScope traceScope ("RenderGraph::Submit", "Frame");
+
     if (GVK_ERROR (!compiled)) {
         return;
     }
@@ -398,14 +1560,65 @@ void RenderGraph::Submit (uint32_t frameIndex, const std::vector<VkSemaphore>& w
         return;
     }
 
+    if (profiler != nullptr) {
+        profiler->Collect (*operationTimingObserver);
+        fenceToSignal = profiler->GetFenceToSignal (frameIndex, fenceToSignal);
+    }
+
     std::vector<VkPipelineStageFlags> waitDstStageMasks (waitSemaphores.size (), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
 
-    graphSettings.device->GetGraphicsQueue ().Submit (waitSemaphores, waitDstStageMasks, { &commandBuffers[frameIndex] }, signalSemaphores, fenceToSignal);
+    if (asyncComputeOperations.empty ()) {
+        graphSettings.device->GetGraphicsQueue ().Submit (waitSemaphores, waitDstStageMasks, { &commandBuffers[frameIndex] }, signalSemaphores, fenceToSignal);
+
+        if (profiler != nullptr) {
+            profiler->OnSubmitted (frameIndex, fenceToSignal);
+        }
+        return;
+    }
+
+    // the compute work of this frame can only overwrite its buffers after the last graphics submission reading them has finished
+    std::vector<VkSemaphore>          computeWaitSemaphores;
+    std::vector<uint64_t>             computeWaitValues;
+    std::vector<VkPipelineStageFlags> computeWaitDstStageMasks;
+
+    if (lastGraphicsTimelineValues[frameIndex] > 0) {
+        computeWaitSemaphores.push_back (*graphicsTimeline);
+        computeWaitValues.push_back (lastGraphicsTimelineValues[frameIndex]);
+        computeWaitDstStageMasks.push_back (VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    }
+
+    ++computeTimelineValue;
+
+    graphSettings.device->GetComputeQueue ().Submit (computeWaitSemaphores, computeWaitValues, computeWaitDstStageMasks, { &computeCommandBuffers[frameIndex] }, { *computeTimeline }, { computeTimelineValue }, VK_NULL_HANDLE);
+
+    // values for binary semaphores are ignored
+    std::vector<VkSemaphore> graphicsWaitSemaphores = waitSemaphores;
+    std::vector<uint64_t>    graphicsWaitValues (waitSemaphores.size (), 0);
+    graphicsWaitSemaphores.push_back (*computeTimeline);
+    graphicsWaitValues.push_back (computeTimelineValue);
+    waitDstStageMasks.push_back (VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+    ++graphicsTimelineValue;
+
+    std::vector<VkSemaphore> graphicsSignalSemaphores = signalSemaphores;
+    std::vector<uint64_t>    graphicsSignalValues (signalSemaphores.size (), 0);
+    graphicsSignalSemaphores.push_back (*graphicsTimeline);
+    graphicsSignalValues.push_back (graphicsTimelineValue);
+
+    graphSettings.device->GetGraphicsQueue ().Submit (graphicsWaitSemaphores, graphicsWaitValues, waitDstStageMasks, { &commandBuffers[frameIndex] }, graphicsSignalSemaphores, graphicsSignalValues, fenceToSignal);
+
+    lastGraphicsTimelineValues[frameIndex] = graphicsTimelineValue;
+
+    if (profiler != nullptr) {
+        profiler->OnSubmitted (frameIndex, fenceToSignal);
+    }
 }
 
 
 void RenderGraph::Present (uint32_t imageIndex, GVK::Swapchain& swapchain, const std::vector<VkSemaphore>& waitSemaphores)
 {
+    Utils::TraceScope traceScope ("RenderGraph::Present", "Frame");
+
     GVK_ASSERT (swapchain.SupportsPresenting ());
 
     // TODO itt present queue kene
@@ -420,4 +1633,18 @@ uint32_t RenderGraph::GetPassCount () const
     return passes.size ();
 }
 
+
+bool RenderGraph::UsesAsyncCompute () const
+{
+    GVK_ASSERT (compiled);
+
+    return !asyncComputeOperations.empty ();
+}
+
+
+void RenderGraph::SetOperationTimingObserver (IOperationTimingObserver& observer)
+{
+    operationTimingObserver = &observer;
+}
+
 } // namespace RG
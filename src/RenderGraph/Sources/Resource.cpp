@@ -1,4 +1,5 @@
 #include "Resource.hpp"
+#include "UniformArena.hpp"
 
 #include "VulkanWrapper/Image.hpp"
 #include "VulkanWrapper/ImageView.hpp"
@@ -6,9 +7,12 @@
 #include "VulkanWrapper/Commands.hpp"
 #include "VulkanWrapper/Event.hpp"
 #include "VulkanWrapper/Sampler.hpp"
+#include "VulkanWrapper/SharedAllocation.hpp"
 #include "VulkanWrapper/Utils/BufferTransferable.hpp"
 #include "VulkanWrapper/Utils/VulkanUtils.hpp"
 
+#include <algorithm>
+
 namespace RG {
 
 
@@ -44,12 +48,17 @@ void OneTimeCompileResource::Compile (const GraphSettings& settings)
 }
 
 
-WritableImageResource::SingleImageResource::SingleImageResource (const GVK::DeviceExtra& device, uint32_t width, uint32_t height, uint32_t arrayLayers, VkFormat format, VkImageTiling tiling)
-    : image (std::make_unique<GVK::Image2D> (device.GetAllocator (), GVK::Image::MemoryLocation::GPU,
+static constexpr VkImageUsageFlags WritableImageUsage           = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+static constexpr VkImageUsageFlags TransientAttachmentImageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+
+WritableImageResource::SingleImageResource::SingleImageResource (const GVK::DeviceExtra& device, uint32_t width, uint32_t height, uint32_t arrayLayers, VkFormat format, VkImageTiling tiling, bool transientAttachment)
+    : image (std::make_unique<GVK::Image2D> (device.GetAllocator (), transientAttachment ? GVK::Image::MemoryLocation::GPULazilyAllocated : GVK::Image::MemoryLocation::GPU,
                                         width, height,
                                         format, tiling,
-                                             VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
-                                        arrayLayers))
+                                             transientAttachment ? TransientAttachmentImageUsage : WritableImageUsage,
+                                        arrayLayers, 1,
+                                        transientAttachment ? VK_NULL_HANDLE : device.GetAllocatorObject ().GetRenderTargetPool ()))
 {
     for (uint32_t layerIndex = 0; layerIndex < arrayLayers; ++layerIndex) {
         imageViews.push_back (std::make_unique<GVK::ImageView2D> (device, *image, layerIndex));
@@ -62,6 +71,28 @@ WritableImageResource::SingleImageResource::SingleImageResource (const GVK::Devi
 }
 
 
+WritableImageResource::SingleImageResource::SingleImageResource (std::unique_ptr<GVK::AliasedImage2D>&& aliasedImage)
+    : image (std::move (aliasedImage))
+{
+}
+
+
+void WritableImageResource::SingleImageResource::BindMemory (const GVK::DeviceExtra& device, const GVK::SharedAllocation& allocation, VkDeviceSize offset)
+{
+    GVK::AliasedImage2D* aliasedImage = dynamic_cast<GVK::AliasedImage2D*> (image.get ());
+    if (GVK_ERROR (aliasedImage == nullptr)) {
+        return;
+    }
+
+    aliasedImage->BindMemory (allocation, offset);
+
+    imageViews.clear ();
+    for (uint32_t layerIndex = 0; layerIndex < image->GetArrayLayers (); ++layerIndex) {
+        imageViews.push_back (std::make_unique<GVK::ImageView2D> (device, *image, layerIndex));
+    }
+}
+
+
 WritableImageResource::WritableImageResource (VkFilter filter, uint32_t width, uint32_t height, uint32_t arrayLayers, VkFormat format)
     : filter (filter)
     , format (format)
@@ -85,7 +116,7 @@ WritableImageResource::~WritableImageResource () = default;
 
 void WritableImageResource::Compile (const GraphSettings& graphSettings)
 {
-    sampler = std::make_unique<GVK::Sampler> (graphSettings.GetDevice (), filter);
+    sampler = graphSettings.GetDevice ().GetObjectCache ().GetSampler (filter);
 
     images.clear ();
     for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
@@ -94,6 +125,47 @@ void WritableImageResource::Compile (const GraphSettings& graphSettings)
 }
 
 
+void WritableImageResource::CompileTransientAttachment (const GraphSettings& graphSettings)
+{
+    sampler = graphSettings.GetDevice ().GetObjectCache ().GetSampler (filter);
+
+    images.clear ();
+    for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
+        images.push_back (std::make_unique<SingleImageResource> (graphSettings.GetDevice (), width, height, arrayLayers, format, VK_IMAGE_TILING_OPTIMAL, true));
+    }
+}
+
+
+void WritableImageResource::CompileAliased (const GraphSettings& graphSettings)
+{
+    sampler = graphSettings.GetDevice ().GetObjectCache ().GetSampler (filter);
+
+    images.clear ();
+    for (uint32_t resourceIndex = 0; resourceIndex < graphSettings.framesInFlight; ++resourceIndex) {
+        images.push_back (std::make_unique<SingleImageResource> (std::make_unique<GVK::AliasedImage2D> (graphSettings.GetDevice (), width, height, format, VK_IMAGE_TILING_OPTIMAL, WritableImageUsage, arrayLayers)));
+    }
+}
+
+
+VkMemoryRequirements WritableImageResource::GetMemoryRequirements () const
+{
+    GVK_ASSERT (!images.empty ());
+
+    const GVK::AliasedImage2D* aliasedImage = dynamic_cast<const GVK::AliasedImage2D*> (images[0]->image.get ());
+    if (GVK_ERROR (aliasedImage == nullptr)) {
+        return {};
+    }
+
+    return aliasedImage->GetMemoryRequirements ();
+}
+
+
+void WritableImageResource::BindAliasedMemory (const GVK::DeviceExtra& device, uint32_t resourceIndex, const GVK::SharedAllocation& allocation, VkDeviceSize offset)
+{
+    images[resourceIndex]->BindMemory (device, allocation, offset);
+}
+
+
 VkImageLayout WritableImageResource::GetInitialLayout () const
 {
     return initialLayout;
@@ -139,11 +211,24 @@ VkImageView WritableImageResource::GetImageViewForFrame (uint32_t resourceIndex,
 VkSampler   WritableImageResource::GetSampler () { return *sampler; }
 
 
+std::vector<VmaAllocation> WritableImageResource::GetAllocations () const
+{
+    std::vector<VmaAllocation> result;
+    for (const std::unique_ptr<SingleImageResource>& img : images) {
+        const VmaAllocation allocation = *img->image;
+        if (allocation != VK_NULL_HANDLE) {
+            result.push_back (allocation);
+        }
+    }
+    return result;
+}
+
+
 void SingleWritableImageResource::Compile (const GraphSettings& graphSettings)
 {
     readWriteSync = std::make_unique<VW::Event> (graphSettings.GetDevice ());
 
-    sampler = std::make_unique<GVK::Sampler> (graphSettings.GetDevice (), filter);
+    sampler = graphSettings.GetDevice ().GetObjectCache ().GetSampler (filter);
     images.clear ();
     images.push_back (std::make_unique<SingleImageResource> (graphSettings.GetDevice (), width, height, arrayLayers, GetFormat ()));
 }
@@ -194,6 +279,7 @@ GPUBufferResource::~GPUBufferResource () = default;
 
 void GPUBufferResource::Compile (const GraphSettings& settings)
 {
+    buffers.clear ();
     buffers.reserve (settings.framesInFlight);
     for (uint32_t i = 0; i < settings.framesInFlight; ++i) {
         buffers.push_back (std::make_unique<GVK::BufferTransferable> (settings.GetDevice (), size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT));
@@ -225,18 +311,31 @@ void GPUBufferResource::TransferFromGPUToCPU (uint32_t resourceIndex) const
 }
 
 
-ReadOnlyImageResource::ReadOnlyImageResource (VkFormat format, VkFilter filter, uint32_t width, uint32_t height, uint32_t depth, uint32_t layerCount)
+std::vector<VmaAllocation> GPUBufferResource::GetAllocations () const
+{
+    std::vector<VmaAllocation> result;
+    for (const std::unique_ptr<GVK::BufferTransferable>& buffer : buffers) {
+        result.push_back (buffer->bufferGPU);
+        result.push_back (buffer->bufferCPU);
+    }
+    return result;
+}
+
+
+ReadOnlyImageResource::ReadOnlyImageResource (VkFormat format, VkFilter filter, uint32_t width, uint32_t height, uint32_t depth, uint32_t layerCount, uint32_t mipLevels)
     : format (format)
     , filter (filter)
     , width (width)
     , height (height)
     , depth (depth)
     , layerCount (layerCount)
+    , mipLevels (mipLevels)
 {
     GVK_ASSERT (width > 0);
     GVK_ASSERT (height > 0);
     GVK_ASSERT (depth > 0);
     GVK_ASSERT (layerCount > 0);
+    GVK_ASSERT (mipLevels == 1 || (std::max (width, height) > 1 && depth == 1 && layerCount == 1));
 }
 
 
@@ -251,14 +350,21 @@ ReadOnlyImageResource::~ReadOnlyImageResource () = default;
 
 void ReadOnlyImageResource::CompileOnce (const GraphSettings& settings)
 {
-    sampler = std::make_unique<GVK::Sampler> (settings.GetDevice (), filter);
+    if (mipLevels > 1) {
+        VkSamplerCreateInfo samplerCreateInfo = GVK::Sampler::GetCreateInfo (filter, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
+        samplerCreateInfo.maxLod              = static_cast<float> (mipLevels);
+        sampler                               = settings.GetDevice ().GetObjectCache ().GetSampler (samplerCreateInfo);
+    } else {
+        sampler = settings.GetDevice ().GetObjectCache ().GetSampler (filter);
+    }
 
-    if (height == 1 && depth == 1) {
+    // 1D images have no mip levels, a single row with mip levels stays 2D
+    if (height == 1 && depth == 1 && mipLevels == 1) {
         image     = std::make_unique<GVK::Image1DTransferable> (settings.GetDevice (), format, width, VK_IMAGE_USAGE_SAMPLED_BIT);
         imageView = std::make_unique<GVK::ImageView1D> (settings.GetDevice (), *image->imageGPU);
     } else if (depth == 1) {
         if (layerCount == 1) {
-            image     = std::make_unique<GVK::Image2DTransferable> (settings.GetDevice (), format, width, height, VK_IMAGE_USAGE_SAMPLED_BIT);
+            image     = std::make_unique<GVK::Image2DTransferable> (settings.GetDevice (), format, width, height, VK_IMAGE_USAGE_SAMPLED_BIT, 1, mipLevels);
             imageView = std::make_unique<GVK::ImageView2D> (settings.GetDevice (), *image->imageGPU, 0);
         } else {
             image     = std::make_unique<GVK::Image2DTransferable> (settings.GetDevice (), format, width, height, VK_IMAGE_USAGE_SAMPLED_BIT, layerCount);
@@ -274,6 +380,66 @@ void ReadOnlyImageResource::CompileOnce (const GraphSettings& settings)
 }
 
 
+void ReadOnlyImageResource::RecordMipLevelGeneration (GVK::CommandBuffer& commandBuffer) const
+{
+    GVK::Image& gpuImage = *image->imageGPU;
+
+    const VkAccessFlags transferMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    int32_t levelWidth  = static_cast<int32_t> (width);
+    int32_t levelHeight = static_cast<int32_t> (height);
+
+    for (uint32_t level = 1; level < mipLevels; ++level) {
+        // the previous level becomes the blit source
+        VkImageMemoryBarrier toSource          = gpuImage.GetBarrier (VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, transferMask, transferMask);
+        toSource.subresourceRange.baseMipLevel = level - 1;
+        toSource.subresourceRange.levelCount   = 1;
+
+        std::unique_ptr<GVK::CommandPipelineBarrier> barrier = std::make_unique<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        barrier->AddImageMemoryBarrier (toSource);
+        commandBuffer.RecordCommand (std::move (barrier));
+
+        const int32_t nextWidth  = std::max (levelWidth / 2, 1);
+        const int32_t nextHeight = std::max (levelHeight / 2, 1);
+
+        VkImageBlit blit                   = {};
+        blit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel       = level - 1;
+        blit.srcSubresource.baseArrayLayer = 0;
+        blit.srcSubresource.layerCount     = 1;
+        blit.srcOffsets[0]                 = { 0, 0, 0 };
+        blit.srcOffsets[1]                 = { levelWidth, levelHeight, 1 };
+        blit.dstSubresource                = blit.srcSubresource;
+        blit.dstSubresource.mipLevel       = level;
+        blit.dstOffsets[0]                 = { 0, 0, 0 };
+        blit.dstOffsets[1]                 = { nextWidth, nextHeight, 1 };
+
+        commandBuffer.Record<GVK::CommandGeneric> ([&gpuImage, blit] (VkCommandBuffer commandBuffer) {
+            vkCmdBlitImage (commandBuffer, gpuImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, gpuImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+        });
+
+        levelWidth  = nextWidth;
+        levelHeight = nextHeight;
+    }
+
+    // every level but the last one is in transfer src layout
+    VkImageMemoryBarrier sourceLevels          = gpuImage.GetBarrier (VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, transferMask, VK_ACCESS_SHADER_READ_BIT);
+    sourceLevels.subresourceRange.baseMipLevel = 0;
+    sourceLevels.subresourceRange.levelCount   = mipLevels - 1;
+
+    VkImageMemoryBarrier lastLevel          = gpuImage.GetBarrier (VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, transferMask, VK_ACCESS_SHADER_READ_BIT);
+    lastLevel.subresourceRange.baseMipLevel = mipLevels - 1;
+    lastLevel.subresourceRange.levelCount   = 1;
+
+    std::unique_ptr<GVK::CommandPipelineBarrier> barrier = std::make_unique<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    if (mipLevels > 1) {
+        barrier->AddImageMemoryBarrier (sourceLevels);
+    }
+    barrier->AddImageMemoryBarrier (lastLevel);
+    commandBuffer.RecordCommand (std::move (barrier));
+}
+
+
 VkImageLayout ReadOnlyImageResource::GetInitialLayout () const { return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; }
 
 
@@ -304,6 +470,16 @@ VkImageView ReadOnlyImageResource::GetImageViewForFrame (uint32_t, uint32_t) { r
 VkSampler   ReadOnlyImageResource::GetSampler () { return *sampler; }
 
 
+std::vector<VmaAllocation> ReadOnlyImageResource::GetAllocations () const
+{
+    if (image == nullptr) {
+        return {};
+    }
+
+    return { static_cast<VmaAllocation> (*image->imageGPU), static_cast<VmaAllocation> (image->GetBufferCPU ()) };
+}
+
+
 SwapchainImageResource::SwapchainImageResource (GVK::SwapchainProvider& swapchainProv)
     : swapchainProv (swapchainProv)
 {
@@ -383,8 +559,12 @@ void CPUBufferResource::Compile (const GraphSettings& graphSettings)
     mappings.clear ();
     buffers.clear ();
 
+    // written on the host and read by operations on the graphics and the async compute queue
+    const std::vector<uint32_t>& concurrentQueueFamilies = graphSettings.GetDevice ().GetConcurrentQueueFamilies ();
+
     for (uint32_t i = 0; i < graphSettings.framesInFlight; ++i) {
-        buffers.push_back (std::make_unique<GVK::UniformBuffer> (graphSettings.GetDevice ().GetAllocator (), size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, GVK::Buffer::MemoryLocation::CPU));
+        buffers.push_back (std::make_unique<GVK::UniformBuffer> (graphSettings.GetDevice ().GetAllocator (), size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, GVK::Buffer::MemoryLocation::CPU,
+                                                                 concurrentQueueFamilies, graphSettings.GetDevice ().GetAllocatorObject ().GetUniformBufferPool (size)));
         mappings.push_back (std::make_unique<GVK::MemoryMapping> (graphSettings.GetDevice ().GetAllocator (), *buffers[buffers.size () - 1]));
     }
 }
@@ -399,4 +579,81 @@ uint32_t CPUBufferResource::GetBufferSize () { return size; }
 GVK::MemoryMapping& CPUBufferResource::GetMapping (uint32_t resourceIndex) { return *mappings[resourceIndex]; }
 
 
+std::vector<VmaAllocation> CPUBufferResource::GetAllocations () const
+{
+    std::vector<VmaAllocation> result;
+    for (const std::unique_ptr<GVK::Buffer>& buffer : buffers) {
+        result.push_back (*buffer);
+    }
+    return result;
+}
+
+
+void CPUBufferResource::BindMovedAllocations (const GraphSettings& graphSettings, const std::vector<bool>& moved)
+{
+    GVK_ASSERT (moved.size () == buffers.size ());
+
+    for (size_t i = 0; i < buffers.size (); ++i) {
+        if (!moved[i]) {
+            continue;
+        }
+
+        // the mapping was moved with the allocation, but the previous pointer is invalid
+        mappings[i].reset ();
+        buffers[i]->BindMovedAllocation (graphSettings.GetDevice ());
+        mappings[i] = std::make_unique<GVK::MemoryMapping> (graphSettings.GetDevice ().GetAllocator (), *buffers[i]);
+    }
+}
+
+
+UniformArenaBufferResource::UniformArenaBufferResource (const std::shared_ptr<UniformArena>& arena, uint32_t blockIndex)
+    : arena (arena)
+    , blockIndex (blockIndex)
+{
+    GVK_ASSERT (arena != nullptr);
+    GVK_ASSERT (blockIndex < arena->GetBlockCount ());
+}
+
+
+UniformArenaBufferResource::~UniformArenaBufferResource () = default;
+
+
+void UniformArenaBufferResource::Compile (const GraphSettings& graphSettings)
+{
+    arena->Compile (graphSettings);
+}
+
+
+VkBuffer UniformArenaBufferResource::GetBufferForFrame (uint32_t) { return arena->GetBuffer (); }
+
+
+uint32_t UniformArenaBufferResource::GetBufferSize () { return arena->GetBlockSize (blockIndex); }
+
+
+uint32_t UniformArenaBufferResource::GetDynamicOffset (uint32_t resourceIndex) const { return arena->GetDynamicOffset (blockIndex, resourceIndex); }
+
+
+std::function<uint32_t (uint32_t)> UniformArenaBufferResource::GetDynamicOffsetProvider ()
+{
+    return [=] (uint32_t resourceIndex) -> uint32_t {
+        return GetDynamicOffset (resourceIndex);
+    };
+}
+
+
+void UniformArenaBufferResource::Copy (uint32_t resourceIndex, const void* data, size_t size) const
+{
+    arena->Copy (blockIndex, resourceIndex, data, size);
+}
+
+
+std::vector<VmaAllocation> UniformArenaBufferResource::GetAllocations () const
+{
+    if (!arena->IsCompiled ()) {
+        return {};
+    }
+    return { arena->GetAllocation () };
+}
+
+
 } // namespace RG
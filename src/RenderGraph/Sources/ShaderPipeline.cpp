@@ -6,6 +6,7 @@
 #include "VulkanWrapper/GraphicsPipeline.hpp"
 #include "VulkanWrapper/PipelineLayout.hpp"
 #include "VulkanWrapper/RenderPass.hpp"
+#include "VulkanWrapper/ObjectCache.hpp"
 #include "VulkanWrapper/DescriptorSetLayout.hpp"
 
 #include "Utils/MultithreadedFunction.hpp"
@@ -161,6 +162,17 @@ void ShaderPipeline::SetShadersFromSourceFiles (const std::vector<std::filesyste
     MultithreadedFunction d (shaderPath.size (), [&] (uint32_t threadCount, uint32_t threadIndex) {
         SetShaderFromSourceFile (shaderPath[threadIndex]);
     });
+
+    // ShaderCompileException is rethrown here
+    d.Wait ();
+}
+
+
+void ShaderPipeline::SetSpecializationConstants (const GVK::SpecializationConstants& values)
+{
+    IterateShaders ([&] (GVK::ShaderModule& shaderModule) {
+        shaderModule.SetSpecializationConstants (values);
+    });
 }
 
 
@@ -203,7 +215,22 @@ void ShaderPipeline::Compile (CompileSettings&& settings_)
     dependency.srcSubpass           = 0;
     dependency.dstSubpass           = VK_SUBPASS_EXTERNAL;
 
-    compileResult.renderPass     = std::unique_ptr<GVK::RenderPass> (new GVK::RenderPass (device, compileSettings.attachmentDescriptions, { subpass }, { dependency, dependency2 }));
+    std::vector<VkFormat> colorAttachmentFormats;
+
+    if (compileSettings.dynamicRendering) {
+        GVK_ASSERT (compileSettings.renderPass == nullptr && compileSettings.inputAttachmentReferences.empty ());
+        compileResult.renderPass = nullptr;
+        for (const VkAttachmentReference& reference : compileSettings.attachmentReferences) {
+            colorAttachmentFormats.push_back (compileSettings.attachmentDescriptions[reference.attachment].format);
+        }
+    } else if (compileSettings.renderPass != nullptr) {
+        compileResult.renderPass = compileSettings.renderPass;
+    } else if (compileSettings.objectCache != nullptr) {
+        compileResult.renderPass = compileSettings.objectCache->GetRenderPass (compileSettings.attachmentDescriptions, { subpass }, { dependency, dependency2 });
+    } else {
+        compileResult.renderPass = std::make_shared<GVK::RenderPass> (device, compileSettings.attachmentDescriptions, std::vector<VkSubpassDescription> { subpass }, std::vector<VkSubpassDependency> { dependency, dependency2 });
+    }
+
     compileResult.pipelineLayout = std::unique_ptr<GVK::PipelineLayout> (new GVK::PipelineLayout (device, { compileSettings.layout }));
 
     const std::vector<VkVertexInputAttributeDescription> attribs  = RG::FromShaderReflection::GetVertexAttributes (vertexShader->GetReflection (), instancedVertexProvider);
@@ -215,12 +242,15 @@ void ShaderPipeline::Compile (CompileSettings&& settings_)
         compileSettings.height,
         static_cast<uint32_t> (compileSettings.attachmentReferences.size ()),
         *compileResult.pipelineLayout,
-        *compileResult.renderPass,
+        (compileResult.renderPass != nullptr) ? static_cast<VkRenderPass> (*compileResult.renderPass) : VK_NULL_HANDLE,
         GetShaderStages (),
         bindings,
         attribs,
         compileSettings.topology,
-        compileSettings.blendEnabled.has_value () ? *compileSettings.blendEnabled : true));
+        compileSettings.blendEnabled.has_value () ? *compileSettings.blendEnabled : true,
+        compileSettings.pipelineCache,
+        compileSettings.subpassIndex,
+        colorAttachmentFormats));
 }
 
 
@@ -256,10 +286,13 @@ void ShaderPipeline::Reload ()
             }
 
             if (newShader != nullptr) {
+                newShader->SetSpecializationConstants (currentShader->GetSpecializationConstants ());
                 currentShader = std::move (newShader);
             }
         }
     });
+
+    reloader.Wait ();
 }
 
 
@@ -286,7 +319,7 @@ void ShaderPipeline::IterateShaders (const std::function<void (GVK::ShaderModule
 }
 
 
-std::unique_ptr<GVK::DescriptorSetLayout> ShaderPipeline::CreateDescriptorSetLayout (VkDevice device) const
+std::unique_ptr<GVK::DescriptorSetLayout> ShaderPipeline::CreateDescriptorSetLayout (VkDevice device, FromShaderReflection::IDescriptorWriteInfoProvider& infoProvider) const
 {
     std::vector<VkDescriptorSetLayoutBinding> layout;
 
@@ -298,7 +331,7 @@ std::unique_ptr<GVK::DescriptorSetLayout> ShaderPipeline::CreateDescriptorSetLay
     }
 
     IterateShaders ([&] (GVK::ShaderModule& shaderModule) {
-        auto layoutPart = RG::FromShaderReflection::GetLayout (shaderModule.GetReflection (), shaderModule.GetShaderKind ());
+        auto layoutPart = RG::FromShaderReflection::GetLayout (shaderModule.GetReflection (), shaderModule.GetShaderKind (), infoProvider);
         layout.insert (layout.end (), layoutPart.begin (), layoutPart.end ());
     });
 
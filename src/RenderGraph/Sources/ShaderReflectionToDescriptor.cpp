@@ -5,6 +5,8 @@
 #include "Utils/Assert.hpp"
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
+
 
 namespace RG {
 namespace FromShaderReflection {
@@ -46,6 +48,27 @@ std::vector<VkDescriptorBufferInfo> DescriptorWriteInfoTable::GetDescriptorBuffe
 }
 
 
+bool DescriptorWriteInfoTable::IsDynamicUniformBuffer (const std::string& name, GVK::ShaderKind shaderKind)
+{
+    return std::any_of (bufferInfos.begin (), bufferInfos.end (), [&] (const BufferEntry& entry) {
+        return entry.name == name && entry.shaderKind == shaderKind && entry.dynamicOffset != nullptr;
+    });
+}
+
+
+uint32_t DescriptorWriteInfoTable::GetDynamicOffset (const std::string& name, GVK::ShaderKind shaderKind, uint32_t frameIndex)
+{
+    for (const BufferEntry& entry : bufferInfos) {
+        if (entry.name == name && entry.shaderKind == shaderKind && entry.dynamicOffset != nullptr) {
+            return entry.dynamicOffset (frameIndex);
+        }
+    }
+
+    GVK_BREAK ();
+    return 0;
+}
+
+
 IUpdateDescriptorSets::~IUpdateDescriptorSets () = default;
 
 
@@ -134,7 +157,7 @@ static void UpdateDescriptorSetsFromUBOs (const GVK::ShaderModule::Reflection& r
         write.dstSet               = dstSet;
         write.dstBinding           = ubo->binding;
         write.dstArrayElement      = 0;
-        write.descriptorType       = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        write.descriptorType       = infoProvider.IsDynamicUniformBuffer (ubo->name, shaderKind) ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         write.descriptorCount      = newSize - currentSize;
         write.pBufferInfo          = &bufferInfos[currentSize];
         write.pImageInfo           = nullptr;
@@ -263,6 +286,23 @@ void WriteDescriptors (const GVK::ShaderModule::Reflection& reflection,
 }
 
 
+std::vector<std::pair<uint32_t, uint32_t>> GetDynamicOffsets (const GVK::ShaderModule::Reflection& reflection,
+                                                               uint32_t                             frameIndex,
+                                                               GVK::ShaderKind                      shaderKind,
+                                                               IDescriptorWriteInfoProvider&        infoProvider)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> result;
+
+    for (const std::shared_ptr<SR::BufferObject>& ubo : reflection.ubos) {
+        if (infoProvider.IsDynamicUniformBuffer (ubo->name, shaderKind)) {
+            result.emplace_back (ubo->binding, infoProvider.GetDynamicOffset (ubo->name, shaderKind, frameIndex));
+        }
+    }
+
+    return result;
+}
+
+
 static VkShaderStageFlags GetShaderStageFromShaderKind (GVK::ShaderKind shaderKind)
 {
     switch (shaderKind) {
@@ -277,7 +317,7 @@ static VkShaderStageFlags GetShaderStageFromShaderKind (GVK::ShaderKind shaderKi
 }
 
 
-std::vector<VkDescriptorSetLayoutBinding> GetLayout (const GVK::ShaderModule::Reflection& reflection, GVK::ShaderKind shaderKind)
+std::vector<VkDescriptorSetLayoutBinding> GetLayout (const GVK::ShaderModule::Reflection& reflection, GVK::ShaderKind shaderKind, IDescriptorWriteInfoProvider& infoProvider)
 {
     std::vector<VkDescriptorSetLayoutBinding> result;
 
@@ -294,7 +334,7 @@ std::vector<VkDescriptorSetLayoutBinding> GetLayout (const GVK::ShaderModule::Re
     for (const std::shared_ptr<SR::BufferObject>& ubo : reflection.ubos) {
         VkDescriptorSetLayoutBinding bin = {};
         bin.binding                      = ubo->binding;
-        bin.descriptorType               = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        bin.descriptorType               = infoProvider.IsDynamicUniformBuffer (ubo->name, shaderKind) ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         bin.descriptorCount              = 1;
         bin.stageFlags                   = GetShaderStageFromShaderKind (shaderKind);
         bin.pImmutableSamplers           = nullptr;
@@ -0,0 +1,116 @@
+#include "TransientMemory.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+
+namespace RG {
+
+static VkDeviceSize AlignUp (VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (alignment <= 1) ? value : (value + alignment - 1) / alignment * alignment;
+}
+
+
+TransientMemoryLayout::TransientMemoryLayout (const std::vector<ResourceLifetime>& lifetimes, const std::vector<VkMemoryRequirements>& requirements)
+{
+    GVK_ASSERT (lifetimes.size () == requirements.size ());
+
+    // resources placed after each other at the same offset
+    struct Slot {
+        uint32_t            lastPass;
+        VkDeviceSize        size;
+        VkDeviceSize        alignment;
+        uint32_t            memoryTypeBits;
+        std::vector<size_t> resources;
+    };
+
+    std::vector<size_t> order (lifetimes.size ());
+    std::iota (order.begin (), order.end (), 0);
+    std::stable_sort (order.begin (), order.end (), [&] (size_t a, size_t b) {
+        return lifetimes[a].firstPass < lifetimes[b].firstPass;
+    });
+
+    std::vector<Slot> slots;
+
+    for (size_t resourceIndex : order) {
+        const ResourceLifetime&     lifetime    = lifetimes[resourceIndex];
+        const VkMemoryRequirements& requirement = requirements[resourceIndex];
+
+        // the free slot that grows the least
+        std::optional<size_t> bestSlot;
+        VkDeviceSize          bestGrowth = 0;
+
+        for (size_t slotIndex = 0; slotIndex < slots.size (); ++slotIndex) {
+            const Slot& slot = slots[slotIndex];
+            if (slot.lastPass >= lifetime.firstPass || (slot.memoryTypeBits & requirement.memoryTypeBits) == 0) {
+                continue;
+            }
+
+            const VkDeviceSize growth = std::max (slot.size, requirement.size) - slot.size;
+            if (!bestSlot.has_value () || growth < bestGrowth) {
+                bestSlot   = slotIndex;
+                bestGrowth = growth;
+            }
+        }
+
+        if (!bestSlot.has_value ()) {
+            slots.push_back ({ lifetime.lastPass, requirement.size, requirement.alignment, requirement.memoryTypeBits, { resourceIndex } });
+            continue;
+        }
+
+        Slot& slot = slots[*bestSlot];
+        slot.lastPass       = lifetime.lastPass;
+        slot.size           = std::max (slot.size, requirement.size);
+        slot.alignment      = std::max (slot.alignment, requirement.alignment);
+        slot.memoryTypeBits = slot.memoryTypeBits & requirement.memoryTypeBits;
+        slot.resources.push_back (resourceIndex);
+    }
+
+    placements.resize (lifetimes.size (), { 0, 0 });
+
+    for (const Slot& slot : slots) {
+        auto block = std::find_if (blocks.begin (), blocks.end (), [&] (const Block& b) {
+            return (b.memoryTypeBits & slot.memoryTypeBits) != 0;
+        });
+
+        if (block == blocks.end ()) {
+            blocks.push_back ({ 0, slot.alignment, slot.memoryTypeBits });
+            block = blocks.end () - 1;
+        }
+
+        const VkDeviceSize offset = AlignUp (block->size, slot.alignment);
+
+        block->size           = offset + slot.size;
+        block->alignment      = std::max (block->alignment, slot.alignment);
+        block->memoryTypeBits = block->memoryTypeBits & slot.memoryTypeBits;
+
+        for (size_t resourceIndex : slot.resources) {
+            placements[resourceIndex] = { static_cast<uint32_t> (block - blocks.begin ()), offset };
+        }
+    }
+}
+
+
+VkDeviceSize TransientMemoryLayout::GetUnaliasedSize (const std::vector<VkMemoryRequirements>& requirements)
+{
+    VkDeviceSize result = 0;
+    for (const VkMemoryRequirements& requirement : requirements) {
+        result += requirement.size;
+    }
+    return result;
+}
+
+
+VkDeviceSize TransientMemoryLayout::GetAllocatedSize () const
+{
+    VkDeviceSize result = 0;
+    for (const Block& block : blocks) {
+        result += block.size;
+    }
+    return result;
+}
+
+} // namespace RG
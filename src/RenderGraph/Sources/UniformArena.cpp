@@ -0,0 +1,135 @@
+#include "UniformArena.hpp"
+
+#include "GraphSettings.hpp"
+
+#include "VulkanWrapper/Buffer.hpp"
+#include "VulkanWrapper/DeviceExtra.hpp"
+#include "VulkanWrapper/Utils/MemoryMapping.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+
+namespace RG {
+
+static VkDeviceSize AlignUp (VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (alignment <= 1) ? value : (value + alignment - 1) / alignment * alignment;
+}
+
+
+UniformArena::UniformArena ()
+    : device (VK_NULL_HANDLE)
+    , framesInFlight (0)
+    , compiledBlockCount (0)
+    , partitionSize (0)
+{
+}
+
+
+UniformArena::~UniformArena () = default;
+
+
+uint32_t UniformArena::Allocate (uint32_t size)
+{
+    blocks.push_back ({ size, 0 });
+
+    return static_cast<uint32_t> (blocks.size () - 1);
+}
+
+
+void UniformArena::Free (uint32_t blockIndex)
+{
+    GVK_ASSERT (blockIndex < blocks.size ());
+
+    // the next block starts at the same aligned offset
+    blocks[blockIndex].size = 0;
+}
+
+
+void UniformArena::Compile (const GraphSettings& graphSettings)
+{
+    const GVK::DeviceExtra& deviceExtra = graphSettings.GetDevice ();
+
+    if (buffer != nullptr && device == static_cast<VkDevice> (deviceExtra) && framesInFlight == graphSettings.framesInFlight && compiledBlockCount == blocks.size ()) {
+        return;
+    }
+
+    mapping.reset ();
+    buffer.reset ();
+
+    const VkPhysicalDeviceProperties* properties = nullptr;
+    vmaGetPhysicalDeviceProperties (deviceExtra.GetAllocator (), &properties);
+
+    const VkDeviceSize alignment = properties->limits.minUniformBufferOffsetAlignment;
+
+    partitionSize = 0;
+    for (Block& block : blocks) {
+        GVK_ASSERT (block.size <= properties->limits.maxUniformBufferRange);
+
+        block.offset  = partitionSize;
+        partitionSize = AlignUp (partitionSize + block.size, alignment);
+    }
+
+    // dynamic offsets of every partition have to be aligned too
+    partitionSize = std::max<VkDeviceSize> (AlignUp (partitionSize, alignment), alignment);
+
+    device             = deviceExtra;
+    framesInFlight     = graphSettings.framesInFlight;
+    compiledBlockCount = blocks.size ();
+
+    // small arenas share the blocks of the small uniform buffers, so they are defragmented with them
+    const VmaPool pool = deviceExtra.GetAllocatorObject ().GetUniformBufferPool (partitionSize * framesInFlight);
+
+    buffer  = std::make_unique<GVK::UniformBuffer> (deviceExtra.GetAllocator (), partitionSize * framesInFlight, VK_BUFFER_USAGE_TRANSFER_DST_BIT, GVK::Buffer::MemoryLocation::CPU, deviceExtra.GetConcurrentQueueFamilies (), pool);
+    mapping = std::make_unique<GVK::MemoryMapping> (deviceExtra.GetAllocator (), *buffer);
+
+    spdlog::trace ("UniformArena: {} blocks in {} partitions of {} bytes.", blocks.size (), framesInFlight, partitionSize);
+}
+
+
+void UniformArena::BindMovedAllocation (const GraphSettings& graphSettings)
+{
+    GVK_ASSERT (IsCompiled ());
+
+    // the mapping was moved with the allocation, but the previous pointer is invalid
+    mapping.reset ();
+    buffer->BindMovedAllocation (graphSettings.GetDevice ());
+    mapping = std::make_unique<GVK::MemoryMapping> (graphSettings.GetDevice ().GetAllocator (), *buffer);
+}
+
+
+VkBuffer UniformArena::GetBuffer () const
+{
+    GVK_ASSERT (IsCompiled ());
+    return *buffer;
+}
+
+
+VmaAllocation UniformArena::GetAllocation () const
+{
+    GVK_ASSERT (IsCompiled ());
+    return *buffer;
+}
+
+
+uint32_t UniformArena::GetDynamicOffset (uint32_t blockIndex, uint32_t frameIndex) const
+{
+    GVK_ASSERT (IsCompiled ());
+    GVK_ASSERT (blockIndex < compiledBlockCount);
+    GVK_ASSERT (frameIndex < framesInFlight);
+
+    return static_cast<uint32_t> (partitionSize * frameIndex + blocks[blockIndex].offset);
+}
+
+
+void UniformArena::Copy (uint32_t blockIndex, uint32_t frameIndex, const void* data, size_t size) const
+{
+    GVK_ASSERT (size <= blocks[blockIndex].size);
+
+    mapping->Copy (data, size, GetDynamicOffset (blockIndex, frameIndex));
+}
+
+} // namespace RG
@@ -19,6 +19,8 @@
 
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
+
 namespace RG {
 
 
@@ -34,10 +36,41 @@ UniformReflection::UniformReflection (RG::ConnectionSet& connectionSet, const Re
 void UniformReflection::Flush (uint32_t frameIndex)
 {
     Utils::ForEach<RG::CPUBufferResource> (bufferObjectResources, [&] (const std::shared_ptr<RG::CPUBufferResource>& bufferObjectRes) {
+        // not compiled when the graph culled its operation
+        if (bufferObjectRes->mappings.empty ()) {
+            return;
+        }
+
         const std::shared_ptr<SR::IBufferData> bufferObjectData = udatas.at (bufferObjectRes->GetUUID ());
 
         bufferObjectRes->GetMapping (frameIndex).Copy (bufferObjectData->GetData (), bufferObjectData->GetSize ());
     });
+
+    Utils::ForEach<RG::UniformArenaBufferResource> (bufferObjectResources, [&] (const std::shared_ptr<RG::UniformArenaBufferResource>& bufferObjectRes) {
+        if (!bufferObjectRes->arena->IsCompiled ()) {
+            return;
+        }
+
+        const std::shared_ptr<SR::IBufferData> bufferObjectData = udatas.at (bufferObjectRes->GetUUID ());
+
+        bufferObjectRes->Copy (frameIndex, bufferObjectData->GetData (), bufferObjectData->GetSize ());
+    });
+}
+
+
+UniformReflection::ResourceCreator UniformReflection::UniformArenaResourceCreator (const std::shared_ptr<UniformArena>& arena)
+{
+    return [=] (const std::shared_ptr<RG::Operation>& op, const GVK::ShaderModule& shaderModule, const std::shared_ptr<SR::BufferObject>& bufferObject, bool& treatAsOutput) -> std::shared_ptr<RG::DescriptorBindableBufferResource> {
+        const std::vector<std::shared_ptr<SR::BufferObject>>& ubos = shaderModule.GetReflection ().ubos;
+
+        const bool isUniformBlock = std::find (ubos.begin (), ubos.end (), bufferObject) != ubos.end ();
+        if (!isUniformBlock) {
+            return DefaultResourceCreator (op, shaderModule, bufferObject, treatAsOutput);
+        }
+
+        // the dynamic blocks of the operation are counted when connected, see CreateGraphConnections
+        return std::make_unique<RG::UniformArenaBufferResource> (arena, arena->Allocate (bufferObject->GetFullSize ()));
+    };
 }
 
 
@@ -47,6 +80,12 @@ void UniformReflection::CreateGraphResources (const RG::ConnectionSet& connectio
 
     const auto CreateBufferObjectResource = [&] (const std::shared_ptr<RG::Operation>& op, const GVK::ShaderModule& shaderModule, const std::shared_ptr<SR::BufferObject>& bufferObject, BufferObjectSelector& bufferObjectsel) {
 
+        // before creating the resource, so no arena space is reserved for it
+        if (connectionSet.GetNodeByName (bufferObject->name) != nullptr) {
+            spdlog::trace ("[UniformReflection] Skipping buffer object named \"{}\" because it already exists.", bufferObject->name);
+            return;
+        }
+
         bool treatAsOutput = false;
 
         std::shared_ptr<RG::DescriptorBindableBufferResource> bufferObjectRes = resourceCreator (op, shaderModule, bufferObject, treatAsOutput);
@@ -54,11 +93,6 @@ void UniformReflection::CreateGraphResources (const RG::ConnectionSet& connectio
         if (bufferObjectRes == nullptr)
             return;
 
-        if (connectionSet.GetNodeByName (bufferObject->name) != nullptr) {
-            spdlog::trace ("[UniformReflection] Skipping buffer object named \"{}\" because it already exists.", bufferObject->name);
-            return;
-        }
-
         bufferObjectRes->SetName (bufferObject->name);
         bufferObjectRes->SetDebugInfo ("Made by UniformReflection.");
 
@@ -105,18 +139,47 @@ void UniformReflection::CreateGraphConnections (RG::ConnectionSet& connectionSet
 
     for (auto& [operation, bufferObject, resource, shaderKind, treatAsOutput] : bufferObjectConnections) {
 
+        // counted here, so the blocks connected to the operation by others are included
+        if (auto arenaRes = std::dynamic_pointer_cast<RG::UniformArenaBufferResource> (resource)) {
+            const size_t boundBlockCount = connectionSet.GetPointingHere<RG::UniformArenaBufferResource> (operation.get ()).size ()
+                                         + connectionSet.GetPointingTo<RG::UniformArenaBufferResource> (operation.get ()).size ();
+
+            if (boundBlockCount >= UniformArena::MaxDynamicBlocksPerOperation) {
+                spdlog::warn ("[UniformReflection] Too many dynamic uniform buffers, \"{}\" gets its own buffers.", bufferObject->name);
+
+                arenaRes->arena->Free (arenaRes->blockIndex);
+
+                std::shared_ptr<RG::DescriptorBindableBufferResource> ownBuffers = std::make_unique<RG::CPUBufferResource> (bufferObject->GetFullSize ());
+                ownBuffers->SetName (resource->GetName ());
+                ownBuffers->SetDebugInfo ("Made by UniformReflection.");
+
+                std::replace (bufferObjectResources.begin (), bufferObjectResources.end (), resource, ownBuffers);
+
+                udatas.insert ({ ownBuffers->GetUUID (), udatas.at (resource->GetUUID ()) });
+                udatas.erase (resource->GetUUID ());
+
+                resource = ownBuffers;
+            }
+        }
+
         if (treatAsOutput) {
             connectionSet.Add (operation, resource);
         } else {
             connectionSet.Add (resource, operation);
         }
 
+        // the whole offset of a block in an arena is dynamic
+        std::function<uint32_t (uint32_t)> dynamicOffset;
+        if (auto arenaRes = std::dynamic_pointer_cast<RG::UniformArenaBufferResource> (resource)) {
+            dynamicOffset = arenaRes->GetDynamicOffsetProvider ();
+        }
+
         if (auto renderOp = std::dynamic_pointer_cast<RG::RenderOperation> (operation)) {
             auto& table = renderOp->compileSettings.descriptorWriteProvider;
-            table->bufferInfos.push_back ({ bufferObject->name, shaderKind, resource->GetBufferForFrameProvider (), 0, resource->GetBufferSize () });
+            table->bufferInfos.push_back ({ bufferObject->name, shaderKind, resource->GetBufferForFrameProvider (), 0, resource->GetBufferSize (), dynamicOffset });
         } else if (auto computeOp = std::dynamic_pointer_cast<RG::ComputeOperation> (operation)) {
             auto& table = computeOp->compileSettings.descriptorWriteProvider;
-            table->bufferInfos.push_back ({ bufferObject->name, shaderKind, resource->GetBufferForFrameProvider (), 0, resource->GetBufferSize () });
+            table->bufferInfos.push_back ({ bufferObject->name, shaderKind, resource->GetBufferForFrameProvider (), 0, resource->GetBufferSize (), dynamicOffset });
         } else {
             GVK_BREAK ();
         }
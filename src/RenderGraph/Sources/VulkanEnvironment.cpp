@@ -19,12 +19,15 @@
 #include "fmt/format.h"
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
 
 static Utils::CommandLineOnOffFlag disableValidationLayersFlag (std::vector<std::string> { "--disableValidationLayers", "-v" }, "Disables Vulkan validation layers.");
 static Utils::CommandLineOnOffFlag logVulkanVersionFlag ("--logVulkanVersion");
+static Utils::CommandLineOnOffFlag disableAsyncComputeFlag ("--disableAsyncCompute", "Runs compute operations on the graphics queue even if a dedicated compute queue is available.");
+static Utils::CommandLineOnOffFlag disableDynamicRenderingFlag ("--disableDynamicRendering", "Records render operations with render passes and framebuffers even if VK_KHR_dynamic_rendering is available.");
 
 
 namespace RG {
@@ -57,6 +60,14 @@ Presentable::Presentable (VulkanEnvironment& env, std::unique_ptr<Window>&& wind
 }
 
 
+Presentable::Presentable (std::unique_ptr<GVK::Swapchain>&& swapchain)
+    : window (nullptr)
+    , surface (nullptr)
+    , swapchain (std::move (swapchain))
+{
+}
+
+
 GVK::Swapchain& Presentable::GetSwapchain ()
 {
     return *swapchain;
@@ -65,6 +76,7 @@ GVK::Swapchain& Presentable::GetSwapchain ()
 
 const GVK::Surface& Presentable::GetSurface () const
 {
+    GVK_ASSERT (surface != nullptr);
     return *surface;
 }
 
@@ -238,6 +250,9 @@ void defaultDebugCallback (VkDebugUtilsMessageSeverityFlagBitsEXT      messageSe
 void VulkanEnvironment::Wait () const
 {
     graphicsQueue->Wait ();
+    if (computeQueue != nullptr) {
+        computeQueue->Wait ();
+    }
     device->Wait ();
 }
 
@@ -296,9 +311,32 @@ VulkanEnvironment::VulkanEnvironment (std::optional<GVK::DebugUtilsMessenger::Ca
         vkGetPhysicalDeviceFormatProperties (*physicalDevice, VK_FORMAT_R32G32B32_SFLOAT, &props);
     }
 
-    device = std::make_unique<GVK::DeviceObject> (*physicalDevice, std::vector<uint32_t> { *physicalDevice->GetQueueFamilies ().graphics }, deviceExtensions);
+    const GVK::PhysicalDevice::QueueFamilies queueFamilies = physicalDevice->GetQueueFamilies ();
+
+    const bool useAsyncCompute = queueFamilies.asyncCompute.has_value () && !disableAsyncComputeFlag.IsFlagOn ();
+
+    std::vector<uint32_t> queueFamilyIndices { *queueFamilies.graphics };
+    if (useAsyncCompute) {
+        queueFamilyIndices.push_back (*queueFamilies.asyncCompute);
+    }
+
+    std::unique_ptr<GVK::DeviceObject> deviceObject = std::make_unique<GVK::DeviceObject> (*physicalDevice, queueFamilyIndices, deviceExtensions);
+
+    // async compute is synchronized with timeline semaphores
+    const bool asyncComputeAvailable = useAsyncCompute && deviceObject->IsTimelineSemaphoreEnabled ();
+
+    const bool                           useDynamicRendering       = deviceObject->IsDynamicRenderingEnabled () && !disableDynamicRenderingFlag.IsFlagOn ();
+    const GVK::DynamicRenderingFunctions dynamicRenderingFunctions = deviceObject->GetDynamicRenderingFunctions ();
+
+    const bool memoryBudgetEnabled = deviceObject->IsMemoryBudgetEnabled ();
+
+    device = std::move (deviceObject);
+
+    allocator = std::make_unique<GVK::Allocator> (*instance, *physicalDevice, *device, memoryBudgetEnabled);
 
-    allocator = std::make_unique<GVK::Allocator> (*instance, *physicalDevice, *device);
+    if (memoryBudgetEnabled) {
+        spdlog::info ("Using VK_EXT_memory_budget.");
+    }
 
     graphicsQueue = std::make_unique<GVK::Queue> (*device, *physicalDevice->GetQueueFamilies ().graphics);
 
@@ -306,6 +344,38 @@ VulkanEnvironment::VulkanEnvironment (std::optional<GVK::DebugUtilsMessenger::Ca
 
     deviceExtra = std::make_unique<GVK::DeviceExtra> (*instance, *device, *commandPool, *allocator, *graphicsQueue);
 
+    if (asyncComputeAvailable) {
+        computeQueue       = std::make_unique<GVK::Queue> (*device, *queueFamilies.asyncCompute);
+        computeCommandPool = std::make_unique<GVK::CommandPool> (*device, *queueFamilies.asyncCompute);
+
+        deviceExtra->SetAsyncComputeQueue (*computeQueue, *computeCommandPool, queueFamilyIndices);
+
+        computeCommandPool->SetName (*deviceExtra, "VulkanEnvironment Compute CommandPool");
+
+        spdlog::info ("Using async compute queue (queue family {}).", *queueFamilies.asyncCompute);
+    }
+
+    if (useDynamicRendering) {
+        deviceExtra->SetDynamicRenderingFunctions (dynamicRenderingFunctions);
+
+        spdlog::info ("Using VK_KHR_dynamic_rendering.");
+    }
+
+    {
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties (*physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilyProperties (queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties (*physicalDevice, &queueFamilyCount, queueFamilyProperties.data ());
+
+        // operations are timed on every queue they are submitted to
+        uint32_t timestampValidBits = queueFamilyProperties[*queueFamilies.graphics].timestampValidBits;
+        if (asyncComputeAvailable) {
+            timestampValidBits = std::min (timestampValidBits, queueFamilyProperties[*queueFamilies.asyncCompute].timestampValidBits);
+        }
+
+        deviceExtra->SetTimestampProperties (physicalDevice->GetProperties ().limits.timestampPeriod, timestampValidBits);
+    }
+
     commandPool->SetName (*deviceExtra, "VulkanEnvironment CommandPool");
     static_cast<GVK::DeviceObject*> (device.get ())->SetName (*deviceExtra, "VulkanEnvironment DeviceObject");
 }
@@ -5,6 +5,8 @@
 
 #include "Utils/Assert.hpp"
 
+#include <memory>
+
 
 template<typename T>
 class PyExtract {
@@ -34,4 +36,26 @@ public:
     }
 };
 
+
+// callbacks are default constructed (null) or set to None from python when unused
+inline bool IsCallbackSet (const pybind11::object& callback)
+{
+    return callback && !callback.is_none ();
+}
+
+
+// Sequences are destroyed on C++ threads that do not hold the GIL.
+// The python objects are leaked when the interpreter was already finalized at exit.
+template<typename Impl>
+void ReleasePythonObjects (std::unique_ptr<Impl>& impl)
+{
+    if (!Py_IsInitialized ()) {
+        impl.release ();
+        return;
+    }
+
+    pybind11::gil_scoped_acquire gil;
+    impl.reset ();
+}
+
 #endif
\ No newline at end of file
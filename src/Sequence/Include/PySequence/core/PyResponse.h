@@ -35,6 +35,7 @@ public:
     pybind11::object setJoiner (pybind11::object joiner);
 
     void registerCallback (uint32_t msg, pybind11::object callback);
+    bool hasCallbacks () const;
 
 #if 0
     template<typename T>
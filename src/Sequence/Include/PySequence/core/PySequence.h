@@ -34,6 +34,7 @@ public:
     pybind11::object set (pybind11::object settings);
 
     pybind11::object          onReset (pybind11::object cb);
+    bool                      hasCallbacks () const;
     std::shared_ptr<PySequence> setAgenda (pybind11::object agenda);
 
     pybind11::object setPythonObject (pybind11::object o);
@@ -76,6 +76,9 @@ public:
     pybind11::object onFrame (pybind11::object callback);
     pybind11::object onFinish (pybind11::object callback);
 
+    // forward rendering, event and start/frame/finish callbacks
+    bool hasCallbacks () const;
+
     pybind11::object setPythonObject (pybind11::object o);
     pybind11::object getPythonObject () const;
 
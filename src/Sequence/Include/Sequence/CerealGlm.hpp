@@ -0,0 +1,39 @@
+#ifndef CEREALGLM_HPP
+#define CEREALGLM_HPP
+
+#include <glm/glm.hpp>
+
+// cereal serialization for the glm types used in Pass, Stimulus and SpatialFilter,
+// found by argument dependent lookup
+namespace glm {
+
+template<typename Archive>
+void serialize (Archive& ar, glm::vec2& v)
+{
+    ar (v.x, v.y);
+}
+
+
+template<typename Archive>
+void serialize (Archive& ar, glm::vec3& v)
+{
+    ar (v.x, v.y, v.z);
+}
+
+
+template<typename Archive>
+void serialize (Archive& ar, glm::vec4& v)
+{
+    ar (v.x, v.y, v.z, v.w);
+}
+
+
+template<typename Archive>
+void serialize (Archive& ar, glm::mat4& m)
+{
+    ar (m[0], m[1], m[2], m[3]);
+}
+
+} // namespace glm
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef FRAMEDIAGNOSTICS_HPP
+#define FRAMEDIAGNOSTICS_HPP
+
+// from Utils
+#include "Utils/Noncopyable.hpp"
+#include "Utils/SPSCQueue.hpp"
+
+// from Sequence
+#include "SequenceAPI.hpp"
+
+// from std
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+
+// Per-frame diagnostics of the render thread: window title, frame timing.
+// The render thread only pushes fixed size records to a preallocated lock-free queue,
+// formatting and logging happens on a background thread, which sleeps while the queue is empty.
+// The title is formatted at most a few times per second, the render thread only picks up the finished string.
+class SEQUENCE_API FrameDiagnostics : public Noncopyable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Statistics {
+        uint32_t processedCount;
+        uint32_t droppedCount;
+        uint32_t titleUpdateCount;
+    };
+
+private:
+    struct Record {
+        enum class Type : uint8_t {
+            Rendered,
+            Presented,
+        };
+
+        Type              type;
+        uint32_t          frameIndex;
+        uint32_t          stimulusFrameIndex;
+        uint32_t          stimulusDuration;
+        Clock::time_point time;
+        Clock::duration   renderTime;
+    };
+
+    const std::string sequenceNameInTitle;
+    const uint32_t    sequenceDuration;
+
+    Utils::SPSCQueue<Record, 1024> records;
+
+    std::atomic<bool>     stopRequested;
+    std::atomic<uint64_t> pushedCount;
+    std::atomic<uint64_t> processedCount;
+    std::atomic<uint32_t> droppedCount;
+    std::atomic<uint32_t> titleUpdateCount;
+
+    // the render thread takes the lock only when the background thread is going to sleep, see Wake
+    std::mutex              wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<bool>       waiting;
+
+    std::mutex                 titleMutex;
+    std::atomic<bool>          titleReady;
+    std::optional<std::string> pendingTitle;
+
+    // used only on the background thread
+    Clock::time_point lastTitleTime;
+    Clock::time_point lastTimingLogTime;
+    Clock::time_point lastPresentTime;
+    uint32_t          presentCount;
+    Clock::duration   maxPresentInterval;
+    uint32_t          renderCount;
+    Clock::duration   renderTimeSum;
+    Clock::duration   maxRenderTime;
+
+    std::thread thread;
+
+public:
+    FrameDiagnostics (const std::string& sequenceNameInTitle, uint32_t sequenceDuration);
+
+    ~FrameDiagnostics ();
+
+    // called on the render thread, blocks only while the idle background thread is going to sleep
+
+    void OnFrameRendered (uint32_t frameIndex, Clock::duration renderTime);
+    void OnFramePresented (uint32_t frameIndex, uint32_t stimulusFrameIndex, uint32_t stimulusDuration);
+
+    // returns a title when it changed since the last call, never blocks
+    std::optional<std::string> TryGetTitle ();
+
+    // blocks until all pushed records are processed
+    void Flush ();
+
+    Statistics GetStatistics () const;
+
+private:
+    void Wake ();
+    void ThreadFunction ();
+    void Process (const Record& record);
+    void LogTiming (Clock::time_point now);
+};
+
+
+#endif
@@ -4,6 +4,7 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
 #include <list>
 #include <map>
 #include <string>
@@ -13,6 +14,7 @@
 #ifdef GEARSVK_CEREAL
 #include <cereal/cereal.hpp>
 #include <cereal/types/polymorphic.hpp>
+#include "CerealGlm.hpp"
 #endif
 
 class Sequence;
@@ -49,6 +51,12 @@ public:
     ShaderFunctionMap   temporalShaderFunctions;
     using ShaderImageMap = std::map<std::string, std::string>;
     ShaderImageMap shaderImages;
+    //! Shader images are bound in name order starting at this binding.
+    static constexpr uint32_t ShaderImageFirstBinding = 110;
+    //! The FRAMESINFLIGHT specialization constant of the random generator and the pass shaders, the number of random layers.
+    static constexpr uint32_t RandomLayerCountConstantId = 0;
+    //! Shader variables are specialization constants starting at this id, colors and vectors are declared per component.
+    static constexpr uint32_t ShaderVariableFirstConstantId = 1;
 
     std::vector<glm::vec2> polygonMask;
     struct QuadData {
@@ -189,7 +197,10 @@ public:
 
     std::string getStimulusGeneratorVertexShaderSource (Pass::RasterizationMode mode) const;
     std::string getStimulusGeneratorGeometryShaderSource (Pass::RasterizationMode mode) const;
-    std::string getStimulusGeneratorShaderSource () const;
+    //! With more than one sub-frame, main is evaluated for every sub-frame and their results are packed into the color channels.
+    std::string getStimulusGeneratorShaderSource (uint32_t subFrameCount = 1) const;
+    //! Values of the specialization constants declared for the shader variables, colors and vectors by getStimulusGeneratorShaderSource.
+    std::map<std::string, float> getShaderVariableConstants () const;
 
     uint32_t getStartingFrame () const
     {
@@ -120,10 +120,14 @@ public:
     uint32_t               getDuration () const { return duration; }
     float              getTimeForFrame (unsigned int frame);
     const StimulusMap& getStimuli () const { return stimuli; }
+    const ResponseMap& getResponses () const { return responses; }
     const ChannelMap&  getChannels () const { return channels; }
     uint32_t               getChannelCount () const { return channels.size (); }
     const SignalMap&   getSignals () const { return signals; }
 
+    //! Number of sequence frames presented in one device frame. With high frequency rendering, three consecutive frames are packed into the red, green and blue channels.
+    uint32_t getSubFrameCount () const { return useHighFreqRender ? 3 : 1; }
+
     void setupGeometry (
         float        fieldWidth_um,
         float        fieldHeight_um,
@@ -269,12 +273,6 @@ public:
         ar (CEREAL_NVP (greyscale));
         ar (CEREAL_NVP (useOpenCL));
         ar (CEREAL_NVP (useHighFreqRender));
-        ar (CEREAL_NVP (maxRandomGridWidth));
-        ar (CEREAL_NVP (maxRandomGridHeight));
-        ar (CEREAL_NVP (exportRandomsWithHashmark));
-        ar (CEREAL_NVP (exportRandomsChannelCount));
-        ar (CEREAL_NVP (exportRandomsAsReal));
-        ar (CEREAL_NVP (exportRandomsAsBinary));
         ar (CEREAL_NVP (maxParticleGridWidth));
         ar (CEREAL_NVP (maxParticleGridHeight));
         ar (CEREAL_NVP (fieldWidth_um));
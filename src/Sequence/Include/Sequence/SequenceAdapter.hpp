@@ -22,29 +22,49 @@ class StimulusAdapterView;
 class Stimulus;
 class Sequence;
 class IRandomExporter;
+class ISignalSink;
+class FrameDiagnostics;
+class SignalDispatcher;
 
 namespace RG {
 class VulkanEnvironment;
 class Presentable;
 class SynchronizedSwapchainGraphRenderer;
+class ImageLoader;
+class PresentTimingLog;
 }
 
 
 class SEQUENCE_API SequenceAdapter : public RG::IFrameDisplayObserver {
+public:
+    // starting frame of a stimulus -> starting frame of the first stimulus equivalent to it, they share their adapter
+    using EquivalentStimulusMap = std::map<uint32_t, uint32_t>;
+
 private:
     const std::shared_ptr<Sequence> sequence;
 
+    const EquivalentStimulusMap equivalentStimuli;
+
     std::optional<uint32_t> lastRenderedFrameIndex;
 
     RG::VulkanEnvironment&           environment;
     std::shared_ptr<RG::Presentable> currentPresentable;
 
+    // shared by all stimuli, images are loaded once for all presentables
+    std::unique_ptr<RG::ImageLoader> imageLoader;
+
     std::map<std::shared_ptr<Stimulus const>, std::shared_ptr<StimulusAdapterView>> views;
 
     std::unique_ptr<RG::SynchronizedSwapchainGraphRenderer> renderer;
 
     std::unique_ptr<IRandomExporter> randomExporter;
 
+    std::unique_ptr<SignalDispatcher> signalDispatcher;
+
+    std::unique_ptr<FrameDiagnostics> frameDiagnostics;
+
+    std::unique_ptr<RG::PresentTimingLog> presentTimingLog;
+
     std::vector<uint32_t> resourceIndexToRenderedFrameMapping;
 
     std::string sequenceNameInTitle;
@@ -52,10 +72,23 @@ private:
 public:
     SequenceAdapter (RG::VulkanEnvironment& environment, const std::shared_ptr<Sequence>& sequence, const std::string& sequenceNameInTitle);
 
+    // the equivalent stimuli are not searched again, see SequenceBundle
+    SequenceAdapter (RG::VulkanEnvironment& environment, const std::shared_ptr<Sequence>& sequence, const std::string& sequenceNameInTitle, const EquivalentStimulusMap& equivalentStimuli);
+
+    static EquivalentStimulusMap FindEquivalentStimuli (const Sequence& sequence);
+
     virtual ~SequenceAdapter () = default;
 
+    // compiles the shaders of every stimulus that has its own adapter, see StimulusAdapter::PrecompileShaders
+    void PrecompileShaders () const;
+
+    // with high frequency rendering, the frame and the following sub-frames are rendered into one image
     void RenderFrameIndex (const uint32_t frameIndex);
 
+    // renders the sequence frame displayed at the given device frame, counted from 0
+    // with a frame rate divisor, the frame is rendered once and presented again on the following device frames
+    void RenderDeviceFrame (const uint32_t deviceFrameIndex);
+
     void Wait ();
 
     void SetCurrentPresentable (std::shared_ptr<RG::Presentable> presentable);
@@ -66,12 +99,28 @@ public:
 
     std::shared_ptr<Sequence> GetSequence () { return sequence; }
 
+    const EquivalentStimulusMap& GetEquivalentStimuli () const { return equivalentStimuli; }
+
+    // signals are logged by default
+    void SetSignalSink (std::unique_ptr<ISignalSink>&& sink);
+
+    SignalDispatcher& GetSignalDispatcher () { return *signalDispatcher; }
+
+    // timing of the device frames presented since the current presentable was set
+    const RG::PresentTimingLog& GetPresentTimingLog () const { return *presentTimingLog; }
+
+    // created for the current presentable
+    RG::SynchronizedSwapchainGraphRenderer& GetRenderer () { return *renderer; }
+
     // implementing RG::IFrameDisplayObserver
 
     virtual void OnImageAcquisitionFenceSignaled (uint32_t) override;
+    virtual void OnFramePresented (const RG::FrameTiming&) override;
 
 private:
     void CreateStimulusAdapterViews ();
+    void RepeatLastFrame ();
+    void RecreateSwapchain ();
 };
 
 
@@ -0,0 +1,64 @@
+#ifndef SEQUENCEBUNDLE_HPP
+#define SEQUENCEBUNDLE_HPP
+
+// from Sequence
+#include "SequenceAPI.hpp"
+#include "SequenceAdapter.hpp"
+
+// from std
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+
+class Sequence;
+
+namespace RG {
+class VulkanEnvironment;
+}
+
+namespace GVK {
+class DeviceExtra;
+}
+
+
+// A sequence loaded from Python once and saved with everything needed to start it again:
+// the sequence itself, the equivalent stimuli, the SPIR-V of its shaders and the pipeline cache data.
+// Starting from a bundle does not run the Python interpreter and glslang.
+// Python callbacks of the sequence (onReset, onFrame, registerCallback, ...) cannot be saved, sequences using them are not bundled.
+class SEQUENCE_API SequenceBundle {
+public:
+    static constexpr uint32_t Version = 1;
+
+    std::filesystem::path                     sourcePath;
+    uint64_t                                  sourceHash;
+    std::shared_ptr<Sequence>                 sequence;
+    SequenceAdapter::EquivalentStimulusMap    equivalentStimuli;
+    std::map<uint64_t, std::vector<uint32_t>> shaderBinaries;
+    std::vector<uint8_t>                      pipelineCacheData;
+
+    // the pyx file and every python file of the project it can import
+    // the project is the closest "Project" folder containing the pyx file, or the folder of the pyx file
+    static uint64_t GetSourceHash (const std::filesystem::path& pyxPath);
+
+    // throws for sequences with python callbacks
+    // should be called after the sequence was rendered, so all shaders are compiled and all pipelines are created
+    static void Write (const std::filesystem::path& bundlePath, const std::filesystem::path& pyxPath, SequenceAdapter& sequenceAdapter, const GVK::DeviceExtra& device);
+
+    // returns nullopt for missing files and files written by a different version
+    static std::optional<SequenceBundle> Read (const std::filesystem::path& bundlePath);
+
+    bool HasSource () const;
+
+    // false if the source was modified since the bundle was written or the source is not available
+    bool IsUpToDate () const;
+
+    // the shader binaries are added to the ShaderBinaryCache and the pipeline cache data to the cache of the device
+    std::unique_ptr<SequenceAdapter> CreateSequenceAdapter (RG::VulkanEnvironment& environment) const;
+};
+
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef SIGNALDISPATCHER_HPP
+#define SIGNALDISPATCHER_HPP
+
+// from Utils
+#include "Utils/Noncopyable.hpp"
+#include "Utils/SPSCQueue.hpp"
+
+// from Sequence
+#include "SequenceAPI.hpp"
+
+// from std
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Sequence;
+
+
+struct SEQUENCE_API SignalEdge {
+    uint32_t    frameIndex; // sequence frame index
+    std::string channel;
+    std::string port;
+    bool        clear;
+};
+
+
+class SEQUENCE_API ISignalSink {
+public:
+    virtual ~ISignalSink () = default;
+
+    // called on the dispatcher thread
+    virtual void Emit (const SignalEdge& edge) = 0;
+};
+
+
+// logs signals, used when no output is set
+class SEQUENCE_API LogSignalSink : public ISignalSink {
+public:
+    virtual void Emit (const SignalEdge& edge) override;
+};
+
+
+// writes one line per signal edge, the path can be a regular file, a fifo or a pty
+class SEQUENCE_API FileSignalSink : public ISignalSink {
+private:
+    std::ofstream stream;
+
+public:
+    FileSignalSink (const std::filesystem::path& path);
+
+    virtual void Emit (const SignalEdge& edge) override;
+};
+
+
+// Emits the signals of presented frames on a separate thread.
+// The render thread only pushes the presentation time of a frame to a lock-free queue,
+// the dispatcher thread waits until the time of each scheduled signal edge and emits it to the sink.
+// With busy waiting, the last part of the wait before an edge spins instead of sleeping for sub-millisecond accuracy,
+// the thread blocks while there are no presented frames.
+class SEQUENCE_API SignalDispatcher : public Noncopyable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Statistics {
+        uint32_t emittedCount;
+        uint32_t droppedFrameCount;
+        double   meanJitterMicroseconds; // mean of absolute differences between intended and actual emission
+        double   maxJitterMicroseconds;
+    };
+
+private:
+    struct PresentedFrame {
+        uint32_t          frameIndex;
+        Clock::time_point presentedAt;
+    };
+
+    // sorted by frame index
+    const std::vector<SignalEdge> schedule;
+
+    const std::unique_ptr<ISignalSink> sink;
+
+    // frames presented with one device frame, signals of the later sub-frames are delayed
+    const Clock::duration subFrameInterval;
+    const uint32_t        subFrameCount;
+    const bool            busyWait;
+
+    Utils::SPSCQueue<PresentedFrame, 256> presentedFrames;
+
+    std::atomic<bool>     stopRequested;
+    std::atomic<uint64_t> pushedCount;
+    std::atomic<uint64_t> dispatchedCount;
+    std::atomic<uint32_t> droppedFrameCount;
+
+    // wakes the dispatcher thread when a frame is pushed or stop is requested, only used while it is sleeping
+    std::atomic<bool>       sleeping;
+    std::mutex              wakeMutex;
+    std::condition_variable wakeCondition;
+
+    mutable std::mutex statisticsMutex;
+    uint32_t           emittedCount;
+    double             jitterSumMicroseconds;
+    double             maxJitterMicroseconds;
+
+    std::thread thread;
+
+public:
+    SignalDispatcher (std::vector<SignalEdge>&& schedule, std::unique_ptr<ISignalSink>&& sink, Clock::duration subFrameInterval, uint32_t subFrameCount, bool busyWait);
+
+    // waits for the already presented frames
+    ~SignalDispatcher ();
+
+    // starts the dispatcher thread, called when rendering starts, later calls do nothing
+    void Start ();
+
+    // called on the render thread, lock-free unless the dispatcher thread is sleeping
+    void OnFramePresented (uint32_t frameIndex, Clock::time_point presentedAt);
+
+    // blocks until the signals of all presented frames are emitted, the dispatcher must be started
+    void Flush ();
+
+    Statistics GetStatistics () const;
+
+    // all sequence and stimulus signals in sequence frame indices
+    static std::vector<SignalEdge> CreateSchedule (const Sequence& sequence);
+
+private:
+    void ThreadFunction ();
+    void Dispatch (const PresentedFrame& frame);
+    void WaitUntil (Clock::time_point time) const;
+};
+
+
+#endif
@@ -11,6 +11,7 @@
 #ifdef GEARSVK_CEREAL
 #include <cereal/cereal.hpp>
 #include <cereal/types/polymorphic.hpp>
+#include "CerealGlm.hpp"
 #endif
 
 class Sequence;
@@ -18,6 +18,7 @@
 #ifdef GEARSVK_CEREAL
 #include <cereal/cereal.hpp>
 #include <cereal/types/polymorphic.hpp>
+#include "CerealGlm.hpp"
 #endif
 
 class Pass;
@@ -244,11 +245,11 @@ public:
         ar (CEREAL_NVP (temporalWeightMin));
         ar (CEREAL_NVP (temporalProcessingStateTransitionMatrix));
         ar (CEREAL_NVP (spatialFilter));
-        ar (CEREAL_NVP (randomGeneratorShaderSource));
-        ar (CEREAL_NVP (randomGridWidth));
-        ar (CEREAL_NVP (randomGridHeight));
-        ar (CEREAL_NVP (randomSeed));
-        ar (CEREAL_NVP (freezeRandomsAfterFrame));
+        ar (CEREAL_NVP (rngCompute_shaderSource));
+        ar (CEREAL_NVP (rngCompute_workGroupSizeX));
+        ar (CEREAL_NVP (rngCompute_workGroupSizeY));
+        ar (CEREAL_NVP (rngCompute_seed));
+        ar (CEREAL_NVP (rngCompute_multiLayer));
         ar (CEREAL_NVP (particleShaderSource));
         ar (CEREAL_NVP (particleGridWidth));
         ar (CEREAL_NVP (particleGridHeight));
@@ -17,6 +17,8 @@
 
 #include "glm/glm.hpp"
 
+#include <vulkan/vulkan.h>
+
 class Pass;
 class Stimulus;
 
@@ -32,6 +34,7 @@ class Operation;
 class SynchronizedSwapchainGraphRenderer;
 class Renderer;
 class GPUBufferResource;
+class ImageLoader;
 class IFrameDisplayObserver;
 class VulkanEnvironment;
 } // namespace RG
@@ -52,16 +55,28 @@ private:
 
     const std::shared_ptr<Stimulus const>  stimulus;
 
+    // the sequence's field in swapchain coordinates, clipped to the swapchain
+    const VkRect2D  fieldArea;
     const glm::vec2 patternSizeOnRetina;
     const double    deviceRefreshRate;
 
+    // sequence frames rendered into one swapchain image, see Sequence::getSubFrameCount
+    const uint32_t subFrameCount;
+    const uint32_t frameRateDivisor;
+
     std::shared_ptr<RG::RenderGraph>                                renderGraph;
     std::shared_ptr<RG::UniformReflection>                          reflection;
     std::map<std::shared_ptr<Pass>, std::shared_ptr<RG::Operation>> passToOperation;
     std::shared_ptr<RG::Operation>                                  randomGeneratorOperation;
 
 public:
-    StimulusAdapter (const RG::VulkanEnvironment& environment, RG::Presentable& presentable, const std::shared_ptr<Stimulus const>& stimulus);
+    StimulusAdapter (const RG::VulkanEnvironment& environment, RG::ImageLoader& imageLoader, RG::Presentable& presentable, const std::shared_ptr<Stimulus const>& stimulus);
+
+    // fills the ShaderBinaryCache with the shaders the adapter compiles, they do not depend on the presentable,
+    // does not use the device, can be called from any thread
+    static void PrecompileShaders (const std::shared_ptr<Stimulus const>& stimulus);
+
+    VkRect2D GetFieldArea () const { return fieldArea; }
 
     void RenderFrameIndex (RG::Renderer&                          renderer,
                            const std::shared_ptr<Stimulus const>& stimulus,
@@ -69,6 +84,9 @@ public:
                            RG::IFrameDisplayObserver&             frameDisplayObserver,
                            IRandomExporter&                       randomExporter);
 
+    // moves the host visible memory of the render graph together, waits for the device, see RG::RenderGraph::DefragmentMemory
+    void DefragmentMemory ();
+
     void Wait ();
 
 private:
@@ -22,23 +22,27 @@ class VulkanEnvironment;
 class Presentable;
 class Renderer;
 class IFrameDisplayObserver;
+class ImageLoader;
 } // namespace RG
 
 
 class SEQUENCE_API StimulusAdapterView : public Noncopyable {
 private:
-    RG::VulkanEnvironment&               environment;
+    RG::VulkanEnvironment&                environment;
+    RG::ImageLoader&                      imageLoader;
     const std::shared_ptr<Stimulus const> stimulus;
 
     std::map<std::shared_ptr<RG::Presentable>, std::shared_ptr<StimulusAdapter>> compiledAdapters;
 
 public:
-    StimulusAdapterView (RG::VulkanEnvironment& environment, const std::shared_ptr<Stimulus const>& stimulus);
+    StimulusAdapterView (RG::VulkanEnvironment& environment, RG::ImageLoader& imageLoader, const std::shared_ptr<Stimulus const>& stimulus);
 
     void CreateForPresentable (std::shared_ptr<RG::Presentable>& presentable);
 
     void DestroyForPresentable (const std::shared_ptr<RG::Presentable>& presentable);
 
+    void DefragmentMemory (const std::shared_ptr<RG::Presentable>& presentable);
+
     void RenderFrameIndex (RG::Renderer&                     renderer,
                            std::shared_ptr<RG::Presentable>&     presentable,
                            const std::shared_ptr<Stimulus const>& stimulus,
@@ -0,0 +1,198 @@
+#include "FrameDiagnostics.hpp"
+
+// from Utils
+#include "Utils/Trace.hpp"
+
+// from std
+#include <algorithm>
+#include <cmath>
+
+#include "spdlog/spdlog.h"
+
+
+static constexpr std::chrono::milliseconds TitleUpdateInterval { 250 };
+static constexpr std::chrono::seconds      TimingLogInterval { 5 };
+
+
+FrameDiagnostics::FrameDiagnostics (const std::string& sequenceNameInTitle, uint32_t sequenceDuration)
+    : sequenceNameInTitle { sequenceNameInTitle }
+    , sequenceDuration { sequenceDuration }
+    , stopRequested { false }
+    , pushedCount { 0 }
+    , processedCount { 0 }
+    , droppedCount { 0 }
+    , titleUpdateCount { 0 }
+    , waiting { false }
+    , titleReady { false }
+    , lastTitleTime {}
+    , lastTimingLogTime { Clock::now () }
+    , lastPresentTime {}
+    , presentCount { 0 }
+    , maxPresentInterval { 0 }
+    , renderCount { 0 }
+    , renderTimeSum { 0 }
+    , maxRenderTime { 0 }
+{
+    thread = std::thread (&FrameDiagnostics::ThreadFunction, this);
+}
+
+
+FrameDiagnostics::~FrameDiagnostics ()
+{
+    stopRequested = true;
+    Wake ();
+    thread.join ();
+}
+
+
+void FrameDiagnostics::OnFrameRendered (uint32_t frameIndex, Clock::duration renderTime)
+{
+    if (records.TryPush ({ Record::Type::Rendered, frameIndex, 0, 0, Clock::now (), renderTime })) {
+        ++pushedCount;
+        Wake ();
+    } else {
+        ++droppedCount;
+    }
+}
+
+
+void FrameDiagnostics::OnFramePresented (uint32_t frameIndex, uint32_t stimulusFrameIndex, uint32_t stimulusDuration)
+{
+    if (records.TryPush ({ Record::Type::Presented, frameIndex, stimulusFrameIndex, stimulusDuration, Clock::now (), Clock::duration::zero () })) {
+        ++pushedCount;
+        Wake ();
+    } else {
+        ++droppedCount;
+    }
+}
+
+
+std::optional<std::string> FrameDiagnostics::TryGetTitle ()
+{
+    if (!titleReady.load (std::memory_order_acquire)) {
+        return std::nullopt;
+    }
+
+    // the background thread is writing the title, it will be picked up next frame
+    std::unique_lock<std::mutex> lock (titleMutex, std::try_to_lock);
+    if (!lock.owns_lock ()) {
+        return std::nullopt;
+    }
+
+    titleReady = false;
+
+    std::optional<std::string> result;
+    result.swap (pendingTitle);
+    return result;
+}
+
+
+void FrameDiagnostics::Flush ()
+{
+    while (processedCount.load () != pushedCount.load ()) {
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+}
+
+
+FrameDiagnostics::Statistics FrameDiagnostics::GetStatistics () const
+{
+    return { static_cast<uint32_t> (processedCount.load ()), droppedCount.load (), titleUpdateCount.load () };
+}
+
+
+void FrameDiagnostics::Wake ()
+{
+    // waiting is set before the background thread checks pushedCount and stopRequested under the lock,
+    // so either it sees the new value, or the notification is sent after it started waiting
+    if (waiting) {
+        std::lock_guard<std::mutex> lock (wakeMutex);
+        wakeCondition.notify_one ();
+    }
+}
+
+
+void FrameDiagnostics::ThreadFunction ()
+{
+    while (true) {
+        const std::optional<Record> record = records.TryPop ();
+
+        if (!record.has_value ()) {
+            if (stopRequested) {
+                break;
+            }
+
+            std::unique_lock<std::mutex> lock (wakeMutex);
+            waiting = true;
+            wakeCondition.wait (lock, [&] { return stopRequested || pushedCount != processedCount; });
+            waiting = false;
+            continue;
+        }
+
+        Process (*record);
+
+        ++processedCount;
+    }
+}
+
+
+void FrameDiagnostics::Process (const Record& record)
+{
+    Utils::TraceScope traceScope ("FrameDiagnostics::Process", "Diagnostics");
+
+    switch (record.type) {
+        case Record::Type::Rendered:
+            ++renderCount;
+            renderTimeSum += record.renderTime;
+            maxRenderTime = std::max (maxRenderTime, record.renderTime);
+            break;
+
+        case Record::Type::Presented:
+            if (presentCount > 0) {
+                maxPresentInterval = std::max (maxPresentInterval, record.time - lastPresentTime);
+            }
+            lastPresentTime = record.time;
+            ++presentCount;
+
+            if (record.time - lastTitleTime >= TitleUpdateInterval) {
+                lastTitleTime = record.time;
+
+                std::string title = fmt::format ("GearsVk - {} [stimulus frame: {} / {} ({}), sequence frame: {} / {} ({})",
+                                                 sequenceNameInTitle,
+                                                 record.stimulusFrameIndex, record.stimulusDuration, std::floor (static_cast<double> (record.stimulusFrameIndex) / record.stimulusDuration * 100.0),
+                                                 record.frameIndex, sequenceDuration, std::floor (static_cast<double> (record.frameIndex) / sequenceDuration * 100.0));
+
+                std::lock_guard<std::mutex> lock (titleMutex);
+                pendingTitle = std::move (title);
+                titleReady   = true;
+                ++titleUpdateCount;
+            }
+            break;
+    }
+
+    if (record.time - lastTimingLogTime >= TimingLogInterval) {
+        LogTiming (record.time);
+    }
+}
+
+
+void FrameDiagnostics::LogTiming (Clock::time_point now)
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    const double meanRenderTime = renderCount > 0 ? Milliseconds (renderTimeSum).count () / renderCount : 0.0;
+
+    spdlog::debug ("Frame timing: {} frames presented, max present interval {:.3f} ms, render thread {:.3f} ms mean, {:.3f} ms max, {} records dropped.",
+                   presentCount,
+                   Milliseconds (maxPresentInterval).count (),
+                   meanRenderTime,
+                   Milliseconds (maxRenderTime).count (),
+                   droppedCount.load ());
+
+    lastTimingLogTime  = now;
+    presentCount       = 0;
+    maxPresentInterval = Clock::duration::zero ();
+    renderCount        = 0;
+    renderTimeSum      = Clock::duration::zero ();
+    maxRenderTime      = Clock::duration::zero ();
+}
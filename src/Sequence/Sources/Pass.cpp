@@ -6,6 +6,7 @@
 #include <ctime>
 #include <fstream>
 #include <limits>
+#include <regex>
 #include <sstream>
 
 #include "Utils/FileSystemUtils.hpp"
@@ -378,6 +379,78 @@ static std::string GenerateUniformBlock (const uint32_t binding, const std::stri
 }
 
 
+static std::string GetComponentConstantName (const std::string& varName, const char* component)
+{
+    return "gears_" + varName + "_" + component;
+}
+
+
+// the values are set when the pipeline is created, so passes with different values share their SPIR-V
+static std::string GenerateShaderVariableConstants (const Pass& pass)
+{
+    std::stringstream ss;
+
+    uint32_t   constantId       = Pass::ShaderVariableFirstConstantId;
+    const auto declareComponent = [&] (const std::string& name) {
+        ss << "layout (constant_id = " << constantId++ << ") const float " << name << " = 0.0;" << std::endl;
+    };
+
+    for (auto& svar : pass.shaderColors) {
+        declareComponent (GetComponentConstantName (svar.first, "x"));
+        declareComponent (GetComponentConstantName (svar.first, "y"));
+        declareComponent (GetComponentConstantName (svar.first, "z"));
+        ss << "const vec3 " << svar.first << " = vec3 (" << GetComponentConstantName (svar.first, "x") << ", " << GetComponentConstantName (svar.first, "y") << ", " << GetComponentConstantName (svar.first, "z") << ");" << std::endl;
+    }
+    for (auto& svar : pass.shaderVectors) {
+        declareComponent (GetComponentConstantName (svar.first, "x"));
+        declareComponent (GetComponentConstantName (svar.first, "y"));
+        ss << "const vec2 " << svar.first << " = vec2 (" << GetComponentConstantName (svar.first, "x") << ", " << GetComponentConstantName (svar.first, "y") << ");" << std::endl;
+    }
+    for (auto& svar : pass.shaderVariables) {
+        declareComponent (svar.first);
+    }
+
+    return ss.str ();
+}
+
+
+std::map<std::string, float> Pass::getShaderVariableConstants () const
+{
+    std::map<std::string, float> result;
+
+    for (auto& svar : shaderColors) {
+        result[GetComponentConstantName (svar.first, "x")] = svar.second.x;
+        result[GetComponentConstantName (svar.first, "y")] = svar.second.y;
+        result[GetComponentConstantName (svar.first, "z")] = svar.second.z;
+    }
+    for (auto& svar : shaderVectors) {
+        result[GetComponentConstantName (svar.first, "x")] = svar.second.x;
+        result[GetComponentConstantName (svar.first, "y")] = svar.second.y;
+    }
+    for (auto& svar : shaderVariables) {
+        result[svar.first] = svar.second;
+    }
+
+    return result;
+}
+
+
+// image samplers are declared by the patterns without a binding, they would all end up on binding 0
+static std::string BindShaderImages (const std::string& shaderSource, const Pass::ShaderImageMap& shaderImages)
+{
+    std::string result = shaderSource;
+
+    uint32_t binding = Pass::ShaderImageFirstBinding;
+    for (auto& [varName, file] : shaderImages) {
+        const std::regex declaration ("uniform\\s+sampler2D\\s+" + varName + "\\s*;");
+        result = std::regex_replace (result, declaration, "layout (binding = " + std::to_string (binding) + ") uniform sampler2D " + varName + ";");
+        ++binding;
+    }
+
+    return result;
+}
+
+
 /*
 static void ReplaceAll (std::string& str, const std::string& from, const std::string& to)
 {
@@ -394,8 +467,47 @@ static void ReplaceAll (std::string& str, const std::string& from, const std::st
 */
 
 
-std::string Pass::getStimulusGeneratorShaderSource () const
+// time and frame are shadowed by per sub-frame values, so the generator functions and main can be used as they are
+static const char* SubFramePrologue = R"GLSLCODE(
+int   gearsSubFrameIndex = 0;
+int   gearsSubFrameFrame = 0;
+float gearsSubFrameTime  = 0.0;
+
+#define GEARS_SUBFRAME_INDEX gearsSubFrameIndex
+#define frame gearsSubFrameFrame
+#define time gearsSubFrameTime
+#define main gearsSubFrameMain
+)GLSLCODE";
+
+
+// sub-frame i is written to channel i, alpha masks are expected to be the same for all sub-frames
+static const char* SubFrameEpilogue = R"GLSLCODE(
+#undef main
+#undef time
+#undef frame
+
+void main ()
 {
+    vec4 result = vec4 (0.0);
+    for (int i = 0; i < GEARS_SUBFRAME_COUNT; ++i) {
+        gearsSubFrameIndex = i;
+        gearsSubFrameFrame = frame + i;
+        gearsSubFrameTime  = time + float (i) * subFrameTimeStep;
+
+        gearsSubFrameMain ();
+
+        result[i] = presented[i];
+        result.a  = presented.a;
+    }
+    presented = result;
+}
+)GLSLCODE";
+
+
+std::string Pass::getStimulusGeneratorShaderSource (uint32_t subFrameCount) const
+{
+    GVK_ASSERT (subFrameCount >= 1 && subFrameCount <= 3);
+
     static const char* GLSL_VERSION = "#version 450";
     static const char* NEWLINE = "\n";
 
@@ -408,22 +520,24 @@ std::string Pass::getStimulusGeneratorShaderSource () const
     std::vector<std::pair<std::string, std::string>> commonBlock;
 
     commonBlock.emplace_back ("vec2", "patternSizeOnRetina");
+    // gl_FragCoord is relative to the swapchain, patterns subtract the origin of the field
+    commonBlock.emplace_back ("vec2", "fieldOffset");
     commonBlock.emplace_back ("int", "swizzleForFft");
     commonBlock.emplace_back ("int", "frame");
     commonBlock.emplace_back ("float", "time");
-
-    for (auto& svar : shaderColors) {
-        commonBlock.emplace_back ("vec3", svar.first);
-    }
-    for (auto& svar : shaderVectors) {
-        commonBlock.emplace_back ("vec2", svar.first);
-    }
-    for (auto& svar : shaderVariables) {
-        commonBlock.emplace_back ("float", svar.first);
+    if (subFrameCount > 1) {
+        commonBlock.emplace_back ("float", "subFrameTimeStep");
     }
 
     shaderSource += GenerateUniformBlock (1, "commonUniformBlock", commonBlock);
 
+    shaderSource += GenerateShaderVariableConstants (*this);
+
+    if (subFrameCount > 1) {
+        shaderSource += "#define GEARS_SUBFRAME_COUNT " + std::to_string (subFrameCount) + NEWLINE;
+        shaderSource += SubFramePrologue;
+    }
+
     for (const std::string& sfunc : shaderFunctionOrder) {
         std::string funcSource = shaderFunctions.find (sfunc)->second;
 /*
@@ -439,7 +553,13 @@ std::string Pass::getStimulusGeneratorShaderSource () const
         shaderSource += "\n";
     }
 
-    return shaderSource + stimulusGeneratorShaderSource;
+    shaderSource += stimulusGeneratorShaderSource;
+
+    if (subFrameCount > 1) {
+        shaderSource += SubFrameEpilogue;
+    }
+
+    return BindShaderImages (shaderSource, shaderImages);
 }
 
 
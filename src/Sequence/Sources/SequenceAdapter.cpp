@@ -4,13 +4,19 @@
 #include "Utils/Assert.hpp"
 #include "Utils/CommandLineFlag.hpp"
 #include "Utils/FileSystemUtils.hpp"
+#include "Utils/Trace.hpp"
 
 #include "StimulusAdapter.hpp"
 #include "StimulusAdapterView.hpp"
+#include "SignalDispatcher.hpp"
+#include "FrameDiagnostics.hpp"
 
 #include "RenderGraph/Window/GLFWWindow.hpp"
 #include "RenderGraph/GraphRenderer.hpp"
+#include "RenderGraph/ImageLoader.hpp"
+#include "RenderGraph/PresentTimingLog.hpp"
 #include "VulkanWrapper/Surface.hpp"
+#include "VulkanWrapper/ObjectCache.hpp"
 #include "RenderGraph/VulkanEnvironment.hpp"
 #include "VulkanWrapper/Utils/ImageData.hpp"
 #include "RenderGraph/Resource.hpp"
@@ -22,7 +28,9 @@
 
 // from std
 #include <algorithm>
+#include <chrono>
 #include <iomanip>
+#include <filesystem>
 #include <fstream>
 #include <map>
 #include <sstream>
@@ -160,16 +168,48 @@ static std::unique_ptr<IRandomExporter> GetRandomExporterImpl (GVK::DeviceExtra&
 }
 
 
+Utils::CommandLineOnOffFlag presentTimingLogFlag { "--presentTimingLog", "Saves the timing of every presented frame to %temp%/GearsVk/PresentTiming.bin" };
+
+static std::unique_ptr<RG::PresentTimingLog> GetPresentTimingLogImpl (const std::shared_ptr<Sequence>& sequence)
+{
+    const std::chrono::duration<double> refreshInterval (1.0 / static_cast<double> (sequence->deviceFrameRate));
+    const std::chrono::nanoseconds      expectedInterval = std::chrono::duration_cast<std::chrono::nanoseconds> (refreshInterval);
+
+    if (presentTimingLogFlag.IsFlagOn ()) {
+        const std::filesystem::path dir = std::filesystem::temp_directory_path () / "GearsVk";
+        std::filesystem::create_directories (dir);
+        return std::make_unique<RG::PresentTimingLog> (expectedInterval, dir / "PresentTiming.bin");
+    }
+
+    return std::make_unique<RG::PresentTimingLog> (expectedInterval);
+}
+
+
 Utils::CommandLineOnOffFlag printSignalsFlag { "--printSignals", "Prints signals to stdout." };
 
+Utils::CommandLineOnOffFlag defragmentMemoryFlag { "--defragmentMemory", "Defragments the host visible memory of every stimulus before its first frame. Waits for the device, the previous frame may stay on the screen longer." };
+
 SequenceAdapter::SequenceAdapter (RG::VulkanEnvironment& environment, const std::shared_ptr<Sequence>& sequence, const std::string& sequenceNameInTitle)
+    : SequenceAdapter (environment, sequence, sequenceNameInTitle, FindEquivalentStimuli (*sequence))
+{
+}
+
+
+SequenceAdapter::SequenceAdapter (RG::VulkanEnvironment& environment, const std::shared_ptr<Sequence>& sequence, const std::string& sequenceNameInTitle, const EquivalentStimulusMap& equivalentStimuli)
     : sequence { sequence }
+    , equivalentStimuli { equivalentStimuli }
     , environment { environment }
+    , imageLoader { std::make_unique<RG::ImageLoader> (*environment.deviceExtra) }
     , randomExporter { GetRandomExporterImpl (*environment.deviceExtra, sequence) }
+    , frameDiagnostics { std::make_unique<FrameDiagnostics> (sequenceNameInTitle, sequence->getDuration ()) }
     , sequenceNameInTitle { sequenceNameInTitle }
 {
+    Utils::TraceScope traceScope ("SequenceAdapter creation", "Sequence");
+
     CreateStimulusAdapterViews ();
 
+    SetSignalSink (std::make_unique<LogSignalSink> ());
+
     if (printSignalsFlag.IsFlagOn ()) {
         spdlog::info ("======= Sequence signals =======");
         for (auto& signal : sequence->getSignals ()) {
@@ -194,29 +234,62 @@ SequenceAdapter::SequenceAdapter (RG::VulkanEnvironment& environment, const std:
 }
 
 
-void SequenceAdapter::CreateStimulusAdapterViews ()
+SequenceAdapter::EquivalentStimulusMap SequenceAdapter::FindEquivalentStimuli (const Sequence& sequence)
 {
-    std::map<std::shared_ptr<Stimulus const>, std::shared_ptr<StimulusAdapterView>> created;
+    Utils::TraceScope traceScope ("SequenceAdapter::FindEquivalentStimuli", "Sequence");
 
-    size_t stindex = 0;
+    EquivalentStimulusMap result;
 
-    for (auto& [_, stim] : sequence->getStimuli ()) {
-        std::shared_ptr<StimulusAdapterView> equivalentAdapter;
-        for (const auto& [mappedStimulus, adapter] : created) {
-            if (mappedStimulus->IsEquivalent (*stim)) {
-                equivalentAdapter = adapter;
+    std::vector<std::pair<uint32_t, std::shared_ptr<Stimulus const>>> representatives;
+
+    for (auto& [startingFrame, stim] : sequence.getStimuli ()) {
+        uint32_t representative = startingFrame;
+        for (const auto& [representativeStartingFrame, representativeStimulus] : representatives) {
+            if (representativeStimulus->IsEquivalent (*stim)) {
+                representative = representativeStartingFrame;
                 break;
             }
         }
 
-        if (equivalentAdapter != nullptr) {
-            views[stim] = equivalentAdapter;
-        } else {
-            views[stim]   = std::make_unique<StimulusAdapterView> (environment, stim);
-            created[stim] = views[stim];
+        if (representative == startingFrame) {
+            representatives.emplace_back (startingFrame, stim);
+        }
+
+        result[startingFrame] = representative;
+    }
+
+    return result;
+}
+
+
+void SequenceAdapter::PrecompileShaders () const
+{
+    Utils::TraceScope traceScope ("SequenceAdapter::PrecompileShaders", "Sequence");
+
+    for (auto& [startingFrame, stim] : sequence->getStimuli ()) {
+        const auto representative = equivalentStimuli.find (startingFrame);
+        if (representative != equivalentStimuli.end () && representative->second != startingFrame) {
+            continue;
         }
 
-        ++stindex;
+        StimulusAdapter::PrecompileShaders (stim);
+    }
+}
+
+
+void SequenceAdapter::CreateStimulusAdapterViews ()
+{
+    const Sequence::StimulusMap& stimuli = sequence->getStimuli ();
+
+    for (auto& [startingFrame, stim] : stimuli) {
+        const auto representative = equivalentStimuli.find (startingFrame);
+
+        if (GVK_VERIFY (representative != equivalentStimuli.end ()) && representative->second != startingFrame) {
+            // stimuli are ordered by starting frame, the representative already has its view
+            views[stim] = views.at (stimuli.at (representative->second));
+        } else {
+            views[stim] = std::make_unique<StimulusAdapterView> (environment, *imageLoader, stim);
+        }
     }
 }
 
@@ -233,12 +306,33 @@ static void SignalImplCout (std::string_view type, std::string_view channelName,
 }
 
 
-static void SignalImpl (std::string_view type, std::string_view channelName, std::string_view channelPort, bool clear)
+void SequenceAdapter::SetSignalSink (std::unique_ptr<ISignalSink>&& sink)
 {
-    spdlog::info ("[{}] Channel: {} ({}), clear: {}", type, channelName, channelPort, clear);
+    const uint32_t subFrameCount    = sequence->getSubFrameCount ();
+    const uint32_t frameRateDivisor = std::max (sequence->frameRateDivisor, 1u);
+
+    // a rendered frame stays on the screen for frameRateDivisor device frames
+    const std::chrono::duration<double> subFrameInterval (frameRateDivisor / (static_cast<double> (sequence->deviceFrameRate) * subFrameCount));
+
+    // the previous dispatcher emits its pending signals before it is destroyed
+    signalDispatcher.reset ();
+    signalDispatcher = std::make_unique<SignalDispatcher> (SignalDispatcher::CreateSchedule (*sequence),
+                                                           std::move (sink),
+                                                           std::chrono::duration_cast<SignalDispatcher::Clock::duration> (subFrameInterval),
+                                                           subFrameCount,
+                                                           sequence->getUsesBusyWaitingThreadForSingals ());
+
+    // the thread is started with the rendering, see SetCurrentPresentable
+    if (renderer != nullptr) {
+        signalDispatcher->Start ();
+    }
 }
 
 
+// marks resource indices that presented a retained frame again
+static constexpr uint32_t RepeatedFrameIndex = UINT32_MAX;
+
+
 // previous resource index finished preseting
 void SequenceAdapter::OnImageAcquisitionFenceSignaled (uint32_t resourceIndex)
 {
@@ -247,6 +341,11 @@ void SequenceAdapter::OnImageAcquisitionFenceSignaled (uint32_t resourceIndex)
     const size_t finishedFrameIndex = resourceIndexToRenderedFrameMapping[previousResourceIndex];
 
     resourceIndexToRenderedFrameMapping[previousResourceIndex] = 0;
+
+    // signals were sent when the frame was first presented
+    if (finishedFrameIndex == RepeatedFrameIndex) {
+        return;
+    }
     
     // TODO check if signal's frame index and finishedFrameIndex are the same
 
@@ -256,28 +355,27 @@ void SequenceAdapter::OnImageAcquisitionFenceSignaled (uint32_t resourceIndex)
     GVK_ASSERT (finishedFrameIndex + 1 /* TODO why +1 */ >= stimulus->getStartingFrame ());
     const size_t stimulusFrameIndex = finishedFrameIndex - stimulus->getStartingFrame ();
 
-    if (currentPresentable->HasWindow ()) {
-        const std::string titleString = fmt::format ("GearsVk - {} [stimulus frame: {} / {} ({}), sequence frame: {} / {} ({})",
-                                                     sequenceNameInTitle,
-                                                     stimulusFrameIndex, stimulus->getDuration (), std::floor (static_cast<double> (stimulusFrameIndex) / stimulus->getDuration () * 100.0),
-                                                     finishedFrameIndex, sequence->getDuration (), std::floor (static_cast<double> (finishedFrameIndex) / sequence->getDuration () * 100.0));
-        currentPresentable->GetWindow ().SetTitle (titleString);
-    }
+    // the title is formatted on the diagnostics thread
+    frameDiagnostics->OnFramePresented (static_cast<uint32_t> (finishedFrameIndex), static_cast<uint32_t> (stimulusFrameIndex), stimulus->getDuration ());
 
-    auto sequenceSignals = sequence->getSignals ().equal_range (finishedFrameIndex);
-    for (auto it = sequenceSignals.first; it != sequenceSignals.second; ++it) {
-        auto channel = sequence->getChannels ().find (it->second.channel);
-        if (GVK_VERIFY (channel != sequence->getChannels ().end ())) {
-            SignalImpl ("SEQUENCE SIGNAL", it->second.channel, channel->second.portName, it->second.clear);
+    if (currentPresentable->HasWindow ()) {
+        const std::optional<std::string> title = frameDiagnostics->TryGetTitle ();
+        if (title.has_value ()) {
+            currentPresentable->GetWindow ().SetTitle (*title);
         }
     }
-    
-    auto stimulusSignals = stimulus->getSignals ().equal_range (stimulusFrameIndex);
-    for (auto it = stimulusSignals.first; it != stimulusSignals.second; ++it) {
-        auto channel = sequence->getChannels ().find (it->second.channel);
-        if (GVK_VERIFY (channel != sequence->getChannels ().end ())) {
-            SignalImpl ("STIMULUS TICK SIGNAL", it->second.channel, channel->second.portName, it->second.clear);
-        }
+
+    // the finished image contains all sub-frames starting from the rendered frame index,
+    // their signals are emitted on the dispatcher thread
+    signalDispatcher->OnFramePresented (static_cast<uint32_t> (finishedFrameIndex), SignalDispatcher::Clock::now ());
+}
+
+
+void SequenceAdapter::OnFramePresented (const RG::FrameTiming& timing)
+{
+    const uint32_t missedVblanks = presentTimingLog->Add (timing);
+    if (missedVblanks > 0) {
+        spdlog::warn ("Dropped frame: the previous frame stayed on the screen for {} extra refreshes.", missedVblanks);
     }
 }
 
@@ -295,23 +393,73 @@ void SequenceAdapter::RenderFrameIndex (const uint32_t frameIndex)
     try {
         std::shared_ptr<const Stimulus> stim = sequence->getStimulusAtFrame (frameIndex);
         if (GVK_VERIFY (stim != nullptr)) {
+            // the first stimulus was compiled right before, there is nothing to defragment yet
+            if (defragmentMemoryFlag.IsFlagOn () && lastRenderedFrameIndex.has_value () && sequence->getStimulusAtFrame (*lastRenderedFrameIndex) != stim) {
+                views[stim]->DefragmentMemory (currentPresentable);
+            }
+
+            const FrameDiagnostics::Clock::time_point renderStart = FrameDiagnostics::Clock::now ();
+
             const size_t nextResourceIndex = renderer->GetNextRenderResourceIndex ();
             resourceIndexToRenderedFrameMapping[nextResourceIndex] = frameIndex;
             views[stim]->RenderFrameIndex (*renderer, currentPresentable, stim, frameIndex, *this, *randomExporter);
+            lastRenderedFrameIndex = frameIndex;
+
+            frameDiagnostics->OnFrameRendered (frameIndex, FrameDiagnostics::Clock::now () - renderStart);
         }
     } catch (GVK::OutOfDateSwapchain&) {
-        if (currentPresentable->HasWindow () && currentPresentable->GetWindow ().GetWidth () == 0 && currentPresentable->GetWindow ().GetHeight () == 0) {
-            return;
-        }
-        environment.Wait ();
-        views.clear ();
-        currentPresentable->GetSwapchain ().Recreate ();
-        CreateStimulusAdapterViews ();
-        SetCurrentPresentable (currentPresentable);
+        RecreateSwapchain ();
+    }
+}
+
+
+void SequenceAdapter::RenderDeviceFrame (const uint32_t deviceFrameIndex)
+{
+    const uint32_t frameRateDivisor = std::max (sequence->frameRateDivisor, 1u);
+    const uint32_t frameIndex       = 1 + (deviceFrameIndex / frameRateDivisor) * sequence->getSubFrameCount ();
+
+    // the random generators and the signals only advance when a new frame is rendered
+    if (deviceFrameIndex % frameRateDivisor != 0 && lastRenderedFrameIndex == frameIndex) {
+        RepeatLastFrame ();
+    } else {
+        RenderFrameIndex (frameIndex);
+    }
+}
+
+
+void SequenceAdapter::RepeatLastFrame ()
+{
+    if (GVK_ERROR (renderer == nullptr)) {
+        return;
+    }
+
+    if (currentPresentable->HasWindow () && currentPresentable->GetWindow ().GetWidth () == 0 && currentPresentable->GetWindow ().GetHeight () == 0) {
+        return;
+    }
+
+    try {
+        const size_t nextResourceIndex = renderer->GetNextRenderResourceIndex ();
+        resourceIndexToRenderedFrameMapping[nextResourceIndex] = RepeatedFrameIndex;
+        renderer->RepeatLastFrame (*this);
+    } catch (GVK::OutOfDateSwapchain&) {
+        RecreateSwapchain ();
     }
 }
 
 
+void SequenceAdapter::RecreateSwapchain ()
+{
+    if (currentPresentable->HasWindow () && currentPresentable->GetWindow ().GetWidth () == 0 && currentPresentable->GetWindow ().GetHeight () == 0) {
+        return;
+    }
+    environment.Wait ();
+    views.clear ();
+    currentPresentable->GetSwapchain ().Recreate ();
+    CreateStimulusAdapterViews ();
+    SetCurrentPresentable (currentPresentable);
+}
+
+
 void SequenceAdapter::Wait ()
 {
     if (GVK_VERIFY (renderer != nullptr)) {
@@ -324,14 +472,52 @@ void SequenceAdapter::SetCurrentPresentable (std::shared_ptr<RG::Presentable> pr
 {
     currentPresentable = presentable;
 
+    // all images are decoded and uploaded together before the stimuli are compiled
+    {
+        std::vector<std::filesystem::path> imagePaths;
+        for (auto& [_, stim] : sequence->getStimuli ()) {
+            for (const std::shared_ptr<Pass>& pass : stim->getPasses ()) {
+                for (auto& [varName, file] : pass->shaderImages) {
+                    imagePaths.push_back (file);
+                }
+            }
+        }
+        imageLoader->Load (imagePaths);
+    }
+
     for (auto& [stim, view] : views) {
         view->CreateForPresentable (currentPresentable);
     }
 
-    renderer = std::make_unique<RG::SynchronizedSwapchainGraphRenderer> (*environment.deviceExtra, presentable->GetSwapchain ());
+    const RG::ImageLoader::Statistics imageStatistics = imageLoader->GetStatistics ();
+    spdlog::info ("Image loader: {} images requested, {} decoded, {} upload submits, {} bytes.",
+                  imageStatistics.requestCount,
+                  imageStatistics.decodedCount,
+                  imageStatistics.uploadSubmitCount,
+                  imageStatistics.uploadedBytes);
+
+    // requested objects would all be separate without the cache
+    const GVK::ObjectCache::Statistics cacheStatistics = environment.deviceExtra->GetObjectCache ().GetStatistics ();
+    spdlog::info ("Object cache: {} objects requested, {} created, alive: {} samplers, {} render passes, {} framebuffers.",
+                  cacheStatistics.requestCount,
+                  cacheStatistics.createdCount,
+                  cacheStatistics.samplerCount,
+                  cacheStatistics.renderPassCount,
+                  cacheStatistics.framebufferCount);
+
+    // frames are kept for the repeated device frames, see RenderDeviceFrame
+    const bool retainLastFrame = sequence->frameRateDivisor > 1;
+
+    renderer = std::make_unique<RG::SynchronizedSwapchainGraphRenderer> (*environment.deviceExtra, presentable->GetSwapchain (), retainLastFrame);
+
+    presentTimingLog = GetPresentTimingLogImpl (sequence);
+
+    lastRenderedFrameIndex = std::nullopt;
 
     resourceIndexToRenderedFrameMapping.clear ();
     resourceIndexToRenderedFrameMapping.resize (renderer->GetFramesInFlight (), 0);
+
+    signalDispatcher->Start ();
 }
 
 
@@ -381,16 +567,21 @@ void SequenceAdapter::RenderFullOnExternalWindow ()
     
     window.Show ();
 
-    uint32_t frameIndex = 1; // TODO do all sequences start at frame 1?
+    const uint32_t frameRateDivisor = std::max (sequence->frameRateDivisor, 1u);
+
+    uint32_t deviceFrameIndex = 0;
 
     window.DoEventLoop ([&] (bool& shouldStop) {
         spdlog::trace ("DoEventLoop called");
 
-        RenderFrameIndex (frameIndex);
+        RenderDeviceFrame (deviceFrameIndex);
         
-        frameIndex++;
+        ++deviceFrameIndex;
+
+        // TODO do all sequences start at frame 1?
+        const uint32_t nextFrameIndex = 1 + (deviceFrameIndex / frameRateDivisor) * sequence->getSubFrameCount ();
 
-        if (frameIndex == sequence->getDuration () || escPressed) {
+        if (nextFrameIndex >= sequence->getDuration () || escPressed) {
             shouldStop = true;
             spdlog::trace ("Should stop pressed");
         }
@@ -398,6 +589,8 @@ void SequenceAdapter::RenderFullOnExternalWindow ()
 
     spdlog::trace ("DoEventLoop ended, env.Wait ()");
 
+    spdlog::info (presentTimingLog->GetSummaryString ());
+
     environment.Wait ();
 
     for (auto& [stim, view] : views) {
@@ -0,0 +1,243 @@
+// the archives must be included before the types are registered, see CEREAL_REGISTER_TYPE
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/list.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/memory.hpp>
+#include <cereal/types/set.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include "SequenceBundle.hpp"
+
+// from Utils
+#include "Utils/Hasher.hpp"
+#include "Utils/Trace.hpp"
+
+// from VulkanWrapper
+#include "VulkanWrapper/DeviceExtra.hpp"
+#include "VulkanWrapper/ShaderModule.hpp"
+
+// from RenderGraph
+#include "RenderGraph/VulkanEnvironment.hpp"
+
+// from Sequence
+#include "Pass.h"
+#include "Response.h"
+#include "Sequence.h"
+#include "SpatialFilter.h"
+#include "Stimulus.h"
+#include "PySequence/core/PyPass.h"
+#include "PySequence/core/PyResponse.h"
+#include "PySequence/core/PySequence.h"
+#include "PySequence/core/PyStimulus.h"
+
+// from std
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "spdlog/spdlog.h"
+
+
+static constexpr char BundleMagic[4] = { 'G', 'V', 'S', 'B' };
+
+
+static void AddFileToHash (Utils::Hasher& hasher, const std::filesystem::path& path)
+{
+    std::ifstream file (path, std::ios::binary);
+    if (!file.is_open ()) {
+        throw std::runtime_error ("failed to open \"" + path.string () + "\"");
+    }
+
+    const std::string content { std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> () };
+
+    hasher.Add (path.filename ().string ());
+    hasher.Add (content);
+}
+
+
+static std::filesystem::path GetProjectRoot (const std::filesystem::path& pyxPath)
+{
+    const std::filesystem::path pyxFolder = std::filesystem::absolute (pyxPath).parent_path ();
+
+    for (std::filesystem::path folder = pyxFolder; !folder.empty (); folder = folder.parent_path ()) {
+        if (folder.filename () == "Project") {
+            return folder;
+        }
+        if (folder == folder.parent_path ()) {
+            break;
+        }
+    }
+
+    return pyxFolder;
+}
+
+
+uint64_t SequenceBundle::GetSourceHash (const std::filesystem::path& pyxPath)
+{
+    Utils::Hasher hasher;
+
+    const std::filesystem::path projectRoot = GetProjectRoot (pyxPath);
+
+    AddFileToHash (hasher, pyxPath);
+
+    std::vector<std::filesystem::path> pythonFiles;
+    if (std::filesystem::exists (projectRoot)) {
+        for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator (projectRoot)) {
+            if (entry.is_regular_file () && entry.path ().extension () == ".py") {
+                pythonFiles.push_back (entry.path ());
+            }
+        }
+    }
+
+    // directory iteration order is unspecified
+    std::sort (pythonFiles.begin (), pythonFiles.end ());
+
+    for (const std::filesystem::path& pythonFile : pythonFiles) {
+        AddFileToHash (hasher, pythonFile);
+    }
+
+    return hasher.Get ();
+}
+
+
+// python callbacks cannot be saved, the bundled sequence would run without them
+static std::vector<std::string> GetObjectsWithPythonCallbacks (const Sequence& sequence)
+{
+    std::vector<std::string> result;
+
+    const PySequence* pySequence = dynamic_cast<const PySequence*> (&sequence);
+    if (pySequence != nullptr && pySequence->hasCallbacks ()) {
+        result.push_back ("sequence \"" + sequence.name + "\"");
+    }
+
+    for (const auto& [startFrame, stimulus] : sequence.getStimuli ()) {
+        const PyStimulus* pyStimulus = dynamic_cast<const PyStimulus*> (stimulus.get ());
+        if (pyStimulus != nullptr && pyStimulus->hasCallbacks ()) {
+            result.push_back ("stimulus \"" + stimulus->name + "\" at frame " + std::to_string (startFrame));
+        }
+    }
+
+    for (const auto& [startFrame, response] : sequence.getResponses ()) {
+        const PyResponse* pyResponse = dynamic_cast<const PyResponse*> (response.get ());
+        if (pyResponse != nullptr && pyResponse->hasCallbacks ()) {
+            result.push_back ("response at frame " + std::to_string (startFrame));
+        }
+    }
+
+    return result;
+}
+
+
+void SequenceBundle::Write (const std::filesystem::path& bundlePath, const std::filesystem::path& pyxPath, SequenceAdapter& sequenceAdapter, const GVK::DeviceExtra& device)
+{
+    Utils::TraceScope traceScope ("Sequence bundle writing", "Sequence");
+
+    const std::string                               sourcePath        = std::filesystem::absolute (pyxPath).string ();
+    const uint64_t                                  sourceHash        = GetSourceHash (pyxPath);
+    const std::shared_ptr<Sequence>                 sequence          = sequenceAdapter.GetSequence ();
+    const SequenceAdapter::EquivalentStimulusMap&   equivalentStimuli = sequenceAdapter.GetEquivalentStimuli ();
+    const std::map<uint64_t, std::vector<uint32_t>> shaderBinaries    = GVK::ShaderBinaryCache::Get ().GetBinaries ();
+    const std::vector<uint8_t>                      pipelineCacheData = device.GetPipelineCache ().GetData ();
+
+    const std::vector<std::string> objectsWithCallbacks = GetObjectsWithPythonCallbacks (*sequence);
+    if (!objectsWithCallbacks.empty ()) {
+        std::string message = "sequence cannot be bundled, python callbacks are not saved:";
+        for (const std::string& object : objectsWithCallbacks) {
+            message += "\n    " + object;
+        }
+        throw std::runtime_error (message);
+    }
+
+    std::ofstream file (bundlePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open ()) {
+        throw std::runtime_error ("failed to open sequence bundle \"" + bundlePath.string () + "\"");
+    }
+
+    file.write (BundleMagic, sizeof (BundleMagic));
+    file.write (reinterpret_cast<const char*> (&Version), sizeof (Version));
+
+    {
+        cereal::BinaryOutputArchive archive (file);
+        archive (sourcePath, sourceHash, sequence, equivalentStimuli, shaderBinaries, pipelineCacheData);
+    }
+
+    spdlog::info ("Sequence bundle written to \"{}\" ({} shaders, {} bytes of pipeline cache)", bundlePath.string (), shaderBinaries.size (), pipelineCacheData.size ());
+}
+
+
+std::optional<SequenceBundle> SequenceBundle::Read (const std::filesystem::path& bundlePath)
+{
+    Utils::TraceScope traceScope ("Sequence bundle reading", "Sequence");
+
+    std::ifstream file (bundlePath, std::ios::in | std::ios::binary);
+    if (!file.is_open ()) {
+        return std::nullopt;
+    }
+
+    char     magic[sizeof (BundleMagic)] = {};
+    uint32_t version                     = 0;
+    file.read (magic, sizeof (magic));
+    file.read (reinterpret_cast<char*> (&version), sizeof (version));
+
+    if (!file || !std::equal (std::begin (magic), std::end (magic), std::begin (BundleMagic))) {
+        spdlog::warn ("\"{}\" is not a sequence bundle", bundlePath.string ());
+        return std::nullopt;
+    }
+
+    if (version != Version) {
+        spdlog::warn ("Sequence bundle \"{}\" has version {}, expected {}", bundlePath.string (), version, Version);
+        return std::nullopt;
+    }
+
+    SequenceBundle bundle;
+    std::string    sourcePath;
+
+    try {
+        cereal::BinaryInputArchive archive (file);
+        archive (sourcePath, bundle.sourceHash, bundle.sequence, bundle.equivalentStimuli, bundle.shaderBinaries, bundle.pipelineCacheData);
+    } catch (cereal::Exception& e) {
+        spdlog::warn ("Failed to read sequence bundle \"{}\": {}", bundlePath.string (), e.what ());
+        return std::nullopt;
+    }
+
+    bundle.sourcePath = sourcePath;
+
+    return bundle;
+}
+
+
+bool SequenceBundle::HasSource () const
+{
+    return std::filesystem::exists (sourcePath);
+}
+
+
+bool SequenceBundle::IsUpToDate () const
+{
+    if (!HasSource ()) {
+        spdlog::warn ("Source of sequence bundle \"{}\" is not available, the bundle cannot be checked", sourcePath.string ());
+        return false;
+    }
+
+    return GetSourceHash (sourcePath) == sourceHash;
+}
+
+
+std::unique_ptr<SequenceAdapter> SequenceBundle::CreateSequenceAdapter (RG::VulkanEnvironment& environment) const
+{
+    Utils::TraceScope traceScope ("Sequence adapter creation from bundle", "Sequence");
+
+    GVK::ShaderBinaryCache& shaderBinaryCache = GVK::ShaderBinaryCache::Get ();
+    for (const auto& [key, binary] : shaderBinaries) {
+        shaderBinaryCache.Add (key, binary);
+    }
+
+    if (!pipelineCacheData.empty ()) {
+        environment.deviceExtra->GetPipelineCache ().Merge (pipelineCacheData);
+    }
+
+    return std::make_unique<SequenceAdapter> (environment, sequence, sourcePath.filename ().string (), equivalentStimuli);
+}
@@ -0,0 +1,269 @@
+#include "SignalDispatcher.hpp"
+
+// from Gears
+#include "Sequence.h"
+#include "Stimulus.h"
+
+// from Utils
+#include "Utils/Assert.hpp"
+#include "Utils/Platform.hpp"
+#include "Utils/Trace.hpp"
+
+// from std
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "spdlog/spdlog.h"
+
+#ifdef PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// sleeping is not precise enough, the last part of the wait is spinning when busy waiting
+static constexpr std::chrono::microseconds BusyWaitMargin { 2000 };
+
+// how often Flush checks the dispatched frames
+static constexpr std::chrono::microseconds FlushPollInterval { 200 };
+
+
+// slightly above the normal threads, but in the same scheduling class as the render and present threads
+// a realtime thread spinning before an edge would preempt them
+static void SetCurrentThreadHighPriority ()
+{
+#ifdef PLATFORM_WINDOWS
+    if (!SetThreadPriority (GetCurrentThread (), THREAD_PRIORITY_ABOVE_NORMAL)) {
+        spdlog::warn ("Failed to raise the priority of the signal thread.");
+    }
+#else
+    // a negative nice value needs privileges, the thread still works without it
+    if (setpriority (PRIO_PROCESS, static_cast<id_t> (syscall (SYS_gettid)), -5) != 0) {
+        spdlog::info ("Signal thread is running with normal priority.");
+    }
+#endif
+}
+
+
+void LogSignalSink::Emit (const SignalEdge& edge)
+{
+    spdlog::info ("[SIGNAL] Frame: {}, channel: {} ({}), clear: {}", edge.frameIndex, edge.channel, edge.port, edge.clear);
+}
+
+
+FileSignalSink::FileSignalSink (const std::filesystem::path& path)
+    : stream (path, std::ios::out | std::ios::app)
+{
+    if (!stream.is_open ()) {
+        throw std::runtime_error ("failed to open signal output \"" + path.string () + "\"");
+    }
+}
+
+
+void FileSignalSink::Emit (const SignalEdge& edge)
+{
+    stream << edge.frameIndex << " " << edge.port << " " << edge.channel << " " << (edge.clear ? "clear" : "raise") << std::endl;
+}
+
+
+SignalDispatcher::SignalDispatcher (std::vector<SignalEdge>&&      schedule,
+                                    std::unique_ptr<ISignalSink>&& sink,
+                                    Clock::duration                subFrameInterval,
+                                    uint32_t                       subFrameCount,
+                                    bool                           busyWait)
+    : schedule { std::move (schedule) }
+    , sink { std::move (sink) }
+    , subFrameInterval { subFrameInterval }
+    , subFrameCount { subFrameCount }
+    , busyWait { busyWait }
+    , stopRequested { false }
+    , pushedCount { 0 }
+    , dispatchedCount { 0 }
+    , droppedFrameCount { 0 }
+    , sleeping { false }
+    , emittedCount { 0 }
+    , jitterSumMicroseconds { 0.0 }
+    , maxJitterMicroseconds { 0.0 }
+{
+    GVK_ASSERT (this->sink != nullptr);
+    GVK_ASSERT (subFrameCount >= 1);
+    GVK_ASSERT (std::is_sorted (this->schedule.begin (), this->schedule.end (), [] (const SignalEdge& a, const SignalEdge& b) { return a.frameIndex < b.frameIndex; }));
+}
+
+
+SignalDispatcher::~SignalDispatcher ()
+{
+    if (!thread.joinable ()) {
+        GVK_ASSERT (pushedCount.load () == 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (wakeMutex);
+        stopRequested = true;
+    }
+    wakeCondition.notify_one ();
+
+    thread.join ();
+}
+
+
+void SignalDispatcher::Start ()
+{
+    if (thread.joinable ()) {
+        return;
+    }
+
+    thread = std::thread (&SignalDispatcher::ThreadFunction, this);
+}
+
+
+void SignalDispatcher::OnFramePresented (uint32_t frameIndex, Clock::time_point presentedAt)
+{
+    GVK_ASSERT (thread.joinable ());
+
+    if (!presentedFrames.TryPush ({ frameIndex, presentedAt })) {
+        ++droppedFrameCount;
+        return;
+    }
+
+    ++pushedCount;
+
+    // the dispatcher sets sleeping before checking pushedCount, so either it sees the new count or this sees it sleeping
+    // it holds the lock until it waits, so the notification is not lost
+    if (sleeping) {
+        std::lock_guard<std::mutex> lock (wakeMutex);
+        wakeCondition.notify_one ();
+    }
+}
+
+
+void SignalDispatcher::Flush ()
+{
+    if (GVK_ERROR (!thread.joinable ())) {
+        return;
+    }
+
+    while (dispatchedCount.load () != pushedCount.load ()) {
+        std::this_thread::sleep_for (FlushPollInterval);
+    }
+}
+
+
+SignalDispatcher::Statistics SignalDispatcher::GetStatistics () const
+{
+    std::lock_guard<std::mutex> lock (statisticsMutex);
+
+    Statistics result;
+    result.emittedCount           = emittedCount;
+    result.droppedFrameCount      = droppedFrameCount.load ();
+    result.meanJitterMicroseconds = emittedCount > 0 ? jitterSumMicroseconds / emittedCount : 0.0;
+    result.maxJitterMicroseconds  = maxJitterMicroseconds;
+    return result;
+}
+
+
+std::vector<SignalEdge> SignalDispatcher::CreateSchedule (const Sequence& sequence)
+{
+    std::vector<SignalEdge> result;
+
+    const auto addSignal = [&] (uint32_t frameIndex, const std::string& channelName, bool clear) {
+        auto channel = sequence.getChannels ().find (channelName);
+        if (GVK_ERROR (channel == sequence.getChannels ().end ())) {
+            return;
+        }
+        result.push_back ({ frameIndex, channelName, channel->second.portName, clear });
+    };
+
+    for (auto& [frameIndex, signal] : sequence.getSignals ()) {
+        addSignal (frameIndex, signal.channel, signal.clear);
+    }
+
+    for (auto& [_, stimulus] : sequence.getStimuli ()) {
+        for (auto& [frameIndex, signal] : stimulus->getSignals ()) {
+            addSignal (stimulus->getStartingFrame () + frameIndex, signal.channel, signal.clear);
+        }
+    }
+
+    std::stable_sort (result.begin (), result.end (), [] (const SignalEdge& a, const SignalEdge& b) { return a.frameIndex < b.frameIndex; });
+
+    return result;
+}
+
+
+void SignalDispatcher::ThreadFunction ()
+{
+    SetCurrentThreadHighPriority ();
+
+    while (true) {
+        const std::optional<PresentedFrame> frame = presentedFrames.TryPop ();
+
+        if (!frame.has_value ()) {
+            if (stopRequested) {
+                break;
+            }
+            // blocks until a frame is pushed, spinning is only done right before a signal edge, see WaitUntil
+            std::unique_lock<std::mutex> lock (wakeMutex);
+            sleeping = true;
+            wakeCondition.wait (lock, [&] { return stopRequested || dispatchedCount.load () != pushedCount.load (); });
+            sleeping = false;
+            continue;
+        }
+
+        Dispatch (*frame);
+
+        ++dispatchedCount;
+    }
+}
+
+
+void SignalDispatcher::Dispatch (const PresentedFrame& frame)
+{
+    const auto compareFrame = [] (const SignalEdge& edge, uint32_t frameIndex) { return edge.frameIndex < frameIndex; };
+
+    auto begin = std::lower_bound (schedule.begin (), schedule.end (), frame.frameIndex, compareFrame);
+    auto end   = std::lower_bound (begin, schedule.end (), frame.frameIndex + subFrameCount, compareFrame);
+
+    for (auto it = begin; it != end; ++it) {
+        const Clock::time_point intended = frame.presentedAt + subFrameInterval * (it->frameIndex - frame.frameIndex);
+
+        WaitUntil (intended);
+
+        const Clock::time_point actual = Clock::now ();
+
+        {
+            Utils::TraceScope traceScope ("Signal dispatch", "Signal");
+            sink->Emit (*it);
+        }
+
+        const double jitterMicroseconds = std::abs (std::chrono::duration<double, std::micro> (actual - intended).count ());
+
+        std::lock_guard<std::mutex> lock (statisticsMutex);
+        ++emittedCount;
+        jitterSumMicroseconds += jitterMicroseconds;
+        maxJitterMicroseconds = std::max (maxJitterMicroseconds, jitterMicroseconds);
+    }
+}
+
+
+void SignalDispatcher::WaitUntil (Clock::time_point time) const
+{
+    if (!busyWait) {
+        std::this_thread::sleep_until (time);
+        return;
+    }
+
+    if (Clock::now () < time - BusyWaitMargin) {
+        std::this_thread::sleep_until (time - BusyWaitMargin);
+    }
+
+    // yielding lets the render and present threads run on this core
+    while (Clock::now () < time) {
+        std::this_thread::yield ();
+    }
+}
@@ -636,6 +636,10 @@ bool Stimulus::IsEquivalent (const Stimulus& other) const
         if (leftPass.shaderVectors != rightPass.shaderVectors) {
             return false;
         }
+        // the same sampler names are bound to the images of the representative
+        if (leftPass.shaderImages != rightPass.shaderImages) {
+            return false;
+        }
     }
 
     return requiresClearing == other.requiresClearing &&
@@ -9,6 +9,7 @@
 #include "Utils/CommandLineFlag.hpp"
 #include "Utils/Assert.hpp"
 #include "Utils/FileSystemUtils.hpp"
+#include "Utils/Trace.hpp"
 #include "Utils/Utils.hpp"
 
 // from VulkanWrapper
@@ -18,20 +19,24 @@
 #include "VulkanWrapper/DescriptorSet.hpp"
 #include "VulkanWrapper/DescriptorPool.hpp"
 #include "VulkanWrapper/DescriptorSetLayout.hpp"
+#include "VulkanWrapper/ShaderModule.hpp"
 
 // from RenderGraph
 #include "RenderGraph/DrawRecordable/DrawRecordable.hpp"
 #include "RenderGraph/DrawRecordable/DrawRecordableInfo.hpp"
 #include "RenderGraph/GraphRenderer.hpp"
 #include "RenderGraph/GraphSettings.hpp"
+#include "RenderGraph/ImageLoader.hpp"
 #include "RenderGraph/Operation.hpp"
 #include "RenderGraph/RenderGraph.hpp"
 #include "RenderGraph/Resource.hpp"
+#include "RenderGraph/UniformArena.hpp"
 #include "RenderGraph/UniformReflection.hpp"
 #include "RenderGraph/VulkanEnvironment.hpp"
 #include "RenderGraph/ShaderPipeline.hpp"
 
 // from std
+#include <algorithm>
 #include <random>
 #include <string>
 #include <cstring>
@@ -45,20 +50,102 @@ constexpr bool LogUniformDebugInfo = false;
 constexpr double deviceRefreshRateDefault = 60.0;
 
 
-static std::string PreprocessShaderString (const std::string& source, const std::shared_ptr<Stimulus const>& stimulus, const uint32_t framesInFlight)
+static uint32_t GetSubFrameCount (const std::shared_ptr<Stimulus const>& stimulus)
 {
-    return Utils::ReplaceAll (source, "FRAMESINFLIGHT", [&] () -> std::string {
-        return std::to_string (stimulus->rngCompute_multiLayer ? framesInFlight : 1);
-    });
+    return (stimulus->sequence != nullptr) ? stimulus->sequence->getSubFrameCount () : 1;
+}
+
+
+// sequence frames are rendered once every frameRateDivisor device frames
+static uint32_t GetFrameRateDivisor (const std::shared_ptr<Stimulus const>& stimulus)
+{
+    return (stimulus->sequence != nullptr) ? std::max (stimulus->sequence->frameRateDivisor, 1u) : 1;
+}
+
+
+// random layers are allocated for every sub-frame
+static uint32_t GetRandomLayerCount (const std::shared_ptr<Stimulus const>& stimulus, const uint32_t framesInFlight)
+{
+    return (stimulus->rngCompute_multiLayer ? framesInFlight : 1) * GetSubFrameCount (stimulus);
+}
+
+
+// the shaders are compiled without these values, so they do not depend on the swapchain length and the pass parameters
+static GVK::SpecializationConstants GetRandomGeneratorConstants (const std::shared_ptr<Stimulus const>& stimulus, const uint32_t framesInFlight)
+{
+    GVK::SpecializationConstants result;
+    result.Set ("FRAMESINFLIGHT", GetRandomLayerCount (stimulus, framesInFlight));
+    return result;
+}
+
+
+static GVK::SpecializationConstants GetPassConstants (const Pass& pass, const std::shared_ptr<Stimulus const>& stimulus, const uint32_t framesInFlight)
+{
+    GVK::SpecializationConstants result = GetRandomGeneratorConstants (stimulus, framesInFlight);
+    for (const auto& [name, value] : pass.getShaderVariableConstants ()) {
+        result.Set (name, value);
+    }
+    return result;
+}
+
+
+// the field is given from the bottom left corner of the window, like glViewport
+static VkRect2D GetFieldAreaInSwapchain (const std::shared_ptr<Stimulus const>& stimulus, uint32_t width, uint32_t height)
+{
+    if (stimulus->sequence == nullptr) {
+        return VkRect2D { { 0, 0 }, { width, height } };
+    }
+
+    const Sequence& sequence = *stimulus->sequence;
+
+    const int64_t left   = std::clamp<int64_t> (sequence.fieldLeft_px, 0, width);
+    const int64_t right  = std::clamp<int64_t> (static_cast<int64_t> (sequence.fieldLeft_px) + sequence.fieldWidth_px, 0, width);
+    const int64_t top    = std::clamp<int64_t> (static_cast<int64_t> (height) - sequence.fieldBottom_px - sequence.fieldHeight_px, 0, height);
+    const int64_t bottom = std::clamp<int64_t> (static_cast<int64_t> (height) - sequence.fieldBottom_px, 0, height);
+
+    VkRect2D result      = {};
+    result.offset.x      = static_cast<int32_t> (left);
+    result.offset.y      = static_cast<int32_t> (top);
+    result.extent.width  = static_cast<uint32_t> (right - left);
+    result.extent.height = static_cast<uint32_t> (bottom - top);
+    return result;
+}
+
+
+void StimulusAdapter::PrecompileShaders (const std::shared_ptr<Stimulus const>& stimulus)
+{
+    Utils::TraceScope traceScope ("StimulusAdapter::PrecompileShaders", "Sequence");
+
+    const uint32_t subFrameCount = GetSubFrameCount (stimulus);
+
+    for (const std::shared_ptr<Pass>& pass : stimulus->getPasses ()) {
+        const std::string vert = pass->getStimulusGeneratorVertexShaderSource (pass->rasterizationMode);
+        const std::string geom = pass->getStimulusGeneratorGeometryShaderSource (pass->rasterizationMode);
+        const std::string frag = pass->getStimulusGeneratorShaderSource (subFrameCount);
+
+        GVK::ShaderModule::PrecompileGLSLString (GVK::ShaderKind::Vertex, vert);
+        if (!geom.empty ()) {
+            GVK::ShaderModule::PrecompileGLSLString (GVK::ShaderKind::Geometry, geom);
+        }
+        GVK::ShaderModule::PrecompileGLSLString (GVK::ShaderKind::Fragment, frag);
+    }
+
+    if (!stimulus->rngCompute_shaderSource.empty ()) {
+        GVK::ShaderModule::PrecompileGLSLString (GVK::ShaderKind::Compute, stimulus->rngCompute_shaderSource);
+    }
 }
 
 
 StimulusAdapter::StimulusAdapter (const RG::VulkanEnvironment&           environment,
+                                  RG::ImageLoader&                       imageLoader,
                                   RG::Presentable&                       presentable,
                                   const std::shared_ptr<Stimulus const>& stimulus)
     : environment { environment }
-    , patternSizeOnRetina { presentable.GetSwapchain ().GetWidth (), presentable.GetSwapchain ().GetHeight () }
+    , fieldArea { GetFieldAreaInSwapchain (stimulus, presentable.GetSwapchain ().GetWidth (), presentable.GetSwapchain ().GetHeight ()) }
+    , patternSizeOnRetina { fieldArea.extent.width, fieldArea.extent.height }
     , deviceRefreshRate { presentable.GetRefreshRate ().value_or (deviceRefreshRateDefault) }
+    , subFrameCount { GetSubFrameCount (stimulus) }
+    , frameRateDivisor { GetFrameRateDivisor (stimulus) }
 {
     renderGraph = std::make_unique<RG::RenderGraph> ();
 
@@ -85,9 +172,9 @@ StimulusAdapter::StimulusAdapter (const RG::VulkanEnvironment&           environ
 
         GVK_ASSERT (pass->rasterizationMode == Pass::RasterizationMode::fullscreen);
 
-        const std::string vert = PreprocessShaderString (pass->getStimulusGeneratorVertexShaderSource (pass->rasterizationMode), stimulus, framesInFlight);
-        const std::string geom = PreprocessShaderString (pass->getStimulusGeneratorGeometryShaderSource (pass->rasterizationMode), stimulus, framesInFlight);
-        const std::string frag = PreprocessShaderString (pass->getStimulusGeneratorShaderSource (), stimulus, framesInFlight);
+        const std::string vert = pass->getStimulusGeneratorVertexShaderSource (pass->rasterizationMode);
+        const std::string geom = pass->getStimulusGeneratorGeometryShaderSource (pass->rasterizationMode);
+        const std::string frag = pass->getStimulusGeneratorShaderSource (subFrameCount);
 
         std::unique_ptr<RG::ShaderPipeline> sequencePip = std::make_unique<RG::ShaderPipeline> (*environment.device);
 
@@ -96,6 +183,7 @@ StimulusAdapter::StimulusAdapter (const RG::VulkanEnvironment&           environ
             sequencePip->SetShaderFromSourceString (GVK::ShaderKind::Geometry, geom);
         }
         sequencePip->SetFragmentShaderFromString (frag);
+        sequencePip->SetSpecializationConstants (GetPassConstants (*pass, stimulus, framesInFlight));
 
         std::shared_ptr<RG::RenderOperation> passOperation = std::make_unique<RG::RenderOperation> (
             std::make_unique<RG::DrawRecordableInfo> (1, 6), std::move (sequencePip), VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
@@ -112,6 +200,7 @@ StimulusAdapter::StimulusAdapter (const RG::VulkanEnvironment&           environ
         //}
 
         passOperation->compileSettings.blendEnabled = true;
+        passOperation->compileSettings.renderArea   = fieldArea;
 
         GVK_ASSERT (!stimulus->usesForwardRendering);
         //GVK_ASSERT (stimulus->mono);
@@ -124,23 +213,53 @@ StimulusAdapter::StimulusAdapter (const RG::VulkanEnvironment&           environ
         passToOperation[pass] = passOperation;
     }
 
+    // images loaded from files, nullptr if the file could not be loaded
+    std::map<std::string, std::shared_ptr<RG::ReadOnlyImageResource>> shaderImages;
+    for (const std::shared_ptr<Pass>& pass : passes) {
+        for (auto& [varName, file] : pass->shaderImages) {
+            shaderImages[varName] = imageLoader.Get (file);
+        }
+    }
+
     RG::ImageMap imgMap = RG::CreateEmptyImageResources (s.connectionSet, [&] (const SR::Sampler& sampler) -> std::optional<RG::CreateParams> {
         if (sampler.name == "gamma") {
             return std::make_tuple (glm::uvec3 { 256, 0, 0 }, VK_FORMAT_R32_SFLOAT, VK_FILTER_NEAREST);
         }
 
+        // placeholder, so the stimulus still renders without its image
+        const auto shaderImage = shaderImages.find (sampler.name);
+        if (shaderImage != shaderImages.end () && shaderImage->second == nullptr) {
+            return std::make_tuple (glm::uvec3 { 1, 1, 0 }, VK_FORMAT_R8G8B8A8_SRGB, VK_FILTER_LINEAR);
+        }
+
         return std::nullopt;
     });
 
-    std::shared_ptr<RG::ComputeOperation> rngGen;
-    if (!stimulus->rngCompute_shaderSource.empty ()) {
+    for (auto& [pass, op] : passToOperation) {
+        std::shared_ptr<RG::RenderOperation> renderOp = std::dynamic_pointer_cast<RG::RenderOperation> (op);
+
+        renderOp->GetShaderPipeline ()->IterateShaders ([&] (const GVK::ShaderModule& shaderModule) {
+            for (const SR::Sampler& sampler : shaderModule.GetReflection ().samplers) {
+                const auto shaderImage = shaderImages.find (sampler.name);
+                if (shaderImage == shaderImages.end () || shaderImage->second == nullptr) {
+                    continue;
+                }
 
-        const std::string preProcessedShaderSource = PreprocessShaderString (stimulus->rngCompute_shaderSource, stimulus, framesInFlight);
+                s.connectionSet.Add (shaderImage->second, renderOp);
 
+                auto& table = renderOp->compileSettings.descriptorWriteProvider;
+                table->imageInfos.push_back ({ sampler.name, shaderModule.GetShaderKind (), shaderImage->second->GetSamplerProvider (), shaderImage->second->GetImageViewForFrameProvider (), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+            }
+        });
+    }
+
+    std::shared_ptr<RG::ComputeOperation> rngGen;
+    if (!stimulus->rngCompute_shaderSource.empty ()) {
         rngGen = std::make_shared<RG::ComputeOperation> (stimulus->rngCompute_workGroupSizeX, stimulus->rngCompute_workGroupSizeY, 1);
         rngGen->SetName ("RNG_Compute");
 
-        rngGen->compileSettings.computeShaderPipeline = std::make_unique<RG::ComputeShaderPipeline> (*environment.device, preProcessedShaderSource);
+        rngGen->compileSettings.computeShaderPipeline = std::make_unique<RG::ComputeShaderPipeline> (*environment.device, stimulus->rngCompute_shaderSource);
+        rngGen->compileSettings.computeShaderPipeline->SetSpecializationConstants (GetRandomGeneratorConstants (stimulus, framesInFlight));
 
         auto randomBufferCreator = [&] (const std::shared_ptr<RG::Operation>&, const GVK::ShaderModule&, const std::shared_ptr<SR::BufferObject>& bufferObject, bool& treatAsOutput) -> std::shared_ptr<RG::DescriptorBindableBufferResource> {
             if (bufferObject->name == "OutputBuffer") {
@@ -182,33 +301,41 @@ StimulusAdapter::StimulusAdapter (const RG::VulkanEnvironment&           environ
         gammaTexture->CopyTransitionTransfer (gammaAndTemporalWeights);
     }
 
+    // placeholders are black instead of undefined
+    for (const auto& [varName, shaderImage] : shaderImages) {
+        if (shaderImage != nullptr) {
+            continue;
+        }
+
+        std::shared_ptr<RG::ReadOnlyImageResource> placeholder = imgMap.FindByName (varName);
+        if (placeholder != nullptr) {
+            placeholder->Compile (RG::GraphSettings (*environment.deviceExtra, 0));
+            placeholder->CopyTransitionTransfer (std::vector<uint8_t> { 0, 0, 0, 255 });
+        }
+    }
+
+    // the uniform blocks of the graph share one mapped buffer, the arena must not be shared with other graphs
+    const std::shared_ptr<RG::UniformArena>      uniformArena = std::make_shared<RG::UniformArena> ();
+    const RG::UniformReflection::ResourceCreator arenaCreator = RG::UniformReflection::UniformArenaResourceCreator (uniformArena);
+
     auto randomBufferSkipper = [&] (const std::shared_ptr<RG::Operation>& op, const GVK::ShaderModule& sm, const std::shared_ptr<SR::BufferObject>& bufferObject, bool& treatAsOutput) -> std::shared_ptr<RG::DescriptorBindableBufferResource> {
         if (bufferObject->name == "RandomBuffer") {
             return nullptr;
         }
 
-        return RG::UniformReflection::DefaultResourceCreator (op, sm, bufferObject, treatAsOutput);
+        return arenaCreator (op, sm, bufferObject, treatAsOutput);
     };
 
     reflection = std::make_unique<RG::UniformReflection> (s.connectionSet, randomBufferSkipper);
 
     renderGraph->Compile (std::move (s));
 
-    // set constant uniform values
+    // set constant uniform values, shader variables are specialization constants
     {
-        for (auto& [pass, op] : passToOperation) {
-            for (auto& [name, value] : pass->shaderVariables)
-                (*reflection)[op->GetUUID ()][GVK::ShaderKind::Fragment]["commonUniformBlock"][name] = static_cast<float> (value);
-            for (auto& [name, value] : pass->shaderVectors)
-                (*reflection)[op->GetUUID ()][GVK::ShaderKind::Fragment]["commonUniformBlock"][name] = static_cast<glm::vec2> (value);
-            for (auto& [name, value] : pass->shaderColors)
-                (*reflection)[op->GetUUID ()][GVK::ShaderKind::Fragment]["commonUniformBlock"][name] = static_cast<glm::vec3> (value);
-        }
-
         auto rngComputeOp = renderGraph->GetConnectionSet ().GetByName<RG::ComputeOperation> ("RNG_Compute");
         if (rngComputeOp != nullptr) {
             (*reflection)[rngComputeOp][GVK::ShaderKind::Compute]["RandomGeneratorConfig"]["seed"] = 7; // TODO RNG
-            (*reflection)[rngComputeOp][GVK::ShaderKind::Compute]["RandomGeneratorConfig"]["framesInFlight"] = framesInFlight;
+            (*reflection)[rngComputeOp][GVK::ShaderKind::Compute]["RandomGeneratorConfig"]["framesInFlight"] = GetRandomLayerCount (stimulus, framesInFlight);
         }
     }
 }
@@ -219,14 +346,21 @@ void StimulusAdapter::SetUniforms (const GVK::UUID& renderOperationId, const std
     auto& vertexShaderUniforms   = (*reflection)[renderOperationId][GVK::ShaderKind::Vertex];
     auto& fragmentShaderUniforms = (*reflection)[renderOperationId][GVK::ShaderKind::Fragment];
 
-    const double timeInSeconds = frameIndex / deviceRefreshRate;
+    // sub-frames are displayed at a multiple of the device refresh rate, divided frames at a fraction of it
+    const double frameRate     = deviceRefreshRate * subFrameCount / frameRateDivisor;
+    const double timeInSeconds = frameIndex / frameRate;
 
     vertexShaderUniforms["PatternSizeOnRetina"] = patternSizeOnRetina;
 
-    fragmentShaderUniforms["commonUniformBlock"]["time"]                = static_cast<float> (timeInSeconds - stimulus->getStartingFrame () / deviceRefreshRate);
+    fragmentShaderUniforms["commonUniformBlock"]["time"]                = static_cast<float> (timeInSeconds - stimulus->getStartingFrame () / frameRate);
     fragmentShaderUniforms["commonUniformBlock"]["patternSizeOnRetina"] = patternSizeOnRetina;
+    fragmentShaderUniforms["commonUniformBlock"]["fieldOffset"]         = glm::vec2 (fieldArea.offset.x, fieldArea.offset.y);
     fragmentShaderUniforms["commonUniformBlock"]["frame"]               = static_cast<int32_t> (frameIndex);
 
+    if (subFrameCount > 1) {
+        fragmentShaderUniforms["commonUniformBlock"]["subFrameTimeStep"] = static_cast<float> (1.0 / frameRate);
+    }
+
     fragmentShaderUniforms["commonUniformBlock"]["swizzleForFft"] = 0xffffffff;
 
     if (!stimulus->rngCompute_shaderSource.empty ()) {
@@ -235,7 +369,8 @@ void StimulusAdapter::SetUniforms (const GVK::UUID& renderOperationId, const std
             auto rngComputeOp = renderGraph->GetConnectionSet ().GetByName<RG::ComputeOperation> ("RNG_Compute");
             GVK_ASSERT (rngComputeOp != nullptr);
 
-            computeRefl["RandomBufferConfig"]["randoms_layerIndex"] = stimulus->rngCompute_multiLayer ? resourceIndex : 0;
+            // sub-frames read the following layers
+            computeRefl["RandomBufferConfig"]["randoms_layerIndex"] = (stimulus->rngCompute_multiLayer ? resourceIndex : 0) * subFrameCount;
 
             computeRefl["RandomBufferConfig"]["randomGridSize"] = glm::ivec2 (rngComputeOp->GetWorkGroupSizeX (), rngComputeOp->GetWorkGroupSizeX ());
 
@@ -273,12 +408,14 @@ void StimulusAdapter::RenderFrameIndex (RG::Renderer&                          r
     const uint32_t stimulusStartingFrame = stimulus->getStartingFrame ();
     const uint32_t stimulusEndingFrame   = stimulus->getStartingFrame () + stimulus->getDuration ();
 
-    if (GVK_ERROR (frameIndex < stimulusStartingFrame || frameIndex >= stimulusEndingFrame)) {
+    if (GVK_ERROR (frameIndex < stimulusStartingFrame || frameIndex + subFrameCount > stimulusEndingFrame)) {
         return;
     }
 
     GVK::EventObserver obs;
     obs.Observe (renderer.preSubmitEvent, [&] (RG::RenderGraph& graph, uint32_t swapchainImageIndex, uint64_t timeNs) {
+        Utils::TraceScope setUniformsScope ("SetUniforms", "Frame");
+
         for (auto& [pass, renderOp] : passToOperation) {
             SetUniforms (renderOp->GetUUID (), stimulus, renderer.GetNextRenderResourceIndex (), frameIndex);
         }
@@ -289,7 +426,7 @@ void StimulusAdapter::RenderFrameIndex (RG::Renderer&                          r
 
             if (GVK_VERIFY (uniforms.Contains ("RandomGeneratorConfig"))) {
                 uniforms["RandomGeneratorConfig"]["startFrameIndex"]  = static_cast<uint32_t> (frameIndex);
-                uniforms["RandomGeneratorConfig"]["nextElementIndex"] = static_cast<uint32_t> (frameIndex - 1) % renderGraph->graphSettings.framesInFlight;
+                uniforms["RandomGeneratorConfig"]["nextElementIndex"] = static_cast<uint32_t> (frameIndex - 1) % GetRandomLayerCount (stimulus, renderGraph->graphSettings.framesInFlight);
             }
         }
 
@@ -297,6 +434,8 @@ void StimulusAdapter::RenderFrameIndex (RG::Renderer&                          r
             reflection->PrintDebugInfo ();
         }
 
+        Utils::TraceScope flushScope ("Uniform flush", "Frame");
+
         reflection->Flush (swapchainImageIndex);
     });
 
@@ -310,3 +449,9 @@ void StimulusAdapter::RenderFrameIndex (RG::Renderer&                          r
         }
     }
 }
+
+
+void StimulusAdapter::DefragmentMemory ()
+{
+    renderGraph->DefragmentMemory ();
+}
@@ -10,8 +10,9 @@
 #include "Stimulus.h"
 
 
-StimulusAdapterView::StimulusAdapterView (RG::VulkanEnvironment& environment, const std::shared_ptr<Stimulus const>& stimulus)
+StimulusAdapterView::StimulusAdapterView (RG::VulkanEnvironment& environment, RG::ImageLoader& imageLoader, const std::shared_ptr<Stimulus const>& stimulus)
     : environment (environment)
+    , imageLoader (imageLoader)
     , stimulus (stimulus)
 {
 }
@@ -24,7 +25,7 @@ void StimulusAdapterView::CreateForPresentable (std::shared_ptr<RG::Presentable>
         return;
     }
 
-    compiledAdapters[presentable] = std::make_unique<StimulusAdapter> (environment, *presentable, stimulus);
+    compiledAdapters[presentable] = std::make_unique<StimulusAdapter> (environment, imageLoader, *presentable, stimulus);
 }
 
 
@@ -40,6 +41,16 @@ void StimulusAdapterView::DestroyForPresentable (const std::shared_ptr<RG::Prese
 }
 
 
+void StimulusAdapterView::DefragmentMemory (const std::shared_ptr<RG::Presentable>& presentable)
+{
+    if (GVK_ERROR (compiledAdapters.find (presentable) == compiledAdapters.end ())) {
+        return;
+    }
+
+    compiledAdapters[presentable]->DefragmentMemory ();
+}
+
+
 void StimulusAdapterView::RenderFrameIndex (RG::Renderer&                          renderer,
                                             std::shared_ptr<RG::Presentable>&      presentable,
                                             const std::shared_ptr<Stimulus const>& stimulus,
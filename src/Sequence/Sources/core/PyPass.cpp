@@ -26,7 +26,10 @@ PyPass::PyPass ()
 }
 
 
-PyPass::~PyPass () = default;
+PyPass::~PyPass ()
+{
+    ReleasePythonObjects (impl);
+}
 
 
 pybind11::object PyPass::setJoiner (pybind11::object joiner)
@@ -1,5 +1,6 @@
 #include "core/PyResponse.h"
 #include "core/PySequence.h"
+#include "PyExtract.hpp"
 #include <algorithm>
 #include <ctime>
 #include <fstream>
@@ -20,7 +21,10 @@ PyResponse::PyResponse ()
 }
 
 
-PyResponse::~PyResponse () = default;
+PyResponse::~PyResponse ()
+{
+    ReleasePythonObjects (impl);
+}
 
 
 pybind11::object PyResponse::setPythonObject (pybind11::object o)
@@ -50,3 +54,11 @@ void PyResponse::registerCallback (uint32_t msg, pybind11::object callback)
             return;
     impl->callbacks[msg].push_back (callback);
 }
+
+
+bool PyResponse::hasCallbacks () const
+{
+    return std::any_of (impl->callbacks.begin (), impl->callbacks.end (), [] (const auto& msgAndCallbacks) {
+        return !msgAndCallbacks.second.empty ();
+    });
+}
@@ -30,7 +30,10 @@ PySequence::PySequence (std::string name)
 }
 
 
-PySequence::~PySequence () = default;
+PySequence::~PySequence ()
+{
+    ReleasePythonObjects (impl);
+}
 
 
 pybind11::object PySequence::set (pybind11::object settings)
@@ -159,6 +162,12 @@ pybind11::object PySequence::onReset (pybind11::object cb)
 }
 
 
+bool PySequence::hasCallbacks () const
+{
+    return IsCallbackSet (impl->resetCallback);
+}
+
+
 pybind11::object PySequence::setPythonObject (pybind11::object o)
 {
     impl->pythonObject = o;
@@ -33,7 +33,10 @@ PyStimulus::PyStimulus ()
 }
 
 
-PyStimulus::~PyStimulus () = default;
+PyStimulus::~PyStimulus ()
+{
+    ReleasePythonObjects (impl);
+}
 
 
 pybind11::object PyStimulus::setGamma (pybind11::object gammaList, bool invert)
@@ -168,6 +171,18 @@ pybind11::object PyStimulus::getJoiner ()
 }
 
 
+bool PyStimulus::hasCallbacks () const
+{
+    if (IsCallbackSet (impl->forwardRenderingCallback) || IsCallbackSet (impl->startCallback) || IsCallbackSet (impl->frameCallback) || IsCallbackSet (impl->finishCallback)) {
+        return true;
+    }
+
+    return std::any_of (impl->callbacks.begin (), impl->callbacks.end (), [] (const auto& msgAndCallbacks) {
+        return !msgAndCallbacks.second.empty ();
+    });
+}
+
+
 pybind11::object PyStimulus::setPythonObject (pybind11::object o)
 {
     impl->pythonObject = o;
@@ -4,6 +4,7 @@
 #include "RenderGraph/RenderGraph.hpp"
 #include "RenderGraph/VulkanEnvironment.hpp"
 #include "Sequence/SequenceAdapter.hpp"
+#include "Sequence/SequenceBundle.hpp"
 #include "Sequence/StimulusAdapter.hpp"
 
 #include "Utils/BuildType.hpp"
@@ -13,13 +14,18 @@
 #include "spdlog/spdlog.h"
 
 #include <iostream>
+#include <optional>
+
+
+static Utils::CommandLineOnOffFlag bundleFlag { "--bundle", "Starts the sequence from <sequence>.gvkbundle when it is up to date, writes it otherwise." };
+
 
 int main (int argc, char** argv)
 {
     spdlog::set_default_logger (Utils::GetLogger ());
 
     if (argc < 2) {
-        std::cout << "Fist argument must be an absolute path of a sequence .pyx file." << std::endl;
+        std::cout << "Fist argument must be an absolute path of a sequence .pyx or .gvkbundle file." << std::endl;
         return EXIT_FAILURE;
     }
 
@@ -40,7 +46,45 @@ int main (int argc, char** argv)
 
     std::unique_ptr<RG::VulkanEnvironment> env = std::make_unique<RG::VulkanEnvironment> (RG::defaultDebugCallback, RG::GetGLFWInstanceExtensions (), std::vector<const char*> { VK_KHR_SWAPCHAIN_EXTENSION_NAME, VK_KHR_SHADER_NON_SEMANTIC_INFO_EXTENSION_NAME });
 
-    std::unique_ptr<SequenceAdapter> sequenceAdapter = Gears::GetSequenceAdapterFromPyx (*env, sequencePath);
+    // the bundle is written after the run, when all shaders are compiled and all pipelines are created
+    std::optional<std::filesystem::path> bundleToWrite;
+    std::filesystem::path                pyxPath = sequencePath;
+
+    std::unique_ptr<SequenceAdapter> sequenceAdapter;
+
+    if (sequencePath.extension () == ".gvkbundle") {
+        std::optional<SequenceBundle> bundle = SequenceBundle::Read (sequencePath);
+        if (GVK_ERROR (!bundle.has_value ())) {
+            spdlog::error ("Failed to read sequence bundle.");
+            return EXIT_FAILURE;
+        }
+
+        if (!bundle->HasSource ()) {
+            // a bundle can be run on its own, but it cannot be checked
+            spdlog::warn ("Source of sequence bundle \"{}\" is not available, running the bundle as it is", bundle->sourcePath.string ());
+            sequenceAdapter = bundle->CreateSequenceAdapter (*env);
+        } else if (bundle->IsUpToDate ()) {
+            sequenceAdapter = bundle->CreateSequenceAdapter (*env);
+        } else {
+            spdlog::info ("Sequence bundle is out of date, loading \"{}\"", bundle->sourcePath.string ());
+            pyxPath       = bundle->sourcePath;
+            bundleToWrite = sequencePath;
+        }
+    } else if (bundleFlag.IsFlagOn ()) {
+        const std::filesystem::path bundlePath = std::filesystem::path (sequencePath).concat (".gvkbundle");
+
+        std::optional<SequenceBundle> bundle = SequenceBundle::Read (bundlePath);
+        if (bundle.has_value () && bundle->IsUpToDate ()) {
+            sequenceAdapter = bundle->CreateSequenceAdapter (*env);
+        } else {
+            bundleToWrite = bundlePath;
+        }
+    }
+
+    if (sequenceAdapter == nullptr) {
+        sequenceAdapter = Gears::GetSequenceAdapterFromPyx (*env, pyxPath);
+    }
+
     if (GVK_ERROR (sequenceAdapter == nullptr)) {
         spdlog::error ("Failed to load sequence.");
         return EXIT_FAILURE;
@@ -55,5 +99,13 @@ int main (int argc, char** argv)
 
     sequenceAdapter->Wait ();
 
+    if (bundleToWrite.has_value ()) {
+        try {
+            SequenceBundle::Write (*bundleToWrite, pyxPath, *sequenceAdapter, *env->deviceExtra);
+        } catch (std::exception& ex) {
+            spdlog::error ("Failed to write sequence bundle.\n{}", ex.what ());
+        }
+    }
+
     return EXIT_SUCCESS;
 }
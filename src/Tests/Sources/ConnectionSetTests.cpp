@@ -0,0 +1,602 @@
+#include "RenderGraph/GraphSettings.hpp"
+#include "RenderGraph/Operation.hpp"
+#include "RenderGraph/RenderGraph.hpp"
+#include "RenderGraph/Resource.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+
+using ConnectionSetTests = ::testing::Test;
+
+
+namespace {
+
+// only the structure of the graph is used, nothing is compiled or recorded
+class TestOperation : public RG::Operation {
+public:
+    TestOperation (const std::string& name)
+    {
+        SetName (name);
+    }
+
+    virtual void Compile (const RG::GraphSettings&) override {}
+    virtual void CompileWithExtent (const RG::GraphSettings&, uint32_t, uint32_t) override {}
+
+    virtual void Record (const RG::ConnectionSet&, uint32_t, GVK::CommandBuffer&) override {}
+
+    virtual std::vector<VkDescriptorPoolSize> GetDescriptorPoolSizes () const override { return {}; }
+
+    virtual VkImageLayout GetImageLayoutAtStartForInputs (RG::Resource&) override { return VK_IMAGE_LAYOUT_UNDEFINED; }
+    virtual VkImageLayout GetImageLayoutAtEndForInputs (RG::Resource&) override { return VK_IMAGE_LAYOUT_UNDEFINED; }
+    virtual VkImageLayout GetImageLayoutAtStartForOutputs (RG::Resource&) override { return VK_IMAGE_LAYOUT_UNDEFINED; }
+    virtual VkImageLayout GetImageLayoutAtEndForOutputs (RG::Resource&) override { return VK_IMAGE_LAYOUT_UNDEFINED; }
+};
+
+
+class TestResource : public RG::Resource {
+public:
+    TestResource (const std::string& name)
+    {
+        SetName (name);
+    }
+
+    virtual void Compile (const RG::GraphSettings&) override {}
+};
+
+
+std::shared_ptr<RG::Operation> Op (const std::string& name)
+{
+    return std::make_shared<TestOperation> (name);
+}
+
+
+std::shared_ptr<RG::Resource> Res (const std::string& name)
+{
+    return std::make_shared<TestResource> (name);
+}
+
+
+std::vector<std::string> GetDeadNodeNames (const RG::ConnectionSet& connectionSet)
+{
+    std::vector<std::string> result;
+    for (const std::shared_ptr<RG::Node>& node : RG::GetDeadNodes (connectionSet)) {
+        result.push_back (node->GetName ());
+    }
+    return result;
+}
+
+} // namespace
+
+
+TEST_F (ConnectionSetTests, DeadNodes_AllOperationsReachOutput)
+{
+    auto input        = Res ("input");
+    auto intermediate = Res ("intermediate");
+    auto output       = Res ("output");
+    auto first        = Op ("first");
+    auto second       = Op ("second");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (input, first);
+    connectionSet.Add (first, intermediate);
+    connectionSet.Add (intermediate, second);
+    connectionSet.Add (second, output);
+
+    EXPECT_TRUE (GetDeadNodeNames (connectionSet).empty ());
+}
+
+
+TEST_F (ConnectionSetTests, DeadNodes_OperationWithoutOutput)
+{
+    auto input  = Res ("input");
+    auto output = Res ("output");
+    auto used   = Op ("used");
+    auto debug  = Op ("debug");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (input, used);
+    connectionSet.Add (used, output);
+    connectionSet.Add (input, debug);
+
+    // input is still read by a live operation
+    EXPECT_EQ (std::vector<std::string> ({ "debug" }), GetDeadNodeNames (connectionSet));
+}
+
+
+TEST_F (ConnectionSetTests, DeadNodes_DeadChainIsCulled)
+{
+    auto output      = Res ("output");
+    auto main        = Op ("main");
+    auto generated   = Res ("generated");
+    auto generator   = Op ("generator");
+    auto config      = Res ("config");
+    auto consumer    = Op ("consumer");
+    auto unusedInput = Res ("unusedInput");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (main, output);
+    connectionSet.Add (config, generator);
+    connectionSet.Add (generator, generated);
+    connectionSet.Add (generated, consumer);
+    connectionSet.Add (unusedInput, consumer);
+
+    // consumer writes nothing, so nothing reads generated, and generator and its input are dead too
+    EXPECT_EQ (std::vector<std::string> ({ "config", "generator", "generated", "consumer", "unusedInput" }), GetDeadNodeNames (connectionSet));
+}
+
+
+TEST_F (ConnectionSetTests, DeadNodes_PinnedResourceKeepsWriters)
+{
+    auto output    = Res ("output");
+    auto main      = Op ("main");
+    auto generated = Res ("generated");
+    auto generator = Op ("generator");
+    auto consumer  = Op ("consumer");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (main, output);
+    connectionSet.Add (generator, generated);
+    connectionSet.Add (generated, consumer);
+
+    EXPECT_EQ (std::vector<std::string> ({ "generator", "generated", "consumer" }), GetDeadNodeNames (connectionSet));
+
+    connectionSet.Pin (generated);
+
+    EXPECT_EQ (std::vector<std::string> ({ "consumer" }), GetDeadNodeNames (connectionSet));
+}
+
+
+TEST_F (ConnectionSetTests, DeadNodes_ReadWriteResourceIsOutput)
+{
+    auto accumulated = Res ("accumulated");
+    auto accumulator = Op ("accumulator");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (accumulated, accumulator);
+    connectionSet.Add (accumulator, accumulated);
+
+    EXPECT_TRUE (GetDeadNodeNames (connectionSet).empty ());
+}
+
+
+TEST_F (ConnectionSetTests, DeadNodes_LiveOperationKeepsAllOutputs)
+{
+    auto input     = Res ("input");
+    auto output    = Res ("output");
+    auto scratch   = Res ("scratch");
+    auto main      = Op ("main");
+    auto debugView = Op ("debugView");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (input, main);
+    connectionSet.Add (main, output);
+    connectionSet.Add (main, scratch);
+    connectionSet.Add (scratch, debugView);
+
+    // scratch is written by main anyway
+    EXPECT_EQ (std::vector<std::string> ({ "debugView" }), GetDeadNodeNames (connectionSet));
+}
+
+
+TEST_F (ConnectionSetTests, DeadNodes_AllWritersOfLiveResourceAreLive)
+{
+    auto shared = Res ("shared");
+    auto output = Res ("output");
+    auto first  = Op ("first");
+    auto second = Op ("second");
+    auto reader = Op ("reader");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (first, shared);
+    connectionSet.Add (second, shared);
+    connectionSet.Add (shared, reader);
+    connectionSet.Add (reader, output);
+
+    EXPECT_TRUE (GetDeadNodeNames (connectionSet).empty ());
+}
+
+
+TEST_F (ConnectionSetTests, DeadNodes_UnconnectedNodes)
+{
+    auto lonelyResource  = Res ("lonelyResource");
+    auto lonelyOperation = Op ("lonelyOperation");
+    auto pinned          = Res ("pinned");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (lonelyResource);
+    connectionSet.Add (lonelyOperation);
+    connectionSet.Pin (pinned);
+
+    EXPECT_EQ (std::vector<std::string> ({ "lonelyResource", "lonelyOperation" }), GetDeadNodeNames (connectionSet));
+}
+
+
+TEST_F (ConnectionSetTests, NodeIndicesFollowInsertionOrder)
+{
+    auto input  = Res ("input");
+    auto output = Res ("output");
+    auto op     = Op ("op");
+    auto other  = Res ("other");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (input, op);
+    connectionSet.Add (op, output);
+    connectionSet.Add (input, op);
+
+    EXPECT_EQ (3, connectionSet.GetNodeCount ());
+    EXPECT_EQ (0, connectionSet.GetNodeIndex (input.get ()));
+    EXPECT_EQ (1, connectionSet.GetNodeIndex (op.get ()));
+    EXPECT_EQ (2, connectionSet.GetNodeIndex (output.get ()));
+    EXPECT_EQ (RG::ConnectionSet::InvalidIndex, connectionSet.GetNodeIndex (other.get ()));
+
+    EXPECT_TRUE (connectionSet.IsOperation (1));
+    EXPECT_FALSE (connectionSet.IsOperation (2));
+    EXPECT_EQ (op, connectionSet.GetNodeByIndex (1));
+
+    // every connection is kept, like before
+    EXPECT_EQ (std::vector<uint32_t> ({ 1, 1 }), connectionSet.GetOperationIndicesPointingTo (0));
+    EXPECT_EQ (std::vector<uint32_t> ({ 0, 0 }), connectionSet.GetResourceIndicesPointingHere (1));
+    EXPECT_EQ (std::vector<uint32_t> ({ 2 }), connectionSet.GetResourceIndicesPointingTo (1));
+    EXPECT_TRUE (connectionSet.GetOperationIndicesPointingTo (1).empty ());
+
+    EXPECT_TRUE (connectionSet.GetPointingTo<RG::Node> (other.get ()).empty ());
+}
+
+
+TEST_F (ConnectionSetTests, NeighboursInConnectionOrder)
+{
+    auto a      = Res ("a");
+    auto b      = Res ("b");
+    auto c      = Res ("c");
+    auto first  = Op ("first");
+    auto second = Op ("second");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (c, second);
+    connectionSet.Add (a, first);
+    connectionSet.Add (b, first);
+    connectionSet.Add (first, c);
+    connectionSet.Add (b, second);
+
+    const auto Names = [] (const auto& nodes) {
+        std::vector<std::string> names;
+        for (const auto& node : nodes) {
+            names.push_back (node->GetName ());
+        }
+        return names;
+    };
+
+    EXPECT_EQ (std::vector<std::string> ({ "a", "b" }), Names (connectionSet.GetPointingHere<RG::Resource> (first.get ())));
+    EXPECT_EQ (std::vector<std::string> ({ "c", "b" }), Names (connectionSet.GetPointingHere<RG::Node> (second.get ())));
+    EXPECT_EQ (std::vector<std::string> ({ "first", "second" }), Names (connectionSet.GetPointingTo<RG::Operation> (b.get ())));
+    EXPECT_EQ (std::vector<std::string> ({ "first" }), Names (connectionSet.GetPointingHere<TestOperation> (c.get ())));
+
+    EXPECT_TRUE (connectionSet.GetPointingTo<RG::Resource> (b.get ()).empty ());
+    EXPECT_TRUE (connectionSet.GetPointingHere<RG::Operation> (first.get ()).empty ());
+}
+
+
+TEST_F (ConnectionSetTests, GetNodeByNameAfterRename)
+{
+    auto input = Res ("input");
+    auto op    = Op ("");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (input, op);
+
+    EXPECT_EQ (input, connectionSet.GetNodeByName ("input"));
+    EXPECT_EQ (nullptr, connectionSet.GetNodeByName ("op"));
+
+    // names can be set after adding the nodes
+    op->SetName ("op");
+    input->SetName ("renamed");
+
+    EXPECT_EQ (op, connectionSet.GetNodeByName ("op"));
+    EXPECT_EQ (input, connectionSet.GetNodeByName ("renamed"));
+    EXPECT_EQ (nullptr, connectionSet.GetNodeByName ("input"));
+    EXPECT_EQ (op, connectionSet.GetByName<RG::Operation> ("op"));
+    EXPECT_EQ (nullptr, connectionSet.GetByName<RG::Resource> ("op"));
+}
+
+
+TEST_F (ConnectionSetTests, LargeGraph)
+{
+    // operation i reads resources i and i / 2, and writes resource i + 1
+    constexpr uint32_t OperationCount = 5000;
+
+    std::vector<std::shared_ptr<RG::Resource>>  resources;
+    std::vector<std::shared_ptr<RG::Operation>> operations;
+    for (uint32_t i = 0; i <= OperationCount; ++i) {
+        resources.push_back (Res ("resource" + std::to_string (i)));
+    }
+    for (uint32_t i = 0; i < OperationCount; ++i) {
+        operations.push_back (Op ("operation" + std::to_string (i)));
+    }
+
+    const auto buildStart = std::chrono::high_resolution_clock::now ();
+
+    RG::ConnectionSet connectionSet;
+    for (uint32_t i = 0; i < OperationCount; ++i) {
+        connectionSet.Add (resources[i], operations[i]);
+        if (i / 2 != i) {
+            connectionSet.Add (resources[i / 2], operations[i]);
+        }
+        connectionSet.Add (operations[i], resources[i + 1]);
+    }
+
+    const auto queryStart = std::chrono::high_resolution_clock::now ();
+
+    size_t neighbourCount = 0;
+    for (const std::shared_ptr<RG::Node>& node : connectionSet.GetNodesByInsertionOrder ()) {
+        neighbourCount += connectionSet.GetPointingTo<RG::Node> (node.get ()).size ();
+        neighbourCount += connectionSet.GetPointingHere<RG::Node> (node.get ()).size ();
+    }
+
+    const auto nameStart = std::chrono::high_resolution_clock::now ();
+
+    uint32_t foundByName = 0;
+    for (uint32_t i = 0; i < OperationCount; ++i) {
+        foundByName += (connectionSet.GetNodeByName ("operation" + std::to_string (i)) == operations[i]) ? 1 : 0;
+    }
+
+    const auto deadNodesStart = std::chrono::high_resolution_clock::now ();
+
+    const std::vector<std::string> deadNodes = GetDeadNodeNames (connectionSet);
+
+    const auto end = std::chrono::high_resolution_clock::now ();
+
+    const auto Milliseconds = [] (auto from, auto to) {
+        return std::chrono::duration<double, std::milli> (to - from).count ();
+    };
+
+    std::cout << "ConnectionSet with " << connectionSet.GetNodeCount () << " nodes, "
+              << "build: " << Milliseconds (buildStart, queryStart) << " ms, "
+              << "neighbours of every node: " << Milliseconds (queryStart, nameStart) << " ms, "
+              << "every operation by name: " << Milliseconds (nameStart, deadNodesStart) << " ms, "
+              << "dead nodes: " << Milliseconds (deadNodesStart, end) << " ms" << std::endl;
+
+    EXPECT_EQ (2 * OperationCount + 1, connectionSet.GetNodeCount ());
+    EXPECT_EQ (2 * (3 * OperationCount - 1), neighbourCount);
+    EXPECT_EQ (OperationCount, foundByName);
+    EXPECT_TRUE (deadNodes.empty ());
+}
+
+
+namespace {
+
+std::vector<std::vector<std::string>> GetLevelNames (const RG::ConnectionSet& connectionSet, const std::vector<bool>& skippedNodes = {})
+{
+    std::vector<std::vector<std::string>> result;
+    for (const std::vector<RG::Operation*>& level : RG::GetDependencyLevels (connectionSet, skippedNodes)) {
+        std::vector<std::string>& names = result.emplace_back ();
+        for (RG::Operation* op : level) {
+            names.push_back (op->GetName ());
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+
+TEST_F (ConnectionSetTests, DependencyLevels_IndependentOperationsShareLevel)
+{
+    auto input        = Res ("input");
+    auto intermediate = Res ("intermediate");
+    auto output       = Res ("output");
+    auto other        = Res ("other");
+    auto first        = Op ("first");
+    auto second       = Op ("second");
+    auto independent  = Op ("independent");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (intermediate, second);
+    connectionSet.Add (second, output);
+    connectionSet.Add (input, first);
+    connectionSet.Add (first, intermediate);
+    connectionSet.Add (input, independent);
+    connectionSet.Add (independent, other);
+
+    EXPECT_EQ (std::vector<std::vector<std::string>> ({ { "first", "independent" }, { "second" } }), GetLevelNames (connectionSet));
+}
+
+
+TEST_F (ConnectionSetTests, DependencyLevels_LongestPath)
+{
+    auto input  = Res ("input");
+    auto a      = Res ("a");
+    auto b      = Res ("b");
+    auto output = Res ("output");
+    auto first  = Op ("first");
+    auto second = Op ("second");
+    auto third  = Op ("third");
+
+    // third reads the outputs of both first and second, it is recorded once, after both
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (input, first);
+    connectionSet.Add (first, a);
+    connectionSet.Add (a, second);
+    connectionSet.Add (second, b);
+    connectionSet.Add (a, third);
+    connectionSet.Add (b, third);
+    connectionSet.Add (third, output);
+
+    EXPECT_EQ (std::vector<std::vector<std::string>> ({ { "first" }, { "second" }, { "third" } }), GetLevelNames (connectionSet));
+}
+
+
+TEST_F (ConnectionSetTests, DependencyLevels_WritersOfSameResource)
+{
+    auto output = Res ("output");
+    auto first  = Op ("first");
+    auto second = Op ("second");
+    auto third  = Op ("third");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (first, output);
+    connectionSet.Add (second, output);
+    connectionSet.Add (third, output);
+
+    EXPECT_EQ (std::vector<std::vector<std::string>> ({ { "first" }, { "second" }, { "third" } }), GetLevelNames (connectionSet));
+}
+
+
+TEST_F (ConnectionSetTests, DependencyLevels_ReadWriteResource)
+{
+    auto accumulator = Res ("accumulator");
+    auto output      = Res ("output");
+    auto accumulate  = Op ("accumulate");
+    auto display     = Op ("display");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (accumulator, accumulate);
+    connectionSet.Add (accumulate, accumulator);
+    connectionSet.Add (accumulator, display);
+    connectionSet.Add (display, output);
+
+    EXPECT_EQ (std::vector<std::vector<std::string>> ({ { "accumulate" }, { "display" } }), GetLevelNames (connectionSet));
+}
+
+
+TEST_F (ConnectionSetTests, DependencyLevels_SkippedNodes)
+{
+    auto input  = Res ("input");
+    auto a      = Res ("a");
+    auto output = Res ("output");
+    auto first  = Op ("first");
+    auto second = Op ("second");
+    auto unused = Op ("unused");
+
+    RG::ConnectionSet connectionSet;
+    connectionSet.Add (input, first);
+    connectionSet.Add (first, a);
+    connectionSet.Add (a, second);
+    connectionSet.Add (second, output);
+    connectionSet.Add (a, unused);
+
+    std::vector<bool> skippedNodes (connectionSet.GetNodeCount (), false);
+    skippedNodes[connectionSet.GetNodeIndex (unused.get ())] = true;
+
+    EXPECT_EQ (std::vector<std::vector<std::string>> ({ { "first" }, { "second" } }), GetLevelNames (connectionSet, skippedNodes));
+}
+
+
+TEST_F (ConnectionSetTests, DependencyLevels_RandomGraphs)
+{
+    std::mt19937 random (42);
+
+    for (uint32_t graphIndex = 0; graphIndex < 50; ++graphIndex) {
+        const uint32_t operationCount = 1 + random () % 40;
+
+        std::vector<std::shared_ptr<RG::Operation>> operations;
+        std::vector<std::shared_ptr<RG::Resource>>  resources;
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            operations.push_back (Op ("operation" + std::to_string (i)));
+            resources.push_back (Res ("resource" + std::to_string (i)));
+        }
+
+        // operation i writes resource i and reads resources of earlier operations,
+        // it also writes some resources of earlier operations that nothing read yet, so the graph stays acyclic
+        std::vector<std::pair<std::shared_ptr<RG::Node>, std::shared_ptr<RG::Node>>> connections;
+        std::vector<bool>                                                            isRead (operationCount, false);
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            connections.emplace_back (operations[i], resources[i]);
+            for (uint32_t j = 0; j < i; ++j) {
+                const uint32_t r = random () % 8;
+                if (r == 0) {
+                    connections.emplace_back (resources[j], operations[i]);
+                    isRead[j] = true;
+                } else if (r == 1 && !isRead[j]) {
+                    connections.emplace_back (operations[i], resources[j]);
+                }
+            }
+        }
+
+        // the levels do not depend on the order of the connections
+        std::shuffle (connections.begin (), connections.end (), random);
+
+        RG::ConnectionSet connectionSet;
+        for (const auto& [from, to] : connections) {
+            connectionSet.Add (from, to);
+        }
+
+        const std::vector<std::vector<RG::Operation*>> levels = RG::GetDependencyLevels (connectionSet);
+
+        std::vector<uint32_t> levelOfOperation (connectionSet.GetNodeCount (), UINT32_MAX);
+        for (uint32_t level = 0; level < levels.size (); ++level) {
+            EXPECT_FALSE (levels[level].empty ());
+            for (RG::Operation* op : levels[level]) {
+                uint32_t& levelOfOp = levelOfOperation[connectionSet.GetNodeIndex (op)];
+                EXPECT_EQ (UINT32_MAX, levelOfOp);
+                levelOfOp = level;
+            }
+        }
+
+        for (const std::shared_ptr<RG::Operation>& op : operations) {
+            const uint32_t level = levelOfOperation[connectionSet.GetNodeIndex (op.get ())];
+            ASSERT_NE (UINT32_MAX, level);
+
+            for (const std::shared_ptr<RG::Resource>& input : connectionSet.GetPointingHere<RG::Resource> (op.get ())) {
+                for (const std::shared_ptr<RG::Operation>& writer : connectionSet.GetPointingHere<RG::Operation> (input.get ())) {
+                    if (writer != op) {
+                        EXPECT_LT (levelOfOperation[connectionSet.GetNodeIndex (writer.get ())], level);
+                    }
+                }
+            }
+
+            for (const std::shared_ptr<RG::Resource>& output : connectionSet.GetPointingTo<RG::Resource> (op.get ())) {
+                for (const std::shared_ptr<RG::Operation>& writer : connectionSet.GetPointingHere<RG::Operation> (output.get ())) {
+                    if (writer != op) {
+                        EXPECT_NE (levelOfOperation[connectionSet.GetNodeIndex (writer.get ())], level);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+TEST_F (ConnectionSetTests, DependencyLevels_LargeGraph)
+{
+    // 100 independent chains of 100 operations, every operation also reads the input of its chain
+    constexpr uint32_t ChainCount  = 100;
+    constexpr uint32_t ChainLength = 100;
+
+    RG::ConnectionSet connectionSet;
+    for (uint32_t chainIndex = 0; chainIndex < ChainCount; ++chainIndex) {
+        std::shared_ptr<RG::Resource> input    = Res ("input" + std::to_string (chainIndex));
+        std::shared_ptr<RG::Resource> previous = input;
+        for (uint32_t i = 0; i < ChainLength; ++i) {
+            std::shared_ptr<RG::Operation> op   = Op ("");
+            std::shared_ptr<RG::Resource>  next = Res ("");
+            connectionSet.Add (previous, op);
+            if (previous != input) {
+                connectionSet.Add (input, op);
+            }
+            connectionSet.Add (op, next);
+            previous = next;
+        }
+    }
+
+    const auto start = std::chrono::high_resolution_clock::now ();
+
+    const std::vector<std::vector<RG::Operation*>> levels = RG::GetDependencyLevels (connectionSet);
+
+    const auto end = std::chrono::high_resolution_clock::now ();
+
+    std::cout << "GetDependencyLevels with " << ChainCount * ChainLength << " operations: "
+              << std::chrono::duration<double, std::milli> (end - start).count () << " ms" << std::endl;
+
+    ASSERT_EQ (ChainLength, levels.size ());
+    for (const std::vector<RG::Operation*>& level : levels) {
+        EXPECT_EQ (ChainCount, level.size ());
+    }
+}
@@ -0,0 +1,147 @@
+#include "TestEnvironment.hpp"
+
+#include "Sequence/FrameDiagnostics.hpp"
+#include "Sequence/SignalDispatcher.hpp"
+
+#include "gtest/gtest.h"
+
+#include "spdlog/spdlog.h"
+#include "spdlog/sinks/basic_file_sink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using FrameDiagnosticsTests = ::testing::Test;
+
+
+namespace {
+
+using Clock = FrameDiagnostics::Clock;
+
+
+struct RenderThreadTime {
+    double meanMicroseconds;
+    double maxMicroseconds;
+};
+
+
+// frames are paced, so the background threads can keep up like they would with vsync
+template<typename FrameFunction>
+RenderThreadTime MeasureRenderThreadTime (uint32_t frameCount, FrameFunction&& frameFunction)
+{
+    double sum = 0.0;
+    double max = 0.0;
+
+    for (uint32_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        const Clock::time_point start = Clock::now ();
+        frameFunction (frameIndex);
+        const double elapsed = std::chrono::duration<double, std::micro> (Clock::now () - start).count ();
+
+        sum += elapsed;
+        max = std::max (max, elapsed);
+
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+
+    return { sum / frameCount, max };
+}
+
+} // namespace
+
+
+TEST_F (FrameDiagnosticsTests, TitleIsThrottled)
+{
+    FrameDiagnostics diagnostics ("Test", 1000);
+
+    std::vector<std::string> titles;
+
+    const Clock::time_point end = Clock::now () + std::chrono::milliseconds (600);
+    for (uint32_t frameIndex = 0; Clock::now () < end; ++frameIndex) {
+        diagnostics.OnFrameRendered (frameIndex, std::chrono::microseconds (100));
+        diagnostics.OnFramePresented (frameIndex, frameIndex, 1000);
+
+        const std::optional<std::string> title = diagnostics.TryGetTitle ();
+        if (title.has_value ()) {
+            titles.push_back (*title);
+        }
+
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+
+    diagnostics.Flush ();
+
+    const std::optional<std::string> lastTitle = diagnostics.TryGetTitle ();
+    if (lastTitle.has_value ()) {
+        titles.push_back (*lastTitle);
+    }
+
+    const FrameDiagnostics::Statistics statistics = diagnostics.GetStatistics ();
+
+    EXPECT_EQ (statistics.droppedCount, 0);
+    EXPECT_GE (statistics.titleUpdateCount, 2);
+    EXPECT_LE (statistics.titleUpdateCount, 4);
+    EXPECT_LE (titles.size (), statistics.titleUpdateCount);
+    ASSERT_FALSE (titles.empty ());
+    EXPECT_EQ (titles[0].find ("GearsVk - Test [stimulus frame: 0 / 1000"), 0);
+}
+
+
+TEST_F (FrameDiagnosticsTests, RenderThreadTimeBenchmark)
+{
+    constexpr uint32_t FrameCount       = 500;
+    constexpr uint32_t SequenceDuration = 1000;
+
+    std::filesystem::create_directories (TempFolder);
+
+    // what the render thread did before: formatting the title and logging the signals synchronously
+    std::shared_ptr<spdlog::logger> syncLogger = std::make_shared<spdlog::logger> ("SyncBenchmark", std::make_shared<spdlog::sinks::basic_file_sink_mt> ((TempFolder / "sync_log.txt").string (), true));
+
+    std::string title;
+
+    const RenderThreadTime before = MeasureRenderThreadTime (FrameCount, [&] (uint32_t frameIndex) {
+        title = fmt::format ("GearsVk - {} [stimulus frame: {} / {} ({}), sequence frame: {} / {} ({})",
+                             "Benchmark",
+                             frameIndex, SequenceDuration, std::floor (static_cast<double> (frameIndex) / SequenceDuration * 100.0),
+                             frameIndex, SequenceDuration, std::floor (static_cast<double> (frameIndex) / SequenceDuration * 100.0));
+        syncLogger->info ("[{}] Channel: {} ({}), clear: {}", "SEQUENCE SIGNAL", "Tick", "COM1", frameIndex % 2 == 1);
+        syncLogger->flush ();
+    });
+
+    // the render thread only pushes records now
+    std::vector<SignalEdge> schedule;
+    for (uint32_t frameIndex = 0; frameIndex < FrameCount; ++frameIndex) {
+        schedule.push_back ({ frameIndex, "Tick", "COM1", frameIndex % 2 == 1 });
+    }
+
+    FrameDiagnostics diagnostics ("Benchmark", SequenceDuration);
+    SignalDispatcher dispatcher (std::move (schedule), std::make_unique<LogSignalSink> (), std::chrono::milliseconds (1), 1, false);
+    dispatcher.Start ();
+
+    const RenderThreadTime after = MeasureRenderThreadTime (FrameCount, [&] (uint32_t frameIndex) {
+        diagnostics.OnFrameRendered (frameIndex, std::chrono::microseconds (100));
+        diagnostics.OnFramePresented (frameIndex, frameIndex, SequenceDuration);
+        dispatcher.OnFramePresented (frameIndex, SignalDispatcher::Clock::now ());
+
+        const std::optional<std::string> newTitle = diagnostics.TryGetTitle ();
+        if (newTitle.has_value ()) {
+            title = *newTitle;
+        }
+    });
+
+    diagnostics.Flush ();
+    dispatcher.Flush ();
+
+    std::cout << "Render thread diagnostics before: mean " << before.meanMicroseconds << " us, max " << before.maxMicroseconds << " us" << std::endl;
+    std::cout << "Render thread diagnostics after: mean " << after.meanMicroseconds << " us, max " << after.maxMicroseconds << " us" << std::endl;
+
+    EXPECT_EQ (diagnostics.GetStatistics ().droppedCount, 0);
+    EXPECT_EQ (dispatcher.GetStatistics ().emittedCount, FrameCount);
+}
@@ -2,9 +2,16 @@
 
 // from RenderGraph
 #include "RenderGraph/DrawRecordable/DrawRecordable.hpp"
+#include "RenderGraph/DrawRecordable/DrawRecordableInfo.hpp"
 #include "RenderGraph/Window/GLFWWindow.hpp"
 #include "RenderGraph/GraphRenderer.hpp"
+#include "RenderGraph/GraphSettings.hpp"
+#include "RenderGraph/ImageLoader.hpp"
+#include "RenderGraph/Operation.hpp"
+#include "RenderGraph/PresentTimingLog.hpp"
 #include "RenderGraph/RenderGraph.hpp"
+#include "RenderGraph/Resource.hpp"
+#include "RenderGraph/ShaderPipeline.hpp"
 #include "RenderGraph/UniformReflection.hpp"
 #include "RenderGraph/VulkanEnvironment.hpp"
 
@@ -16,6 +23,7 @@
 #include "Sequence/StimulusAdapter.hpp"
 
 // from Utils
+#include "Utils/Event.hpp"
 #include "Utils/StaticInit.hpp"
 #include "Utils/FileSystemUtils.hpp"
 
@@ -36,8 +44,17 @@
 
 #include "GearsPYD/GearsAPIv2.hpp"
 #include "Sequence/SequenceAdapter.hpp"
-
+#include "Sequence/SequenceBundle.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 #include "spdlog/spdlog.h"
 
 
@@ -192,6 +209,599 @@ TEST_F (GearsTests, 3_Patterns_8_Other_3_mandelbrot)
 }
 
 
+TEST_F (GearsTests, FrameRateDivisor_RepeatsRenderedFrames)
+{
+    constexpr uint32_t frameRateDivisor = 2;
+
+    sequenceAdapter = Gears::GetSequenceAdapterFromPyx (*env, SequencesFolder / "4_MovingShapes" / "1_Bars" / "04_velocity400.pyx");
+    ASSERT_NE (sequenceAdapter, nullptr);
+
+    // must be set before the adapters and the renderer are created
+    sequenceAdapter->GetSequence ()->frameRateDivisor = frameRateDivisor;
+
+    pres = std::make_shared<RG::Presentable> (std::make_unique<GVK::FakeSwapchain> (GetDeviceExtra (), 800, 600));
+    sequenceAdapter->SetCurrentPresentable (pres);
+
+    RG::SynchronizedSwapchainGraphRenderer& renderer = sequenceAdapter->GetRenderer ();
+
+    // the uniforms and the random generators of the stimulus are updated before every graph submission
+    uint32_t uniformUpdateCount = 0;
+
+    GVK::EventObserver obs;
+    obs.Observe (renderer.preSubmitEvent, [&] (RG::RenderGraph&, uint32_t, uint64_t) {
+        ++uniformUpdateCount;
+    });
+
+    const auto renderDeviceFrame = [&] (uint32_t deviceFrameIndex) {
+        sequenceAdapter->RenderDeviceFrame (deviceFrameIndex);
+        sequenceAdapter->Wait ();
+
+        std::vector<std::unique_ptr<GVK::InheritedImage>> imgs = pres->GetSwapchain ().GetImageObjects ();
+        return GVK::ImageData { GetDeviceExtra (), *imgs[0], 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR };
+    };
+
+    // device frames 480 .. 487 display sequence frames 241 .. 244, each of them twice
+    std::optional<GVK::ImageData> previous;
+    for (uint32_t deviceFrameIndex = 480; deviceFrameIndex < 488; ++deviceFrameIndex) {
+        const RG::SynchronizedSwapchainGraphRenderer::FrameStats before               = renderer.GetFrameStats ();
+        const uint32_t                                           uniformUpdatesBefore = uniformUpdateCount;
+
+        GVK::ImageData current = renderDeviceFrame (deviceFrameIndex);
+
+        const RG::SynchronizedSwapchainGraphRenderer::FrameStats after = renderer.GetFrameStats ();
+
+        if (deviceFrameIndex % frameRateDivisor != 0) {
+            // copied from the retained image, the graph is not executed
+            EXPECT_EQ (before.submittedGraphs, after.submittedGraphs) << "device frame " << deviceFrameIndex;
+            EXPECT_EQ (before.retainedFrames, after.retainedFrames) << "device frame " << deviceFrameIndex;
+            EXPECT_EQ (before.repeatedFrames + 1, after.repeatedFrames) << "device frame " << deviceFrameIndex;
+            EXPECT_EQ (uniformUpdatesBefore, uniformUpdateCount) << "device frame " << deviceFrameIndex;
+        } else {
+            EXPECT_EQ (before.submittedGraphs + 1, after.submittedGraphs) << "device frame " << deviceFrameIndex;
+            EXPECT_EQ (before.retainedFrames + 1, after.retainedFrames) << "device frame " << deviceFrameIndex;
+            EXPECT_EQ (before.repeatedFrames, after.repeatedFrames) << "device frame " << deviceFrameIndex;
+            EXPECT_EQ (uniformUpdatesBefore + 1, uniformUpdateCount) << "device frame " << deviceFrameIndex;
+        }
+
+        if (previous.has_value ()) {
+            if (deviceFrameIndex % frameRateDivisor != 0) {
+                EXPECT_TRUE (current == *previous) << "device frame " << deviceFrameIndex << " should repeat the previous frame";
+            } else {
+                EXPECT_FALSE (current == *previous) << "device frame " << deviceFrameIndex << " should show a new frame";
+            }
+        }
+
+        previous = std::move (current);
+    }
+
+    // one graph submission for every sequence frame
+    EXPECT_EQ (4, renderer.GetFrameStats ().submittedGraphs);
+    EXPECT_EQ (4, renderer.GetFrameStats ().repeatedFrames);
+    EXPECT_EQ (4, uniformUpdateCount);
+}
+
+
+TEST_F (GearsTests, FieldOffset_TranslatesPattern)
+{
+    constexpr uint32_t swapchainWidth  = 800;
+    constexpr uint32_t swapchainHeight = 600;
+    constexpr uint32_t fieldSize       = 256;
+
+    // the cartoon pass is shaded from gl_FragCoord
+    const std::filesystem::path sequencePath = SequencesFolder / "7_VirtualEnvironments" / "2_3DEnvironments" / "2_Raycast" / "4_cartoon.pyx";
+
+    const auto renderField = [&] (uint32_t fieldLeft, uint32_t fieldBottom) {
+        sequenceAdapter = Gears::GetSequenceAdapterFromPyx (*env, sequencePath);
+        if (sequenceAdapter == nullptr) {
+            ADD_FAILURE ();
+            return std::vector<uint8_t> {};
+        }
+
+        std::shared_ptr<Sequence> sequence = sequenceAdapter->GetSequence ();
+        sequence->fieldLeft_px   = fieldLeft;
+        sequence->fieldBottom_px = fieldBottom;
+        sequence->fieldWidth_px  = fieldSize;
+        sequence->fieldHeight_px = fieldSize;
+
+        pres = std::make_shared<RG::Presentable> (std::make_unique<GVK::FakeSwapchain> (GetDeviceExtra (), swapchainWidth, swapchainHeight));
+        sequenceAdapter->SetCurrentPresentable (pres);
+
+        sequenceAdapter->RenderFrameIndex (60);
+        sequenceAdapter->Wait ();
+
+        std::vector<std::unique_ptr<GVK::InheritedImage>> imgs = pres->GetSwapchain ().GetImageObjects ();
+        GVK::ImageData image { GetDeviceExtra (), *imgs[0], 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR };
+
+        // the field is placed from the bottom left corner, the image rows start at the top
+        const size_t top      = swapchainHeight - fieldBottom - fieldSize;
+        const size_t rowBytes = fieldSize * image.components * image.componentByteSize;
+
+        std::vector<uint8_t> cropped;
+        for (size_t y = top; y < top + fieldSize; ++y) {
+            const size_t rowStart = (y * image.width + fieldLeft) * image.components * image.componentByteSize;
+            cropped.insert (cropped.end (), image.data.begin () + rowStart, image.data.begin () + rowStart + rowBytes);
+        }
+
+        sequenceAdapter.reset ();
+        pres.reset ();
+
+        return cropped;
+    };
+
+    const std::vector<uint8_t> atOrigin = renderField (0, 0);
+    const std::vector<uint8_t> shifted  = renderField (300, 200);
+
+    ASSERT_EQ (atOrigin.size (), shifted.size ());
+    EXPECT_TRUE (atOrigin == shifted);
+    EXPECT_TRUE (std::any_of (atOrigin.begin (), atOrigin.end (), [] (uint8_t value) { return value != 0; }));
+}
+
+
+// the classification is tested with synthetic timings in PresentTimingLogTests
+TEST_F (GearsTests, PresentTiming_LogsEveryPresentedFrame)
+{
+    constexpr uint32_t frameCount = 30;
+
+    sequenceAdapter = Gears::GetSequenceAdapterFromPyx (*env, SequencesFolder / "4_MovingShapes" / "1_Bars" / "04_velocity400.pyx");
+    ASSERT_NE (sequenceAdapter, nullptr);
+
+    pres = std::make_shared<RG::Presentable> (std::make_unique<GVK::FakeSwapchain> (GetDeviceExtra (), 800, 600));
+    sequenceAdapter->SetCurrentPresentable (pres);
+
+    for (uint32_t deviceFrameIndex = 0; deviceFrameIndex < frameCount; ++deviceFrameIndex) {
+        sequenceAdapter->RenderDeviceFrame (deviceFrameIndex);
+        sequenceAdapter->Wait ();
+    }
+
+    EXPECT_EQ (sequenceAdapter->GetPresentTimingLog ().GetSummary ().frameCount, frameCount);
+}
+
+
+TEST_F (GearsTests, SequenceBundle_RendersSameFramesWithoutCompiling)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    const std::filesystem::path pyxPath    = SequencesFolder / "4_MovingShapes" / "1_Bars" / "04_velocity400.pyx";
+    const std::filesystem::path bundlePath = TempFolder / "04_velocity400.gvkbundle";
+    const std::vector<uint32_t> frames     = { 1, 120, 240, 480 };
+
+    const auto renderFrames = [&] () {
+        pres = std::make_shared<RG::Presentable> (std::make_unique<GVK::FakeSwapchain> (GetDeviceExtra (), 800, 600));
+        sequenceAdapter->SetCurrentPresentable (pres);
+
+        std::vector<GVK::ImageData> images;
+        for (uint32_t frameIndex : frames) {
+            sequenceAdapter->RenderFrameIndex (frameIndex);
+            sequenceAdapter->Wait ();
+
+            std::vector<std::unique_ptr<GVK::InheritedImage>> imgs = pres->GetSwapchain ().GetImageObjects ();
+            images.emplace_back (GetDeviceExtra (), *imgs[0], 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        }
+        return images;
+    };
+
+    const Clock::time_point pyxStart = Clock::now ();
+
+    sequenceAdapter = Gears::GetSequenceAdapterFromPyx (*env, pyxPath);
+    ASSERT_NE (sequenceAdapter, nullptr);
+
+    const std::vector<GVK::ImageData>            fromPyx                  = renderFrames ();
+    const Clock::duration                        pyxStartup               = Clock::now () - pyxStart;
+    const SequenceAdapter::EquivalentStimulusMap equivalentStimuliFromPyx = sequenceAdapter->GetEquivalentStimuli ();
+
+    std::filesystem::create_directories (TempFolder);
+    SequenceBundle::Write (bundlePath, pyxPath, *sequenceAdapter, GetDeviceExtra ());
+
+    sequenceAdapter.reset ();
+    pres.reset ();
+    GVK::ShaderBinaryCache::Get ().Clear ();
+
+    const Clock::time_point bundleStart = Clock::now ();
+
+    std::optional<SequenceBundle> bundle = SequenceBundle::Read (bundlePath);
+    ASSERT_TRUE (bundle.has_value ());
+    EXPECT_TRUE (bundle->IsUpToDate ());
+    EXPECT_EQ (bundle->equivalentStimuli, equivalentStimuliFromPyx);
+    EXPECT_EQ (SequenceAdapter::FindEquivalentStimuli (*bundle->sequence), equivalentStimuliFromPyx) << "the deserialized sequence should have the same stimuli";
+
+    const GVK::ShaderBinaryCache::Statistics statisticsBefore = GVK::ShaderBinaryCache::Get ().GetStatistics ();
+
+    sequenceAdapter = bundle->CreateSequenceAdapter (*env);
+    ASSERT_NE (sequenceAdapter, nullptr);
+
+    const std::vector<GVK::ImageData> fromBundle    = renderFrames ();
+    const Clock::duration             bundleStartup = Clock::now () - bundleStart;
+
+    const GVK::ShaderBinaryCache::Statistics statisticsAfter = GVK::ShaderBinaryCache::Get ().GetStatistics ();
+
+    std::cout << "Startup and " << frames.size () << " frames from pyx: " << std::chrono::duration<double, std::milli> (pyxStartup).count () << " ms" << std::endl;
+    std::cout << "Startup and " << frames.size () << " frames from bundle: " << std::chrono::duration<double, std::milli> (bundleStartup).count () << " ms" << std::endl;
+
+    EXPECT_EQ (statisticsAfter.missCount, statisticsBefore.missCount) << "glslang should not run for a bundled sequence";
+    EXPECT_GT (statisticsAfter.hitCount, statisticsBefore.hitCount);
+    EXPECT_EQ (sequenceAdapter->GetEquivalentStimuli (), equivalentStimuliFromPyx);
+
+    ASSERT_EQ (fromBundle.size (), fromPyx.size ());
+    for (size_t i = 0; i < frames.size (); ++i) {
+        EXPECT_TRUE (fromBundle[i] == fromPyx[i]) << "frame " << frames[i] << " differs";
+    }
+}
+
+
+TEST_F (GearsTests, SequenceBundle_RefusesPythonCallbacks)
+{
+    const std::filesystem::path pyxPath    = SequencesFolder / "4_MovingShapes" / "4_Interactive" / "1_mouseAdjustable.pyx";
+    const std::filesystem::path bundlePath = TempFolder / "1_mouseAdjustable.gvkbundle";
+
+    LoadFromFile (pyxPath);
+
+    std::filesystem::create_directories (TempFolder);
+    std::filesystem::remove (bundlePath);
+
+    // MouseRect and MouseCrossing register event callbacks, the bundle would run without them
+    EXPECT_THROW (SequenceBundle::Write (bundlePath, pyxPath, *sequenceAdapter, GetDeviceExtra ()), std::runtime_error);
+    EXPECT_FALSE (std::filesystem::exists (bundlePath));
+}
+
+
+static std::vector<std::filesystem::path> GetLoadableSequences ()
+{
+    // the sequences of the disabled LoadOnly tests
+    const std::vector<std::string> skippedFolders = { "4_SampleFilters" };
+    const std::vector<std::string> skippedFiles   = { "21_temp_filter_test.pyx", "1_tempocell.pyx", "9_quads.pyx", "4_mouseResizableFilter.pyx", "1_brownian.pyx",
+                                                    "5_showoff.pyx", "6_showoffScale.pyx", "1_chess_60Hz.pyx", "8_chess_pinch.pyx", "9_chess_hires.pyx", "2_soft_60Hz_big_dog.pyx" };
+
+    const auto contains = [] (const std::vector<std::string>& names, const std::string& name) {
+        return std::find (names.begin (), names.end (), name) != names.end ();
+    };
+
+    std::vector<std::filesystem::path> result;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator (SequencesFolder)) {
+        if (entry.path ().extension () != ".pyx" || contains (skippedFiles, entry.path ().filename ().string ())) {
+            continue;
+        }
+
+        const bool inSkippedFolder = std::any_of (entry.path ().begin (), entry.path ().end (), [&] (const std::filesystem::path& part) {
+            return contains (skippedFolders, part.string ());
+        });
+
+        if (!inSkippedFolder) {
+            result.push_back (entry.path ());
+        }
+    }
+
+    std::sort (result.begin (), result.end ());
+
+    return result;
+}
+
+
+TEST_F (GearsTests, LoadAllSequences_ParallelMatchesSequential)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    const std::vector<std::filesystem::path> sequencePaths = GetLoadableSequences ();
+    ASSERT_FALSE (sequencePaths.empty ());
+
+    // the shared python modules are imported once, neither run should pay for it
+    ASSERT_NE (Gears::GetSequenceFromPyx (sequencePaths[0]), nullptr);
+
+    GVK::ShaderBinaryCache::Get ().Clear ();
+
+    const Clock::time_point sequentialStart = Clock::now ();
+
+    std::vector<std::unique_ptr<SequenceAdapter>> sequential;
+    for (const std::filesystem::path& sequencePath : sequencePaths) {
+        sequential.push_back (Gears::GetSequenceAdapterFromPyx (*env, sequencePath));
+        if (sequential.back () != nullptr) {
+            sequential.back ()->PrecompileShaders ();
+        }
+    }
+
+    const Clock::duration sequentialTime = Clock::now () - sequentialStart;
+
+    GVK::ShaderBinaryCache::Get ().Clear ();
+
+    const Clock::time_point parallelStart = Clock::now ();
+
+    const std::vector<std::unique_ptr<SequenceAdapter>> parallel = Gears::GetSequenceAdaptersFromPyx (*env, sequencePaths);
+
+    const Clock::duration parallelTime = Clock::now () - parallelStart;
+
+    std::cout << "Loading " << sequencePaths.size () << " sequences one by one: " << std::chrono::duration<double, std::milli> (sequentialTime).count () << " ms" << std::endl;
+    std::cout << "Loading " << sequencePaths.size () << " sequences in parallel: " << std::chrono::duration<double, std::milli> (parallelTime).count () << " ms" << std::endl;
+
+    ASSERT_EQ (parallel.size (), sequential.size ());
+    for (size_t i = 0; i < sequencePaths.size (); ++i) {
+        ASSERT_NE (parallel[i], nullptr) << sequencePaths[i].string ();
+        ASSERT_NE (sequential[i], nullptr) << sequencePaths[i].string ();
+        EXPECT_EQ (parallel[i]->GetSequence ()->getStimuli ().size (), sequential[i]->GetSequence ()->getStimuli ().size ()) << sequencePaths[i].string ();
+        EXPECT_EQ (parallel[i]->GetEquivalentStimuli (), sequential[i]->GetEquivalentStimuli ()) << sequencePaths[i].string ();
+    }
+}
+
+
+TEST_F (HeadlessTestEnvironment, Pass_HighFrequencyRenderMatchesSeparateFrames)
+{
+    constexpr uint32_t width  = 256;
+    constexpr uint32_t height = 256;
+
+    constexpr float   startTime        = 2.f;
+    constexpr int32_t startFrame       = 361;
+    constexpr float   subFrameTimeStep = 1.f / 180.f;
+
+    Pass pass;
+    pass.setShaderVariable ("frameWeight", 0.25f);
+    pass.setShaderFunction ("wave", "float wave (vec2 uv, float time) { return fract (uv.x * 3.0 + time * 7.0); }");
+    pass.setStimulusGeneratorShaderSource (R"(
+layout (location = 0) in vec2 textureCoords;
+
+layout (location = 0) out vec4 presented;
+
+void main ()
+{
+    float value = fract (wave (textureCoords, time) + float (frame % 4) * frameWeight);
+    presented = vec4 (vec3 (value), 1.0);
+}
+)");
+
+    const auto render = [&] (uint32_t subFrameCount, float time, int32_t frame) {
+        std::shared_ptr<RG::RenderOperation> operation = RG::RenderOperation::Builder (GetDevice ())
+                                                             .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                             .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                             .SetVertexShader (passThroughVertexShader)
+                                                             .SetFragmentShader (pass.getStimulusGeneratorShaderSource (subFrameCount))
+                                                             .SetBlendEnabled (false)
+                                                             .Build ();
+
+        std::shared_ptr<RG::WritableImageResource> output = std::make_unique<RG::WritableImageResource> (VK_FILTER_LINEAR, width, height, 1, VK_FORMAT_R8G8B8A8_UNORM);
+
+        RG::GraphSettings s (GetDeviceExtra (), 1);
+
+        auto& aTable = operation->compileSettings.attachmentProvider;
+        aTable->table.push_back ({ "presented", GVK::ShaderKind::Fragment, { output->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, output->GetImageViewForFrameProvider (), output->GetInitialLayout (), output->GetFinalLayout () } });
+
+        s.connectionSet.Add (operation, output);
+
+        GVK::SpecializationConstants constants;
+        for (auto& [name, value] : pass.getShaderVariableConstants ()) {
+            constants.Set (name, value);
+        }
+        operation->GetShaderPipeline ()->SetSpecializationConstants (constants);
+
+        RG::UniformReflection reflection (s.connectionSet);
+
+        RG::RenderGraph graph;
+        graph.Compile (std::move (s));
+
+        auto& commonUniformBlock = reflection[operation][GVK::ShaderKind::Fragment]["commonUniformBlock"];
+        commonUniformBlock["time"]  = time;
+        commonUniformBlock["frame"] = frame;
+        if (subFrameCount > 1) {
+            commonUniformBlock["subFrameTimeStep"] = subFrameTimeStep;
+        }
+
+        reflection.Flush (0);
+
+        graph.Submit (0);
+        env->Wait ();
+
+        return GVK::ImageData (GetDeviceExtra (), *output->GetImages ()[0], 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    };
+
+    const GVK::ImageData packed = render (3, startTime, startFrame);
+
+    ASSERT_EQ (packed.width, width);
+    ASSERT_EQ (packed.height, height);
+    ASSERT_EQ (packed.components, 4);
+
+    for (uint32_t subFrame = 0; subFrame < 3; ++subFrame) {
+        const GVK::ImageData separate = render (1, startTime + subFrame * subFrameTimeStep, startFrame + static_cast<int32_t> (subFrame));
+
+        uint32_t wrongPixels = 0;
+        for (size_t pixelIndex = 0; pixelIndex < width * height; ++pixelIndex) {
+            // monochrome frames, every channel has the same value
+            const int32_t expected = separate.data[pixelIndex * 4];
+            const int32_t actual   = packed.data[pixelIndex * 4 + subFrame];
+
+            // the sub-frame time is added on the gpu, it may be rounded differently
+            if (std::abs (expected - actual) > 1) {
+                ++wrongPixels;
+            }
+        }
+
+        EXPECT_EQ (wrongPixels, 0) << "sub-frame " << subFrame;
+    }
+
+    // the test is only meaningful if the sub-frames are different
+    EXPECT_FALSE (render (1, startTime, startFrame) == render (1, startTime + subFrameTimeStep, startFrame + 1));
+}
+
+
+TEST_F (HeadlessTestEnvironment, Pass_ShaderVariableConstantsMatchUniforms)
+{
+    constexpr uint32_t width  = 64;
+    constexpr uint32_t height = 64;
+
+    const std::string patternMain = R"(
+layout (location = 0) in vec2 textureCoords;
+
+layout (location = 0) out vec4 presented;
+
+void main ()
+{
+    presented = vec4 (tint * brightness * step (distance (textureCoords, center), 0.25), 1.0);
+}
+)";
+
+    Pass pass;
+    pass.setShaderVariable ("brightness", 0.75f);
+    pass.setShaderVector ("center", 0.25f, 0.5f);
+    pass.setShaderColor ("tint", -2.f, 0.2f, 0.6f, 1.f);
+    pass.setStimulusGeneratorShaderSource (patternMain);
+
+    // the same pattern with the shader variables in a uniform block, the way they were passed before
+    const std::string uniformShader = R"(
+#version 450
+
+layout (binding = 1) uniform Parameters {
+    vec3  tint;
+    vec2  center;
+    float brightness;
+};
+)" + patternMain;
+
+    const auto render = [&] (const std::string& fragmentShader, const GVK::SpecializationConstants& constants) {
+        std::shared_ptr<RG::RenderOperation> operation = RG::RenderOperation::Builder (GetDevice ())
+                                                             .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                             .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                             .SetVertexShader (passThroughVertexShader)
+                                                             .SetFragmentShader (fragmentShader)
+                                                             .SetBlendEnabled (false)
+                                                             .Build ();
+
+        operation->GetShaderPipeline ()->SetSpecializationConstants (constants);
+
+        std::shared_ptr<RG::WritableImageResource> output = std::make_unique<RG::WritableImageResource> (VK_FILTER_LINEAR, width, height, 1, VK_FORMAT_R8G8B8A8_UNORM);
+
+        RG::GraphSettings s (GetDeviceExtra (), 1);
+
+        auto& aTable = operation->compileSettings.attachmentProvider;
+        aTable->table.push_back ({ "presented", GVK::ShaderKind::Fragment, { output->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, output->GetImageViewForFrameProvider (), output->GetInitialLayout (), output->GetFinalLayout () } });
+
+        s.connectionSet.Add (operation, output);
+
+        RG::UniformReflection reflection (s.connectionSet);
+
+        RG::RenderGraph graph;
+        graph.Compile (std::move (s));
+
+        auto& fragmentUniforms = reflection[operation][GVK::ShaderKind::Fragment];
+        if (fragmentUniforms.Contains ("Parameters")) {
+            fragmentUniforms["Parameters"]["tint"]       = pass.shaderColors.at ("tint");
+            fragmentUniforms["Parameters"]["center"]     = pass.shaderVectors.at ("center");
+            fragmentUniforms["Parameters"]["brightness"] = pass.shaderVariables.at ("brightness");
+        }
+
+        reflection.Flush (0);
+
+        graph.Submit (0);
+        env->Wait ();
+
+        return GVK::ImageData (GetDeviceExtra (), *output->GetImages ()[0], 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    };
+
+    GVK::SpecializationConstants constants;
+    for (auto& [name, value] : pass.getShaderVariableConstants ()) {
+        constants.Set (name, value);
+    }
+
+    const GVK::ImageData specialized = render (pass.getStimulusGeneratorShaderSource (), constants);
+    const GVK::ImageData uniform     = render (uniformShader, GVK::SpecializationConstants {});
+
+    EXPECT_TRUE (specialized == uniform);
+
+    // the test is only meaningful if the constants are used, unspecialized they are all zero
+    EXPECT_FALSE (specialized == render (pass.getStimulusGeneratorShaderSource (), GVK::SpecializationConstants {}));
+}
+
+
+TEST_F (GearsTests, SequenceAdapter_ShaderImageRendersLoadedFile)
+{
+    constexpr uint32_t width      = 64;
+    constexpr uint32_t height     = 64;
+    constexpr uint32_t squareSize = 8;
+
+    std::vector<uint8_t> checkerboard (width * height * 4, 255);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            const uint8_t value = ((x / squareSize + y / squareSize) % 2 == 0) ? 0 : 255;
+            for (uint32_t c = 0; c < 3; ++c) {
+                checkerboard[(y * width + x) * 4 + c] = value;
+            }
+        }
+    }
+
+    std::vector<uint8_t> opaqueBlack (width * height * 4, 0);
+    for (size_t i = 3; i < opaqueBlack.size (); i += 4) {
+        opaqueBlack[i] = 255;
+    }
+
+    const GVK::ImageData reference = GVK::ImageData::FromDataUint (checkerboard, width, height, 4);
+    const GVK::ImageData black     = GVK::ImageData::FromDataUint (opaqueBlack, width, height, 4);
+
+    std::filesystem::create_directories (TempFolder);
+    const std::filesystem::path imagePath   = TempFolder / "checkerboard.png";
+    const std::filesystem::path missingPath = TempFolder / "missing.png";
+    reference.SaveTo (imagePath);
+    std::filesystem::remove (missingPath);
+
+    // the same file is decoded and uploaded only once
+    {
+        RG::ImageLoader imageLoader (GetDeviceExtra ());
+        imageLoader.Load ({ imagePath, imagePath });
+
+        std::shared_ptr<RG::ReadOnlyImageResource> image = imageLoader.Get (imagePath);
+        ASSERT_NE (image, nullptr);
+        EXPECT_EQ (imageLoader.Get (TempFolder / "." / "checkerboard.png"), image);
+        EXPECT_EQ (imageLoader.GetStatistics ().requestCount, 2);
+        EXPECT_EQ (imageLoader.GetStatistics ().decodedCount, 1);
+        EXPECT_EQ (imageLoader.GetStatistics ().uploadSubmitCount, 1);
+        EXPECT_EQ (imageLoader.GetStatistics ().uploadedBytes, width * height * 4);
+    }
+
+    std::shared_ptr<Sequence> sequence = std::make_shared<Sequence> ("Shader images");
+
+    // the sampler is bound by StimulusAdapter from the reflection of the pass, a missing file gets the placeholder
+    for (const std::filesystem::path& imageFile : { imagePath, missingPath }) {
+        std::shared_ptr<Pass> pass = std::make_shared<Pass> ();
+        pass->setShaderImage ("checkerboard", imageFile.string ());
+        pass->setShaderFunction ("pattern", "uniform sampler2D checkerboard;\nvec3 pattern (vec2 uv) { return texture (checkerboard, uv).rgb; }");
+        pass->setStimulusGeneratorShaderSource (R"(
+layout (location = 1) in vec2 fTexCoord;
+
+layout (location = 0) out vec4 presented;
+
+void main ()
+{
+    presented = vec4 (pattern (fTexCoord), 1.0);
+}
+)");
+
+        std::shared_ptr<Stimulus> stimulus = std::make_shared<Stimulus> ();
+        stimulus->setDuration (1);
+        stimulus->addPass (pass);
+
+        sequence->addStimulus (stimulus);
+        stimulus->onSequenceComplete ();
+    }
+
+    const std::string fragmentShader = sequence->getStimulusAtFrame (1)->getPasses ()[0]->getStimulusGeneratorShaderSource ();
+    EXPECT_NE (fragmentShader.find ("layout (binding = " + std::to_string (Pass::ShaderImageFirstBinding) + ") uniform sampler2D checkerboard;"), std::string::npos);
+
+    sequenceAdapter = std::make_unique<SequenceAdapter> (*env, sequence, "Shader images");
+
+    // the stimuli differ only in their image files
+    EXPECT_EQ (sequenceAdapter->GetEquivalentStimuli ().at (2), 2);
+
+    // the field covers the whole swapchain, so the pixels are sampled at the texel centers
+    pres = std::make_shared<RG::Presentable> (std::make_unique<GVK::FakeSwapchain> (GetDeviceExtra (), width, height));
+    sequenceAdapter->SetCurrentPresentable (pres);
+
+    const auto renderFrame = [&] (uint32_t frameIndex) {
+        sequenceAdapter->RenderFrameIndex (frameIndex);
+        sequenceAdapter->Wait ();
+
+        std::vector<std::unique_ptr<GVK::InheritedImage>> imgs = pres->GetSwapchain ().GetImageObjects ();
+        return GVK::ImageData (GetDeviceExtra (), *imgs[0], 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    };
+
+    // black and white are the same in srgb and linear, and in rgba and bgra
+    EXPECT_TRUE (renderFrame (1) == reference);
+    EXPECT_TRUE (renderFrame (2) == black) << "the placeholder should be black";
+}
+
+
 // clang-format off
 
 TEST_F (GearsTests, LoadOnly_0_Utility_1_Spots_1_tiny_red) { LoadFromFile (SequencesFolder / "0_Utility" / "1_Spots" / "1_tiny_red.pyx"); RenderFirstFrame (); }
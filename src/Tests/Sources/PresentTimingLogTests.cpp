@@ -0,0 +1,146 @@
+#include "RenderGraph/PresentTimingLog.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+
+using PresentTimingLogTests = ::testing::Test;
+
+
+namespace {
+
+using Clock = RG::FrameTiming::Clock;
+
+constexpr std::chrono::milliseconds RefreshInterval { 10 };
+
+
+class SyntheticFrames {
+private:
+    Clock::time_point imageAvailable;
+
+public:
+    SyntheticFrames ()
+        : imageAvailable { Clock::time_point {} + std::chrono::seconds (1) }
+    {
+    }
+
+    // the image of the frame becomes available after the given interval, the frame is presented acquireToPresent later
+    RG::FrameTiming Next (Clock::duration interval, Clock::duration acquireToPresent = std::chrono::milliseconds (2))
+    {
+        imageAvailable += interval;
+
+        RG::FrameTiming timing;
+        timing.resourceIndex  = 0;
+        timing.imageIndex     = 0;
+        timing.acquireStarted = imageAvailable - std::chrono::microseconds (100);
+        timing.imageAvailable = imageAvailable;
+        timing.submitted      = imageAvailable + acquireToPresent / 2;
+        timing.presented      = imageAvailable + acquireToPresent;
+        return timing;
+    }
+};
+
+} // namespace
+
+
+TEST_F (PresentTimingLogTests, LongerIntervalsAreDroppedFrames)
+{
+    RG::PresentTimingLog log (RefreshInterval);
+    SyntheticFrames      frames;
+
+    // the first frame has no interval
+    EXPECT_EQ (0, log.Add (frames.Next (Clock::duration::zero ())));
+
+    for (uint32_t i = 0; i < 9; ++i) {
+        EXPECT_EQ (0, log.Add (frames.Next (RefreshInterval)));
+    }
+
+    EXPECT_EQ (1, log.Add (frames.Next (2 * RefreshInterval)));
+    EXPECT_EQ (0, log.Add (frames.Next (RefreshInterval)));
+    EXPECT_EQ (2, log.Add (frames.Next (3 * RefreshInterval)));
+    EXPECT_EQ (0, log.Add (frames.Next (RefreshInterval, std::chrono::milliseconds (15))));
+
+    const RG::PresentTimingLog::Summary& summary = log.GetSummary ();
+
+    EXPECT_EQ (14, summary.frameCount);
+    EXPECT_EQ (2, summary.droppedFrameCount);
+    EXPECT_EQ (3, summary.missedVblankCount);
+    EXPECT_EQ (1, summary.lateFrameCount);
+    EXPECT_DOUBLE_EQ (30.0, summary.maxIntervalMilliseconds);
+    EXPECT_NEAR (160.0 / 13.0, summary.meanIntervalMilliseconds, 1e-9);
+
+    // every interval is an exact multiple of the refresh interval
+    EXPECT_EQ (13, summary.jitterHistogram[0]);
+}
+
+
+TEST_F (PresentTimingLogTests, JitterIsMeasuredFromTheNearestRefresh)
+{
+    RG::PresentTimingLog log (RefreshInterval);
+    SyntheticFrames      frames;
+
+    log.Add (frames.Next (Clock::duration::zero ()));
+    log.Add (frames.Next (std::chrono::microseconds (9'800)));
+    log.Add (frames.Next (std::chrono::microseconds (10'300)));
+    log.Add (frames.Next (std::chrono::microseconds (10'600)));
+    log.Add (frames.Next (std::chrono::microseconds (12'400)));
+
+    // 20'100 us is two refreshes with 100 us jitter
+    EXPECT_EQ (1, log.Add (frames.Next (std::chrono::microseconds (20'100))));
+
+    const RG::PresentTimingLog::Summary& summary = log.GetSummary ();
+
+    EXPECT_EQ (1, summary.droppedFrameCount);
+    EXPECT_EQ (2, summary.jitterHistogram[0]);
+    EXPECT_EQ (1, summary.jitterHistogram[1]);
+    EXPECT_EQ (1, summary.jitterHistogram[2]);
+    EXPECT_EQ (1, summary.jitterHistogram[RG::PresentTimingLog::HistogramBucketCount - 1]);
+}
+
+
+TEST_F (PresentTimingLogTests, BinaryLogHasOneRecordPerFrame)
+{
+    const std::filesystem::path logPath = std::filesystem::temp_directory_path () / "GearsVkPresentTimingLogTests.bin";
+
+    {
+        RG::PresentTimingLog log (RefreshInterval, logPath);
+        SyntheticFrames      frames;
+
+        log.Add (frames.Next (Clock::duration::zero ()));
+        log.Add (frames.Next (RefreshInterval));
+        log.Add (frames.Next (2 * RefreshInterval));
+    }
+
+    std::ifstream           file (logPath, std::ios::binary);
+    const std::vector<char> content { std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> () };
+    constexpr size_t        headerSize = 4 + sizeof (uint32_t) + sizeof (uint64_t);
+
+    file.close ();
+    std::filesystem::remove (logPath);
+
+    ASSERT_EQ (headerSize + 3 * sizeof (RG::PresentTimingLog::BinaryRecord), content.size ());
+    EXPECT_EQ (0, std::memcmp (content.data (), "GVPT", 4));
+
+    uint32_t version          = 0;
+    uint64_t expectedInterval = 0;
+    std::memcpy (&version, content.data () + 4, sizeof (version));
+    std::memcpy (&expectedInterval, content.data () + 8, sizeof (expectedInterval));
+    EXPECT_EQ (RG::PresentTimingLog::BinaryLogVersion, version);
+    EXPECT_EQ (10'000'000, expectedInterval);
+
+    RG::PresentTimingLog::BinaryRecord records[3];
+    std::memcpy (records, content.data () + headerSize, sizeof (records));
+
+    EXPECT_EQ (0, records[0].imageAvailable);
+    EXPECT_EQ (10'000'000, records[1].imageAvailable);
+    EXPECT_EQ (30'000'000, records[2].imageAvailable);
+    EXPECT_EQ (2, records[2].presentIndex);
+    EXPECT_EQ (0, records[1].missedVblanks);
+    EXPECT_EQ (1, records[2].missedVblanks);
+}
@@ -181,11 +181,15 @@ void main () {
         commandBuffer.Record<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, std::vector<VkMemoryBarrier> { flushAllMemory }, std::vector<VkBufferMemoryBarrier> {}, std::vector<VkImageMemoryBarrier> { transition });
         commandBuffer.Record<GVK::CommandBeginRenderPass> (*sp->compileResult.renderPass, fb, VkRect2D { { 0, 0 }, { 512, 512 } }, std::vector<VkClearValue> { clearValue }, VK_SUBPASS_CONTENTS_INLINE);
         commandBuffer.Record<GVK::CommandBindPipeline> (VK_PIPELINE_BIND_POINT_GRAPHICS, *sp->compileResult.pipeline);
+        commandBuffer.Record<GVK::CommandSetViewport> (VkViewport { 0.0f, 0.0f, 512.0f, 512.0f, 0.0f, 1.0f });
+        commandBuffer.Record<GVK::CommandSetScissor> (VkRect2D { { 0, 0 }, { 512, 512 } });
         commandBuffer.Record<GVK::CommandDraw> (6, 1, 0, 0);
         commandBuffer.Record<GVK::CommandEndRenderPass> ();
         commandBuffer.Record<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, std::vector<VkMemoryBarrier> { flushAllMemory }, std::vector<VkBufferMemoryBarrier> {}, std::vector<VkImageMemoryBarrier> { transition });
         commandBuffer.Record<GVK::CommandBeginRenderPass> (*sp2->compileResult.renderPass, fb, VkRect2D { { 0, 0 }, { 512, 512 } }, std::vector<VkClearValue> { clearValue }, VK_SUBPASS_CONTENTS_INLINE);
         commandBuffer.Record<GVK::CommandBindPipeline> (VK_PIPELINE_BIND_POINT_GRAPHICS, *sp2->compileResult.pipeline);
+        commandBuffer.Record<GVK::CommandSetViewport> (VkViewport { 0.0f, 0.0f, 512.0f, 512.0f, 0.0f, 1.0f });
+        commandBuffer.Record<GVK::CommandSetScissor> (VkRect2D { { 0, 0 }, { 512, 512 } });
         commandBuffer.Record<GVK::CommandDraw> (6, 1, 0, 0);
         commandBuffer.Record<GVK::CommandEndRenderPass> ();
         commandBuffer.Record<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, std::vector<VkMemoryBarrier> { flushAllMemory }, std::vector<VkBufferMemoryBarrier> {}, std::vector<VkImageMemoryBarrier> { transition });
@@ -326,11 +330,15 @@ void main () {
         commandBuffer.Record<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, std::vector<VkMemoryBarrier> { flushAllMemory }, std::vector<VkBufferMemoryBarrier> {}, std::vector<VkImageMemoryBarrier> { transition });
         commandBuffer.Record<GVK::CommandBeginRenderPass> (*renderOp->compileSettings.pipeline->compileResult.renderPass, *renderOp->compileResult.framebuffers[0], VkRect2D { { 0, 0 }, { 512, 512 } }, std::vector<VkClearValue> { clearValue }, VK_SUBPASS_CONTENTS_INLINE);
         commandBuffer.Record<GVK::CommandBindPipeline> (VK_PIPELINE_BIND_POINT_GRAPHICS, *renderOp->compileSettings.pipeline->compileResult.pipeline);
+        commandBuffer.Record<GVK::CommandSetViewport> (VkViewport { 0.0f, 0.0f, 512.0f, 512.0f, 0.0f, 1.0f });
+        commandBuffer.Record<GVK::CommandSetScissor> (VkRect2D { { 0, 0 }, { 512, 512 } });
         commandBuffer.Record<GVK::CommandDraw> (6, 1, 0, 0);
         commandBuffer.Record<GVK::CommandEndRenderPass> ();
         commandBuffer.Record<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, std::vector<VkMemoryBarrier> { flushAllMemory }, std::vector<VkBufferMemoryBarrier> {}, std::vector<VkImageMemoryBarrier> { transition });
         commandBuffer.Record<GVK::CommandBeginRenderPass> (*renderOp2->compileSettings.pipeline->compileResult.renderPass, *renderOp2->compileResult.framebuffers[0], VkRect2D { { 0, 0 }, { 512, 512 } }, std::vector<VkClearValue> { clearValue }, VK_SUBPASS_CONTENTS_INLINE);
         commandBuffer.Record<GVK::CommandBindPipeline> (VK_PIPELINE_BIND_POINT_GRAPHICS, *renderOp2->compileSettings.pipeline->compileResult.pipeline);
+        commandBuffer.Record<GVK::CommandSetViewport> (VkViewport { 0.0f, 0.0f, 512.0f, 512.0f, 0.0f, 1.0f });
+        commandBuffer.Record<GVK::CommandSetScissor> (VkRect2D { { 0, 0 }, { 512, 512 } });
         commandBuffer.Record<GVK::CommandDraw> (6, 1, 0, 0);
         commandBuffer.Record<GVK::CommandEndRenderPass> ();
         commandBuffer.Record<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, std::vector<VkMemoryBarrier> { flushAllMemory }, std::vector<VkBufferMemoryBarrier> {}, std::vector<VkImageMemoryBarrier> { transition });
@@ -459,11 +467,15 @@ void main () {
         commandBuffer.Record<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, std::vector<VkMemoryBarrier> { flushAllMemory }, std::vector<VkBufferMemoryBarrier> {}, std::vector<VkImageMemoryBarrier> { transition });
         commandBuffer.Record<GVK::CommandBeginRenderPass> (*renderOp->compileSettings.pipeline->compileResult.renderPass, *renderOp->compileResult.framebuffers[0], VkRect2D { { 0, 0 }, { 512, 512 } }, std::vector<VkClearValue> { clearValue }, VK_SUBPASS_CONTENTS_INLINE);
         commandBuffer.Record<GVK::CommandBindPipeline> (VK_PIPELINE_BIND_POINT_GRAPHICS, *renderOp->compileSettings.pipeline->compileResult.pipeline);
+        commandBuffer.Record<GVK::CommandSetViewport> (VkViewport { 0.0f, 0.0f, 512.0f, 512.0f, 0.0f, 1.0f });
+        commandBuffer.Record<GVK::CommandSetScissor> (VkRect2D { { 0, 0 }, { 512, 512 } });
         commandBuffer.Record<GVK::CommandDraw> (6, 1, 0, 0);
         commandBuffer.Record<GVK::CommandEndRenderPass> ();
         commandBuffer.Record<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, std::vector<VkMemoryBarrier> { flushAllMemory }, std::vector<VkBufferMemoryBarrier> {}, std::vector<VkImageMemoryBarrier> { transition });
         commandBuffer.Record<GVK::CommandBeginRenderPass> (*renderOp2->compileSettings.pipeline->compileResult.renderPass, *renderOp2->compileResult.framebuffers[0], VkRect2D { { 0, 0 }, { 512, 512 } }, std::vector<VkClearValue> { clearValue }, VK_SUBPASS_CONTENTS_INLINE);
         commandBuffer.Record<GVK::CommandBindPipeline> (VK_PIPELINE_BIND_POINT_GRAPHICS, *renderOp2->compileSettings.pipeline->compileResult.pipeline);
+        commandBuffer.Record<GVK::CommandSetViewport> (VkViewport { 0.0f, 0.0f, 512.0f, 512.0f, 0.0f, 1.0f });
+        commandBuffer.Record<GVK::CommandSetScissor> (VkRect2D { { 0, 0 }, { 512, 512 } });
         commandBuffer.Record<GVK::CommandDraw> (6, 1, 0, 0);
         commandBuffer.Record<GVK::CommandEndRenderPass> ();
         commandBuffer.Record<GVK::CommandPipelineBarrier> (VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, std::vector<VkMemoryBarrier> { flushAllMemory }, std::vector<VkBufferMemoryBarrier> {}, std::vector<VkImageMemoryBarrier> {});
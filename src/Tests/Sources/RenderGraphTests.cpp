@@ -4,9 +4,11 @@
 #include "RenderGraph/GraphRenderer.hpp"
 #include "RenderGraph/GraphSettings.hpp"
 #include "RenderGraph/Operation.hpp"
+#include "RenderGraph/OperationProfiler.hpp"
 #include "RenderGraph/RenderGraph.hpp"
 #include "RenderGraph/Resource.hpp"
 #include "RenderGraph/ShaderPipeline.hpp"
+#include "RenderGraph/UniformArena.hpp"
 #include "RenderGraph/UniformReflection.hpp"
 #include "RenderGraph/BufferView.hpp"
 #include "RenderGraph/VulkanEnvironment.hpp"
@@ -25,9 +27,12 @@
 
 #include <glm/glm.hpp>
 
+#include <chrono>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <thread>
 
@@ -844,6 +849,107 @@ void main()
 }
 
 
+static const std::string layeredComputeShader = R"(
+#version 450
+
+layout (local_size_x = 1, local_size_y = 1) in;
+
+layout (constant_id = 0) const uint FRAMESINFLIGHT = 1;
+layout (constant_id = 3) const float scale = 0.5;
+
+layout (set = 0, binding = 0) buffer OutputBuffer {
+    uvec4 randomsBuffer[FRAMESINFLIGHT][4][4];
+};
+
+void main ()
+{
+    uint gIDx = gl_GlobalInvocationID.x;
+    uint gIDy = gl_GlobalInvocationID.y;
+
+    for (uint layer = 0; layer < FRAMESINFLIGHT; ++layer) {
+        randomsBuffer[layer][gIDy][gIDx] = uvec4 (layer, gIDy, gIDx, uint (scale * 10.0));
+    }
+}
+)";
+
+
+TEST_F (HeadlessTestEnvironment, ShaderModule_SpecializationConstants)
+{
+    std::unique_ptr<GVK::ShaderModule> shaderModule = GVK::ShaderModule::CreateFromGLSLString (GetDevice (), GVK::ShaderKind::Compute, layeredComputeShader);
+
+    const std::vector<SR::SpecializationConstant>& constants = shaderModule->GetReflection ().specializationConstants;
+    ASSERT_EQ (2, constants.size ());
+    EXPECT_EQ ("FRAMESINFLIGHT", constants[0].name);
+    EXPECT_EQ (0, constants[0].constantId);
+    EXPECT_EQ (SR::FieldType::Uint, constants[0].type);
+    EXPECT_EQ (1, constants[0].defaultValue);
+    EXPECT_EQ ("scale", constants[1].name);
+    EXPECT_EQ (3, constants[1].constantId);
+    EXPECT_EQ (SR::FieldType::Float, constants[1].type);
+
+    ASSERT_EQ (1, shaderModule->GetReflection ().storageBuffers.size ());
+    EXPECT_EQ (1 * 4 * 4 * 16, shaderModule->GetReflection ().storageBuffers[0]->GetFullSize ());
+    EXPECT_EQ (nullptr, shaderModule->GetShaderStageCreateInfo ().pSpecializationInfo);
+
+    GVK::SpecializationConstants values;
+    values.Set ("FRAMESINFLIGHT", 3u);
+    values.Set ("notDeclaredInTheShader", 1.f);
+    shaderModule->SetSpecializationConstants (values);
+
+    // the array is sized by the new value, the default values are still reported
+    EXPECT_EQ (3 * 4 * 4 * 16, shaderModule->GetReflection ().storageBuffers[0]->GetFullSize ());
+    EXPECT_EQ (1, shaderModule->GetReflection ().specializationConstants[0].defaultValue);
+
+    const VkPipelineShaderStageCreateInfo stageCreateInfo = shaderModule->GetShaderStageCreateInfo ();
+    ASSERT_NE (nullptr, stageCreateInfo.pSpecializationInfo);
+    ASSERT_EQ (1, stageCreateInfo.pSpecializationInfo->mapEntryCount);
+    EXPECT_EQ (0, stageCreateInfo.pSpecializationInfo->pMapEntries[0].constantID);
+    EXPECT_EQ (3, *reinterpret_cast<const uint32_t*> (stageCreateInfo.pSpecializationInfo->pData));
+}
+
+
+TEST_F (HeadlessTestEnvironment, ComputeShader_RenderGraph_SpecializationConstants)
+{
+    constexpr uint32_t layerCount = 3;
+
+    std::shared_ptr<RG::ComputeOperation> layerWriter = std::make_unique<RG::ComputeOperation> (4, 4, 1);
+
+    GVK::SpecializationConstants values;
+    values.Set ("FRAMESINFLIGHT", layerCount);
+    values.Set ("scale", 2.f);
+
+    layerWriter->compileSettings.computeShaderPipeline = std::make_unique<RG::ComputeShaderPipeline> (GetDevice (), layeredComputeShader);
+    layerWriter->compileSettings.computeShaderPipeline->SetSpecializationConstants (values);
+
+    const uint32_t bufferSize = layerWriter->compileSettings.computeShaderPipeline->computeShader->GetReflection ().storageBuffers[0]->GetFullSize ();
+    ASSERT_EQ (layerCount * 4 * 4 * sizeof (glm::uvec4), bufferSize);
+
+    std::shared_ptr<RG::CPUBufferResource> outputBuffer = std::make_unique<RG::CPUBufferResource> (bufferSize);
+
+    layerWriter->compileSettings.descriptorWriteProvider->bufferInfos.push_back ({ "OutputBuffer", GVK::ShaderKind::Compute, outputBuffer->GetBufferForFrameProvider (), 0, outputBuffer->GetBufferSize () });
+
+    RG::GraphSettings s (GetDeviceExtra (), 1);
+    s.connectionSet.Add (layerWriter, outputBuffer);
+
+    RG::RenderGraph graph;
+    graph.Compile (std::move (s));
+
+    graph.Submit (0);
+    env->Wait ();
+
+    std::vector<glm::uvec4> layers (layerCount * 4 * 4);
+    memcpy (layers.data (), outputBuffer->GetMapping (0).Get (), bufferSize);
+
+    for (uint32_t layer = 0; layer < layerCount; ++layer) {
+        for (uint32_t y = 0; y < 4; ++y) {
+            for (uint32_t x = 0; x < 4; ++x) {
+                EXPECT_EQ (glm::uvec4 (layer, y, x, 20), layers[(layer * 4 + y) * 4 + x]);
+            }
+        }
+    }
+}
+
+
 TEST_F (HeadlessTestEnvironment, ComputeShader_RenderGraph)
 {
     const std::string compSrc = R"(
@@ -1016,100 +1122,1552 @@ void main()
 }
 
 
-TEST_F (HeadlessTestEnvironment, RenderGraph_TwoOperationsRenderingToOutput)
+TEST_F (HeadlessTestEnvironment, ComputeShader_RenderGraph_AsyncCompute_MatchesGraphicsQueue)
 {
-    /*
-        firstPass  ---> presented
-        secondPass  _/ 
-    */
+    // without a compute only queue family both runs would use the graphics queue
+    if (!GetDeviceExtra ().HasAsyncComputeQueue ()) {
+        GTEST_SKIP () << "no async compute queue, the device has no compute only queue family or timeline semaphores are not supported";
+    }
 
-    // will turn into
+    const std::string compSrc = R"(
+#version 450
 
-    /*
-        firstPass ---> presented ---> secondPass ---> presented
-    */
+layout (local_size_x = 4, local_size_y = 4) in;
 
-    const std::string frag1 = R"(
+layout (set = 0, binding = 0) uniform RandomGeneratorConfig {
+    uint seed;
+    uint frameIndex;
+};
+
+layout (set = 0, binding = 1) buffer OutputBuffer {
+    uint randomsBuffer[4][4];
+};
+
+void main()
+{
+    uint gIDx = gl_GlobalInvocationID.x;
+    uint gIDy = gl_GlobalInvocationID.y;
+
+    uint x = gIDx * 1341593453u ^ gIDy * 971157919u ^ seed * 2883500843u ^ frameIndex * 1790208463u;
+    x ^= x << 13u;
+    x ^= x >> 17u;
+    x ^= x << 5u;
+
+    randomsBuffer[gIDy][gIDx] = x;
+}
+    )";
+
+    constexpr uint32_t framesInFlight = 3;
+    constexpr uint32_t frameCount     = 7;
+
+    const auto GenerateRandoms = [&] (bool useAsyncCompute) -> std::vector<std::vector<uint32_t>> {
+        std::shared_ptr<RG::ComputeOperation> randomGenerator  = std::make_unique<RG::ComputeOperation> (1, 1, 1);
+        randomGenerator->compileSettings.computeShaderPipeline = std::make_unique<RG::ComputeShaderPipeline> (GetDevice (), compSrc);
+
+        RG::ConnectionSet connectionSet;
+        connectionSet.Add (randomGenerator);
+
+        auto creator = [&] (const std::shared_ptr<RG::Operation>&, const GVK::ShaderModule&, const std::shared_ptr<SR::BufferObject>& bufferObject, bool&) -> std::shared_ptr<RG::DescriptorBindableBufferResource> {
+            if (bufferObject->name == "OutputBuffer")
+                return std::make_unique<RG::GPUBufferResource> (bufferObject->GetFullSize ());
+
+            return std::make_unique<RG::CPUBufferResource> (bufferObject->GetFullSize ());
+        };
+
+        RG::UniformReflection refl (connectionSet, creator);
+
+        RG::GraphSettings s (GetDeviceExtra (), std::move (connectionSet), framesInFlight);
+        s.useAsyncCompute = useAsyncCompute;
+
+        RG::RenderGraph graph;
+        graph.Compile (std::move (s));
+
+        EXPECT_EQ (useAsyncCompute, graph.UsesAsyncCompute ());
+
+        std::shared_ptr<RG::GPUBufferResource> randomsBuffer = graph.GetConnectionSet ().GetByName<RG::GPUBufferResource> ("OutputBuffer");
+
+        for (uint32_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+            const uint32_t resourceIndex = frameIndex % framesInFlight;
+
+            // frames in flight are submitted without waiting, the graph must order the compute and graphics submissions itself
+            refl[randomGenerator][GVK::ShaderKind::Compute]["RandomGeneratorConfig"]["seed"]       = static_cast<uint32_t> (7);
+            refl[randomGenerator][GVK::ShaderKind::Compute]["RandomGeneratorConfig"]["frameIndex"] = frameIndex;
+
+            refl.Flush (resourceIndex);
+
+            graph.Submit (resourceIndex);
+
+            if (resourceIndex == framesInFlight - 1) {
+                env->Wait ();
+            }
+        }
+
+        env->Wait ();
+
+        std::vector<std::vector<uint32_t>> result;
+        for (uint32_t resourceIndex = 0; resourceIndex < framesInFlight; ++resourceIndex) {
+            randomsBuffer->TransferFromGPUToCPU (resourceIndex);
+
+            std::vector<uint32_t>& randoms = result.emplace_back (randomsBuffer->GetBufferSize () / sizeof (uint32_t));
+            memcpy (randoms.data (), randomsBuffer->buffers[resourceIndex]->bufferCPUMapping.Get (), randomsBuffer->GetBufferSize ());
+        }
+
+        return result;
+    };
+
+    const std::vector<std::vector<uint32_t>> asyncResult    = GenerateRandoms (true);
+    const std::vector<std::vector<uint32_t>> graphicsResult = GenerateRandoms (false);
+
+    ASSERT_EQ (framesInFlight, asyncResult.size ());
+    ASSERT_EQ (framesInFlight, graphicsResult.size ());
+
+    for (uint32_t resourceIndex = 0; resourceIndex < framesInFlight; ++resourceIndex) {
+        EXPECT_EQ (graphicsResult[resourceIndex], asyncResult[resourceIndex]);
+    }
+}
+
+
+TEST_F (HeadlessTestEnvironment, DescriptorAllocator_1000Operations)
+{
+    constexpr uint32_t operationCount = 1000;
+    constexpr uint32_t framesInFlight = 3;
+
+    // a typical operation: uniforms and a sampled texture
+    GVK::DescriptorSetLayout layout (GetDevice (), {
+                                                       { 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
+                                                       { 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
+                                                   });
+
+    const std::vector<VkDescriptorPoolSize> operationPoolSizes {
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 },
+    };
+
+    {
+        GVK::DescriptorAllocator allocator (GetDevice (), framesInFlight);
+
+        std::vector<VkDescriptorPoolSize> aggregatePoolSizes;
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            aggregatePoolSizes.insert (aggregatePoolSizes.end (), operationPoolSizes.begin (), operationPoolSizes.end ());
+        }
+        allocator.SetPoolSizes (aggregatePoolSizes, operationCount);
+
+        // the descriptors of every operation fit in a single pool per arena
+        ASSERT_EQ (2, allocator.GetPoolSizes ().size ());
+        EXPECT_EQ (VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, allocator.GetPoolSizes ()[0].type);
+        EXPECT_EQ (operationCount, allocator.GetPoolSizes ()[0].descriptorCount);
+        EXPECT_EQ (VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, allocator.GetPoolSizes ()[1].type);
+        EXPECT_EQ (operationCount, allocator.GetPoolSizes ()[1].descriptorCount);
+        EXPECT_EQ (operationCount, allocator.GetSetsPerPool ());
+
+        std::vector<std::unique_ptr<GVK::DescriptorSet>> descriptorSets;
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            for (uint32_t resourceIndex = 0; resourceIndex < framesInFlight; ++resourceIndex) {
+                descriptorSets.push_back (std::make_unique<GVK::DescriptorSet> (allocator, resourceIndex, layout));
+            }
+        }
+
+        EXPECT_EQ (framesInFlight, allocator.GetPoolCount ());
+        EXPECT_EQ (operationCount * framesInFlight, allocator.GetAllocatedSetCount ());
+
+        // pools are kept and reused after a reset
+        allocator.Reset ();
+        EXPECT_EQ (0u, allocator.GetAllocatedSetCount ());
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            allocator.Allocate (i % framesInFlight, layout);
+        }
+        EXPECT_EQ (framesInFlight, allocator.GetPoolCount ());
+    }
+
+    // without size statistics the pools grow, but their count stays logarithmic
+    {
+        GVK::DescriptorAllocator allocator (GetDevice (), 1, 16);
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            allocator.Allocate (0, layout);
+        }
+        EXPECT_LE (allocator.GetPoolCount (), 7u);
+        EXPECT_EQ (operationCount, allocator.GetAllocatedSetCount ());
+    }
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_OperationsShareDescriptorPools)
+{
+    const std::string compSrc = R"(
 #version 450
-#extension GL_ARB_separate_shader_objects : enable
 
-layout (location = 0) out vec4 outColor;
+layout (local_size_x = 1) in;
 
-void main () {
-    outColor = vec4 (1, 0, 0, 0.5);
+layout (set = 0, binding = 0) buffer OutputBuffer {
+    uint value;
+};
+
+void main()
+{
+    value = 1;
 }
     )";
 
-    const std::string frag2 = R"(
+    constexpr uint32_t operationCount = 16;
+    constexpr uint32_t framesInFlight = 3;
+
+    RG::ConnectionSet                                  connectionSet;
+    std::vector<std::shared_ptr<RG::ComputeOperation>> ops;
+
+    for (uint32_t i = 0; i < operationCount; ++i) {
+        std::shared_ptr<RG::ComputeOperation> op = std::make_unique<RG::ComputeOperation> (1, 1, 1);
+        op->compileSettings.computeShaderPipeline = std::make_unique<RG::ComputeShaderPipeline> (GetDevice (), compSrc);
+
+        std::shared_ptr<RG::GPUBufferResource> buffer = std::make_unique<RG::GPUBufferResource> (4);
+        op->compileSettings.descriptorWriteProvider->bufferInfos.push_back ({ "OutputBuffer", GVK::ShaderKind::Compute, buffer->GetBufferForFrameProvider (), 0, buffer->GetBufferSize () });
+
+        connectionSet.Add (op, buffer);
+        ops.push_back (op);
+    }
+
+    const auto getDescriptorSets = [&] () {
+        std::vector<std::vector<VkDescriptorSet>> result;
+        for (const std::shared_ptr<RG::ComputeOperation>& op : ops) {
+            result.emplace_back ();
+            for (uint32_t resourceIndex = 0; resourceIndex < framesInFlight; ++resourceIndex) {
+                result.back ().push_back (op->compileResult.descriptors.GetDescriptorSet (resourceIndex));
+            }
+        }
+        return result;
+    };
+
+    RG::RenderGraph graph;
+    graph.Compile (RG::GraphSettings (GetDeviceExtra (), std::move (connectionSet), framesInFlight));
+
+    const GVK::DescriptorAllocator* allocator = graph.descriptorAllocator.get ();
+    ASSERT_NE (nullptr, allocator);
+
+    // one arena of the shared allocator fits one storage buffer descriptor of each operation
+    ASSERT_EQ (1, allocator->GetPoolSizes ().size ());
+    EXPECT_EQ (VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, allocator->GetPoolSizes ()[0].type);
+    EXPECT_EQ (operationCount, allocator->GetPoolSizes ()[0].descriptorCount);
+    EXPECT_EQ (operationCount, allocator->GetSetsPerPool ());
+
+    EXPECT_EQ (framesInFlight, allocator->GetPoolCount ());
+    EXPECT_EQ (operationCount * framesInFlight, allocator->GetAllocatedSetCount ());
+
+    const std::vector<std::vector<VkDescriptorSet>> descriptorSets = getDescriptorSets ();
+
+    std::set<VkDescriptorSet> uniqueDescriptorSets;
+    for (uint32_t i = 0; i < operationCount; ++i) {
+        ASSERT_EQ (framesInFlight, ops[i]->compileResult.descriptors.descriptorSets.size ());
+        uniqueDescriptorSets.insert (descriptorSets[i].begin (), descriptorSets[i].end ());
+    }
+    EXPECT_EQ (operationCount * framesInFlight, uniqueDescriptorSets.size ());
+
+    // recompiling one operation allocates only its descriptor sets, the others keep theirs
+    graph.RecompileOperations ({ ops[0].get () });
+
+    EXPECT_EQ (allocator, graph.descriptorAllocator.get ());
+    EXPECT_EQ ((operationCount + 1) * framesInFlight, allocator->GetAllocatedSetCount ());
+    EXPECT_LE (allocator->GetPoolCount (), 2 * framesInFlight);
+
+    const std::vector<std::vector<VkDescriptorSet>> recompiledDescriptorSets = getDescriptorSets ();
+    for (uint32_t i = 1; i < operationCount; ++i) {
+        EXPECT_EQ (descriptorSets[i], recompiledDescriptorSets[i]);
+    }
+
+    const uint32_t poolCount = allocator->GetPoolCount ();
+
+    // compiling the graph again resets the allocator and reuses its pools
+    RG::GraphSettings s = std::move (graph.graphSettings);
+    graph.Compile (std::move (s));
+
+    EXPECT_EQ (allocator, graph.descriptorAllocator.get ());
+    EXPECT_EQ (poolCount, allocator->GetPoolCount ());
+    EXPECT_EQ (operationCount * framesInFlight, allocator->GetAllocatedSetCount ());
+
+    graph.Submit (0);
+    env->Wait ();
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_OperationsShareCachedObjects)
+{
+    const std::string fragSrc = R"(
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
 layout (location = 0) out vec4 outColor;
 
 void main () {
-    outColor = vec4 (0, 0, 1, 0.5);
+    outColor = vec4 (1, 0, 0, 1);
 }
     )";
 
-    std::shared_ptr<RG::RenderOperation> firstPass = RG::RenderOperation::Builder (GetDevice ())
-                                                         .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
-                                                         .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
-                                                         .SetVertexShader (passThroughVertexShader)
-                                                         .SetFragmentShader (frag1)
-                                                         .SetBlendEnabled (false)
-                                                         .SetName ("FIRST")
-                                                         .Build ();
+    constexpr uint32_t operationCount = 32;
+    constexpr uint32_t framesInFlight = 3;
 
-    std::shared_ptr<RG::RenderOperation> secondPass = RG::RenderOperation::Builder (GetDevice ())
+    GVK::ObjectCache& cache = GetDeviceExtra ().GetObjectCache ();
+
+    const GVK::ObjectCache::Statistics before = cache.GetStatistics ();
+
+    std::unique_ptr<RG::RenderGraph> graph = std::make_unique<RG::RenderGraph> ();
+
+    {
+        RG::GraphSettings s (GetDeviceExtra (), framesInFlight);
+        s.useDynamicRendering = false; // the objects of the render pass path are counted
+
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            std::shared_ptr<RG::RenderOperation> op = RG::RenderOperation::Builder (GetDevice ())
                                                           .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
                                                           .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
                                                           .SetVertexShader (passThroughVertexShader)
-                                                          .SetFragmentShader (frag2)
-                                                          .SetBlendEnabled (true)
-                                                          .SetName ("SECOND")
+                                                          .SetFragmentShader (fragSrc)
+                                                          .SetBlendEnabled (false)
                                                           .Build ();
 
-    std::shared_ptr<RG::WritableImageResource> presented = std::make_unique<RG::WritableImageResource> (VK_FILTER_LINEAR, 512, 512, 1, VK_FORMAT_R8G8B8A8_SRGB);
+            std::shared_ptr<RG::WritableImageResource> output = std::make_unique<RG::WritableImageResource> (VK_FILTER_LINEAR, 64, 64, 1, VK_FORMAT_R8G8B8A8_SRGB);
 
-    RG::GraphSettings s (GetDeviceExtra (), 1);
+            op->compileSettings.attachmentProvider->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { output->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, output->GetImageViewForFrameProvider (), output->GetInitialLayout (), output->GetFinalLayout () } });
 
-    auto& aTable2 = firstPass->compileSettings.attachmentProvider;
-    aTable2->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { presented->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, presented->GetImageViewForFrameProvider (), presented->GetInitialLayout (), presented->GetFinalLayout () } });
+            s.connectionSet.Add (op, output);
+        }
 
-    s.connectionSet.Add (firstPass, presented);
+        graph->Compile (std::move (s));
+    }
 
-    auto& aTable3 = secondPass->compileSettings.attachmentProvider;
-    aTable3->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { presented->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_LOAD, presented->GetImageViewForFrameProvider (), presented->GetInitialLayout (), presented->GetFinalLayout () } });
+    const GVK::ObjectCache::Statistics after = cache.GetStatistics ();
 
-    s.connectionSet.Add (secondPass, presented);
+    std::cout << "requested objects: " << after.requestCount - before.requestCount
+              << ", created objects: " << after.createdCount - before.createdCount
+              << " (samplers: " << after.samplerCount << ", render passes: " << after.renderPassCount << ", framebuffers: " << after.framebufferCount << ")" << std::endl;
 
-    RG::RenderGraph graph;
-    graph.Compile (std::move (s));
+    // identical samplers and render passes are shared, framebuffers differ by their image views
+    EXPECT_EQ (before.samplerCount + 1, after.samplerCount);
+    EXPECT_EQ (before.renderPassCount + 1, after.renderPassCount);
+    EXPECT_EQ (before.framebufferCount + operationCount * framesInFlight, after.framebufferCount);
+    EXPECT_EQ (2 + operationCount * framesInFlight, after.createdCount - before.createdCount);
+    EXPECT_GE (after.requestCount - before.requestCount, 2 * operationCount + operationCount * framesInFlight);
 
-    EXPECT_EQ (2, graph.GetPassCount ());
+    graph->Submit (0);
+    env->Wait ();
 
-    GVK::ImageData referenceImage (ReferenceImagesFolder / "pink.png");
+    // recompiling replaces the image views, the released framebuffers must not accumulate
+    RG::GraphSettings s = std::move (graph->graphSettings);
+    graph->Compile (std::move (s));
 
-    const size_t renderCount = 1;
-    size_t       matchCount  = 0;
+    const GVK::ObjectCache::Statistics recompiled = cache.GetStatistics ();
+    EXPECT_EQ (after.samplerCount, recompiled.samplerCount);
+    EXPECT_EQ (after.renderPassCount, recompiled.renderPassCount);
+    EXPECT_EQ (after.framebufferCount, recompiled.framebufferCount);
 
-    for (size_t i = 0; i < renderCount; ++i) {
-        std::this_thread::sleep_for (std::chrono::milliseconds (200));
+    graph->Submit (0);
+    env->Wait ();
 
-        graph.Submit (0);
+    // released on last use
+    graph.reset ();
 
-        env->Wait ();
+    const GVK::ObjectCache::Statistics released = cache.GetStatistics ();
+    EXPECT_EQ (before.samplerCount, released.samplerCount);
+    EXPECT_EQ (before.renderPassCount, released.renderPassCount);
+    EXPECT_EQ (before.framebufferCount, released.framebufferCount);
+}
 
-        GVK::ImageData (GetDeviceExtra (), *presented->GetImages ()[0], 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL).SaveTo (ReferenceImagesFolder / "presentedTwo.png");
 
-        if (GVK::ImageData (GetDeviceExtra (), *presented->GetImages ()[0], 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) == referenceImage) {
-            ++matchCount;
+TEST_F (HeadlessTestEnvironment, RenderGraph_OperationProfiler_QueryIndicesMapToOperations)
+{
+    const std::string lightSrc = R"(
+#version 450
+
+layout (local_size_x = 1) in;
+
+layout (set = 0, binding = 0) buffer OutputBuffer {
+    uint value;
+};
+
+void main()
+{
+    value = 1;
+}
+    )";
+
+    const std::string heavySrc = R"(
+#version 450
+
+layout (local_size_x = 1) in;
+
+layout (set = 0, binding = 0) buffer OutputBuffer {
+    uint value;
+};
+
+void main()
+{
+    uint v = 1;
+    for (uint i = 0; i < 2000000; ++i) {
+        v = v * 1664525u + 1013904223u;
+    }
+    value = v;
+}
+    )";
+
+    // the frame is timed from the first begin to the last end, an operation with a begin and end out of order does not fit in it
+    class TimingCounter : public RG::IOperationTimingObserver {
+    public:
+        std::map<const RG::Operation*, uint32_t> operationCounts;
+        uint32_t                                 frameCount           = 0;
+        uint32_t                                 zeroDurationCount    = 0;
+        uint32_t                                 longerThanFrameCount = 0;
+        std::vector<double>                      frameOperationDurations;
+
+        virtual void OnOperationTimed (const RG::Operation& op, double milliseconds, const RG::TimingStatistics&) override
+        {
+            ++operationCounts[&op];
+            if (milliseconds <= 0.0) {
+                ++zeroDurationCount;
+            }
+            frameOperationDurations.push_back (milliseconds);
         }
+
+        virtual void OnFrameTimed (uint32_t, double milliseconds, const RG::TimingStatistics&) override
+        {
+            ++frameCount;
+            for (double operationMilliseconds : frameOperationDurations) {
+                if (operationMilliseconds > milliseconds) {
+                    ++longerThanFrameCount;
+                }
+            }
+            frameOperationDurations.clear ();
+        }
+    };
+
+    constexpr uint32_t operationCount = 4;
+    constexpr uint32_t heavyIndex     = 2;
+    constexpr uint32_t framesInFlight = 2;
+    constexpr uint32_t frameCount     = 8;
+
+    RG::ConnectionSet                                  connectionSet;
+    std::vector<std::shared_ptr<RG::ComputeOperation>> operations;
+
+    for (uint32_t i = 0; i < operationCount; ++i) {
+        std::shared_ptr<RG::ComputeOperation> op = std::make_unique<RG::ComputeOperation> (1, 1, 1);
+        op->compileSettings.computeShaderPipeline = std::make_unique<RG::ComputeShaderPipeline> (GetDevice (), i == heavyIndex ? heavySrc : lightSrc);
+
+        std::shared_ptr<RG::GPUBufferResource> buffer = std::make_unique<RG::GPUBufferResource> (4);
+        op->compileSettings.descriptorWriteProvider->bufferInfos.push_back ({ "OutputBuffer", GVK::ShaderKind::Compute, buffer->GetBufferForFrameProvider (), 0, buffer->GetBufferSize () });
+
+        connectionSet.Add (op, buffer);
+        operations.push_back (op);
     }
 
-    EXPECT_EQ (renderCount, matchCount);
-}
+    RG::GraphSettings s (GetDeviceExtra (), std::move (connectionSet), framesInFlight);
+    s.profileOperations = true;
+
+    RG::RenderGraph graph;
+    graph.Compile (std::move (s));
 
+    ASSERT_NE (nullptr, graph.profiler);
+
+    // every operation has its own pair of queries
+    std::set<std::pair<RG::OperationProfiler::SubmitQueue, uint32_t>> usedQueries;
+    for (const std::shared_ptr<RG::ComputeOperation>& op : operations) {
+        const std::optional<RG::OperationProfiler::QueryIndex> queryIndex = graph.profiler->GetQueryIndex (op.get ());
+        ASSERT_TRUE (queryIndex.has_value ());
+        EXPECT_EQ (queryIndex->begin + 1, queryIndex->end);
+        EXPECT_TRUE (usedQueries.insert ({ queryIndex->queue, queryIndex->begin }).second);
+        EXPECT_TRUE (usedQueries.insert ({ queryIndex->queue, queryIndex->end }).second);
+    }
+
+    ASSERT_TRUE (graph.profiler->UsesTimestamps ());
+
+    TimingCounter counter;
+    graph.SetOperationTimingObserver (counter);
+
+    for (uint32_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+        graph.Submit (frameIndex % framesInFlight);
+        env->Wait ();
+    }
+
+    // the last frame is only collected when submitting the next one
+    graph.profiler->Collect (counter);
+
+    EXPECT_EQ (frameCount, counter.frameCount);
+
+    for (uint32_t i = 0; i < operationCount; ++i) {
+        const RG::TimingStatistics stats = graph.profiler->GetStatistics (operations[i].get ());
+
+        std::cout << "operation " << i << ": min " << stats.minMilliseconds << " ms, mean " << stats.meanMilliseconds << " ms, p99 " << stats.p99Milliseconds << " ms" << std::endl;
+
+        EXPECT_EQ (frameCount, counter.operationCounts[operations[i].get ()]);
+        EXPECT_EQ (frameCount, stats.sampleCount);
+        EXPECT_LE (stats.minMilliseconds, stats.meanMilliseconds);
+        EXPECT_LE (stats.meanMilliseconds, stats.p99Milliseconds);
+    }
+
+    // every operation has a non-zero, ordered begin and end pair
+    EXPECT_EQ (0, counter.zeroDurationCount);
+    EXPECT_EQ (0, counter.longerThanFrameCount);
+
+    // the pair of the heavy operation brackets more ticks than any pair of the light ones in every frame
+    const RG::TimingStatistics heavyStats = graph.profiler->GetStatistics (operations[heavyIndex].get ());
+    for (uint32_t i = 0; i < operationCount; ++i) {
+        if (i != heavyIndex) {
+            EXPECT_GT (heavyStats.minMilliseconds, graph.profiler->GetStatistics (operations[i].get ()).p99Milliseconds) << "operation " << i;
+        }
+    }
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_RenderAreaRestrictsDrawing)
+{
+    const std::string fragSrc = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (1, 0, 0, 1);
+}
+    )";
+
+    // the last area is partially outside of the image, it is clipped
+    const std::vector<VkRect2D> renderAreas = {
+        { { 0, 0 }, { 256, 256 } },
+        { { 64, 128 }, { 200, 100 } },
+        { { 300, 17 }, { 1, 400 } },
+        { { 400, 450 }, { 300, 300 } },
+    };
+
+    for (const VkRect2D& renderArea : renderAreas) {
+        std::shared_ptr<RG::RenderOperation> redFillOperation = RG::RenderOperation::Builder (GetDevice ())
+                                                                    .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                                    .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                                    .SetVertexShader (passThroughVertexShader)
+                                                                    .SetFragmentShader (fragSrc)
+                                                                    .SetBlendEnabled (false)
+                                                                    .Build ();
+
+        redFillOperation->compileSettings.renderArea = renderArea;
+
+        std::shared_ptr<RG::WritableImageResource> output = std::make_unique<RG::WritableImageResource> (VK_FILTER_LINEAR, 512, 512, 1, VK_FORMAT_R8G8B8A8_UNORM);
+
+        RG::GraphSettings s (GetDeviceExtra (), 1);
+
+        auto& aTable = redFillOperation->compileSettings.attachmentProvider;
+        aTable->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { output->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, output->GetImageViewForFrameProvider (), output->GetInitialLayout (), output->GetFinalLayout () } });
+
+        s.connectionSet.Add (redFillOperation, output);
+
+        RG::RenderGraph graph;
+        graph.Compile (std::move (s));
+        graph.Submit (0);
+
+        env->Wait ();
+
+        const VkRect2D clipped = redFillOperation->GetRenderArea ();
+        EXPECT_LE (clipped.offset.x + clipped.extent.width, 512);
+        EXPECT_LE (clipped.offset.y + clipped.extent.height, 512);
+
+        GVK::ImageData img (GetDeviceExtra (), *output->GetImages ()[0], 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        ASSERT_EQ (img.width, 512);
+        ASSERT_EQ (img.height, 512);
+        ASSERT_EQ (img.components, 4);
+
+        uint32_t wrongPixels = 0;
+        for (uint32_t y = 0; y < 512; ++y) {
+            for (uint32_t x = 0; x < 512; ++x) {
+                const bool inside = renderArea.offset.x <= static_cast<int32_t> (x) && static_cast<int64_t> (x) < renderArea.offset.x + renderArea.extent.width &&
+                                    renderArea.offset.y <= static_cast<int32_t> (y) && static_cast<int64_t> (y) < renderArea.offset.y + renderArea.extent.height;
+
+                const uint8_t* pixel = &img.data[(y * 512 + x) * 4];
+
+                const bool red   = pixel[0] == 255 && pixel[1] == 0 && pixel[2] == 0 && pixel[3] == 255;
+                const bool black = pixel[0] == 0 && pixel[1] == 0 && pixel[2] == 0 && pixel[3] == 255;
+
+                if ((inside && !red) || (!inside && !black)) {
+                    ++wrongPixels;
+                }
+            }
+        }
+
+        EXPECT_EQ (wrongPixels, 0) << "render area: " << renderArea.offset.x << ", " << renderArea.offset.y << ", " << renderArea.extent.width << "x" << renderArea.extent.height;
+    }
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_RenderAreaFillRate)
+{
+    // expensive enough that fragment shading dominates
+    const std::string fragSrc = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    float value = gl_FragCoord.x;
+    for (int i = 0; i < 512; ++i) {
+        value = sin (value) * 0.5 + cos (value * 1.1);
+    }
+    // green marks the shaded pixels
+    outColor = vec4 (value, 1, 0, 1);
+}
+    )";
+
+    struct Result {
+        double   milliseconds;
+        VkRect2D drawArea;
+        uint32_t shadedPixels;
+        uint32_t shadedPixelsOutside;
+    };
+
+    const auto measure = [&] (std::optional<VkRect2D> renderArea) {
+        std::shared_ptr<RG::RenderOperation> operation = RG::RenderOperation::Builder (GetDevice ())
+                                                             .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                             .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                             .SetVertexShader (passThroughVertexShader)
+                                                             .SetFragmentShader (fragSrc)
+                                                             .Build ();
+
+        operation->compileSettings.renderArea = renderArea;
+
+        std::shared_ptr<RG::WritableImageResource> output = std::make_unique<RG::WritableImageResource> (VK_FILTER_LINEAR, 1024, 1024, 1, VK_FORMAT_R8G8B8A8_UNORM);
+
+        RG::GraphSettings s (GetDeviceExtra (), 1);
+
+        auto& aTable = operation->compileSettings.attachmentProvider;
+        aTable->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { output->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, output->GetImageViewForFrameProvider (), output->GetInitialLayout (), output->GetFinalLayout () } });
+
+        s.connectionSet.Add (operation, output);
+
+        RG::RenderGraph graph;
+        graph.Compile (std::move (s));
+
+        // warm up
+        graph.Submit (0);
+        env->Wait ();
+
+        constexpr uint32_t Iterations = 5;
+
+        const auto start = std::chrono::high_resolution_clock::now ();
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            graph.Submit (0);
+            env->Wait ();
+        }
+        const auto end = std::chrono::high_resolution_clock::now ();
+
+        Result result;
+        result.milliseconds        = std::chrono::duration<double, std::milli> (end - start).count () / Iterations;
+        result.drawArea            = operation->GetRenderArea ();
+        result.shadedPixels        = 0;
+        result.shadedPixelsOutside = 0;
+
+        GVK::ImageData img (GetDeviceExtra (), *output->GetImages ()[0], 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        for (uint32_t y = 0; y < img.height; ++y) {
+            for (uint32_t x = 0; x < img.width; ++x) {
+                if (img.data[(y * img.width + x) * 4 + 1] != 255) {
+                    continue;
+                }
+
+                const bool inside = result.drawArea.offset.x <= static_cast<int32_t> (x) && static_cast<int64_t> (x) < result.drawArea.offset.x + result.drawArea.extent.width &&
+                                    result.drawArea.offset.y <= static_cast<int32_t> (y) && static_cast<int64_t> (y) < result.drawArea.offset.y + result.drawArea.extent.height;
+
+                ++result.shadedPixels;
+                if (!inside) {
+                    ++result.shadedPixelsOutside;
+                }
+            }
+        }
+
+        return result;
+    };
+
+    const Result wholeImage = measure (std::nullopt);
+    const Result field      = measure (VkRect2D { { 256, 256 }, { 512, 512 } });
+
+    std::cout << "Render area fill rate: whole image " << wholeImage.milliseconds << " ms, quarter sized field " << field.milliseconds << " ms per frame" << std::endl;
+
+    EXPECT_EQ (wholeImage.drawArea.offset.x, 0);
+    EXPECT_EQ (wholeImage.drawArea.offset.y, 0);
+    EXPECT_EQ (wholeImage.drawArea.extent.width, 1024);
+    EXPECT_EQ (wholeImage.drawArea.extent.height, 1024);
+    EXPECT_EQ (wholeImage.shadedPixels, 1024 * 1024);
+
+    EXPECT_EQ (field.drawArea.offset.x, 256);
+    EXPECT_EQ (field.drawArea.offset.y, 256);
+    EXPECT_EQ (field.drawArea.extent.width, 512);
+    EXPECT_EQ (field.drawArea.extent.height, 512);
+    EXPECT_EQ (field.shadedPixels, 512 * 512);
+    EXPECT_EQ (field.shadedPixelsOutside, 0);
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_TwoOperationsRenderingToOutput)
+{
+    /*
+        firstPass  ---> presented
+        secondPass  _/ 
+    */
+
+    // will turn into
+
+    /*
+        firstPass ---> presented ---> secondPass ---> presented
+    */
+
+    const std::string frag1 = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (1, 0, 0, 0.5);
+}
+    )";
+
+    const std::string frag2 = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (0, 0, 1, 0.5);
+}
+    )";
+
+    std::shared_ptr<RG::RenderOperation> firstPass = RG::RenderOperation::Builder (GetDevice ())
+                                                         .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                         .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                         .SetVertexShader (passThroughVertexShader)
+                                                         .SetFragmentShader (frag1)
+                                                         .SetBlendEnabled (false)
+                                                         .SetName ("FIRST")
+                                                         .Build ();
+
+    std::shared_ptr<RG::RenderOperation> secondPass = RG::RenderOperation::Builder (GetDevice ())
+                                                          .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                          .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                          .SetVertexShader (passThroughVertexShader)
+                                                          .SetFragmentShader (frag2)
+                                                          .SetBlendEnabled (true)
+                                                          .SetName ("SECOND")
+                                                          .Build ();
+
+    std::shared_ptr<RG::WritableImageResource> presented = std::make_unique<RG::WritableImageResource> (VK_FILTER_LINEAR, 512, 512, 1, VK_FORMAT_R8G8B8A8_SRGB);
+
+    RG::GraphSettings s (GetDeviceExtra (), 1);
+
+    auto& aTable2 = firstPass->compileSettings.attachmentProvider;
+    aTable2->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { presented->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, presented->GetImageViewForFrameProvider (), presented->GetInitialLayout (), presented->GetFinalLayout () } });
+
+    s.connectionSet.Add (firstPass, presented);
+
+    auto& aTable3 = secondPass->compileSettings.attachmentProvider;
+    aTable3->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { presented->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_LOAD, presented->GetImageViewForFrameProvider (), presented->GetInitialLayout (), presented->GetFinalLayout () } });
+
+    s.connectionSet.Add (secondPass, presented);
+
+    RG::RenderGraph graph;
+    graph.Compile (std::move (s));
+
+    EXPECT_EQ (2, graph.GetPassCount ());
+
+    GVK::ImageData referenceImage (ReferenceImagesFolder / "pink.png");
+
+    const size_t renderCount = 1;
+    size_t       matchCount  = 0;
+
+    for (size_t i = 0; i < renderCount; ++i) {
+        std::this_thread::sleep_for (std::chrono::milliseconds (200));
+
+        graph.Submit (0);
+
+        env->Wait ();
+
+        GVK::ImageData (GetDeviceExtra (), *presented->GetImages ()[0], 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL).SaveTo (ReferenceImagesFolder / "presentedTwo.png");
+
+        if (GVK::ImageData (GetDeviceExtra (), *presented->GetImages ()[0], 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) == referenceImage) {
+            ++matchCount;
+        }
+    }
+
+    EXPECT_EQ (renderCount, matchCount);
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_TransientImagesShareMemory)
+{
+    /*
+        fill -> first -> copy1 -> second -> copy2 -> third -> copy3 -> output
+    */
+
+    // first and third are not used in the same pass, they are placed at the same memory
+
+    const std::string fillFrag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (1, 0, 0, 1);
+}
+    )";
+
+    const std::string copyFrag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (binding = 0) uniform sampler2D sampl;
+
+layout (location = 0) in vec2 textureCoords;
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = texture (sampl, textureCoords);
+}
+    )";
+
+    std::shared_ptr<RG::WritableImageResource> first  = std::make_unique<RG::WritableImageResource> (512, 512);
+    std::shared_ptr<RG::WritableImageResource> second = std::make_unique<RG::WritableImageResource> (512, 512);
+    std::shared_ptr<RG::WritableImageResource> third  = std::make_unique<RG::WritableImageResource> (512, 512);
+    std::shared_ptr<RG::WritableImageResource> output = std::make_unique<RG::WritableImageResource> (512, 512);
+
+    std::shared_ptr<RG::RenderOperation> fill = RG::RenderOperation::Builder (GetDevice ())
+                                                    .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                    .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                    .SetVertexShader (passThroughVertexShader)
+                                                    .SetFragmentShader (fillFrag)
+                                                    .Build ();
+
+    auto& fillTable = fill->compileSettings.attachmentProvider;
+    fillTable->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { first->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, first->GetImageViewForFrameProvider (), first->GetInitialLayout (), first->GetFinalLayout () } });
+
+    RG::GraphSettings s (GetDeviceExtra (), 3);
+
+    s.connectionSet.Add (fill, first);
+
+    const auto AddCopy = [&] (const std::shared_ptr<RG::WritableImageResource>& from, const std::shared_ptr<RG::WritableImageResource>& to) {
+        std::shared_ptr<RG::RenderOperation> copy = RG::RenderOperation::Builder (GetDevice ())
+                                                        .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                        .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                        .SetVertexShader (passThroughVertexShader)
+                                                        .SetFragmentShader (copyFrag)
+                                                        .Build ();
+
+        auto& table = copy->compileSettings.descriptorWriteProvider;
+        table->imageInfos.push_back ({ "sampl", GVK::ShaderKind::Fragment, from->GetSamplerProvider (), from->GetImageViewForFrameProvider (), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+
+        auto& aTable = copy->compileSettings.attachmentProvider;
+        aTable->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { to->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, to->GetImageViewForFrameProvider (), to->GetInitialLayout (), to->GetFinalLayout () } });
+
+        s.connectionSet.Add (from, copy);
+        s.connectionSet.Add (copy, to);
+    };
+
+    AddCopy (first, second);
+    AddCopy (second, third);
+    AddCopy (third, output);
+
+    RG::RenderGraph graph;
+    graph.Compile (std::move (s));
+
+    EXPECT_EQ (4, graph.GetPassCount ());
+
+    EXPECT_TRUE (graph.IsTransient (first.get ()));
+    EXPECT_TRUE (graph.IsTransient (second.get ()));
+    EXPECT_TRUE (graph.IsTransient (third.get ()));
+    EXPECT_FALSE (graph.IsTransient (output.get ()));
+
+    const RG::RenderGraph::TransientMemoryStats& stats = graph.GetTransientMemoryStats ();
+    EXPECT_EQ (3, stats.imageCount);
+    EXPECT_EQ (stats.unaliasedSize / 3 * 2, stats.allocatedSize);
+
+    for (uint32_t frameIndex = 0; frameIndex < 3; ++frameIndex) {
+        graph.Submit (frameIndex);
+    }
+
+    env->Wait ();
+
+    CompareImages ("red", *output->GetImages ()[0], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    CompareImages ("red", *output->GetImages ()[1], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    CompareImages ("red", *output->GetImages ()[2], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_MergedRenderPass)
+{
+    /*
+        fill -> intermediate -> copy -> output
+    */
+
+    // copy reads intermediate as an input attachment, so the two operations can be subpasses of one render pass
+
+    const std::string fillFrag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (1, 0, 0, 1);
+}
+    )";
+
+    const std::string copyFrag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (input_attachment_index = 0, binding = 0) uniform subpassInput inputColor;
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = subpassLoad (inputColor);
+}
+    )";
+
+    for (const bool mergeRenderOperations : { true, false }) {
+        std::shared_ptr<RG::WritableImageResource> intermediate = std::make_unique<RG::WritableImageResource> (512, 512);
+        std::shared_ptr<RG::WritableImageResource> output       = std::make_unique<RG::WritableImageResource> (512, 512);
+
+        std::shared_ptr<RG::RenderOperation> fill = RG::RenderOperation::Builder (GetDevice ())
+                                                        .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                        .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                        .SetVertexShader (passThroughVertexShader)
+                                                        .SetFragmentShader (fillFrag)
+                                                        .Build ();
+
+        fill->compileSettings.attachmentProvider->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { intermediate->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, intermediate->GetImageViewForFrameProvider (), intermediate->GetInitialLayout (), intermediate->GetFinalLayout () } });
+
+        std::shared_ptr<RG::RenderOperation> copy = RG::RenderOperation::Builder (GetDevice ())
+                                                        .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                        .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                        .SetVertexShader (passThroughVertexShader)
+                                                        .SetFragmentShader (copyFrag)
+                                                        .Build ();
+
+        auto& aTable = copy->compileSettings.attachmentProvider->table;
+        aTable.push_back ({ "inputColor", GVK::ShaderKind::Fragment, { intermediate->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_LOAD, intermediate->GetImageViewForFrameProvider (), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL } });
+        aTable.push_back ({ "outColor", GVK::ShaderKind::Fragment, { output->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, output->GetImageViewForFrameProvider (), output->GetInitialLayout (), output->GetFinalLayout () } });
+
+        copy->compileSettings.descriptorWriteProvider->imageInfos.push_back ({ "inputColor", GVK::ShaderKind::Fragment, intermediate->GetSamplerProvider (), intermediate->GetImageViewForFrameProvider (), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+
+        RG::GraphSettings s (GetDeviceExtra (), 2);
+        s.mergeRenderOperations = mergeRenderOperations;
+
+        s.connectionSet.Add (fill, intermediate);
+        s.connectionSet.Add (intermediate, copy);
+        s.connectionSet.Add (copy, output);
+
+        RG::RenderGraph graph;
+        graph.Compile (std::move (s));
+
+        if (mergeRenderOperations) {
+            EXPECT_EQ (1, graph.GetPassCount ());
+            EXPECT_EQ (1, graph.GetMergedRenderPassCount ());
+            EXPECT_NE (nullptr, graph.GetMergedRenderPass (fill.get ()));
+            EXPECT_EQ (graph.GetMergedRenderPass (fill.get ()), graph.GetMergedRenderPass (copy.get ()));
+
+            // only used inside the render pass, not aliased with other images
+            EXPECT_FALSE (graph.IsTransient (intermediate.get ()));
+        } else {
+            EXPECT_EQ (2, graph.GetPassCount ());
+            EXPECT_EQ (0, graph.GetMergedRenderPassCount ());
+            EXPECT_EQ (nullptr, graph.GetMergedRenderPass (fill.get ()));
+        }
+
+        for (uint32_t frameIndex = 0; frameIndex < 2; ++frameIndex) {
+            graph.Submit (frameIndex);
+        }
+
+        env->Wait ();
+
+        CompareImages ("red", *output->GetImages ()[0], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        CompareImages ("red", *output->GetImages ()[1], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    }
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_IncrementalRecompile)
+{
+    /*
+        fill -> intermediate -> present -> presented
+    */
+
+    const std::string blueFrag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (0, 0, 1, 1);
+}
+    )";
+
+    const std::string redFrag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (1, 0, 0, 1);
+}
+    )";
+
+    const std::string presentFrag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (binding = 0) uniform sampler2D inputColor;
+
+layout (location = 0) in vec2 uv;
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = texture (inputColor, uv);
+}
+    )";
+
+    std::unique_ptr<GVK::FakeSwapchain> swapchain     = std::make_unique<GVK::FakeSwapchain> (GetDeviceExtra (), 800, 600);
+    GVK::FakeSwapchain&                 fakeSwapchain = *swapchain;
+    RG::Presentable                     presentable (std::move (swapchain));
+
+    std::shared_ptr<RG::WritableImageResource>  intermediate = std::make_unique<RG::WritableImageResource> (512, 512);
+    std::shared_ptr<RG::SwapchainImageResource> presented    = std::make_unique<RG::SwapchainImageResource> (presentable);
+
+    std::shared_ptr<RG::RenderOperation> fill = RG::RenderOperation::Builder (GetDevice ())
+                                                    .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                    .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                    .SetVertexShader (passThroughVertexShader)
+                                                    .SetFragmentShader (blueFrag)
+                                                    .Build ();
+
+    fill->compileSettings.attachmentProvider->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { intermediate->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, intermediate->GetImageViewForFrameProvider (), intermediate->GetInitialLayout (), intermediate->GetFinalLayout () } });
+
+    std::shared_ptr<RG::RenderOperation> present = RG::RenderOperation::Builder (GetDevice ())
+                                                       .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                       .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                       .SetVertexShader (passThroughVertexShader)
+                                                       .SetFragmentShader (presentFrag)
+                                                       .Build ();
+
+    present->compileSettings.attachmentProvider->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { presented->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, presented->GetImageViewForFrameProvider (), presented->GetInitialLayout (), presented->GetFinalLayout () } });
+    present->compileSettings.descriptorWriteProvider->imageInfos.push_back ({ "inputColor", GVK::ShaderKind::Fragment, intermediate->GetSamplerProvider (), intermediate->GetImageViewForFrameProvider (), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+
+    RG::GraphSettings s (GetDeviceExtra (), fakeSwapchain.GetImageCount ());
+
+    s.connectionSet.Add (fill, intermediate);
+    s.connectionSet.Add (intermediate, present);
+    s.connectionSet.Add (present, presented);
+
+    RG::RenderGraph graph;
+    graph.Compile (std::move (s));
+
+    {
+        const RG::RenderGraph::CompileStats& stats = graph.GetCompileStats ();
+        EXPECT_EQ (2, stats.compiledResources);
+        EXPECT_EQ (2, stats.compiledPipelines);
+        EXPECT_EQ (0, stats.compiledFramebuffers);
+        EXPECT_EQ (1, stats.recordedCommandBuffers);
+        EXPECT_EQ (800, present->GetRenderArea ().extent.width);
+        EXPECT_EQ (600, present->GetRenderArea ().extent.height);
+    }
+
+    // resize: only the swapchain image and the framebuffer writing it depend on the extent
+    fakeSwapchain.SetRequestedExtent (512, 512);
+    fakeSwapchain.Recreate ();
+    graph.RecompileSwapchainImages ();
+
+    {
+        const RG::RenderGraph::CompileStats& stats = graph.GetCompileStats ();
+        EXPECT_EQ (1, stats.compiledResources);
+        EXPECT_EQ (0, stats.compiledPipelines);
+        EXPECT_EQ (1, stats.compiledFramebuffers);
+        EXPECT_EQ (1, stats.recordedCommandBuffers);
+        EXPECT_EQ (512, present->GetRenderArea ().extent.width);
+        EXPECT_EQ (512, present->GetRenderArea ().extent.height);
+        EXPECT_EQ (512, presented->GetImages ()[0]->GetWidth ());
+    }
+
+    // shader change: only the pipeline of the changed operation
+    fill->GetShaderPipeline ()->fragmentShader.reset ();
+    fill->GetShaderPipeline ()->SetFragmentShaderFromString (redFrag);
+    graph.RecompileOperations ({ fill.get () });
+
+    {
+        const RG::RenderGraph::CompileStats& stats = graph.GetCompileStats ();
+        EXPECT_EQ (0, stats.compiledResources);
+        EXPECT_EQ (1, stats.compiledPipelines);
+        EXPECT_EQ (0, stats.compiledFramebuffers);
+        EXPECT_EQ (1, stats.recordedCommandBuffers);
+    }
+
+    // the descriptor sets are allocated again
+    graph.RecompileOperations ({ present.get () });
+
+    {
+        const RG::RenderGraph::CompileStats& stats = graph.GetCompileStats ();
+        EXPECT_EQ (0, stats.compiledResources);
+        EXPECT_EQ (1, stats.compiledPipelines);
+        EXPECT_EQ (0, stats.compiledFramebuffers);
+        EXPECT_EQ (1, stats.recordedCommandBuffers);
+    }
+
+    graph.Submit (0);
+
+    env->Wait ();
+
+    CompareImages ("red", *presented->GetImages ()[0], VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+}
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_DynamicRendering)
+{
+    if (!GetDeviceExtra ().SupportsDynamicRendering ()) {
+        GTEST_SKIP () << "VK_KHR_dynamic_rendering is not supported";
+    }
+
+    const std::string fragSrc = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (1, 0, 0, 1);
+}
+    )";
+
+    constexpr uint32_t operationCount = 32;
+    constexpr uint32_t framesInFlight = 3;
+
+    GVK::ObjectCache& cache = GetDeviceExtra ().GetObjectCache ();
+
+    for (const bool useDynamicRendering : { false, true }) {
+        std::vector<std::shared_ptr<RG::RenderOperation>>       operations;
+        std::vector<std::shared_ptr<RG::WritableImageResource>> outputs;
+
+        RG::GraphSettings s (GetDeviceExtra (), framesInFlight);
+        s.useDynamicRendering = useDynamicRendering;
+
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            std::shared_ptr<RG::RenderOperation> op = RG::RenderOperation::Builder (GetDevice ())
+                                                          .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                          .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                          .SetVertexShader (passThroughVertexShader)
+                                                          .SetFragmentShader (fragSrc)
+                                                          .SetBlendEnabled (false)
+                                                          .Build ();
+
+            std::shared_ptr<RG::WritableImageResource> output = std::make_unique<RG::WritableImageResource> (512, 512);
+
+            op->compileSettings.attachmentProvider->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { output->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, output->GetImageViewForFrameProvider (), output->GetInitialLayout (), output->GetFinalLayout () } });
+
+            s.connectionSet.Add (op, output);
+
+            operations.push_back (op);
+            outputs.push_back (output);
+        }
+
+        const GVK::ObjectCache::Statistics before = cache.GetStatistics ();
+
+        RG::RenderGraph graph;
+
+        const auto start = std::chrono::high_resolution_clock::now ();
+        graph.Compile (std::move (s));
+        const std::chrono::duration<double, std::milli> compileTime = std::chrono::high_resolution_clock::now () - start;
+
+        const GVK::ObjectCache::Statistics after = cache.GetStatistics ();
+
+        std::cout << (useDynamicRendering ? "dynamic rendering" : "render passes")
+                  << ": compiled in " << compileTime.count () << " ms"
+                  << ", render passes: " << after.renderPassCount - before.renderPassCount
+                  << ", framebuffers: " << after.framebufferCount - before.framebufferCount << std::endl;
+
+        for (const std::shared_ptr<RG::RenderOperation>& op : operations) {
+            EXPECT_EQ (useDynamicRendering, op->UsesDynamicRendering ());
+        }
+
+        if (useDynamicRendering) {
+            EXPECT_EQ (before.renderPassCount, after.renderPassCount);
+            EXPECT_EQ (before.framebufferCount, after.framebufferCount);
+        } else {
+            EXPECT_EQ (before.renderPassCount + 1, after.renderPassCount);
+            EXPECT_EQ (before.framebufferCount + operationCount * framesInFlight, after.framebufferCount);
+        }
+
+        for (uint32_t frameIndex = 0; frameIndex < framesInFlight; ++frameIndex) {
+            graph.Submit (frameIndex);
+        }
+
+        env->Wait ();
+
+        for (const std::shared_ptr<RG::WritableImageResource>& output : outputs) {
+            for (uint32_t frameIndex = 0; frameIndex < framesInFlight; ++frameIndex) {
+                CompareImages ("red", *output->GetImages ()[frameIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            }
+        }
+    }
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_MemoryReport)
+{
+    const std::string fragSrc = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (std140, binding = 0) uniform Color {
+    vec4 color;
+};
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = color;
+}
+    )";
+
+    constexpr uint32_t framesInFlight = 2;
+
+    struct TestGraph {
+        std::shared_ptr<RG::RenderOperation>       op;
+        std::shared_ptr<RG::WritableImageResource> target;
+        std::unique_ptr<RG::UniformReflection>     refl;
+        std::unique_ptr<RG::RenderGraph>           graph;
+    };
+
+    const auto CreateGraph = [&] (uint32_t operationCount, const RG::UniformReflection::ResourceCreator& resourceCreator) {
+        TestGraph result;
+        result.graph = std::make_unique<RG::RenderGraph> ();
+
+        RG::GraphSettings s (GetDeviceExtra (), framesInFlight);
+
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            std::shared_ptr<RG::RenderOperation> op = RG::RenderOperation::Builder (GetDevice ())
+                                                          .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                          .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                          .SetVertexShader (passThroughVertexShader)
+                                                          .SetFragmentShader (fragSrc)
+                                                          .SetBlendEnabled (false)
+                                                          .Build ();
+
+            std::shared_ptr<RG::WritableImageResource> target = std::make_unique<RG::WritableImageResource> (VK_FILTER_LINEAR, 512, 512, 1, VK_FORMAT_R8G8B8A8_UNORM);
+            target->SetName ("Target");
+
+            op->compileSettings.attachmentProvider->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { target->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, target->GetImageViewForFrameProvider (), target->GetInitialLayout (), target->GetFinalLayout () } });
+
+            s.connectionSet.Add (op, target);
+
+            result.op     = op;
+            result.target = target;
+        }
+
+        result.refl = std::make_unique<RG::UniformReflection> (s.connectionSet, resourceCreator);
+
+        result.graph->Compile (std::move (s));
+
+        return result;
+    };
+
+    const GVK::Allocator& allocator = GetDeviceExtra ().GetAllocatorObject ();
+
+    // the allocations of a previous stimulus leave gaps when released
+    TestGraph previous = CreateGraph (8, &RG::UniformReflection::DefaultResourceCreator);
+
+    const GVK::Allocator::Statistics before = allocator.GetStatistics ();
+
+    TestGraph current = CreateGraph (1, &RG::UniformReflection::DefaultResourceCreator);
+
+    const RG::RenderGraph::MemoryReport report = current.graph->GetMemoryReport ();
+    const GVK::Allocator::Statistics    after  = allocator.GetStatistics ();
+
+    for (const auto& [type, size] : report.sizeByType) {
+        std::cout << type << ": " << size << " bytes" << std::endl;
+    }
+    std::cout << "total: " << report.totalSize << " bytes, allocator used: " << report.allocator.usedBytes
+              << " bytes, unused: " << report.allocator.unusedBytes << " bytes, fragmentation: " << report.allocator.fragmentation << std::endl;
+
+    ASSERT_EQ (2, report.resources.size ());
+
+    const RG::RenderGraph::MemoryReport::ResourceMemory& target = report.resources[0];
+    EXPECT_EQ ("Target", target.name);
+    EXPECT_EQ ("WritableImageResource", target.type);
+    EXPECT_EQ (framesInFlight, target.allocationCount);
+    EXPECT_GE (target.size, 512 * 512 * 4 * framesInFlight);
+
+    const RG::RenderGraph::MemoryReport::ResourceMemory& color = report.resources[1];
+    EXPECT_EQ ("Color", color.name);
+    EXPECT_EQ ("CPUBufferResource", color.type);
+    EXPECT_EQ (framesInFlight, color.allocationCount);
+    EXPECT_GE (color.size, 16 * framesInFlight);
+
+    EXPECT_EQ (2, report.sizeByType.size ());
+    EXPECT_EQ (target.size, report.sizeByType.at ("WritableImageResource"));
+    EXPECT_EQ (color.size, report.sizeByType.at ("CPUBufferResource"));
+    EXPECT_EQ (target.size + color.size, report.resourceSize);
+    EXPECT_EQ (0, report.transientSize);
+    EXPECT_EQ (report.resourceSize, report.totalSize);
+
+    // the graph created nothing else
+    EXPECT_EQ (before.allocationCount + 2 * framesInFlight, after.allocationCount);
+    EXPECT_EQ (before.usedBytes + report.totalSize, after.usedBytes);
+    EXPECT_EQ (before.renderTargets.allocationCount + framesInFlight, after.renderTargets.allocationCount);
+    EXPECT_EQ (before.smallUniformBuffers.allocationCount + framesInFlight, after.smallUniformBuffers.allocationCount);
+    EXPECT_FALSE (after.heaps.empty ());
+    EXPECT_GE (after.fragmentation, 0.0);
+    EXPECT_LE (after.fragmentation, 1.0);
+
+    for (VmaAllocation allocation : current.target->GetAllocations ()) {
+        EXPECT_EQ ("Target", allocator.GetAllocationName (allocation));
+    }
+
+    previous = TestGraph ();
+
+    const GVK::Allocator::DefragmentationResult defragmentation = current.graph->DefragmentMemory ();
+    EXPECT_EQ (framesInFlight, defragmentation.moved.size ());
+    EXPECT_GT (defragmentation.allocationsMoved, 0);
+
+    // the moved uniform buffers are bound and mapped again
+    for (uint32_t frameIndex = 0; frameIndex < framesInFlight; ++frameIndex) {
+        (*current.refl)[current.op][GVK::ShaderKind::Fragment]["Color"]["color"] = glm::vec4 (1, 0, 0, 1);
+        current.refl->Flush (frameIndex);
+        current.graph->Submit (frameIndex);
+    }
+
+    env->Wait ();
+
+    for (uint32_t frameIndex = 0; frameIndex < framesInFlight; ++frameIndex) {
+        CompareImages ("red", *current.target->GetImages ()[frameIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    }
+
+    // the blocks of a uniform arena share one allocation, it is reported once
+    constexpr uint32_t arenaOperationCount = 4;
+
+    std::shared_ptr<RG::UniformArena> arena = std::make_shared<RG::UniformArena> ();
+
+    const GVK::Allocator::Statistics beforeArena = allocator.GetStatistics ();
+
+    TestGraph arenaGraph = CreateGraph (arenaOperationCount, RG::UniformReflection::UniformArenaResourceCreator (arena));
+
+    const RG::RenderGraph::MemoryReport arenaReport = arenaGraph.graph->GetMemoryReport ();
+    const GVK::Allocator::Statistics    afterArena  = allocator.GetStatistics ();
+
+    ASSERT_TRUE (arena->IsCompiled ());
+    EXPECT_EQ (arenaOperationCount, arena->GetBlockCount ());
+
+    uint32_t blockCount      = 0;
+    uint32_t allocationCount = 0;
+    for (const RG::RenderGraph::MemoryReport::ResourceMemory& resourceMemory : arenaReport.resources) {
+        if (resourceMemory.type == "UniformArenaBufferResource") {
+            ++blockCount;
+            allocationCount += resourceMemory.allocationCount;
+        }
+    }
+
+    EXPECT_EQ (arenaOperationCount, blockCount);
+    EXPECT_EQ (1, allocationCount);
+    EXPECT_EQ (allocator.GetAllocationSize (arena->GetAllocation ()), arenaReport.sizeByType.at ("UniformArenaBufferResource"));
+    EXPECT_EQ ("Color", allocator.GetAllocationName (arena->GetAllocation ()));
+
+    // the small arena is placed in the uniform buffer pool
+    EXPECT_EQ (beforeArena.allocationCount + arenaOperationCount * framesInFlight + 1, afterArena.allocationCount);
+    EXPECT_EQ (beforeArena.usedBytes + arenaReport.totalSize, afterArena.usedBytes);
+    EXPECT_EQ (beforeArena.smallUniformBuffers.allocationCount + 1, afterArena.smallUniformBuffers.allocationCount);
+
+    // the arena is defragmented with the uniform buffers, its blocks are bound again when moved
+    current = TestGraph ();
+
+    const GVK::Allocator::DefragmentationResult arenaDefragmentation = arenaGraph.graph->DefragmentMemory ();
+    EXPECT_EQ (1, arenaDefragmentation.moved.size ());
+
+    for (uint32_t frameIndex = 0; frameIndex < framesInFlight; ++frameIndex) {
+        (*arenaGraph.refl)[arenaGraph.op][GVK::ShaderKind::Fragment]["Color"]["color"] = glm::vec4 (1, 0, 0, 1);
+        arenaGraph.refl->Flush (frameIndex);
+        arenaGraph.graph->Submit (frameIndex);
+    }
+
+    env->Wait ();
+
+    for (uint32_t frameIndex = 0; frameIndex < framesInFlight; ++frameIndex) {
+        CompareImages ("red", *arenaGraph.target->GetImages ()[frameIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    }
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_UniformArena)
+{
+    const std::string fragSrc = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (std140, binding = 0) uniform Color {
+    vec4 color;
+};
+
+layout (std140, binding = 1) uniform Intensity {
+    float intensity;
+};
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (color.rgb * intensity, color.a);
+}
+    )";
+
+    constexpr uint32_t operationCount = 32;
+    constexpr uint32_t framesInFlight = 3;
+    constexpr uint32_t frameCount     = 300;
+
+    for (const bool useArena : { false, true }) {
+        std::vector<std::shared_ptr<RG::RenderOperation>>       operations;
+        std::vector<std::shared_ptr<RG::WritableImageResource>> outputs;
+
+        RG::GraphSettings s (GetDeviceExtra (), framesInFlight);
+
+        for (uint32_t i = 0; i < operationCount; ++i) {
+            std::shared_ptr<RG::RenderOperation> op = RG::RenderOperation::Builder (GetDevice ())
+                                                          .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                          .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                          .SetVertexShader (passThroughVertexShader)
+                                                          .SetFragmentShader (fragSrc)
+                                                          .SetBlendEnabled (false)
+                                                          .Build ();
+
+            std::shared_ptr<RG::WritableImageResource> output = std::make_unique<RG::WritableImageResource> (512, 512);
+
+            op->compileSettings.attachmentProvider->table.push_back ({ "outColor", GVK::ShaderKind::Fragment, { output->GetFormatProvider (), VK_ATTACHMENT_LOAD_OP_CLEAR, output->GetImageViewForFrameProvider (), output->GetInitialLayout (), output->GetFinalLayout () } });
+
+            s.connectionSet.Add (op, output);
+
+            operations.push_back (op);
+            outputs.push_back (output);
+        }
+
+        std::shared_ptr<RG::UniformArena> arena = std::make_shared<RG::UniformArena> ();
+
+        RG::UniformReflection refl (s.connectionSet, useArena ? RG::UniformReflection::UniformArenaResourceCreator (arena) : &RG::UniformReflection::DefaultResourceCreator);
+
+        RG::RenderGraph graph;
+        graph.Compile (std::move (s));
+
+        uint32_t descriptorSetCount = 0;
+        uint32_t descriptorCount    = 0;
+        for (const std::shared_ptr<RG::RenderOperation>& op : operations) {
+            const uint32_t setCount = static_cast<uint32_t> (op->compileResult.descriptors.descriptorSets.size ());
+            descriptorSetCount += setCount;
+            for (const VkDescriptorPoolSize& poolSize : op->GetDescriptorPoolSizes ()) {
+                descriptorCount += setCount * poolSize.descriptorCount;
+            }
+        }
+
+        // the uniforms of every operation are updated in every frame
+        const auto start = std::chrono::high_resolution_clock::now ();
+        for (uint32_t frame = 0; frame < frameCount; ++frame) {
+            for (const std::shared_ptr<RG::RenderOperation>& op : operations) {
+                refl[op][GVK::ShaderKind::Fragment]["Color"]["color"]         = glm::vec4 (0.5f, 0.0f, 0.0f, 1.0f);
+                refl[op][GVK::ShaderKind::Fragment]["Intensity"]["intensity"] = 2.0f;
+            }
+            refl.Flush (frame % framesInFlight);
+        }
+        const std::chrono::duration<double, std::micro> updateTime = std::chrono::high_resolution_clock::now () - start;
+
+        std::cout << (useArena ? "uniform arena" : "uniform buffers")
+                  << ": " << updateTime.count () / frameCount << " us per frame"
+                  << ", descriptor sets: " << descriptorSetCount
+                  << ", descriptors: " << descriptorCount << std::endl;
+
+        if (useArena) {
+            EXPECT_EQ (operationCount * 2, arena->GetBlockCount ());
+            EXPECT_EQ (arena->GetPartitionSize () * framesInFlight, arena->GetBufferSize ());
+
+            // one descriptor set for every frame, the frames are selected with the dynamic offsets
+            EXPECT_EQ (operationCount, descriptorSetCount);
+            EXPECT_EQ (operationCount * 2, descriptorCount);
+
+            for (const std::shared_ptr<RG::RenderOperation>& op : operations) {
+                for (uint32_t frameIndex = 0; frameIndex < framesInFlight; ++frameIndex) {
+                    const std::vector<uint32_t>& offsets = op->compileResult.descriptors.GetDynamicOffsets (frameIndex);
+                    ASSERT_EQ (2, offsets.size ());
+                    EXPECT_NE (offsets[0], offsets[1]);
+                    EXPECT_EQ (op->compileResult.descriptors.GetDynamicOffsets (0)[0] + arena->GetPartitionSize () * frameIndex, offsets[0]);
+                }
+            }
+        } else {
+            EXPECT_FALSE (arena->IsCompiled ());
+            EXPECT_EQ (operationCount * framesInFlight, descriptorSetCount);
+            EXPECT_EQ (operationCount * framesInFlight * 2, descriptorCount);
+        }
+
+        for (uint32_t frameIndex = 0; frameIndex < framesInFlight; ++frameIndex) {
+            graph.Submit (frameIndex);
+        }
+
+        env->Wait ();
+
+        // swapped dynamic offsets would read the color from the intensity block
+        for (const std::shared_ptr<RG::WritableImageResource>& output : outputs) {
+            for (uint32_t frameIndex = 0; frameIndex < framesInFlight; ++frameIndex) {
+                CompareImages ("red", *output->GetImages ()[frameIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            }
+        }
+    }
+}
+
+
+TEST_F (HeadlessTestEnvironment, RenderGraph_UniformArenaBlockLimit)
+{
+    const std::string fragSrc = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (std140, binding = 0) uniform Block0 { float value0; };
+layout (std140, binding = 1) uniform Block1 { float value1; };
+layout (std140, binding = 2) uniform Block2 { float value2; };
+layout (std140, binding = 3) uniform Block3 { float value3; };
+layout (std140, binding = 4) uniform Block4 { float value4; };
+layout (std140, binding = 5) uniform Block5 { float value5; };
+layout (std140, binding = 6) uniform Block6 { float value6; };
+layout (std140, binding = 7) uniform Block7 { float value7; };
+layout (std140, binding = 8) uniform Block8 { float value8; };
+
+layout (location = 0) out vec4 outColor;
+
+void main () {
+    outColor = vec4 (value0 + value1 + value2 + value3 + value4 + value5 + value6 + value7 + value8);
+}
+    )";
+
+    RG::GraphSettings s (GetDeviceExtra (), 2);
+
+    std::shared_ptr<RG::RenderOperation> op = RG::RenderOperation::Builder (GetDevice ())
+                                                  .SetPrimitiveTopology (VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+                                                  .SetVertices (std::make_unique<RG::DrawRecordableInfo> (1, 6))
+                                                  .SetVertexShader (passThroughVertexShader)
+                                                  .SetFragmentShader (fragSrc)
+                                                  .Build ();
+
+    std::shared_ptr<RG::UniformArena> arena = std::make_shared<RG::UniformArena> ();
+
+    // a block connected before the reflection, e.g. shared with an other graph
+    std::shared_ptr<RG::UniformArenaBufferResource> sharedBlock = std::make_shared<RG::UniformArenaBufferResource> (arena, arena->Allocate (16));
+    s.connectionSet.Add (sharedBlock, op);
+
+    RG::UniformReflection refl (s.connectionSet, RG::UniformReflection::UniformArenaResourceCreator (arena));
+
+    const std::vector<std::shared_ptr<RG::UniformArenaBufferResource>> arenaBlocks = s.connectionSet.GetPointingHere<RG::UniformArenaBufferResource> (op.get ());
+    const std::vector<std::shared_ptr<RG::CPUBufferResource>>          ownBuffers  = s.connectionSet.GetPointingHere<RG::CPUBufferResource> (op.get ());
+
+    EXPECT_EQ (RG::UniformArena::MaxDynamicBlocksPerOperation, arenaBlocks.size ());
+    EXPECT_EQ (2, ownBuffers.size ());
+
+    // the values of the blocks moved to own buffers are still set
+    for (const std::shared_ptr<RG::CPUBufferResource>& ownBuffer : ownBuffers) {
+        EXPECT_TRUE (refl[op][GVK::ShaderKind::Fragment].Contains (ownBuffer->GetName ()));
+    }
+}
 
 // no window, swapchain, surface
 class HeadlessTestEnvironmentWithExt : public TestEnvironmentBase {
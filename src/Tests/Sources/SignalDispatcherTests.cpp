@@ -0,0 +1,212 @@
+#include "TestEnvironment.hpp"
+
+#include "Sequence/SignalDispatcher.hpp"
+#include "Utils/SPSCQueue.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using SignalDispatcherTests = ::testing::Test;
+
+
+namespace {
+
+class RecordingSignalSink : public ISignalSink {
+public:
+    struct Emission {
+        SignalEdge                          edge;
+        SignalDispatcher::Clock::time_point time;
+    };
+
+    std::mutex            mutex;
+    std::vector<Emission> emissions;
+
+    virtual void Emit (const SignalEdge& edge) override
+    {
+        const SignalDispatcher::Clock::time_point now = SignalDispatcher::Clock::now ();
+
+        std::lock_guard<std::mutex> lock (mutex);
+        emissions.push_back ({ edge, now });
+    }
+};
+
+
+struct JitterResult {
+    SignalDispatcher::Statistics statistics;
+    double                       maxMeasuredJitterMicroseconds;
+    size_t                       emissionCount;
+    bool                         inOrder;
+};
+
+
+// presents frames at 60 Hz with three sub-frames each, every sub-frame has a signal edge
+JitterResult MeasureJitter (bool busyWait)
+{
+    constexpr uint32_t FrameCount    = 60;
+    constexpr uint32_t SubFrameCount = 3;
+
+    const std::chrono::microseconds frameInterval (16667);
+    const std::chrono::microseconds subFrameInterval (16667 / SubFrameCount);
+
+    std::vector<SignalEdge> schedule;
+    for (uint32_t frameIndex = 0; frameIndex < FrameCount * SubFrameCount; ++frameIndex) {
+        schedule.push_back ({ frameIndex, "Tick", "COM1", frameIndex % 2 == 1 });
+    }
+
+    std::unique_ptr<RecordingSignalSink> sink    = std::make_unique<RecordingSignalSink> ();
+    RecordingSignalSink&                 sinkRef = *sink;
+
+    std::vector<SignalDispatcher::Clock::time_point> intendedTimes (schedule.size ());
+
+    JitterResult result;
+
+    {
+        SignalDispatcher dispatcher (std::move (schedule), std::move (sink), subFrameInterval, SubFrameCount, busyWait);
+        dispatcher.Start ();
+
+        const SignalDispatcher::Clock::time_point start = SignalDispatcher::Clock::now ();
+        for (uint32_t deviceFrame = 0; deviceFrame < FrameCount; ++deviceFrame) {
+            const SignalDispatcher::Clock::time_point presentedAt = start + frameInterval * deviceFrame;
+            std::this_thread::sleep_until (presentedAt);
+
+            const uint32_t frameIndex = deviceFrame * SubFrameCount;
+            for (uint32_t subFrame = 0; subFrame < SubFrameCount; ++subFrame) {
+                intendedTimes[frameIndex + subFrame] = presentedAt + subFrameInterval * subFrame;
+            }
+
+            dispatcher.OnFramePresented (frameIndex, presentedAt);
+        }
+
+        dispatcher.Flush ();
+
+        result.statistics = dispatcher.GetStatistics ();
+    }
+
+    result.emissionCount                 = sinkRef.emissions.size ();
+    result.inOrder                       = true;
+    result.maxMeasuredJitterMicroseconds = 0.0;
+
+    for (size_t i = 0; i < sinkRef.emissions.size (); ++i) {
+        const RecordingSignalSink::Emission& emission = sinkRef.emissions[i];
+
+        result.inOrder = result.inOrder && emission.edge.frameIndex == i;
+
+        // emission can only be late
+        const double jitter                  = std::chrono::duration<double, std::micro> (emission.time - intendedTimes[emission.edge.frameIndex]).count ();
+        result.maxMeasuredJitterMicroseconds = std::max (result.maxMeasuredJitterMicroseconds, jitter);
+        EXPECT_GE (jitter, 0.0);
+    }
+
+    return result;
+}
+
+} // namespace
+
+
+TEST_F (SignalDispatcherTests, SPSCQueue)
+{
+    Utils::SPSCQueue<uint32_t, 4> queue;
+
+    EXPECT_TRUE (queue.IsEmpty ());
+    EXPECT_FALSE (queue.TryPop ().has_value ());
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE (queue.TryPush (i));
+    }
+    EXPECT_FALSE (queue.TryPush (4));
+
+    EXPECT_EQ (queue.TryPop (), 0);
+    EXPECT_TRUE (queue.TryPush (4));
+
+    for (uint32_t i = 1; i <= 4; ++i) {
+        EXPECT_EQ (queue.TryPop (), i);
+    }
+    EXPECT_TRUE (queue.IsEmpty ());
+
+    constexpr uint32_t ItemCount = 1000000;
+
+    Utils::SPSCQueue<uint32_t, 64> threadedQueue;
+
+    std::thread producer ([&] {
+        for (uint32_t i = 0; i < ItemCount; ++i) {
+            while (!threadedQueue.TryPush (i)) {
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    while (expected < ItemCount) {
+        const std::optional<uint32_t> item = threadedQueue.TryPop ();
+        if (item.has_value ()) {
+            ASSERT_EQ (*item, expected);
+            ++expected;
+        }
+    }
+
+    producer.join ();
+}
+
+
+TEST_F (SignalDispatcherTests, FileSink)
+{
+    std::filesystem::create_directories (TempFolder);
+    const std::filesystem::path outputPath = TempFolder / "signals.txt";
+    std::filesystem::remove (outputPath);
+
+    std::vector<SignalEdge> schedule = {
+        { 2, "ExpSync", "COM1", false },
+        { 3, "Tick", "COM2", false },
+        { 5, "ExpSync", "COM1", true },
+    };
+
+    {
+        SignalDispatcher dispatcher (std::move (schedule), std::make_unique<FileSignalSink> (outputPath), std::chrono::milliseconds (1), 1, false);
+        dispatcher.Start ();
+
+        for (uint32_t frameIndex = 0; frameIndex < 6; ++frameIndex) {
+            dispatcher.OnFramePresented (frameIndex, SignalDispatcher::Clock::now ());
+        }
+    }
+
+    std::ifstream            output (outputPath);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline (output, line);) {
+        lines.push_back (line);
+    }
+
+    ASSERT_EQ (lines.size (), 3);
+    EXPECT_EQ (lines[0], "2 COM1 ExpSync raise");
+    EXPECT_EQ (lines[1], "3 COM2 Tick raise");
+    EXPECT_EQ (lines[2], "5 COM1 ExpSync clear");
+}
+
+
+TEST_F (SignalDispatcherTests, EmissionJitter)
+{
+    const JitterResult sleeping    = MeasureJitter (false);
+    const JitterResult busyWaiting = MeasureJitter (true);
+
+    std::cout << "Signal jitter with sleeping: mean " << sleeping.statistics.meanJitterMicroseconds << " us, max " << sleeping.statistics.maxJitterMicroseconds << " us" << std::endl;
+    std::cout << "Signal jitter with busy waiting: mean " << busyWaiting.statistics.meanJitterMicroseconds << " us, max " << busyWaiting.statistics.maxJitterMicroseconds << " us" << std::endl;
+
+    for (const JitterResult& result : { sleeping, busyWaiting }) {
+        EXPECT_EQ (result.emissionCount, 180);
+        EXPECT_EQ (result.statistics.emittedCount, 180);
+        EXPECT_EQ (result.statistics.droppedFrameCount, 0);
+        EXPECT_TRUE (result.inOrder);
+
+        // the sink measures the same thing, just a bit later
+        EXPECT_LE (result.statistics.maxJitterMicroseconds, result.maxMeasuredJitterMicroseconds);
+    }
+}
@@ -0,0 +1,245 @@
+#include "Utils/MultithreadedFunction.hpp"
+#include "Utils/ThreadPool.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+using ThreadPoolTests = ::testing::Test;
+
+
+TEST_F (ThreadPoolTests, TaskGroupRunsAllTasks)
+{
+    Utils::ThreadPool pool (4);
+
+    std::atomic<uint32_t> counter (0);
+
+    {
+        Utils::TaskGroup group (pool);
+        for (uint32_t i = 0; i < 10000; ++i) {
+            group.Run ([&] { counter.fetch_add (1); });
+        }
+        group.Wait ();
+
+        EXPECT_EQ (10000, counter.load ());
+    }
+}
+
+
+TEST_F (ThreadPoolTests, NestedTaskGroups)
+{
+    // every task waits for its own group, with few workers this only finishes if waiting executes tasks
+    Utils::ThreadPool pool (2);
+
+    std::atomic<uint32_t> counter (0);
+
+    Utils::TaskGroup outer (pool);
+    for (uint32_t i = 0; i < 64; ++i) {
+        outer.Run ([&] {
+            Utils::TaskGroup inner (pool);
+            for (uint32_t j = 0; j < 64; ++j) {
+                inner.Run ([&] {
+                    Utils::TaskGroup innermost (pool);
+                    for (uint32_t k = 0; k < 4; ++k) {
+                        innermost.Run ([&] { counter.fetch_add (1); });
+                    }
+                    innermost.Wait ();
+                });
+            }
+            inner.Wait ();
+        });
+    }
+    outer.Wait ();
+
+    EXPECT_EQ (64 * 64 * 4, counter.load ());
+}
+
+
+TEST_F (ThreadPoolTests, SubmitFromManyThreads)
+{
+    Utils::ThreadPool pool (4);
+
+    std::atomic<uint32_t> counter (0);
+
+    {
+        Utils::TaskGroup group (pool);
+
+        std::vector<std::thread> submitters;
+        for (uint32_t t = 0; t < 8; ++t) {
+            submitters.emplace_back ([&] {
+                for (uint32_t i = 0; i < 1000; ++i) {
+                    group.Run ([&] { counter.fetch_add (1); });
+                }
+            });
+        }
+        for (std::thread& submitter : submitters) {
+            submitter.join ();
+        }
+
+        group.Wait ();
+    }
+
+    EXPECT_EQ (8 * 1000, counter.load ());
+}
+
+
+TEST_F (ThreadPoolTests, DestructorExecutesQueuedTasks)
+{
+    std::atomic<uint32_t> counter (0);
+
+    {
+        Utils::ThreadPool pool (2);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            pool.Submit ([&] { counter.fetch_add (1); });
+        }
+    }
+
+    EXPECT_EQ (1000, counter.load ());
+}
+
+
+TEST_F (ThreadPoolTests, ParallelForVisitsEveryIndexOnce)
+{
+    Utils::ThreadPool pool (4);
+
+    for (const uint32_t grainSize : { 0u, 1u, 7u, 64u, 1000u, 5000u }) {
+        std::vector<std::atomic<uint32_t>> visited (1000);
+        for (std::atomic<uint32_t>& v : visited) {
+            v.store (0);
+        }
+
+        Utils::ParallelFor (0, 1000, grainSize, [&] (uint32_t index) {
+            visited[index].fetch_add (1);
+        }, pool);
+
+        for (uint32_t index = 0; index < 1000; ++index) {
+            EXPECT_EQ (1, visited[index].load ()) << "index " << index << ", grain size " << grainSize;
+        }
+    }
+
+    std::atomic<uint32_t> counter (0);
+    Utils::ParallelFor (10, 10, 1, [&] (uint32_t) { counter.fetch_add (1); }, pool);
+    Utils::ParallelFor (UINT32_MAX - 100, UINT32_MAX, 7, [&] (uint32_t) { counter.fetch_add (1); }, pool);
+    EXPECT_EQ (100, counter.load ());
+}
+
+
+TEST_F (ThreadPoolTests, AsyncReturnsValuesAndExceptions)
+{
+    Utils::ThreadPool pool (2);
+
+    std::future<int> value = pool.Async ([] { return 42; });
+    std::future<int> error = pool.Async ([] () -> int { throw std::runtime_error ("error"); });
+
+    EXPECT_EQ (42, value.get ());
+    EXPECT_THROW (error.get (), std::runtime_error);
+}
+
+
+TEST_F (ThreadPoolTests, TaskGroupRethrowsFirstException)
+{
+    Utils::ThreadPool pool (2);
+
+    std::atomic<uint32_t> counter (0);
+
+    Utils::TaskGroup group (pool);
+    for (uint32_t i = 0; i < 100; ++i) {
+        group.Run ([&, i] {
+            counter.fetch_add (1);
+            if (i % 10 == 0) {
+                throw std::runtime_error ("error");
+            }
+        });
+    }
+
+    EXPECT_THROW (group.Wait (), std::runtime_error);
+    EXPECT_EQ (100, counter.load ());
+
+    // the exception is only reported once
+    EXPECT_NO_THROW (group.Wait ());
+}
+
+
+TEST_F (ThreadPoolTests, DedicatedTaskDoesNotBlockWorkers)
+{
+    Utils::ThreadPool pool (1);
+
+    std::promise<void>       release;
+    std::shared_future<void> released = release.get_future ().share ();
+
+    std::future<int> blocking = pool.RunDedicated ([released] {
+        released.wait ();
+        return 1;
+    });
+
+    // the only worker is free while the dedicated task blocks
+    std::future<int> value = pool.Async ([] { return 2; });
+    EXPECT_EQ (std::future_status::ready, value.wait_for (std::chrono::seconds (10)));
+    EXPECT_EQ (2, value.get ());
+
+    EXPECT_EQ (std::future_status::timeout, blocking.wait_for (std::chrono::milliseconds (0)));
+    release.set_value ();
+    EXPECT_EQ (1, blocking.get ());
+}
+
+
+TEST_F (ThreadPoolTests, MultithreadedFunctionCallsEveryIndex)
+{
+    std::vector<std::atomic<uint32_t>> called (17);
+    for (std::atomic<uint32_t>& c : called) {
+        c.store (0);
+    }
+
+    {
+        MultithreadedFunction function (17, [&] (uint32_t threadCount, uint32_t threadIndex) {
+            EXPECT_EQ (17, threadCount);
+            called[threadIndex].fetch_add (1);
+        });
+    }
+
+    for (std::atomic<uint32_t>& c : called) {
+        EXPECT_EQ (1, c.load ());
+    }
+}
+
+
+TEST_F (ThreadPoolTests, TaskThroughput)
+{
+    constexpr uint32_t TaskCount = 100000;
+
+    std::atomic<uint32_t> counter (0);
+
+    const auto poolStart = std::chrono::high_resolution_clock::now ();
+    {
+        Utils::TaskGroup group;
+        for (uint32_t i = 0; i < TaskCount; ++i) {
+            group.Run ([&] { counter.fetch_add (1); });
+        }
+        group.Wait ();
+    }
+    const auto poolEnd = std::chrono::high_resolution_clock::now ();
+
+    // a thread per task, like the previous MultithreadedFunction, with fewer tasks
+    constexpr uint32_t ThreadCount = 1000;
+
+    const auto threadStart = std::chrono::high_resolution_clock::now ();
+    for (uint32_t i = 0; i < ThreadCount; ++i) {
+        std::thread ([&] { counter.fetch_add (1); }).join ();
+    }
+    const auto threadEnd = std::chrono::high_resolution_clock::now ();
+
+    const double poolNanoseconds   = std::chrono::duration<double, std::nano> (poolEnd - poolStart).count () / TaskCount;
+    const double threadNanoseconds = std::chrono::duration<double, std::nano> (threadEnd - threadStart).count () / ThreadCount;
+
+    std::cout << "ThreadPool task: " << poolNanoseconds << " ns, std::thread: " << threadNanoseconds << " ns per task" << std::endl;
+
+    EXPECT_EQ (TaskCount + ThreadCount, counter.load ());
+}
@@ -0,0 +1,171 @@
+#include "Utils/Trace.hpp"
+
+#include "gtest/gtest.h"
+
+#include "cereal/external/rapidjson/document.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using TraceTests = ::testing::Test;
+
+
+namespace {
+
+using JSONDocument = CEREAL_RAPIDJSON_NAMESPACE::Document;
+using JSONValue    = CEREAL_RAPIDJSON_NAMESPACE::Value;
+
+
+std::vector<const JSONValue*> GetEvents (const JSONDocument& trace, const std::string& name)
+{
+    std::vector<const JSONValue*> result;
+
+    const auto events = trace.FindMember ("traceEvents");
+    if (events == trace.MemberEnd () || !events->value.IsArray ()) {
+        return result;
+    }
+
+    for (const JSONValue& event : events->value.GetArray ()) {
+        const auto eventName = event.FindMember ("name");
+        if (eventName != event.MemberEnd () && eventName->value.IsString () && eventName->value.GetString () == name) {
+            result.push_back (&event);
+        }
+    }
+
+    return result;
+}
+
+
+void BusyWait (std::chrono::microseconds duration)
+{
+    const auto end = std::chrono::high_resolution_clock::now () + duration;
+    while (std::chrono::high_resolution_clock::now () < end) {
+    }
+}
+
+} // namespace
+
+
+TEST_F (TraceTests, ExportedJSONContainsScopes)
+{
+    Utils::ClearTrace ();
+    Utils::SetTracingEnabled (true);
+
+    {
+        Utils::TraceScope outer ("Outer", "Test");
+        BusyWait (std::chrono::microseconds (200));
+        {
+            Utils::TraceScope inner ("Inner \"quoted\"", "Test");
+            BusyWait (std::chrono::microseconds (200));
+        }
+        Utils::TraceInstant ("Instant", "Test");
+    }
+
+    std::thread ([] {
+        Utils::TraceScope scope ("Other thread", "Test");
+    }).join ();
+
+    Utils::SetTracingEnabled (false);
+
+    {
+        Utils::TraceScope disabled ("Disabled", "Test");
+    }
+
+    JSONDocument trace;
+    trace.Parse (Utils::GetTraceJSON ().c_str ());
+    ASSERT_FALSE (trace.HasParseError ());
+    ASSERT_TRUE (trace.IsObject ());
+    ASSERT_TRUE (trace.HasMember ("traceEvents"));
+
+    const std::vector<const JSONValue*> outer   = GetEvents (trace, "Outer");
+    const std::vector<const JSONValue*> inner   = GetEvents (trace, "Inner \"quoted\"");
+    const std::vector<const JSONValue*> instant = GetEvents (trace, "Instant");
+    const std::vector<const JSONValue*> other   = GetEvents (trace, "Other thread");
+
+    ASSERT_EQ (outer.size (), 1);
+    ASSERT_EQ (inner.size (), 1);
+    ASSERT_EQ (instant.size (), 1);
+    ASSERT_EQ (other.size (), 1);
+    EXPECT_TRUE (GetEvents (trace, "Disabled").empty ());
+
+    const JSONValue& outerEvent   = *outer[0];
+    const JSONValue& innerEvent   = *inner[0];
+    const JSONValue& instantEvent = *instant[0];
+    const JSONValue& otherEvent   = *other[0];
+
+    for (const JSONValue* event : { &outerEvent, &innerEvent, &instantEvent, &otherEvent }) {
+        ASSERT_TRUE (event->HasMember ("ph") && (*event)["ph"].IsString ());
+        ASSERT_TRUE (event->HasMember ("cat") && (*event)["cat"].IsString ());
+        ASSERT_TRUE (event->HasMember ("ts") && (*event)["ts"].IsNumber ());
+        ASSERT_TRUE (event->HasMember ("tid") && (*event)["tid"].IsNumber ());
+    }
+    ASSERT_TRUE (outerEvent.HasMember ("dur") && outerEvent["dur"].IsNumber ());
+    ASSERT_TRUE (innerEvent.HasMember ("dur") && innerEvent["dur"].IsNumber ());
+
+    EXPECT_STREQ (outerEvent["ph"].GetString (), "X");
+    EXPECT_STREQ (outerEvent["cat"].GetString (), "Test");
+    EXPECT_STREQ (instantEvent["ph"].GetString (), "i");
+
+    // timestamps are in microseconds
+    const double outerBegin = outerEvent["ts"].GetDouble ();
+    const double outerEnd   = outerBegin + outerEvent["dur"].GetDouble ();
+    const double innerBegin = innerEvent["ts"].GetDouble ();
+    const double innerEnd   = innerBegin + innerEvent["dur"].GetDouble ();
+
+    EXPECT_GE (outerEvent["dur"].GetDouble (), 400.0);
+    EXPECT_GE (innerEvent["dur"].GetDouble (), 200.0);
+    EXPECT_LE (outerBegin, innerBegin);
+    EXPECT_LE (innerEnd, outerEnd);
+
+    EXPECT_EQ (outerEvent["tid"].GetDouble (), innerEvent["tid"].GetDouble ());
+    EXPECT_NE (outerEvent["tid"].GetDouble (), otherEvent["tid"].GetDouble ());
+
+    Utils::ClearTrace ();
+}
+
+
+TEST_F (TraceTests, ScopeOverhead)
+{
+    constexpr uint32_t Iterations = 1000000;
+
+    const auto measure = [] () {
+        const auto start = std::chrono::high_resolution_clock::now ();
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            Utils::TraceScope scope ("Benchmark", "Test");
+        }
+        const auto end = std::chrono::high_resolution_clock::now ();
+        return std::chrono::duration<double, std::nano> (end - start).count () / Iterations;
+    };
+
+    Utils::ClearTrace ();
+
+    Utils::SetTracingEnabled (false);
+    const double disabledNanoseconds = measure ();
+
+    // a disabled scope does not record anything
+    {
+        JSONDocument trace;
+        trace.Parse (Utils::GetTraceJSON ().c_str ());
+        ASSERT_FALSE (trace.HasParseError ());
+        EXPECT_TRUE (GetEvents (trace, "Benchmark").empty ());
+    }
+
+    Utils::SetTracingEnabled (true);
+    const double enabledNanoseconds = measure ();
+    Utils::SetTracingEnabled (false);
+
+    {
+        JSONDocument trace;
+        trace.Parse (Utils::GetTraceJSON ().c_str ());
+        ASSERT_FALSE (trace.HasParseError ());
+        EXPECT_FALSE (GetEvents (trace, "Benchmark").empty ());
+    }
+
+    Utils::ClearTrace ();
+
+    std::cout << "TraceScope overhead: disabled " << disabledNanoseconds << " ns, enabled " << enabledNanoseconds << " ns per scope" << std::endl;
+}
@@ -0,0 +1,119 @@
+#include "RenderGraph/TransientMemory.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+
+using TransientMemoryTests = ::testing::Test;
+
+
+constexpr uint32_t AllMemoryTypes = 0xFFFFFFFF;
+
+
+TEST_F (TransientMemoryTests, DisjointLifetimesShareMemory)
+{
+    const std::vector<RG::ResourceLifetime> lifetimes { { 0, 1 }, { 1, 2 }, { 2, 3 } };
+    const std::vector<VkMemoryRequirements> requirements { { 1024, 256, AllMemoryTypes }, { 1024, 256, AllMemoryTypes }, { 1024, 256, AllMemoryTypes } };
+
+    const RG::TransientMemoryLayout layout (lifetimes, requirements);
+
+    ASSERT_EQ (1, layout.blocks.size ());
+    ASSERT_EQ (3, layout.placements.size ());
+
+    // the first and the last are never used in the same pass
+    EXPECT_EQ (layout.placements[0].offset, layout.placements[2].offset);
+    EXPECT_NE (layout.placements[0].offset, layout.placements[1].offset);
+
+    EXPECT_EQ (3 * 1024, RG::TransientMemoryLayout::GetUnaliasedSize (requirements));
+    EXPECT_EQ (2 * 1024, layout.GetAllocatedSize ());
+}
+
+
+TEST_F (TransientMemoryTests, OverlappingLifetimesDoNotShareMemory)
+{
+    const std::vector<RG::ResourceLifetime> lifetimes { { 0, 3 }, { 1, 2 }, { 3, 4 } };
+    const std::vector<VkMemoryRequirements> requirements { { 1024, 16, AllMemoryTypes }, { 1024, 16, AllMemoryTypes }, { 1024, 16, AllMemoryTypes } };
+
+    const RG::TransientMemoryLayout layout (lifetimes, requirements);
+
+    for (size_t i = 0; i < lifetimes.size (); ++i) {
+        for (size_t j = i + 1; j < lifetimes.size (); ++j) {
+            if (!lifetimes[i].Overlaps (lifetimes[j])) {
+                continue;
+            }
+
+            const RG::TransientMemoryLayout::Placement& a = layout.placements[i];
+            const RG::TransientMemoryLayout::Placement& b = layout.placements[j];
+            if (a.blockIndex != b.blockIndex) {
+                continue;
+            }
+
+            EXPECT_TRUE (a.offset + requirements[i].size <= b.offset || b.offset + requirements[j].size <= a.offset) << i << " and " << j;
+        }
+    }
+
+    // the second one ends before the third one starts
+    EXPECT_EQ (layout.placements[1].offset, layout.placements[2].offset);
+    EXPECT_EQ (2 * 1024, layout.GetAllocatedSize ());
+}
+
+
+TEST_F (TransientMemoryTests, SlotGrowsToTheLargestResource)
+{
+    const std::vector<RG::ResourceLifetime> lifetimes { { 0, 0 }, { 1, 1 }, { 2, 2 } };
+    const std::vector<VkMemoryRequirements> requirements { { 100, 4, AllMemoryTypes }, { 300, 4, AllMemoryTypes }, { 200, 4, AllMemoryTypes } };
+
+    const RG::TransientMemoryLayout layout (lifetimes, requirements);
+
+    ASSERT_EQ (1, layout.blocks.size ());
+    EXPECT_EQ (0, layout.placements[0].offset);
+    EXPECT_EQ (0, layout.placements[1].offset);
+    EXPECT_EQ (0, layout.placements[2].offset);
+    EXPECT_EQ (300, layout.GetAllocatedSize ());
+    EXPECT_EQ (600, RG::TransientMemoryLayout::GetUnaliasedSize (requirements));
+}
+
+
+TEST_F (TransientMemoryTests, OffsetsAreAligned)
+{
+    const std::vector<RG::ResourceLifetime> lifetimes { { 0, 1 }, { 0, 1 }, { 0, 1 } };
+    const std::vector<VkMemoryRequirements> requirements { { 100, 4, AllMemoryTypes }, { 100, 256, AllMemoryTypes }, { 10, 64, AllMemoryTypes } };
+
+    const RG::TransientMemoryLayout layout (lifetimes, requirements);
+
+    ASSERT_EQ (1, layout.blocks.size ());
+    for (size_t i = 0; i < requirements.size (); ++i) {
+        EXPECT_EQ (0, layout.placements[i].offset % requirements[i].alignment) << i;
+    }
+    EXPECT_EQ (256, layout.blocks[0].alignment);
+    EXPECT_EQ (394, layout.GetAllocatedSize ());
+}
+
+
+TEST_F (TransientMemoryTests, IncompatibleMemoryTypesUseSeparateBlocks)
+{
+    const std::vector<RG::ResourceLifetime> lifetimes { { 0, 0 }, { 1, 1 }, { 2, 2 } };
+    const std::vector<VkMemoryRequirements> requirements { { 64, 4, 0b0011 }, { 64, 4, 0b1100 }, { 64, 4, 0b0110 } };
+
+    const RG::TransientMemoryLayout layout (lifetimes, requirements);
+
+    ASSERT_EQ (2, layout.blocks.size ());
+    EXPECT_NE (layout.placements[0].blockIndex, layout.placements[1].blockIndex);
+
+    for (size_t i = 0; i < requirements.size (); ++i) {
+        const RG::TransientMemoryLayout::Block& block = layout.blocks[layout.placements[i].blockIndex];
+        EXPECT_NE (0, block.memoryTypeBits & requirements[i].memoryTypeBits) << i;
+        EXPECT_LE (layout.placements[i].offset + requirements[i].size, block.size) << i;
+    }
+}
+
+
+TEST_F (TransientMemoryTests, EmptyLayout)
+{
+    const RG::TransientMemoryLayout layout ({}, {});
+
+    EXPECT_TRUE (layout.blocks.empty ());
+    EXPECT_TRUE (layout.placements.empty ());
+    EXPECT_EQ (0, layout.GetAllocatedSize ());
+}
@@ -445,8 +445,8 @@ void main ()
             std::cout << "waiting for device... " << std::endl;
             vkDeviceWaitIdle (s.GetDevice ());
             vkQueueWaitIdle (s.GetDevice ().GetGraphicsQueue ());
-            sp->Reload ();
-            renderer.Recreate (graph);
+            brainRenderOp->GetShaderPipeline ()->Reload ();
+            graph.RecompileOperations ({ brainRenderOp.get () });
         }
         switch (key) {
             case '1': currentDisplayMode = DisplayMode::Feladat1; break;
@@ -863,8 +863,8 @@ void main ()
             std::cout << "waiting for device... " << std::endl;
             vkDeviceWaitIdle (*graph.graphSettings.device);
             vkQueueWaitIdle (graph.graphSettings.device->GetGraphicsQueue ());
-            sp->Reload ();
-            renderer.Recreate (graph);
+            brainRenderOp->GetShaderPipeline ()->Reload ();
+            graph.RecompileOperations ({ brainRenderOp.get () });
         }
     });
 
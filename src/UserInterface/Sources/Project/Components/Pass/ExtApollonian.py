@@ -145,7 +145,7 @@ void main(  )
     int ii = 1, jj = 1;
     #endif
     {
-        vec2 q = gl_FragCoord.xy+vec2(float(ii),float(jj))/float(AA);
+        vec2 q = (gl_FragCoord.xy - fieldOffset)+vec2(float(ii),float(jj))/float(AA);
         vec2 p = (2.0*q-iResolution.xy)/iResolution.y;
 
         // camera
@@ -188,7 +188,7 @@ out vec4 fragColor;
 
 void main(  )
 {
-	vec2 uv = gl_FragCoord.xy  / iResolution.xy*2.-1.;
+	vec2 uv = (gl_FragCoord.xy - fieldOffset)  / iResolution.xy*2.-1.;
 	vec2 oriuv=uv;
 	uv.y*=iResolution.y/iResolution.x;
 	vec2 mouse=vec2(0.0, 0.0); //(iMouse.xy/iResolution.xy-.5)*3.;
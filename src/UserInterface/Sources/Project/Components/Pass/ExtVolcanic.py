@@ -232,7 +232,7 @@ out vec4 fragColor;
 
 void main(  )
 {
-    vec2 q = gl_FragCoord.xy / iResolution.xy;
+    vec2 q = (gl_FragCoord.xy - fieldOffset) / iResolution.xy;
 	vec2 p = -1.0 + 2.0*q;
     //p.y = - p.y;
 	p.x *= iResolution.x / iResolution.y;
@@ -36,6 +36,7 @@ class CellShift(Component) :
         stimulus.randomGeneratorShaderSource = self.glslEsc("""
             layout (binding = 0) uniform usampler2D previousSequenceElements[4];
             layout (binding = 1) uniform ubo_seed { uint seed; };
+            layout (binding = 2) uniform ubo_field { vec2 fieldOffset; };
 
             layout (location = 0) out uvec4 nextElement;
 
@@ -46,13 +47,15 @@ class CellShift(Component) :
                 {
                     @<initialCode>@
                 }
-                ivec2 cell = ivec2(gl_FragCoord.xy) + ivec2(@<shiftStepX>@, @<shiftStepY>@);
+                // relative to the field, not to the window
+                ivec2 fragCoord = ivec2(gl_FragCoord.xy - fieldOffset);
+                ivec2 cell = fragCoord + ivec2(@<shiftStepX>@, @<shiftStepY>@);
                 if(!randomizeAll && cell.x > -1 && cell.y > -1 && cell.x < @<gridSizeX>@ && cell.y < @<gridSizeY>@ )
                 {
                     nextElement = texelFetch(previousSequenceElements[0], cell, 0);
                     return;
                 }
-                uvec2 p = uvec2(gl_FragCoord.xy);
+                uvec2 p = uvec2(fragCoord);
                 if(frame == 1) {
                     nextElement.r = p.x * 1341593453u ^ p.y *  971157919u ^ seed * 2883500843u;
                     nextElement.g = p.x * 1790208463u ^ p.y * 1508561443u ^ seed * 2321036227u;
@@ -74,10 +77,10 @@ class CellShift(Component) :
                     nextElement.b = p.x * 3155894689u ^ p.y * 1883169037u ^ seed * 2870559073u;
                     nextElement.a = p.x * 1883169037u ^ p.y * 2278336279u ^ seed * 2278336133u;
                 } else {
-	                uvec4 x = texelFetch(previousSequenceElements[3], ivec2(gl_FragCoord.xy), 0);
-	                uvec4 y = texelFetch(previousSequenceElements[2], ivec2(gl_FragCoord.xy), 0);
-	                uvec4 z = texelFetch(previousSequenceElements[1], ivec2(gl_FragCoord.xy), 0);
-	                uvec4 w = texelFetch(previousSequenceElements[0], ivec2(gl_FragCoord.xy), 0);
+	                uvec4 x = texelFetch(previousSequenceElements[3], fragCoord, 0);
+	                uvec4 y = texelFetch(previousSequenceElements[2], fragCoord, 0);
+	                uvec4 z = texelFetch(previousSequenceElements[1], fragCoord, 0);
+	                uvec4 w = texelFetch(previousSequenceElements[0], fragCoord, 0);
                     // 128-bit xorshift algorithm
                     uvec4 t = x ^ (x << 11u);
                     nextElement = w ^ (w >> 19u) ^ t ^ (t >> 8u);
@@ -18,6 +18,9 @@ class LCG(Component):
 
 layout(local_size_x = 1, local_size_y = 1) in;
 
+// number of random layers, specialized by the StimulusAdapter
+layout (constant_id = 0) const uint FRAMESINFLIGHT = 1;
+
 layout (binding = 6) uniform RandomGeneratorConfig {{
     uint seed;
     uint framesInFlight;
@@ -27,7 +30,7 @@ layout (binding = 6) uniform RandomGeneratorConfig {{
 }};
 
 layout (binding = 7) buffer OutputBuffer {{
-    uvec4 randomsBuffer[1][{stimulus.rngCompute_workGroupSizeY}][{stimulus.rngCompute_workGroupSizeX}];
+    uvec4 randomsBuffer[FRAMESINFLIGHT][{stimulus.rngCompute_workGroupSizeY}][{stimulus.rngCompute_workGroupSizeX}];
 }};
 
 uint64_t Forrest_C (const uint64_t k, const uint64_t seed, const uint64_t g, const uint64_t c, const uint64_t m)
@@ -57,23 +60,26 @@ void main ()
     // IGY JO SORREND const uint64_t frameOffset = gridWidth * gridHeight * 4 * startFrameIndex;
     // IGY JO SORREND const uint64_t pxOffset = uint (gl_GlobalInvocationID.y * gridWidth + gl_GlobalInvocationID.x) * 4;
 
-    const uint64_t frameOffset = gridWidth * gridHeight * 4 * startFrameIndex;
-    const uint64_t pxOffset = uint (gl_GlobalInvocationID.y * gridWidth + gl_GlobalInvocationID.x) * 4;
-    
-    const float perc1 = float (Forrest_C (frameOffset + pxOffset + 0, seed, 48271, 0, 2147483647)) / float (2147483647);
-    const float perc2 = float (Forrest_C (frameOffset + pxOffset + 1, seed, 48271, 0, 2147483647)) / float (2147483647);
-    const float perc3 = float (Forrest_C (frameOffset + pxOffset + 2, seed, 48271, 0, 2147483647)) / float (2147483647);
-    const float perc4 = float (Forrest_C (frameOffset + pxOffset + 3, seed, 48271, 0, 2147483647)) / float (2147483647);
-    
-    uvec4 nextElement = uvec4 (perc1 * uint (-1), perc2 * uint (-1), perc3 * uint (-1), perc4 * uint (-1));
-    nextElement = uvec4 (
-        uint (Forrest_C (frameOffset + pxOffset + 0, seed, 48271, 0, 4294967295)),
-        uint (Forrest_C (frameOffset + pxOffset + 1, seed, 48271, 0, 4294967295)),
-        uint (Forrest_C (frameOffset + pxOffset + 2, seed, 48271, 0, 4294967295)),
-        uint (Forrest_C (frameOffset + pxOffset + 3, seed, 48271, 0, 4294967295))
-    );
+    // one layer per sub-frame with high frequency rendering, a single layer otherwise
+    for (uint layer = 0; layer < FRAMESINFLIGHT; ++layer) {{
+        const uint64_t frameOffset = gridWidth * gridHeight * 4 * (startFrameIndex + layer);
+        const uint64_t pxOffset = uint (gl_GlobalInvocationID.y * gridWidth + gl_GlobalInvocationID.x) * 4;
 
-    randomsBuffer[0][gl_GlobalInvocationID.y][gl_GlobalInvocationID.x] = nextElement;
+        const float perc1 = float (Forrest_C (frameOffset + pxOffset + 0, seed, 48271, 0, 2147483647)) / float (2147483647);
+        const float perc2 = float (Forrest_C (frameOffset + pxOffset + 1, seed, 48271, 0, 2147483647)) / float (2147483647);
+        const float perc3 = float (Forrest_C (frameOffset + pxOffset + 2, seed, 48271, 0, 2147483647)) / float (2147483647);
+        const float perc4 = float (Forrest_C (frameOffset + pxOffset + 3, seed, 48271, 0, 2147483647)) / float (2147483647);
+
+        uvec4 nextElement = uvec4 (perc1 * uint (-1), perc2 * uint (-1), perc3 * uint (-1), perc4 * uint (-1));
+        nextElement = uvec4 (
+            uint (Forrest_C (frameOffset + pxOffset + 0, seed, 48271, 0, 4294967295)),
+            uint (Forrest_C (frameOffset + pxOffset + 1, seed, 48271, 0, 4294967295)),
+            uint (Forrest_C (frameOffset + pxOffset + 2, seed, 48271, 0, 4294967295)),
+            uint (Forrest_C (frameOffset + pxOffset + 3, seed, 48271, 0, 4294967295))
+        );
+
+        randomsBuffer[layer][gl_GlobalInvocationID.y][gl_GlobalInvocationID.x] = nextElement;
+    }}
 
     //const uint perc1 = uint(frameOffset) + uint(pxOffset) + 0;
     //const uint perc2 = uint(frameOffset) + uint(pxOffset) + 1;
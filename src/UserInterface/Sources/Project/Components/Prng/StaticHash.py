@@ -22,12 +22,13 @@ class StaticHash(Component) :
             uniform usampler2D previousSequenceElements2;
             uniform usampler2D previousSequenceElements3;
             uniform uint seed;
+            uniform vec2 fieldOffset;
 
             out uvec4 nextElement;
 
             void main() 
             {
-                uvec2 p = uvec2(gl_FragCoord.xy);
+                uvec2 p = uvec2(gl_FragCoord.xy - fieldOffset);
                 nextElement.r = p.x * 1341593453u ^ p.y *  971157919u ^ seed * 2883500843u;
                 nextElement.g = p.x * 1790208463u ^ p.y * 1508561443u ^ seed * 2321036227u;
                 nextElement.b = 0u;//p.x * 2659567811u ^ p.y * 2918034323u ^ seed * 2244239747u;
@@ -17,6 +17,9 @@ class XorShift128(Component) :
 
 #extension GL_EXT_debug_printf : enable
 
+// number of random layers, specialized by the StimulusAdapter
+layout (constant_id = 0) const uint FRAMESINFLIGHT = 1;
+
 layout (set = 0, binding = 0) uniform RandomGeneratorConfig {{
     uint seed;
     uint framesInFlight;
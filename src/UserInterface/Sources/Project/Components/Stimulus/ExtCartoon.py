@@ -183,7 +183,7 @@ out vec4 fragColor;
 
 void main(  )
 {
-	vec2 uv = gl_FragCoord.xy  / iResolution.xy*2.-1.;
+	vec2 uv = (gl_FragCoord.xy - fieldOffset) / iResolution.xy*2.-1.;
     uv.y = -uv.y;
 	vec2 oriuv=uv;
 	uv.y*=iResolution.y/iResolution.x;
@@ -105,7 +105,7 @@ out vec4 fragColor;
 
 void main(  )
 {
-	vec2 uv = gl_FragCoord.xy  / iResolution.xy*2.-1.;
+	vec2 uv = (gl_FragCoord.xy - fieldOffset)  / iResolution.xy*2.-1.;
     uv.y = -uv.y;
 
 	float t=time*.2;
@@ -114,7 +114,7 @@ void main(  )
 	vec3 dir=normalize(vec3(uv,1.));
 	rot=mat2(cos(t),sin(t),-sin(t),cos(t));
 	dir.xy=dir.xy*rot;
-	float col=raymarch(from,dir,gl_FragCoord.xy); 
+	float col=raymarch(from,dir,(gl_FragCoord.xy - fieldOffset)); 
 	col=pow(col,1.25)*clamp(60.-time,0.,1.);
 	fragColor = vec4(col);
 }
@@ -0,0 +1,51 @@
+#ifndef UTILS_HASHER_HPP
+#define UTILS_HASHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace Utils {
+
+// 64 bit FNV-1a hash. Unlike std::hash, the result is the same between runs and builds,
+// so it can be saved to files.
+class Hasher {
+private:
+    uint64_t value;
+
+public:
+    Hasher ()
+        : value (14695981039346656037ull)
+    {
+    }
+
+    void Add (const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*> (data);
+        for (size_t i = 0; i < size; ++i) {
+            value ^= bytes[i];
+            value *= 1099511628211ull;
+        }
+    }
+
+    void Add (const std::string& str)
+    {
+        // the size separates consecutive strings: "ab" + "c" differs from "a" + "bc"
+        Add (static_cast<uint64_t> (str.size ()));
+        Add (str.data (), str.size ());
+    }
+
+    template<typename T>
+    void Add (const T& data)
+    {
+        static_assert (std::is_trivially_copyable<T>::value, "only trivially copyable values can be hashed by their bytes");
+        Add (&data, sizeof (T));
+    }
+
+    uint64_t Get () const { return value; }
+};
+
+} // namespace Utils
+
+#endif
@@ -1,52 +1,49 @@
 #ifndef MULTITHREADED_FUNCTION_HPP
 #define MULTITHREADED_FUNCTION_HPP
 
+#include "ThreadPool.hpp"
+
 #include <cstdint>
+#include <exception>
 #include <functional>
-#include <thread>
-#include <vector>
 
+// runs threadFunc threadCount times on the thread pool, threadIndex is different for every call
+// the calls may not run in parallel, they must not wait for each other
 class MultithreadedFunction final {
 public:
     using FunctionType = std::function<void (uint32_t threadCount, uint32_t threadIndex)>;
 
 private:
-    bool ended;
-
-    std::vector<std::thread> threads;
+    Utils::TaskGroup group;
 
 public:
     MultithreadedFunction (const uint32_t threadCount, const FunctionType& threadFunc)
-        : ended (false)
     {
-        threads.reserve (threadCount);
         for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
-            threads.emplace_back (threadFunc, threadCount, threadIndex);
+            group.Run ([threadFunc, threadCount, threadIndex] {
+                threadFunc (threadCount, threadIndex);
+            });
         }
     }
 
     MultithreadedFunction (const FunctionType& threadFunc)
-        : MultithreadedFunction (std::thread::hardware_concurrency (), threadFunc)
+        : MultithreadedFunction (Utils::ThreadPool::Get ().GetWorkerCount (), threadFunc)
     {
     }
 
-    void Wait ()
+    // waits like Wait, exceptions are only rethrown if the stack is not already unwinding
+    ~MultithreadedFunction () noexcept (false)
     {
-        if (ended) {
-            return;
+        if (std::uncaught_exceptions () == 0) {
+            group.Wait ();
         }
-
-        for (auto& t : threads) {
-            t.join ();
-        }
-
-        ended = true;
     }
 
-    ~MultithreadedFunction ()
+    // rethrows the first exception thrown by threadFunc
+    void Wait ()
     {
-        Wait ();
+        group.Wait ();
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,68 @@
+#ifndef UTILS_SPSCQUEUE_HPP
+#define UTILS_SPSCQUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace Utils {
+
+// Fixed capacity lock-free queue for exactly one producer and one consumer thread.
+// Push and pop never block or allocate, pushing to a full queue fails.
+template<typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert (Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+private:
+    std::array<T, Capacity> items;
+
+    // separate cache lines, so the two threads dont invalidate each other's index
+    alignas (64) std::atomic<size_t> writeIndex;
+    alignas (64) std::atomic<size_t> readIndex;
+
+public:
+    SPSCQueue ()
+        : writeIndex (0)
+        , readIndex (0)
+    {
+    }
+
+    SPSCQueue (const SPSCQueue&) = delete;
+    SPSCQueue& operator= (const SPSCQueue&) = delete;
+
+    // producer thread only
+    bool TryPush (const T& item)
+    {
+        const size_t write = writeIndex.load (std::memory_order_relaxed);
+        if (write - readIndex.load (std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+
+        items[write & (Capacity - 1)] = item;
+        writeIndex.store (write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer thread only
+    std::optional<T> TryPop ()
+    {
+        const size_t read = readIndex.load (std::memory_order_relaxed);
+        if (read == writeIndex.load (std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+
+        T item = items[read & (Capacity - 1)];
+        readIndex.store (read + 1, std::memory_order_release);
+        return item;
+    }
+
+    bool IsEmpty () const
+    {
+        return readIndex.load (std::memory_order_acquire) == writeIndex.load (std::memory_order_acquire);
+    }
+};
+
+} // namespace Utils
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef UTILS_THREADPOOL_HPP
+#define UTILS_THREADPOOL_HPP
+
+#include "GVKUtilsAPI.hpp"
+#include "Noncopyable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Utils {
+
+// Persistent worker threads with work stealing.
+// Every worker has its own task queue: tasks submitted from a worker go to its own queue and are executed
+// newest first, idle workers steal the oldest tasks of the others. Tasks submitted from other threads
+// are shared by all workers.
+// Waiting for tasks (TaskGroup::Wait) executes queued tasks meanwhile, so tasks can wait for other tasks.
+// Tasks that block (file or network I/O, waiting for other threads) should use RunDedicated instead,
+// so they dont take a worker away from the others.
+class GVK_UTILS_API ThreadPool : public Noncopyable {
+public:
+    using Task = std::function<void ()>;
+
+private:
+    struct TaskQueue {
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct DedicatedThread {
+        std::thread       thread;
+        std::atomic<bool> finished { false };
+    };
+
+    // one per worker, the last one is for tasks submitted from other threads
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread>                workers;
+
+    std::atomic<uint64_t> queuedTaskCount;
+    std::atomic<uint32_t> sleepingWorkerCount;
+
+    std::mutex              sleepMutex;
+    std::condition_variable wakeUp;
+    bool                    stopping;
+
+    std::mutex                                  dedicatedThreadsMutex;
+    std::list<std::unique_ptr<DedicatedThread>> dedicatedThreads;
+
+public:
+    static uint32_t GetDefaultWorkerCount ();
+
+    ThreadPool (uint32_t workerCount = GetDefaultWorkerCount ());
+
+    // queued tasks are executed before the workers exit
+    virtual ~ThreadPool () override;
+
+    // process-wide pool with GetDefaultWorkerCount workers
+    static ThreadPool& Get ();
+
+    uint32_t GetWorkerCount () const { return static_cast<uint32_t> (workers.size ()); }
+
+    // exceptions escaping the task are logged, use Async or a TaskGroup to get them
+    void Submit (Task&& task);
+
+    template<typename Function>
+    std::future<std::invoke_result_t<Function>> Async (Function&& function);
+
+    // runs on a new thread, not on a worker, for tasks that block
+    template<typename Function>
+    std::future<std::invoke_result_t<Function>> RunDedicated (Function&& function);
+
+    // executes one queued task on the calling thread, returns false if there was none
+    bool TryRunOneTask ();
+
+    // nullopt on threads that are not workers of this pool
+    std::optional<uint32_t> GetCurrentWorkerIndex () const;
+
+private:
+    void WorkerThread (uint32_t workerIndex);
+
+    std::optional<Task> TryPopTask (std::optional<uint32_t> workerIndex);
+
+    void RunTask (Task& task);
+
+    void StartDedicatedThread (Task&& task);
+};
+
+
+// Tasks that are waited for together. Wait rethrows the first exception thrown by the tasks.
+class GVK_UTILS_API TaskGroup : public Noncopyable {
+private:
+    ThreadPool& pool;
+
+    std::atomic<uint32_t> pendingTaskCount;
+
+    std::mutex              mutex;
+    std::condition_variable finished;
+    std::exception_ptr      exception;
+
+public:
+    TaskGroup (ThreadPool& pool = ThreadPool::Get ());
+
+    // waits for the tasks, an exception that was not rethrown by Wait is logged
+    virtual ~TaskGroup () override;
+
+    void Run (std::function<void ()>&& task);
+
+    // executes queued tasks of the pool while waiting, so it can be called from a task
+    void Wait ();
+
+private:
+    void OnTaskFinished (std::exception_ptr taskException);
+};
+
+
+// calls function (index) for every index in [begin, end), grainSize consecutive indices are one task
+template<typename Function>
+void ParallelFor (uint32_t begin, uint32_t end, uint32_t grainSize, const Function& function, ThreadPool& pool = ThreadPool::Get ())
+{
+    if (begin >= end) {
+        return;
+    }
+
+    grainSize = std::max (grainSize, 1u);
+
+    if (end - begin <= grainSize) {
+        for (uint32_t index = begin; index < end; ++index) {
+            function (index);
+        }
+        return;
+    }
+
+    TaskGroup group (pool);
+
+    for (uint32_t chunkBegin = begin; chunkBegin < end;) {
+        const uint32_t chunkEnd = (end - chunkBegin > grainSize) ? chunkBegin + grainSize : end;
+
+        group.Run ([&function, chunkBegin, chunkEnd] {
+            for (uint32_t index = chunkBegin; index < chunkEnd; ++index) {
+                function (index);
+            }
+        });
+
+        chunkBegin = chunkEnd;
+    }
+
+    group.Wait ();
+}
+
+
+template<typename Function>
+std::future<std::invoke_result_t<Function>> ThreadPool::Async (Function&& function)
+{
+    using ResultType = std::invoke_result_t<Function>;
+
+    // std::function needs a copyable callable
+    std::shared_ptr<std::packaged_task<ResultType ()>> task = std::make_shared<std::packaged_task<ResultType ()>> (std::forward<Function> (function));
+
+    std::future<ResultType> result = task->get_future ();
+    Submit ([task] { (*task) (); });
+    return result;
+}
+
+
+template<typename Function>
+std::future<std::invoke_result_t<Function>> ThreadPool::RunDedicated (Function&& function)
+{
+    using ResultType = std::invoke_result_t<Function>;
+
+    std::shared_ptr<std::packaged_task<ResultType ()>> task = std::make_shared<std::packaged_task<ResultType ()>> (std::forward<Function> (function));
+
+    std::future<ResultType> result = task->get_future ();
+    StartDedicatedThread ([task] { (*task) (); });
+    return result;
+}
+
+} // namespace Utils
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef UTILS_TRACE_HPP
+#define UTILS_TRACE_HPP
+
+#include "GVKUtilsAPI.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace Utils {
+
+// Low overhead CPU tracing, exported in the Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+// Every thread writes to its own fixed size ring buffer, recording never takes a lock or allocates
+// (except the first event of a thread). When the ring is full, the oldest events are overwritten.
+// Names and categories are not copied, they must be string literals.
+
+namespace Tracing {
+
+extern GVK_UTILS_API std::atomic<bool> enabled;
+
+GVK_UTILS_API void AddComplete (const char* name, const char* category, uint64_t beginNanoseconds, uint64_t endNanoseconds);
+
+GVK_UTILS_API uint64_t GetNanoseconds ();
+
+} // namespace Tracing
+
+
+inline bool IsTracingEnabled ()
+{
+    return Tracing::enabled.load (std::memory_order_relaxed);
+}
+
+GVK_UTILS_API void SetTracingEnabled (bool enabled);
+
+// instant event, e.g. a signal sent at a single point in time
+GVK_UTILS_API void TraceInstant (const char* name, const char* category = "");
+
+// drops all recorded events
+GVK_UTILS_API void ClearTrace ();
+
+// events are read without synchronizing with the recording threads,
+// so tracing should be quiescent (or disabled) when exporting
+GVK_UTILS_API std::string GetTraceJSON ();
+GVK_UTILS_API bool        ExportTrace (const std::filesystem::path& filePath);
+
+
+class TraceScope {
+private:
+    const char* name;
+    const char* category;
+    uint64_t    beginNanoseconds;
+
+public:
+    TraceScope (const char* name, const char* category = "")
+        : name (nullptr)
+    {
+        if (IsTracingEnabled ()) {
+            this->name       = name;
+            this->category   = category;
+            beginNanoseconds = Tracing::GetNanoseconds ();
+        }
+    }
+
+    ~TraceScope ()
+    {
+        if (name != nullptr) {
+            Tracing::AddComplete (name, category, beginNanoseconds, Tracing::GetNanoseconds ());
+        }
+    }
+
+    TraceScope (const TraceScope&) = delete;
+    TraceScope& operator= (const TraceScope&) = delete;
+};
+
+} // namespace Utils
+
+#endif
@@ -8,6 +8,7 @@
 #include <optional>
 
 #include "spdlog/spdlog.h"
+#include "spdlog/async.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/sinks/rotating_file_sink.h"
 
@@ -25,8 +26,12 @@ static CommandLineOnOffCallbackFlag logOffFlag { "--logOff", "Turns off logger."
 
 std::shared_ptr<spdlog::logger> GetLogger ()
 {
-    static std::shared_ptr<spdlog::logger> logger;
-    
+    // messages are written on the thread of this pool, logging only waits for the console or the disk when the queue is full
+    // blocking is preferred to dropping messages, a log with holes is misleading
+    // the pool is destroyed after the logger, the remaining messages are written on exit
+    static std::shared_ptr<spdlog::details::thread_pool> threadPool;
+    static std::shared_ptr<spdlog::logger>               logger;
+
     if (logger == nullptr) {
         time_t    now = time (0);
         struct tm tstruct;
@@ -41,7 +46,8 @@ std::shared_ptr<spdlog::logger> GetLogger ()
         sinks.push_back (std::make_shared<spdlog::sinks::stdout_color_sink_st> ());
         sinks.push_back (std::make_shared<spdlog::sinks::rotating_file_sink_mt> (logFileName, maxFileSize, maxFiles));
 
-        logger = std::make_shared<spdlog::logger> ("GearsVk", std::begin (sinks), std::end (sinks));
+        threadPool = std::make_shared<spdlog::details::thread_pool> (8192, 1);
+        logger     = std::make_shared<spdlog::async_logger> ("GearsVk", std::begin (sinks), std::end (sinks), threadPool, spdlog::async_overflow_policy::block);
 
         logger->set_pattern ("[%T] [%^%l%$] [t %t] %v");
     }
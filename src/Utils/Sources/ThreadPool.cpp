@@ -0,0 +1,315 @@
+#include "ThreadPool.hpp"
+
+#include "Assert.hpp"
+#include "Trace.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <chrono>
+
+
+namespace Utils {
+
+namespace {
+
+struct CurrentWorker {
+    const ThreadPool* pool        = nullptr;
+    uint32_t          workerIndex = 0;
+};
+
+thread_local CurrentWorker currentWorker;
+
+} // namespace
+
+
+uint32_t ThreadPool::GetDefaultWorkerCount ()
+{
+    return std::max (std::thread::hardware_concurrency (), 2u);
+}
+
+
+ThreadPool::ThreadPool (uint32_t workerCount)
+    : queuedTaskCount (0)
+    , sleepingWorkerCount (0)
+    , stopping (false)
+{
+    GVK_ASSERT (workerCount > 0);
+
+    for (uint32_t queueIndex = 0; queueIndex < workerCount + 1; ++queueIndex) {
+        queues.push_back (std::make_unique<TaskQueue> ());
+    }
+
+    workers.reserve (workerCount);
+    for (uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+        workers.emplace_back (&ThreadPool::WorkerThread, this, workerIndex);
+    }
+}
+
+
+ThreadPool::~ThreadPool ()
+{
+    {
+        std::lock_guard<std::mutex> lock (sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all ();
+
+    for (std::thread& worker : workers) {
+        worker.join ();
+    }
+
+    std::lock_guard<std::mutex> lock (dedicatedThreadsMutex);
+    for (std::unique_ptr<DedicatedThread>& dedicatedThread : dedicatedThreads) {
+        dedicatedThread->thread.join ();
+    }
+}
+
+
+ThreadPool& ThreadPool::Get ()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+
+void ThreadPool::Submit (Task&& task)
+{
+    const std::optional<uint32_t> workerIndex = GetCurrentWorkerIndex ();
+
+    TaskQueue& queue = *queues[workerIndex.has_value () ? *workerIndex : workers.size ()];
+
+    {
+        std::lock_guard<std::mutex> lock (queue.mutex);
+        queue.tasks.push_back (std::move (task));
+    }
+
+    queuedTaskCount.fetch_add (1);
+
+    // a worker going to sleep increments sleepingWorkerCount before checking queuedTaskCount,
+    // so either it sees the new task or this sees it sleeping
+    if (sleepingWorkerCount.load () > 0) {
+        {
+            std::lock_guard<std::mutex> lock (sleepMutex);
+        }
+        wakeUp.notify_one ();
+    }
+}
+
+
+bool ThreadPool::TryRunOneTask ()
+{
+    std::optional<Task> task = TryPopTask (GetCurrentWorkerIndex ());
+    if (!task.has_value ()) {
+        return false;
+    }
+
+    RunTask (*task);
+    return true;
+}
+
+
+std::optional<uint32_t> ThreadPool::GetCurrentWorkerIndex () const
+{
+    if (currentWorker.pool != this) {
+        return std::nullopt;
+    }
+
+    return currentWorker.workerIndex;
+}
+
+
+void ThreadPool::WorkerThread (uint32_t workerIndex)
+{
+    currentWorker.pool        = this;
+    currentWorker.workerIndex = workerIndex;
+
+    while (true) {
+        std::optional<Task> task = TryPopTask (workerIndex);
+        if (task.has_value ()) {
+            RunTask (*task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock (sleepMutex);
+
+        sleepingWorkerCount.fetch_add (1);
+        wakeUp.wait (lock, [&] { return queuedTaskCount.load () > 0 || stopping; });
+        sleepingWorkerCount.fetch_sub (1);
+
+        if (stopping && queuedTaskCount.load () == 0) {
+            return;
+        }
+    }
+}
+
+
+std::optional<ThreadPool::Task> ThreadPool::TryPopTask (std::optional<uint32_t> workerIndex)
+{
+    if (queuedTaskCount.load () == 0) {
+        return std::nullopt;
+    }
+
+    const auto popBack = [&] (TaskQueue& queue) -> std::optional<Task> {
+        std::lock_guard<std::mutex> lock (queue.mutex);
+        if (queue.tasks.empty ()) {
+            return std::nullopt;
+        }
+        Task task = std::move (queue.tasks.back ());
+        queue.tasks.pop_back ();
+        return task;
+    };
+
+    const auto popFront = [&] (TaskQueue& queue) -> std::optional<Task> {
+        std::lock_guard<std::mutex> lock (queue.mutex);
+        if (queue.tasks.empty ()) {
+            return std::nullopt;
+        }
+        Task task = std::move (queue.tasks.front ());
+        queue.tasks.pop_front ();
+        return task;
+    };
+
+    const uint32_t workerCount = GetWorkerCount ();
+
+    // own tasks newest first, they are likely still in the cache
+    std::optional<Task> task;
+    if (workerIndex.has_value ()) {
+        task = popBack (*queues[*workerIndex]);
+    }
+
+    if (!task.has_value ()) {
+        task = popFront (*queues[workerCount]);
+    }
+
+    // stealing the oldest tasks, they are likely the largest ones
+    const uint32_t firstVictim = workerIndex.has_value () ? *workerIndex + 1 : 0;
+    for (uint32_t i = 0; i < workerCount && !task.has_value (); ++i) {
+        const uint32_t victim = (firstVictim + i) % workerCount;
+        if (workerIndex.has_value () && victim == *workerIndex) {
+            continue;
+        }
+        task = popFront (*queues[victim]);
+    }
+
+    if (task.has_value ()) {
+        queuedTaskCount.fetch_sub (1);
+    }
+
+    return task;
+}
+
+
+void ThreadPool::RunTask (Task& task)
+{
+    try {
+        task ();
+    } catch (std::exception& e) {
+        spdlog::error ("Exception in thread pool task: {}", e.what ());
+        GVK_BREAK_STR ("exception in thread pool task");
+    } catch (...) {
+        spdlog::error ("Unknown exception in thread pool task.");
+        GVK_BREAK_STR ("exception in thread pool task");
+    }
+}
+
+
+void ThreadPool::StartDedicatedThread (Task&& task)
+{
+    std::lock_guard<std::mutex> lock (dedicatedThreadsMutex);
+
+    // threads of finished tasks are joined here, so long running processes dont accumulate them
+    dedicatedThreads.remove_if ([] (std::unique_ptr<DedicatedThread>& dedicatedThread) {
+        if (!dedicatedThread->finished.load ()) {
+            return false;
+        }
+        dedicatedThread->thread.join ();
+        return true;
+    });
+
+    std::unique_ptr<DedicatedThread> dedicatedThread = std::make_unique<DedicatedThread> ();
+
+    DedicatedThread* dedicatedThreadPtr = dedicatedThread.get ();
+    dedicatedThread->thread             = std::thread ([this, dedicatedThreadPtr, task = std::move (task)] () mutable {
+        RunTask (task);
+        dedicatedThreadPtr->finished.store (true);
+    });
+
+    dedicatedThreads.push_back (std::move (dedicatedThread));
+}
+
+
+TaskGroup::TaskGroup (ThreadPool& pool)
+    : pool (pool)
+    , pendingTaskCount (0)
+{
+}
+
+
+TaskGroup::~TaskGroup ()
+{
+    try {
+        Wait ();
+    } catch (std::exception& e) {
+        spdlog::error ("Exception in task group was not waited for: {}", e.what ());
+        GVK_BREAK_STR ("exception in task group was not waited for");
+    } catch (...) {
+        spdlog::error ("Unknown exception in task group was not waited for.");
+        GVK_BREAK_STR ("exception in task group was not waited for");
+    }
+}
+
+
+void TaskGroup::Run (std::function<void ()>&& task)
+{
+    pendingTaskCount.fetch_add (1);
+
+    pool.Submit ([this, task = std::move (task)] {
+        std::exception_ptr taskException;
+        try {
+            task ();
+        } catch (...) {
+            taskException = std::current_exception ();
+        }
+        OnTaskFinished (taskException);
+    });
+}
+
+
+void TaskGroup::Wait ()
+{
+    Utils::TraceScope traceScope ("TaskGroup::Wait", "ThreadPool");
+
+    while (pendingTaskCount.load () > 0) {
+        if (pool.TryRunOneTask ()) {
+            continue;
+        }
+
+        // the remaining tasks are running on other threads, they may still queue tasks to help with
+        std::unique_lock<std::mutex> lock (mutex);
+        finished.wait_for (lock, std::chrono::milliseconds (1), [&] { return pendingTaskCount.load () == 0; });
+    }
+
+    std::lock_guard<std::mutex> lock (mutex);
+    if (exception != nullptr) {
+        std::exception_ptr firstException = exception;
+        exception                         = nullptr;
+        std::rethrow_exception (firstException);
+    }
+}
+
+
+void TaskGroup::OnTaskFinished (std::exception_ptr taskException)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    if (taskException != nullptr && exception == nullptr) {
+        exception = taskException;
+    }
+
+    // under the lock, so the group cannot be destroyed between the decrement and the notification
+    if (pendingTaskCount.fetch_sub (1) == 1) {
+        finished.notify_all ();
+    }
+}
+
+} // namespace Utils
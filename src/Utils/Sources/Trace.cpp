@@ -0,0 +1,255 @@
+#include "Trace.hpp"
+
+#include "CommandLineFlag.hpp"
+#include "Time.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+
+namespace Utils {
+
+namespace Tracing {
+
+std::atomic<bool> enabled (false);
+
+} // namespace Tracing
+
+
+namespace {
+
+constexpr uint64_t RingCapacity = 1 << 16;
+
+
+struct Event {
+    const char* name;
+    const char* category;
+    uint64_t    beginNanoseconds;
+    uint64_t    durationNanoseconds;
+    char        phase;
+};
+
+
+struct ThreadBuffer {
+    uint32_t                 threadId;
+    std::unique_ptr<Event[]> events;
+
+    // written only by the owner thread
+    std::atomic<uint64_t> writeIndex;
+
+    // events before this index were dropped by ClearTrace
+    std::atomic<uint64_t> firstIndex;
+
+    ThreadBuffer (uint32_t threadId)
+        : threadId (threadId)
+        , events (new Event[RingCapacity])
+        , writeIndex (0)
+        , firstIndex (0)
+    {
+    }
+};
+
+
+// buffers outlive their threads, so events of finished threads are still exported
+struct Registry {
+    std::mutex                                 mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+
+Registry& GetRegistry ()
+{
+    static Registry registry;
+    return registry;
+}
+
+
+thread_local ThreadBuffer* currentThreadBuffer = nullptr;
+
+
+ThreadBuffer& GetThreadBuffer ()
+{
+    if (currentThreadBuffer == nullptr) {
+        Registry& registry = GetRegistry ();
+
+        std::lock_guard<std::mutex> guard (registry.mutex);
+        registry.buffers.push_back (std::make_unique<ThreadBuffer> (static_cast<uint32_t> (registry.buffers.size () + 1)));
+        currentThreadBuffer = registry.buffers.back ().get ();
+    }
+
+    return *currentThreadBuffer;
+}
+
+
+void AddEvent (const Event& event)
+{
+    ThreadBuffer& buffer = GetThreadBuffer ();
+
+    const uint64_t index = buffer.writeIndex.load (std::memory_order_relaxed);
+
+    buffer.events[index % RingCapacity] = event;
+    buffer.writeIndex.store (index + 1, std::memory_order_release);
+}
+
+
+void AppendEscaped (std::ostream& os, const char* str)
+{
+    for (const char* c = str; *c != '\0'; ++c) {
+        switch (*c) {
+            case '"': os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n"; break;
+            case '\r': os << "\\r"; break;
+            case '\t': os << "\\t"; break;
+            default:
+                if (static_cast<unsigned char> (*c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf (escaped, sizeof (escaped), "\\u%04x", static_cast<unsigned int> (*c));
+                    os << escaped;
+                } else {
+                    os << *c;
+                }
+                break;
+        }
+    }
+}
+
+
+void AppendMicroseconds (std::ostream& os, uint64_t nanoseconds)
+{
+    char formatted[32];
+    std::snprintf (formatted, sizeof (formatted), "%llu.%03u", static_cast<unsigned long long> (nanoseconds / 1000), static_cast<unsigned int> (nanoseconds % 1000));
+    os << formatted;
+}
+
+
+void AppendEvent (std::ostream& os, const Event& event, uint32_t threadId)
+{
+    os << "{\"name\":\"";
+    AppendEscaped (os, event.name);
+    os << "\",\"cat\":\"";
+    AppendEscaped (os, event.category);
+    os << "\",\"ph\":\"" << event.phase << "\",\"ts\":";
+    AppendMicroseconds (os, event.beginNanoseconds);
+
+    if (event.phase == 'X') {
+        os << ",\"dur\":";
+        AppendMicroseconds (os, event.durationNanoseconds);
+    } else if (event.phase == 'i') {
+        os << ",\"s\":\"t\"";
+    }
+
+    os << ",\"pid\":1,\"tid\":" << threadId << "}";
+}
+
+
+Utils::CommandLineOnOffCallbackFlag traceFlag ("--trace", "Record CPU trace events and write them to trace.json on exit.", [] {
+    // the registry has to be constructed before registering the exit handler, so it is destroyed after the export
+    GetRegistry ();
+
+    SetTracingEnabled (true);
+
+    std::atexit ([] {
+        ExportTrace ("trace.json");
+    });
+});
+
+} // namespace
+
+
+namespace Tracing {
+
+void AddComplete (const char* name, const char* category, uint64_t beginNanoseconds, uint64_t endNanoseconds)
+{
+    AddEvent (Event { name, category, beginNanoseconds, endNanoseconds - beginNanoseconds, 'X' });
+}
+
+
+uint64_t GetNanoseconds ()
+{
+    return GVK::TimePoint::SinceApplicationStart ();
+}
+
+} // namespace Tracing
+
+
+void SetTracingEnabled (bool value)
+{
+    Tracing::enabled.store (value, std::memory_order_relaxed);
+}
+
+
+void TraceInstant (const char* name, const char* category)
+{
+    if (IsTracingEnabled ()) {
+        AddEvent (Event { name, category, Tracing::GetNanoseconds (), 0, 'i' });
+    }
+}
+
+
+void ClearTrace ()
+{
+    Registry& registry = GetRegistry ();
+
+    std::lock_guard<std::mutex> guard (registry.mutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry.buffers) {
+        buffer->firstIndex.store (buffer->writeIndex.load (std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+
+std::string GetTraceJSON ()
+{
+    Registry& registry = GetRegistry ();
+
+    std::ostringstream os;
+    os << "{\"traceEvents\":[";
+
+    bool first = true;
+
+    std::lock_guard<std::mutex> guard (registry.mutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry.buffers) {
+        const uint64_t writeIndex = buffer->writeIndex.load (std::memory_order_acquire);
+        const uint64_t firstIndex = std::max (buffer->firstIndex.load (std::memory_order_relaxed), writeIndex > RingCapacity ? writeIndex - RingCapacity : 0);
+
+        for (uint64_t index = firstIndex; index < writeIndex; ++index) {
+            if (!first) {
+                os << ",";
+            }
+            first = false;
+
+            os << "\n";
+            AppendEvent (os, buffer->events[index % RingCapacity], buffer->threadId);
+        }
+    }
+
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return os.str ();
+}
+
+
+bool ExportTrace (const std::filesystem::path& filePath)
+{
+    std::ofstream file (filePath, std::ios::binary);
+    if (!file.is_open ()) {
+        spdlog::error ("Failed to open trace file \"{}\".", filePath.string ());
+        return false;
+    }
+
+    file << GetTraceJSON ();
+
+    spdlog::info ("Trace written to \"{}\".", filePath.string ());
+
+    return true;
+}
+
+} // namespace Utils
@@ -9,15 +9,62 @@
 #pragma warning(pop)
 
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace GVK {
 
 class VULKANWRAPPER_API Allocator : public VulkanObject {
+public:
+    // uniform buffers up to this size are allocated from their own pool
+    static constexpr VkDeviceSize SmallUniformBufferMaxSize = 64 * 1024;
+
+    struct PoolStatistics {
+        VkDeviceSize size;       // of the blocks
+        VkDeviceSize unusedSize; // in the blocks
+        size_t       allocationCount;
+        size_t       blockCount;
+    };
+
+    struct HeapBudget {
+        VkDeviceSize usage;  // estimated from the allocations without VK_EXT_memory_budget
+        VkDeviceSize budget; // usage above this may fail or be slow
+    };
+
+    struct Statistics {
+        VkDeviceSize usedBytes;
+        VkDeviceSize unusedBytes; // allocated in blocks, but not used by allocations
+        uint32_t     blockCount;
+        uint32_t     allocationCount;
+        uint32_t     unusedRangeCount;
+
+        // 0 when the unused memory is one range, close to 1 when it is split to many small ranges
+        double fragmentation;
+
+        PoolStatistics smallUniformBuffers;
+        PoolStatistics renderTargets;
+
+        std::vector<HeapBudget> heaps;
+    };
+
+    struct DefragmentationResult {
+        VkDeviceSize      bytesMoved;
+        VkDeviceSize      bytesFreed;
+        uint32_t          allocationsMoved;
+        uint32_t          blocksFreed;
+        std::vector<bool> moved; // per allocation given to Defragment, their resources have to be bound again
+    };
+
 private:
     GVK::MovablePtr<VmaAllocator> handle;
+    bool                          memoryBudgetEnabled;
+
+    GVK::MovablePtr<VmaPool> smallUniformBufferPool;
+    GVK::MovablePtr<VmaPool> renderTargetPool;
 
 public:
-    Allocator (VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device);
+    // memoryBudgetEnabled only if VK_EXT_memory_budget is enabled on the device, see DeviceObject
+    Allocator (VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device, bool memoryBudgetEnabled = false);
     Allocator (Allocator&&) = default;
     Allocator& operator= (Allocator&&) = default;
 
@@ -28,6 +75,24 @@ public:
     virtual VkObjectType GetObjectTypeForName () const override { throw std::runtime_error ("Cannot name VmaAllocator."); }
 
     operator VmaAllocator () const { return handle; }
+
+    bool IsMemoryBudgetEnabled () const { return memoryBudgetEnabled; }
+
+    // VK_NULL_HANDLE for the default pools, resources fall back to those if the pool has an incompatible memory type
+    VmaPool GetUniformBufferPool (VkDeviceSize size) const { return (size <= SmallUniformBufferMaxSize) ? smallUniformBufferPool.Get () : VK_NULL_HANDLE; }
+    VmaPool GetRenderTargetPool () const { return renderTargetPool.Get (); }
+
+    // the name is copied, the allocation must be created with VMA_ALLOCATION_CREATE_USER_DATA_COPY_STRING_BIT
+    void        SetAllocationName (VmaAllocation allocation, const std::string& name) const;
+    std::string GetAllocationName (VmaAllocation allocation) const;
+
+    VkDeviceSize GetAllocationSize (VmaAllocation allocation) const;
+
+    Statistics GetStatistics () const;
+
+    // moves host visible allocations to fill the gaps in their blocks, the allocations must not be used by the device
+    // allocations in device local memory are not moved
+    DefragmentationResult Defragment (const std::vector<VmaAllocation>& allocations) const;
 };
 
 } // namespace GVK
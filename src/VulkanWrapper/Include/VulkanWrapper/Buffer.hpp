@@ -7,6 +7,8 @@
 #include "Utils/MovablePtr.hpp"
 #include "VulkanObject.hpp"
 
+#include <vector>
+
 #pragma warning (push, 0)
 #include "vk_mem_alloc.h"
 #pragma warning(pop)
@@ -19,6 +21,8 @@ private:
     GVK::MovablePtr<VkBuffer>      handle;
     GVK::MovablePtr<VmaAllocation> allocationHandle;
     size_t                         size;
+    VkBufferUsageFlags             usageFlags;
+    std::vector<uint32_t>          concurrentQueueFamilies;
 
 public:
     enum class MemoryLocation {
@@ -26,7 +30,9 @@ public:
         CPU
     };
 
-    Buffer (VmaAllocator allocator, size_t bufferSize, VkBufferUsageFlags usageFlags, MemoryLocation loc);
+    // with more than one queue family in concurrentQueueFamilies the buffer is created with VK_SHARING_MODE_CONCURRENT
+    // the default pools are used if pool is VK_NULL_HANDLE or its memory type is not suitable, see Allocator
+    Buffer (VmaAllocator allocator, size_t bufferSize, VkBufferUsageFlags usageFlags, MemoryLocation loc, const std::vector<uint32_t>& concurrentQueueFamilies = {}, VmaPool pool = VK_NULL_HANDLE);
     Buffer (Buffer&&) = default;
     Buffer& operator= (Buffer&&) = default;
 
@@ -39,13 +45,20 @@ public:
     operator VkBuffer () const { return handle; }
 
     operator VmaAllocation () const { return allocationHandle; }
+
+    // the allocation was moved by Allocator::Defragment, the buffer is recreated and bound to the new place
+    // descriptors and mappings of the previous buffer are invalid after this
+    void BindMovedAllocation (VkDevice device);
+
+private:
+    VkBufferCreateInfo GetCreateInfo () const;
 };
 
 
 class VULKANWRAPPER_API UniformBuffer : public Buffer {
 public:
-    UniformBuffer (VmaAllocator allocator, size_t bufferSize, VkBufferUsageFlags usageFlags, MemoryLocation loc)
-        : Buffer (allocator, bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | usageFlags, loc)
+    UniformBuffer (VmaAllocator allocator, size_t bufferSize, VkBufferUsageFlags usageFlags, MemoryLocation loc, const std::vector<uint32_t>& concurrentQueueFamilies = {}, VmaPool pool = VK_NULL_HANDLE)
+        : Buffer (allocator, bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | usageFlags, loc, concurrentQueueFamilies, pool)
     {
     }
 };
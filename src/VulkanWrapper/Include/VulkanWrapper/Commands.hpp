@@ -348,6 +348,32 @@ public:
 };
 
 
+class VULKANWRAPPER_API CommandNextSubpass : public Command {
+private:
+    VkSubpassContents contents;
+
+public:
+    CommandNextSubpass (VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE)
+        : contents (contents)
+    {
+    }
+
+    virtual void Record (CommandBuffer& commandBuffer) override
+    {
+        vkCmdNextSubpass (commandBuffer.GetHandle (), contents);
+    }
+
+    virtual bool IsEquivalent (const Command& other) override
+    {
+        if (auto otherCommand = dynamic_cast<const CommandNextSubpass*> (&other)) {
+            return contents == otherCommand->contents;
+        }
+
+        return false;
+    }
+};
+
+
 class VULKANWRAPPER_API CommandBeginRenderPass : public Command {
 private:
     VkRenderPassBeginInfo     renderPassBegin;
@@ -390,6 +416,84 @@ public:
 };
 
 
+// VK_KHR_dynamic_rendering, the attachments are image views instead of a render pass and a framebuffer
+class VULKANWRAPPER_API CommandBeginRendering : public Command {
+private:
+    PFN_vkCmdBeginRenderingKHR                cmdBeginRendering;
+    std::vector<VkRenderingAttachmentInfoKHR> colorAttachments;
+    VkRenderingInfoKHR                        renderingInfo;
+
+public:
+    CommandBeginRendering (PFN_vkCmdBeginRenderingKHR                       cmdBeginRendering,
+                           VkRect2D                                         renderArea,
+                           const std::vector<VkRenderingAttachmentInfoKHR>& colorAttachments_)
+        : cmdBeginRendering (cmdBeginRendering)
+        , colorAttachments (colorAttachments_)
+        , renderingInfo ({})
+    {
+        renderingInfo.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+        renderingInfo.pNext                = nullptr;
+        renderingInfo.flags                = 0;
+        renderingInfo.renderArea           = renderArea;
+        renderingInfo.layerCount           = 1;
+        renderingInfo.viewMask             = 0;
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t> (colorAttachments.size ());
+        renderingInfo.pColorAttachments    = colorAttachments.data ();
+        renderingInfo.pDepthAttachment     = nullptr;
+        renderingInfo.pStencilAttachment   = nullptr;
+    }
+
+    virtual void Record (CommandBuffer& commandBuffer) override
+    {
+        cmdBeginRendering (commandBuffer.GetHandle (), &renderingInfo);
+    }
+
+    virtual bool IsEquivalent (const Command& other) override
+    {
+        if (auto otherCommand = dynamic_cast<const CommandBeginRendering*> (&other)) {
+            // ignore VkClearValue
+            if (colorAttachments.size () != otherCommand->colorAttachments.size ()) {
+                return false;
+            }
+            for (size_t i = 0; i < colorAttachments.size (); ++i) {
+                if (colorAttachments[i].imageView != otherCommand->colorAttachments[i].imageView) {
+                    return false;
+                }
+            }
+            return renderingInfo.renderArea.extent.width == otherCommand->renderingInfo.renderArea.extent.width && renderingInfo.renderArea.extent.height == otherCommand->renderingInfo.renderArea.extent.height && renderingInfo.renderArea.offset.x == otherCommand->renderingInfo.renderArea.offset.x && renderingInfo.renderArea.offset.y == otherCommand->renderingInfo.renderArea.offset.y;
+        }
+
+        return false;
+    }
+};
+
+
+class VULKANWRAPPER_API CommandEndRendering : public Command {
+private:
+    PFN_vkCmdEndRenderingKHR cmdEndRendering;
+
+public:
+    CommandEndRendering (PFN_vkCmdEndRenderingKHR cmdEndRendering)
+        : cmdEndRendering (cmdEndRendering)
+    {
+    }
+
+    virtual void Record (CommandBuffer& commandBuffer) override
+    {
+        cmdEndRendering (commandBuffer.GetHandle ());
+    }
+
+    virtual bool IsEquivalent (const Command& other) override
+    {
+        if (auto otherCommand = dynamic_cast<const CommandEndRendering*> (&other)) {
+            return true;
+        }
+
+        return false;
+    }
+};
+
+
 class VULKANWRAPPER_API CommandBindPipeline : public Command {
 private:
     VkPipelineBindPoint pipelineBindPoint;
@@ -721,6 +825,134 @@ public:
     }
 };
 
+
+class VULKANWRAPPER_API CommandResetQueryPool : public Command {
+private:
+    VkQueryPool queryPool;
+    uint32_t    firstQuery;
+    uint32_t    queryCount;
+
+public:
+    CommandResetQueryPool (VkQueryPool queryPool,
+                           uint32_t    firstQuery,
+                           uint32_t    queryCount)
+        : queryPool (queryPool)
+        , firstQuery (firstQuery)
+        , queryCount (queryCount)
+    {
+    }
+
+    virtual void Record (CommandBuffer& commandBuffer) override
+    {
+        vkCmdResetQueryPool (commandBuffer.GetHandle (), queryPool, firstQuery, queryCount);
+    }
+
+    virtual bool IsEquivalent (const Command& other) override
+    {
+        if (auto otherCommand = dynamic_cast<const CommandResetQueryPool*> (&other)) {
+            return queryPool == otherCommand->queryPool &&
+                   firstQuery == otherCommand->firstQuery &&
+                   queryCount == otherCommand->queryCount;
+        }
+
+        return false;
+    }
+};
+
+
+class VULKANWRAPPER_API CommandWriteTimestamp : public Command {
+private:
+    VkPipelineStageFlagBits pipelineStage;
+    VkQueryPool             queryPool;
+    uint32_t                query;
+
+public:
+    CommandWriteTimestamp (VkPipelineStageFlagBits pipelineStage,
+                           VkQueryPool             queryPool,
+                           uint32_t                query)
+        : pipelineStage (pipelineStage)
+        , queryPool (queryPool)
+        , query (query)
+    {
+    }
+
+    virtual void Record (CommandBuffer& commandBuffer) override
+    {
+        vkCmdWriteTimestamp (commandBuffer.GetHandle (), pipelineStage, queryPool, query);
+    }
+
+    virtual bool IsEquivalent (const Command& other) override
+    {
+        if (auto otherCommand = dynamic_cast<const CommandWriteTimestamp*> (&other)) {
+            return pipelineStage == otherCommand->pipelineStage &&
+                   queryPool == otherCommand->queryPool &&
+                   query == otherCommand->query;
+        }
+
+        return false;
+    }
+};
+
+
+class VULKANWRAPPER_API CommandSetViewport : public Command {
+private:
+    VkViewport viewport;
+
+public:
+    CommandSetViewport (const VkViewport& viewport)
+        : viewport (viewport)
+    {
+    }
+
+    virtual void Record (CommandBuffer& commandBuffer) override
+    {
+        vkCmdSetViewport (commandBuffer.GetHandle (), 0, 1, &viewport);
+    }
+
+    virtual bool IsEquivalent (const Command& other) override
+    {
+        if (auto otherCommand = dynamic_cast<const CommandSetViewport*> (&other)) {
+            return viewport.x == otherCommand->viewport.x &&
+                   viewport.y == otherCommand->viewport.y &&
+                   viewport.width == otherCommand->viewport.width &&
+                   viewport.height == otherCommand->viewport.height &&
+                   viewport.minDepth == otherCommand->viewport.minDepth &&
+                   viewport.maxDepth == otherCommand->viewport.maxDepth;
+        }
+
+        return false;
+    }
+};
+
+
+class VULKANWRAPPER_API CommandSetScissor : public Command {
+private:
+    VkRect2D scissor;
+
+public:
+    CommandSetScissor (const VkRect2D& scissor)
+        : scissor (scissor)
+    {
+    }
+
+    virtual void Record (CommandBuffer& commandBuffer) override
+    {
+        vkCmdSetScissor (commandBuffer.GetHandle (), 0, 1, &scissor);
+    }
+
+    virtual bool IsEquivalent (const Command& other) override
+    {
+        if (auto otherCommand = dynamic_cast<const CommandSetScissor*> (&other)) {
+            return scissor.offset.x == otherCommand->scissor.offset.x &&
+                   scissor.offset.y == otherCommand->scissor.offset.y &&
+                   scissor.extent.width == otherCommand->scissor.extent.width &&
+                   scissor.extent.height == otherCommand->scissor.extent.height;
+        }
+
+        return false;
+    }
+};
+
 } // namespace GVK
 
 #endif
@@ -22,7 +22,8 @@ private:
 public:
     ComputePipeline (VkDevice            device,
                      VkPipelineLayout    pipelineLayout,
-                     const ShaderModule& shaderModule);
+                     const ShaderModule& shaderModule,
+                     VkPipelineCache     pipelineCache = VK_NULL_HANDLE);
 
     ComputePipeline (ComputePipeline&&) = default;
     ComputePipeline& operator= (ComputePipeline&&) = default;
@@ -0,0 +1,70 @@
+#ifndef DESCRIPTORALLOCATOR_HPP
+#define DESCRIPTORALLOCATOR_HPP
+
+#include "VulkanWrapper/VulkanWrapperAPI.hpp"
+
+#include "Utils/Noncopyable.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <vector>
+
+namespace GVK {
+
+class DescriptorPool;
+
+// Allocates descriptor sets from a growing list of shared descriptor pools.
+// Each arena (e.g. one per frame in flight) has its own pools, so an arena can be reset in bulk
+// without freeing descriptor sets one by one.
+class VULKANWRAPPER_API DescriptorAllocator : public Noncopyable, public Nonmovable {
+public:
+    struct Allocation {
+        VkDescriptorPool pool;
+        VkDescriptorSet  descriptorSet;
+    };
+
+private:
+    struct Arena {
+        std::vector<std::unique_ptr<DescriptorPool>> pools;
+        size_t                                       currentPool       = 0;
+        uint32_t                                     allocatedSetCount = 0;
+    };
+
+    VkDevice           device;
+    std::vector<Arena> arenas;
+
+    // descriptor counts of a single pool, scaled by the growth factor for every new pool in an arena
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    uint32_t                          setsPerPool;
+
+public:
+    DescriptorAllocator (VkDevice device, uint32_t arenaCount = 1, uint32_t setsPerPool = 64);
+
+    virtual ~DescriptorAllocator () override;
+
+    // sizes the pools created from now on, aggregateSizes and setCount should cover the descriptor sets of one arena
+    void SetPoolSizes (const std::vector<VkDescriptorPoolSize>& aggregateSizes, uint32_t setCount);
+
+    Allocation Allocate (uint32_t arenaIndex, VkDescriptorSetLayout layout);
+
+    // descriptor sets allocated from the arena become invalid, pools are kept for reuse
+    void Reset (uint32_t arenaIndex);
+    void Reset ();
+
+    VkDevice GetDevice () const { return device; }
+    uint32_t GetArenaCount () const { return static_cast<uint32_t> (arenas.size ()); }
+    uint32_t GetPoolCount () const;
+    uint32_t GetAllocatedSetCount () const;
+
+    // of the first pool of an arena
+    const std::vector<VkDescriptorPoolSize>& GetPoolSizes () const { return poolSizes; }
+    uint32_t                                 GetSetsPerPool () const { return setsPerPool; }
+
+private:
+    DescriptorPool& CreatePool (Arena& arena);
+};
+
+} // namespace GVK
+
+#endif
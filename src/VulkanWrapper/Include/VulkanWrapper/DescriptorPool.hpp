@@ -45,7 +45,13 @@ public:
 
     virtual void* GetHandleForName () const override { return handle; }
 
-    virtual VkObjectType GetObjectTypeForName () const override { return VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT; };
+    virtual VkObjectType GetObjectTypeForName () const override { return VK_OBJECT_TYPE_DESCRIPTOR_POOL; };
+
+    // returns all descriptor sets allocated from this pool
+    void Reset ()
+    {
+        vkResetDescriptorPool (device, handle, 0);
+    }
 
     operator VkDescriptorPool () const
     {
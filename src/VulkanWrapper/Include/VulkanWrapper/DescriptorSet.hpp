@@ -6,6 +6,7 @@
 #include "Utils/Assert.hpp"
 #include "Utils/MovablePtr.hpp"
 
+#include "DescriptorAllocator.hpp"
 #include "DescriptorPool.hpp"
 #include "DescriptorSetLayout.hpp"
 
@@ -42,6 +43,17 @@ public:
     {
     }
 
+    // the descriptor set is valid until the arena of the allocator is reset
+    DescriptorSet (DescriptorAllocator& allocator, uint32_t arenaIndex, VkDescriptorSetLayout layout)
+        : device (allocator.GetDevice ())
+        , descriptorPool (VK_NULL_HANDLE)
+        , handle (VK_NULL_HANDLE)
+    {
+        const DescriptorAllocator::Allocation allocation = allocator.Allocate (arenaIndex, layout);
+        descriptorPool                                   = allocation.pool;
+        handle                                           = allocation.descriptorSet;
+    }
+
     virtual ~DescriptorSet () override
     {
         // only free for VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
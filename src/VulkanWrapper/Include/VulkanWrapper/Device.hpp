@@ -25,10 +25,20 @@ public:
 };
 
 
+// device level functions of VK_KHR_dynamic_rendering, nullptr if the extension is not enabled
+struct DynamicRenderingFunctions {
+    PFN_vkCmdBeginRenderingKHR cmdBeginRendering;
+    PFN_vkCmdEndRenderingKHR   cmdEndRendering;
+};
+
+
 class VULKANWRAPPER_API DeviceObject : public VulkanObject, public Device {
 private:
     VkPhysicalDevice          physicalDevice;
     GVK::MovablePtr<VkDevice> handle;
+    bool                      timelineSemaphoreEnabled;
+    bool                      memoryBudgetEnabled;
+    DynamicRenderingFunctions dynamicRenderingFunctions;
 
 public:
     DeviceObject (VkPhysicalDevice physicalDevice, std::vector<uint32_t> queueFamilyIndices, std::vector<const char*> requestedDeviceExtensions);
@@ -49,6 +59,16 @@ public:
         vkDeviceWaitIdle (handle);
     }
 
+    bool IsTimelineSemaphoreEnabled () const { return timelineSemaphoreEnabled; }
+
+    // VK_EXT_memory_budget is enabled whenever the physical device supports it, see Allocator
+    bool IsMemoryBudgetEnabled () const { return memoryBudgetEnabled; }
+
+    // VK_KHR_dynamic_rendering is enabled whenever the physical device supports it
+    bool IsDynamicRenderingEnabled () const { return dynamicRenderingFunctions.cmdBeginRendering != nullptr; }
+
+    const DynamicRenderingFunctions& GetDynamicRenderingFunctions () const { return dynamicRenderingFunctions; }
+
 private:
     uint32_t FindMemoryType (uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
 };
@@ -2,11 +2,15 @@
 #define DEVICEEXTRA_HPP
 
 #include <memory>
+#include <vector>
 
+#include "Allocator.hpp"
 #include "Instance.hpp"
 #include "CommandPool.hpp"
 #include "Device.hpp"
 #include "Queue.hpp"
+#include "ObjectCache.hpp"
+#include "PipelineCache.hpp"
 
 #pragma warning (push, 0)
 #include "vk_mem_alloc.h"
@@ -21,30 +25,92 @@ public:
     CommandPool& commandPool;
     Queue&       graphicsQueue;
     Queue&       presentationQueue;
-    VmaAllocator allocator;
+    Allocator&   allocator;
 
-    DeviceExtra (Instance& instance, Device& device, CommandPool& commandPool, VmaAllocator allocator, Queue& graphicsQueue, Queue& presentationQueue = dummyQueue)
+    // optional, set when the device has a dedicated compute queue family
+    Queue*                computeQueue;
+    CommandPool*          computeCommandPool;
+    std::vector<uint32_t> concurrentQueueFamilies;
+
+    // shared samplers, render passes and framebuffers, internally synchronized
+    std::unique_ptr<ObjectCache> objectCache;
+
+    // used for every pipeline created by the render graph
+    std::unique_ptr<PipelineCache> pipelineCache;
+
+    // nanoseconds per timestamp tick, zero when timestamps are not supported
+    float    timestampPeriod;
+    uint32_t timestampValidBits;
+
+    // set when render operations should use VK_KHR_dynamic_rendering instead of render passes and framebuffers
+    DynamicRenderingFunctions dynamicRenderingFunctions;
+
+    DeviceExtra (Instance& instance, Device& device, CommandPool& commandPool, Allocator& allocator, Queue& graphicsQueue, Queue& presentationQueue = dummyQueue)
         : instance (instance)
         , device (device)
         , commandPool (commandPool)
         , graphicsQueue (graphicsQueue)
         , presentationQueue (presentationQueue)
         , allocator (allocator)
+        , computeQueue (nullptr)
+        , computeCommandPool (nullptr)
+        , objectCache (std::make_unique<ObjectCache> (device))
+        , pipelineCache (std::make_unique<PipelineCache> (device))
+        , timestampPeriod (0.0f)
+        , timestampValidBits (0)
+        , dynamicRenderingFunctions { nullptr, nullptr }
+    {
+    }
+
+    void SetAsyncComputeQueue (Queue& queue, CommandPool& pool, const std::vector<uint32_t>& queueFamiliesToShareWith)
+    {
+        computeQueue            = &queue;
+        computeCommandPool      = &pool;
+        concurrentQueueFamilies = queueFamiliesToShareWith;
+    }
+
+    bool HasAsyncComputeQueue () const { return computeQueue != nullptr && computeCommandPool != nullptr; }
+
+    void SetTimestampProperties (float period, uint32_t validBits)
     {
+        timestampPeriod    = period;
+        timestampValidBits = validBits;
     }
 
+    bool     SupportsTimestamps () const { return timestampPeriod > 0.0f && timestampValidBits > 0; }
+    float    GetTimestampPeriod () const { return timestampPeriod; }
+    uint32_t GetTimestampValidBits () const { return timestampValidBits; }
+
+    void SetDynamicRenderingFunctions (const DynamicRenderingFunctions& functions)
+    {
+        dynamicRenderingFunctions = functions;
+    }
+
+    bool                             SupportsDynamicRendering () const { return dynamicRenderingFunctions.cmdBeginRendering != nullptr && dynamicRenderingFunctions.cmdEndRendering != nullptr; }
+    const DynamicRenderingFunctions& GetDynamicRenderingFunctions () const { return dynamicRenderingFunctions; }
+
+    // buffers accessed from both the graphics and the async compute queue are created with concurrent sharing
+    const std::vector<uint32_t>& GetConcurrentQueueFamilies () const { return concurrentQueueFamilies; }
+
     const Instance&    GetInstance () const { return instance; }
     const Device&      GetDevice () const { return device; }
     const CommandPool& GetCommandPool () const { return commandPool; }
     const Queue&       GetGraphicsQueue () const { return graphicsQueue; }
     const Queue&       GetPresentationQueue () const { return presentationQueue; }
     VmaAllocator       GetAllocator () const { return allocator; }
+    const Allocator&   GetAllocatorObject () const { return allocator; }
+    const Queue&       GetComputeQueue () const { return (computeQueue != nullptr) ? *computeQueue : graphicsQueue; }
+    const CommandPool& GetComputeCommandPool () const { return (computeCommandPool != nullptr) ? *computeCommandPool : commandPool; }
+    ObjectCache&       GetObjectCache () const { return *objectCache; }
+    PipelineCache&     GetPipelineCache () const { return *pipelineCache; }
 
     Instance&    GetInstance () { return instance; }
     Device&      GetDevice () { return device; }
     CommandPool& GetCommandPool () { return commandPool; }
     Queue&       GetGraphicsQueue () { return graphicsQueue; }
     Queue&       GetPresentationQueue () { return presentationQueue; }
+    Queue&       GetComputeQueue () { return (computeQueue != nullptr) ? *computeQueue : graphicsQueue; }
+    CommandPool& GetComputeCommandPool () { return (computeCommandPool != nullptr) ? *computeCommandPool : commandPool; }
 
     // implementing Device
     virtual      operator VkDevice () const override { return device; }
@@ -19,6 +19,7 @@ private:
     GVK::MovablePtr<VkPipeline> handle;
 
 public:
+    // renderPass is VK_NULL_HANDLE for VK_KHR_dynamic_rendering, the pipeline is created for colorAttachmentFormats instead
     GraphicsPipeline (VkDevice                                              device,
                       uint32_t                                              width,
                       uint32_t                                              height,
@@ -29,7 +30,10 @@ public:
                       const std::vector<VkVertexInputBindingDescription>&   vertexBindingDescriptions,
                       const std::vector<VkVertexInputAttributeDescription>& vertexAttributeDescriptions,
                       VkPrimitiveTopology                                   topology,
-                      bool                                                  blendEnabled = true);
+                      bool                                                  blendEnabled           = true,
+                      VkPipelineCache                                       pipelineCache          = VK_NULL_HANDLE,
+                      uint32_t                                              subpass                = 0,
+                      const std::vector<VkFormat>&                          colorAttachmentFormats = {});
 
     GraphicsPipeline (GraphicsPipeline&&) = default;
     GraphicsPipeline& operator= (GraphicsPipeline&&) = default;
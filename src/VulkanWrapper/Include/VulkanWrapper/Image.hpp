@@ -15,6 +15,7 @@
 namespace GVK {
 
 class ImageBuilder;
+class SharedAllocation;
 
 class VULKANWRAPPER_API Image : public VulkanObject {
 public:
@@ -27,7 +28,8 @@ public:
 
     enum class MemoryLocation {
         GPU,
-        CPU
+        CPU,
+        GPULazilyAllocated // for transient attachments, GPU if the device has no lazily allocated memory
     };
 
 protected:
@@ -43,6 +45,7 @@ private:
     uint32_t height;
     uint32_t depth;
     uint32_t arrayLayers;
+    uint32_t mipLevels;
 
 protected:
     // for InheritedImage
@@ -58,7 +61,9 @@ public:
            VkImageTiling     tiling,
            VkImageUsageFlags usage,
            uint32_t          arrayLayers,
-           MemoryLocation    loc);
+           MemoryLocation    loc,
+           uint32_t          mipLevels = 1,
+           VmaPool           pool      = VK_NULL_HANDLE);
 
     Image (ImageBuilder&);
 
@@ -76,6 +81,7 @@ public:
     uint32_t GetWidth () const { return width; }
     uint32_t GetHeight () const { return height; }
     uint32_t GetDepth () const { return depth; }
+    uint32_t GetMipLevels () const { return mipLevels; }
 
     operator VkImage () const { return handle; }
     operator VmaAllocation () const { return allocationHandle; }
@@ -200,13 +206,29 @@ public:
 
 class VULKANWRAPPER_API Image2D : public Image {
 public:
-    Image2D (VmaAllocator allocator, MemoryLocation loc, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL, VkImageUsageFlags usage = 0, uint32_t arrayLayers = 1)
-        : Image (allocator, VK_IMAGE_TYPE_2D, width, height, 1, format, tiling, usage, arrayLayers, loc)
+    Image2D (VmaAllocator allocator, MemoryLocation loc, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL, VkImageUsageFlags usage = 0, uint32_t arrayLayers = 1, uint32_t mipLevels = 1, VmaPool pool = VK_NULL_HANDLE)
+        : Image (allocator, VK_IMAGE_TYPE_2D, width, height, 1, format, tiling, usage, arrayLayers, loc, mipLevels, pool)
     {
     }
 };
 
 
+// created without memory, BindMemory places it into a SharedAllocation
+// images bound to the same memory must not be used at the same time, the contents are undefined after switching
+// between them, the first use after switching should transition from VK_IMAGE_LAYOUT_UNDEFINED
+class VULKANWRAPPER_API AliasedImage2D : public Image {
+public:
+    AliasedImage2D (VkDevice device, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, uint32_t arrayLayers = 1);
+
+    VkMemoryRequirements GetMemoryRequirements () const;
+
+    void BindMemory (const SharedAllocation& allocation, VkDeviceSize offset);
+
+private:
+    VkDevice device;
+};
+
+
 class VULKANWRAPPER_API Image3D : public Image {
 public:
     Image3D (VmaAllocator allocator, MemoryLocation loc, uint32_t width, uint32_t height, uint32_t depth, VkFormat format, VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL, VkImageUsageFlags usage = 0)
@@ -17,7 +17,7 @@ private:
     GVK::MovablePtr<VkImageView> handle;
 
 public:
-    ImageViewBase (VkDevice device, VkImage image, VkFormat format, VkImageViewType viewType, uint32_t layerIndex = 0, uint32_t layerCount = 1);
+    ImageViewBase (VkDevice device, VkImage image, VkFormat format, VkImageViewType viewType, uint32_t layerIndex = 0, uint32_t layerCount = 1, uint32_t levelCount = 1);
     ImageViewBase (VkDevice device, const Image2D& image, VkImageViewType viewType, uint32_t layerIndex = 0);
 
     ImageViewBase (ImageViewBase&&) = default;
@@ -0,0 +1,93 @@
+#ifndef OBJECTCACHE_HPP
+#define OBJECTCACHE_HPP
+
+#include "VulkanWrapper/VulkanWrapperAPI.hpp"
+
+#include "Utils/Noncopyable.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace GVK {
+
+class Sampler;
+class RenderPass;
+class Framebuffer;
+
+// Shares samplers, render passes and framebuffers created with identical create infos.
+// The cache only holds weak references: an object is destroyed when its last user releases it,
+// and the next request with the same create info creates it again.
+class VULKANWRAPPER_API ObjectCache : public Noncopyable, public Nonmovable {
+public:
+    struct Statistics {
+        uint32_t samplerCount;     // currently alive objects
+        uint32_t renderPassCount;
+        uint32_t framebufferCount;
+        uint64_t requestCount;     // objects requested from the cache, one per object created without it
+        uint64_t createdCount;     // requests that had to create a new object
+    };
+
+private:
+    template<typename T>
+    struct Entries {
+        std::unordered_map<std::string, std::weak_ptr<T>> entries;
+        size_t                                            purgeThreshold = 64;
+    };
+
+    struct FramebufferEntry {
+        std::vector<VkImageView>   attachments;
+        std::weak_ptr<Framebuffer> framebuffer;
+    };
+
+    VkDevice device;
+
+    mutable std::mutex mutex;
+
+    Entries<Sampler>    samplers;
+    Entries<RenderPass> renderPasses;
+
+    std::unordered_map<std::string, FramebufferEntry> framebuffers;
+    size_t                                            framebufferPurgeThreshold;
+
+    uint64_t requestCount;
+    uint64_t createdCount;
+
+public:
+    ObjectCache (VkDevice device);
+
+    virtual ~ObjectCache () override;
+
+    std::shared_ptr<Sampler> GetSampler (const VkSamplerCreateInfo& createInfo);
+    std::shared_ptr<Sampler> GetSampler (VkFilter filter, VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
+
+    std::shared_ptr<RenderPass> GetRenderPass (const std::vector<VkAttachmentDescription>& attachments,
+                                               const std::vector<VkSubpassDescription>&    subpasses,
+                                               const std::vector<VkSubpassDependency>&     subpassDependencies);
+
+    // the framebuffer keeps the render pass alive
+    std::shared_ptr<Framebuffer> GetFramebuffer (const std::shared_ptr<RenderPass>& renderPass,
+                                                 const std::vector<VkImageView>&    attachments,
+                                                 uint32_t                           width,
+                                                 uint32_t                           height);
+
+    Statistics GetStatistics () const;
+
+    VkDevice GetDevice () const { return device; }
+
+    // called when an image view is destroyed, its handle may be reused by the driver,
+    // so framebuffers referring to it must not be returned anymore
+    static void ForgetImageView (VkImageView imageView);
+
+private:
+    void ForgetImageViewImpl (VkImageView imageView);
+};
+
+} // namespace GVK
+
+#endif
@@ -24,6 +24,7 @@ public:
         std::optional<uint32_t> presentation;
         std::optional<uint32_t> transfer;
         std::optional<uint32_t> compute;
+        std::optional<uint32_t> asyncCompute; // compute capable, but no graphics
     };
 
 private:
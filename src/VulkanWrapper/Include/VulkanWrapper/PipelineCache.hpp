@@ -0,0 +1,43 @@
+#ifndef PIPELINECACHE_HPP
+#define PIPELINECACHE_HPP
+
+#include "VulkanWrapper/VulkanWrapperAPI.hpp"
+#include "Utils/MovablePtr.hpp"
+#include "VulkanObject.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace GVK {
+
+// Pipelines created with the cache can reuse the driver's compiled code of earlier, equivalent pipelines.
+// The data can be saved and given to a later run, the driver ignores data from a different device or driver version.
+class VULKANWRAPPER_API PipelineCache : public VulkanObject {
+private:
+    VkDevice                         device;
+    GVK::MovablePtr<VkPipelineCache> handle;
+    std::mutex                       mergeMutex;
+
+public:
+    PipelineCache (VkDevice device, const std::vector<uint8_t>& initialData = {});
+
+    virtual ~PipelineCache () override;
+
+    virtual void* GetHandleForName () const override { return handle; }
+
+    virtual VkObjectType GetObjectTypeForName () const override { return VK_OBJECT_TYPE_PIPELINE_CACHE; }
+
+    operator VkPipelineCache () const { return handle; }
+
+    std::vector<uint8_t> GetData () const;
+
+    // adds the pipelines of previously saved data, must not be called while pipelines are created with the cache
+    void Merge (const std::vector<uint8_t>& data);
+};
+
+} // namespace GVK
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef QUERYPOOL_HPP
+#define QUERYPOOL_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "Utils/Assert.hpp"
+#include "Utils/MovablePtr.hpp"
+#include "VulkanObject.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace GVK {
+
+class /* VULKANWRAPPER_API */ QueryPool : public VulkanObject {
+private:
+    VkDevice                     device;
+    GVK::MovablePtr<VkQueryPool> handle;
+    uint32_t                     queryCount;
+
+public:
+    QueryPool (VkDevice device, VkQueryType queryType, uint32_t queryCount)
+        : device (device)
+        , queryCount (queryCount)
+    {
+        VkQueryPoolCreateInfo createInfo = {};
+        createInfo.sType                 = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType             = queryType;
+        createInfo.queryCount            = queryCount;
+
+        if (GVK_ERROR (vkCreateQueryPool (device, &createInfo, nullptr, &handle) != VK_SUCCESS)) {
+            throw std::runtime_error ("failed to create query pool");
+        }
+    }
+
+    QueryPool (QueryPool&&) = default;
+    QueryPool& operator= (QueryPool&&) = default;
+
+    virtual ~QueryPool () override
+    {
+        vkDestroyQueryPool (device, handle, nullptr);
+        handle = nullptr;
+    }
+
+    virtual void* GetHandleForName () const override { return handle; }
+
+    virtual VkObjectType GetObjectTypeForName () const override { return VK_OBJECT_TYPE_QUERY_POOL; }
+
+    operator VkQueryPool () const
+    {
+        return handle;
+    }
+
+    uint32_t GetQueryCount () const { return queryCount; }
+
+    // does not wait for the queries, returns false when any of them is not available yet
+    bool GetResults (uint32_t firstQuery, uint32_t count, std::vector<uint64_t>& results) const
+    {
+        GVK_ASSERT (firstQuery + count <= queryCount);
+
+        results.resize (count);
+
+        const VkResult result = vkGetQueryPoolResults (device, handle, firstQuery, count, count * sizeof (uint64_t), results.data (), sizeof (uint64_t), VK_QUERY_RESULT_64_BIT);
+
+        GVK_ASSERT (result == VK_SUCCESS || result == VK_NOT_READY);
+
+        return result == VK_SUCCESS;
+    }
+};
+
+} // namespace GVK
+
+#endif
@@ -56,6 +56,16 @@ public:
                  const std::vector<CommandBuffer>&       commandBuffers,
                  const std::vector<VkSemaphore>&          signalSemaphores,
                  VkFence                                  fenceToSignal) const;
+
+    // waitValues and signalValues must match the semaphore vectors in size,
+    // values belonging to binary semaphores are ignored
+    void Submit (const std::vector<VkSemaphore>&          waitSemaphores,
+                 const std::vector<uint64_t>&             waitValues,
+                 const std::vector<VkPipelineStageFlags>& waitDstStageMasks,
+                 const std::vector<CommandBuffer*>&       commandBuffers,
+                 const std::vector<VkSemaphore>&          signalSemaphores,
+                 const std::vector<uint64_t>&             signalValues,
+                 VkFence                                  fenceToSignal) const;
 };
 
 VULKANWRAPPER_API extern Queue dummyQueue;
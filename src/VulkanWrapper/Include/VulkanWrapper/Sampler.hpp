@@ -17,6 +17,9 @@ private:
 
 public:
     Sampler (VkDevice device, VkFilter filter, VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
+    Sampler (VkDevice device, const VkSamplerCreateInfo& createInfo);
+
+    static VkSamplerCreateInfo GetCreateInfo (VkFilter filter, VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
 
     Sampler (Sampler&&) = default;
     Sampler& operator= (Sampler&&) = default;
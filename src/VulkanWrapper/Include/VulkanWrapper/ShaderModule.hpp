@@ -5,13 +5,18 @@
 
 #include "Utils/Assert.hpp"
 #include "Utils/MovablePtr.hpp"
+#include "Utils/Noncopyable.hpp"
 
 #include "ShaderReflection.hpp"
 #include "VulkanObject.hpp"
 
 #include <filesystem>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <set>
+#include <unordered_map>
 
 #include <vulkan/vulkan.h>
 
@@ -39,6 +44,58 @@ VULKANWRAPPER_API
 std::string ShaderKindToString (ShaderKind);
 
 
+// SPIR-V of every GLSL source compiled in this process.
+// The key contains the source, the shader kind and the defines, a precompiled sequence bundle
+// preloads the binaries, so glslang does not run for its shaders at all.
+class VULKANWRAPPER_API ShaderBinaryCache : public Noncopyable {
+public:
+    using Key = uint64_t;
+
+    struct Statistics {
+        uint64_t hitCount;
+        uint64_t missCount; // compiled with glslang
+    };
+
+private:
+    mutable std::mutex                             mutex;
+    std::unordered_map<Key, std::vector<uint32_t>> binaries;
+    Statistics                                     statistics;
+
+public:
+    ShaderBinaryCache ();
+
+    static ShaderBinaryCache& Get ();
+
+    std::optional<std::vector<uint32_t>> Find (Key key);
+
+    void Add (Key key, const std::vector<uint32_t>& binary);
+
+    // ordered by key, so saving them gives the same bytes every time
+    std::map<Key, std::vector<uint32_t>> GetBinaries () const;
+
+    void Clear ();
+
+    Statistics GetStatistics () const;
+};
+
+
+// Values of specialization constants by name, applied when the pipeline is created.
+// Names the shader does not declare are ignored, so the same values can be set on every shader of a pipeline.
+class VULKANWRAPPER_API SpecializationConstants {
+private:
+    std::map<std::string, uint32_t> values; // bits of 32 bit scalars
+
+public:
+    void Set (const std::string& name, float value);
+    void Set (const std::string& name, int32_t value);
+    void Set (const std::string& name, uint32_t value);
+
+    bool IsEmpty () const { return values.empty (); }
+
+    const std::map<std::string, uint32_t>& GetValues () const { return values; }
+};
+
+
 class VULKANWRAPPER_API ShaderModule : public VulkanObject {
 public:
     static constexpr uint32_t ShaderKindCount = 6;
@@ -56,8 +113,10 @@ public:
         std::vector<SR::Input>                inputs;
         std::vector<SR::Output>               outputs;
         std::vector<SR::SubpassInput>         subpassInputs;
+        std::vector<SR::SpecializationConstant> specializationConstants;
 
-        Reflection (const std::vector<uint32_t>& binary);
+        // constant id -> value, arrays sized by specialization constants are reflected with these sizes
+        Reflection (const std::vector<uint32_t>& binary, const std::map<uint32_t, uint32_t>& specializationValues = {});
     };
 
 private:
@@ -75,6 +134,11 @@ private:
 
     Reflection reflection;
 
+    SpecializationConstants               specializationConstants;
+    std::vector<VkSpecializationMapEntry> specializationMapEntries;
+    std::vector<uint32_t>                 specializationData;
+    VkSpecializationInfo                  specializationInfo;
+
 private:
     // dont use this ctor, use factories instead
     ShaderModule (ShaderKind                   shaderKind,
@@ -108,6 +172,12 @@ public:
                                                             const std::vector<std::string>& defines   = {},
                                                             const std::vector<std::string>& undefines = {});
 
+    // compiles into the ShaderBinaryCache without creating a shader module, can be called from any thread
+    static void PrecompileGLSLString (ShaderKind                      shaderKind,
+                                      const std::string&              shaderSource,
+                                      const std::vector<std::string>& defines   = {},
+                                      const std::vector<std::string>& undefines = {});
+
     virtual ~ShaderModule () override;
 
     virtual void* GetHandleForName () const override { return handle; }
@@ -116,6 +186,11 @@ public:
 
     void Reload ();
 
+    // the reflection is updated with the new values, so the sizes of specialization constant sized arrays are known before the pipeline is compiled
+    void SetSpecializationConstants (const SpecializationConstants& values);
+
+    const SpecializationConstants& GetSpecializationConstants () const { return specializationConstants; }
+
     const std::vector<uint32_t>& GetBinary () const { return binary; }
 
     const std::filesystem::path& GetLocation () const { return fileLocation; }
@@ -6,6 +6,7 @@
 #include <memory>
 
 #include <cstdint>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -160,6 +161,16 @@ public:
 };
 
 
+// OpSpecConstant with a constant_id, only 32 bit scalars are supported
+class VULKANWRAPPER_API SpecializationConstant {
+public:
+    std::string name;
+    uint32_t    constantId;
+    FieldType   type;
+    uint32_t    defaultValue; // bits of the value in the binary
+};
+
+
 // constructing a spirv_cross::Compiler is expensive
 class VULKANWRAPPER_API SpirvParser {
 public:
@@ -191,6 +202,13 @@ std::vector<Input> GetInputsFromBinary (SpirvParser& compiler);
 VULKANWRAPPER_API
 std::vector<Output> GetOutputsFromBinary (SpirvParser& compiler);
 
+VULKANWRAPPER_API
+std::vector<SpecializationConstant> GetSpecializationConstantsFromBinary (SpirvParser& compiler);
+
+// constant id -> bits of the value, arrays sized by specialization constants are reflected with these sizes
+VULKANWRAPPER_API
+void SetSpecializationConstantValues (SpirvParser& compiler, const std::map<uint32_t, uint32_t>& values);
+
 VULKANWRAPPER_API
 VkFormat FieldTypeToVkFormat (FieldType fieldType);
 
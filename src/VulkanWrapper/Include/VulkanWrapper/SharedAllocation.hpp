@@ -0,0 +1,37 @@
+#ifndef SHAREDALLOCATION_HPP
+#define SHAREDALLOCATION_HPP
+
+#include "VulkanWrapper/VulkanWrapperAPI.hpp"
+
+#include "Utils/MovablePtr.hpp"
+#include "Utils/Noncopyable.hpp"
+
+#pragma warning (push, 0)
+#include "vk_mem_alloc.h"
+#pragma warning(pop)
+
+#include <vulkan/vulkan.h>
+
+namespace GVK {
+
+// device local memory allocated without a resource, images are bound to it at offsets, see AliasedImage2D
+class VULKANWRAPPER_API SharedAllocation : public Noncopyable {
+private:
+    VmaAllocator                   allocator;
+    GVK::MovablePtr<VmaAllocation> handle;
+    VkDeviceSize                   size;
+
+public:
+    SharedAllocation (VmaAllocator allocator, const VkMemoryRequirements& requirements);
+
+    virtual ~SharedAllocation () override;
+
+    VmaAllocator GetAllocator () const { return allocator; }
+    VkDeviceSize GetSize () const { return size; }
+
+    operator VmaAllocation () const { return handle; }
+};
+
+} // namespace GVK
+
+#endif
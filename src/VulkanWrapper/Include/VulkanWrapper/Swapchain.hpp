@@ -182,34 +182,39 @@ private:
     std::unique_ptr<Image>                    image;
     std::vector<std::unique_ptr<ImageView2D>> imageViews;
     const DeviceExtra&                        device;
-    const uint32_t                            width;
-    const uint32_t                            height;
+    uint32_t                                  width;
+    uint32_t                                  height;
+    uint32_t                                  requestedWidth;
+    uint32_t                                  requestedHeight;
 
 public:
     FakeSwapchain (const DeviceExtra& device, uint32_t width, uint32_t height);
 
+    // simulates resizing the window, the image is recreated with the new extent by the next Recreate
+    void SetRequestedExtent (uint32_t width, uint32_t height);
+
     virtual VkFormat             GetImageFormat () const override { return image->GetFormat (); }
     virtual uint32_t             GetImageCount () const override { return 1; }
     virtual uint32_t             GetWidth () const override { return width; }
     virtual uint32_t             GetHeight () const override { return height; }
     virtual std::vector<VkImage> GetImages () const override { return { *image }; }
-    virtual void                 Recreate () override {}
+    virtual void                 Recreate () override;
 
-    virtual uint32_t GetNextImageIndex (VkSemaphore signalSemaphore, VkFence fenceToSignal = VK_NULL_HANDLE) const override
-    {
-        GVK_ASSERT (signalSemaphore == VK_NULL_HANDLE);
-        GVK_ASSERT (fenceToSignal == VK_NULL_HANDLE);
-        return 0;
-    }
+    virtual std::vector<std::unique_ptr<InheritedImage>> GetImageObjects () const override;
+
+    // there is no presentation engine, the image is available immediately:
+    // the semaphore and the fence are signaled by an empty submit
+    virtual uint32_t GetNextImageIndex (VkSemaphore signalSemaphore, VkFence fenceToSignal = VK_NULL_HANDLE) const override;
 
     virtual const std::vector<std::unique_ptr<ImageView2D>>& GetImageViews () const override { return imageViews; }
 
-    virtual bool SupportsPresenting () const override { return false; }
+    virtual bool SupportsPresenting () const override { return true; }
 
-    virtual void Present (VkQueue, uint32_t, const std::vector<VkSemaphore>&) const override
-    {
-        throw std::runtime_error ("fake swapchain cannot present");
-    }
+    // only consumes the wait semaphores, the image stays readable in present layout
+    virtual void Present (VkQueue queue, uint32_t imageIndex, const std::vector<VkSemaphore>& waitSemaphores) const override;
+
+private:
+    void CreateImage ();
 };
 
 } // namespace GVK
@@ -0,0 +1,99 @@
+#ifndef TIMELINESEMAPHORE_HPP
+#define TIMELINESEMAPHORE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "Utils/Assert.hpp"
+#include "Utils/MovablePtr.hpp"
+#include "VulkanObject.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace GVK {
+
+// requires the timelineSemaphore device feature (core in vulkan 1.2)
+class /* VULKANWRAPPER_API */ TimelineSemaphore : public VulkanObject {
+private:
+    VkDevice                     device;
+    GVK::MovablePtr<VkSemaphore> handle;
+
+    static VkSemaphore CreateSemaphore (VkDevice device, uint64_t initialValue)
+    {
+        VkSemaphoreTypeCreateInfo typeInfo = {};
+        typeInfo.sType                     = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType             = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue              = initialValue;
+
+        VkSemaphore           handle;
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType                 = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext                 = &typeInfo;
+        semaphoreInfo.flags                 = 0;
+        if (GVK_ERROR (vkCreateSemaphore (device, &semaphoreInfo, nullptr, &handle) != VK_SUCCESS)) {
+            throw std::runtime_error ("failed to create timeline semaphore");
+        }
+        return handle;
+    }
+
+public:
+    TimelineSemaphore (VkDevice device, uint64_t initialValue = 0)
+        : device (device)
+        , handle (CreateSemaphore (device, initialValue))
+    {
+    }
+
+    TimelineSemaphore (TimelineSemaphore&&) = default;
+    TimelineSemaphore& operator= (TimelineSemaphore&&) = default;
+
+    virtual ~TimelineSemaphore () override
+    {
+        vkDestroySemaphore (device, handle, nullptr);
+        handle = nullptr;
+    }
+
+    virtual void* GetHandleForName () const override { return handle; }
+
+    virtual VkObjectType GetObjectTypeForName () const override { return VK_OBJECT_TYPE_SEMAPHORE; }
+
+    operator VkSemaphore () const
+    {
+        return handle;
+    }
+
+    uint64_t GetValue () const
+    {
+        uint64_t value = 0;
+        GVK_VERIFY (vkGetSemaphoreCounterValue (device, handle, &value) == VK_SUCCESS);
+        return value;
+    }
+
+    void Wait (uint64_t value, uint64_t timeout = std::numeric_limits<uint64_t>::max ()) const
+    {
+        VkSemaphore semaphores[1] = { handle };
+
+        VkSemaphoreWaitInfo waitInfo = {};
+        waitInfo.sType               = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.flags               = 0;
+        waitInfo.semaphoreCount      = 1;
+        waitInfo.pSemaphores         = semaphores;
+        waitInfo.pValues             = &value;
+
+        GVK_VERIFY (vkWaitSemaphores (device, &waitInfo, timeout) == VK_SUCCESS);
+    }
+
+    void Signal (uint64_t value) const
+    {
+        VkSemaphoreSignalInfo signalInfo = {};
+        signalInfo.sType                 = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+        signalInfo.semaphore             = handle;
+        signalInfo.value                 = value;
+
+        GVK_VERIFY (vkSignalSemaphore (device, &signalInfo) == VK_SUCCESS);
+    }
+};
+
+} // namespace GVK
+
+#endif
@@ -26,8 +26,8 @@ public:
     BufferTransferable (const DeviceExtra& device, uint32_t bufferSize, VkBufferUsageFlags usageFlags)
         : device (device)
         , bufferSize (bufferSize)
-        , bufferGPU (device.GetAllocator (), bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usageFlags, Buffer::MemoryLocation::GPU)
-        , bufferCPU (device.GetAllocator (), bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | usageFlags, Buffer::MemoryLocation::CPU)
+        , bufferGPU (device.GetAllocator (), bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usageFlags, Buffer::MemoryLocation::GPU, device.GetConcurrentQueueFamilies ())
+        , bufferCPU (device.GetAllocator (), bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | usageFlags, Buffer::MemoryLocation::CPU, device.GetConcurrentQueueFamilies ())
         , bufferCPUMapping (device.GetAllocator (), bufferCPU)
     {
     }
@@ -75,6 +75,8 @@ public:
     {
         return *imageGPU;
     }
+
+    const Buffer& GetBufferCPU () const { return bufferCPU; }
 };
 
 
@@ -87,7 +89,7 @@ public:
 
 class VULKANWRAPPER_API Image2DTransferable final : public ImageTransferable {
 public:
-    Image2DTransferable (const DeviceExtra& device, VkFormat format, uint32_t width, uint32_t height, VkImageUsageFlags usageFlags, uint32_t arrayLayers = 1);
+    Image2DTransferable (const DeviceExtra& device, VkFormat format, uint32_t width, uint32_t height, VkImageUsageFlags usageFlags, uint32_t arrayLayers = 1, uint32_t mipLevels = 1);
     virtual ~Image2DTransferable () override = default;
 };
 
@@ -56,6 +56,7 @@ public:
     }
 
     void Copy (const void* data, size_t copiedSize) const;
+    void Copy (const void* data, size_t copiedSize, size_t dstOffset) const;
 
     void*    Get () const { return mappedMemory; }
     uint32_t GetSize () { return size; }
@@ -12,6 +12,7 @@
 #include "VulkanWrapper/CommandBuffer.hpp"
 #include "VulkanWrapper/CommandPool.hpp"
 #include "VulkanWrapper/DebugUtilsMessenger.hpp"
+#include "VulkanWrapper/DescriptorAllocator.hpp"
 #include "VulkanWrapper/DescriptorPool.hpp"
 #include "VulkanWrapper/DescriptorSet.hpp"
 #include "VulkanWrapper/DescriptorSetLayout.hpp"
@@ -23,9 +24,12 @@
 #include "VulkanWrapper/Image.hpp"
 #include "VulkanWrapper/ImageView.hpp"
 #include "VulkanWrapper/Instance.hpp"
+#include "VulkanWrapper/ObjectCache.hpp"
 #include "VulkanWrapper/PhysicalDevice.hpp"
 #include "VulkanWrapper/GraphicsPipeline.hpp"
+#include "VulkanWrapper/PipelineCache.hpp"
 #include "VulkanWrapper/PipelineLayout.hpp"
+#include "VulkanWrapper/QueryPool.hpp"
 #include "VulkanWrapper/Queue.hpp"
 #include "VulkanWrapper/RenderPass.hpp"
 #include "VulkanWrapper/Sampler.hpp"
@@ -34,6 +38,7 @@
 #include "VulkanWrapper/ShaderReflection.hpp"
 #include "VulkanWrapper/Surface.hpp"
 #include "VulkanWrapper/Swapchain.hpp"
+#include "VulkanWrapper/TimelineSemaphore.hpp"
 #include "VulkanWrapper/VulkanObject.hpp"
 
 #endif
\ No newline at end of file
@@ -12,6 +12,7 @@ class Buffer;
 class CommandBuffer;
 class CommandPool;
 class DebugUtilsMessenger;
+class DescriptorAllocator;
 class DescriptorPool;
 class DescriptorSet;
 class DescriptorSetLayout;
@@ -23,9 +24,11 @@ class Framebuffer;
 class Image;
 class ImageViewBase;
 class Instance;
+class ObjectCache;
 class PhysicalDevice;
 class GraphicsPipeline;
 class PipelineLayout;
+class QueryPool;
 class Queue;
 class RenderPass;
 class Sampler;
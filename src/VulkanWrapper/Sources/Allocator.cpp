@@ -10,27 +10,233 @@
 
 namespace GVK {
 
-Allocator::Allocator (VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device)
+static constexpr VkDeviceSize SmallUniformBufferBlockSize = 1024 * 1024;
+static constexpr VkDeviceSize RenderTargetBlockSize       = 64 * 1024 * 1024;
+
+
+static VmaPool CreateSmallUniformBufferPool (VmaAllocator allocator)
+{
+    // same as a Buffer with MemoryLocation::CPU
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferInfo.size               = Allocator::SmallUniformBufferMaxSize;
+    bufferInfo.usage              = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage                   = VMA_MEMORY_USAGE_CPU_COPY;
+    allocInfo.requiredFlags           = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+    uint32_t memoryTypeIndex = 0;
+    if (GVK_ERROR (vmaFindMemoryTypeIndexForBufferInfo (allocator, &bufferInfo, &allocInfo, &memoryTypeIndex) != VK_SUCCESS)) {
+        return VK_NULL_HANDLE;
+    }
+
+    VmaPoolCreateInfo poolInfo = {};
+    poolInfo.memoryTypeIndex   = memoryTypeIndex;
+    poolInfo.blockSize         = SmallUniformBufferBlockSize;
+
+    VmaPool pool = VK_NULL_HANDLE;
+    if (GVK_ERROR (vmaCreatePool (allocator, &poolInfo, &pool) != VK_SUCCESS)) {
+        return VK_NULL_HANDLE;
+    }
+
+    return pool;
+}
+
+
+static VmaPool CreateRenderTargetPool (VmaAllocator allocator)
+{
+    // same as the images of a RG::WritableImageResource
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType             = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType         = VK_IMAGE_TYPE_2D;
+    imageInfo.extent            = { 512, 512, 1 };
+    imageInfo.mipLevels         = 1;
+    imageInfo.arrayLayers       = 1;
+    imageInfo.format            = VK_FORMAT_R8G8B8A8_SRGB;
+    imageInfo.tiling            = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage             = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    imageInfo.samples           = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode       = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage                   = VMA_MEMORY_USAGE_GPU_ONLY;
+
+    uint32_t memoryTypeIndex = 0;
+    if (GVK_ERROR (vmaFindMemoryTypeIndexForImageInfo (allocator, &imageInfo, &allocInfo, &memoryTypeIndex) != VK_SUCCESS)) {
+        return VK_NULL_HANDLE;
+    }
+
+    VmaPoolCreateInfo poolInfo = {};
+    poolInfo.memoryTypeIndex   = memoryTypeIndex;
+    poolInfo.blockSize         = RenderTargetBlockSize;
+
+    VmaPool pool = VK_NULL_HANDLE;
+    if (GVK_ERROR (vmaCreatePool (allocator, &poolInfo, &pool) != VK_SUCCESS)) {
+        return VK_NULL_HANDLE;
+    }
+
+    return pool;
+}
+
+
+static Allocator::PoolStatistics GetPoolStatistics (VmaAllocator allocator, VmaPool pool)
+{
+    if (pool == VK_NULL_HANDLE) {
+        return { 0, 0, 0, 0 };
+    }
+
+    VmaPoolStats stats = {};
+    vmaGetPoolStats (allocator, pool, &stats);
+
+    return { stats.size, stats.unusedSize, stats.allocationCount, stats.blockCount };
+}
+
+
+Allocator::Allocator (VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device, bool memoryBudgetEnabled)
     : handle { VK_NULL_HANDLE }
+    , memoryBudgetEnabled (memoryBudgetEnabled)
+    , smallUniformBufferPool { VK_NULL_HANDLE }
+    , renderTargetPool { VK_NULL_HANDLE }
 {
     VmaAllocatorCreateInfo allocatorInfo = {};
     allocatorInfo.physicalDevice         = physicalDevice;
     allocatorInfo.device                 = device;
     allocatorInfo.instance               = instance;
 
+    if (memoryBudgetEnabled) {
+        // the budget is queried with vkGetPhysicalDeviceMemoryProperties2
+        allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_1;
+        allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
+
     if (GVK_ERROR (vmaCreateAllocator (&allocatorInfo, &handle) != VK_SUCCESS)) {
         spdlog::critical ("VmaAllocator creation failed.");
         throw std::runtime_error ("failed to create vma allocator");
     }
 
+    smallUniformBufferPool = CreateSmallUniformBufferPool (handle);
+    renderTargetPool       = CreateRenderTargetPool (handle);
+
     spdlog::trace ("VmaAllocator created: {}, uuid: {}.", handle, GetUUID ().GetValue ());
 }
 
 
 Allocator::~Allocator ()
 {
+    if (handle == VK_NULL_HANDLE) {
+        return;
+    }
+
+    if (smallUniformBufferPool != VK_NULL_HANDLE) {
+        vmaDestroyPool (handle, smallUniformBufferPool);
+    }
+    if (renderTargetPool != VK_NULL_HANDLE) {
+        vmaDestroyPool (handle, renderTargetPool);
+    }
+
     vmaDestroyAllocator (handle);
     handle = nullptr;
 }
 
+
+void Allocator::SetAllocationName (VmaAllocation allocation, const std::string& name) const
+{
+    vmaSetAllocationUserData (handle, allocation, const_cast<char*> (name.c_str ()));
+}
+
+
+std::string Allocator::GetAllocationName (VmaAllocation allocation) const
+{
+    VmaAllocationInfo allocInfo = {};
+    vmaGetAllocationInfo (handle, allocation, &allocInfo);
+
+    return (allocInfo.pUserData != nullptr) ? std::string (static_cast<const char*> (allocInfo.pUserData)) : std::string ();
+}
+
+
+VkDeviceSize Allocator::GetAllocationSize (VmaAllocation allocation) const
+{
+    VmaAllocationInfo allocInfo = {};
+    vmaGetAllocationInfo (handle, allocation, &allocInfo);
+
+    return allocInfo.size;
+}
+
+
+Allocator::Statistics Allocator::GetStatistics () const
+{
+    VmaStats stats = {};
+    vmaCalculateStats (handle, &stats);
+
+    Statistics result       = {};
+    result.usedBytes        = stats.total.usedBytes;
+    result.unusedBytes      = stats.total.unusedBytes;
+    result.blockCount       = stats.total.blockCount;
+    result.allocationCount  = stats.total.allocationCount;
+    result.unusedRangeCount = stats.total.unusedRangeCount;
+    result.fragmentation    = (stats.total.unusedBytes > 0) ? 1.0 - static_cast<double> (stats.total.unusedRangeSizeMax) / static_cast<double> (stats.total.unusedBytes) : 0.0;
+
+    result.smallUniformBuffers = GetPoolStatistics (handle, smallUniformBufferPool);
+    result.renderTargets       = GetPoolStatistics (handle, renderTargetPool);
+
+    const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+    vmaGetMemoryProperties (handle, &memoryProperties);
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+    vmaGetBudget (handle, budgets);
+
+    for (uint32_t heapIndex = 0; heapIndex < memoryProperties->memoryHeapCount; ++heapIndex) {
+        result.heaps.push_back ({ budgets[heapIndex].usage, budgets[heapIndex].budget });
+    }
+
+    return result;
+}
+
+
+Allocator::DefragmentationResult Allocator::Defragment (const std::vector<VmaAllocation>& allocations) const
+{
+    DefragmentationResult result = { 0, 0, 0, 0, std::vector<bool> (allocations.size (), false) };
+
+    if (allocations.empty ()) {
+        return result;
+    }
+
+    std::vector<VmaAllocation> allocationHandles = allocations;
+    std::vector<VkBool32>      allocationsMoved (allocations.size (), VK_FALSE);
+
+    // without a command buffer only host visible memory is moved, by memmove
+    VmaDefragmentationInfo2 defragInfo = {};
+    defragInfo.allocationCount         = static_cast<uint32_t> (allocationHandles.size ());
+    defragInfo.pAllocations            = allocationHandles.data ();
+    defragInfo.pAllocationsChanged     = allocationsMoved.data ();
+    defragInfo.maxCpuBytesToMove       = VK_WHOLE_SIZE;
+    defragInfo.maxCpuAllocationsToMove = UINT32_MAX;
+    defragInfo.commandBuffer           = VK_NULL_HANDLE;
+
+    VmaDefragmentationStats   stats   = {};
+    VmaDefragmentationContext context = VK_NULL_HANDLE;
+
+    const VkResult beginResult = vmaDefragmentationBegin (handle, &defragInfo, &stats, &context);
+    if (GVK_ERROR (beginResult != VK_SUCCESS && beginResult != VK_NOT_READY)) {
+        spdlog::error ("Defragmentation failed.");
+        return result;
+    }
+
+    vmaDefragmentationEnd (handle, context);
+
+    result.bytesMoved       = stats.bytesMoved;
+    result.bytesFreed       = stats.bytesFreed;
+    result.allocationsMoved = stats.allocationsMoved;
+    result.blocksFreed      = stats.deviceMemoryBlocksFreed;
+
+    for (size_t i = 0; i < allocationsMoved.size (); ++i) {
+        result.moved[i] = allocationsMoved[i] == VK_TRUE;
+    }
+
+    spdlog::info ("Defragmentation moved {} allocations ({} bytes), freed {} bytes.", result.allocationsMoved, result.bytesMoved, result.bytesFreed);
+
+    return result;
+}
+
 } // namespace GVK
@@ -6,23 +6,35 @@
 namespace GVK {
 
 
-Buffer::Buffer (VmaAllocator allocator, size_t bufferSize, VkBufferUsageFlags usageFlags, MemoryLocation loc)
+Buffer::Buffer (VmaAllocator allocator, size_t bufferSize, VkBufferUsageFlags usageFlags, MemoryLocation loc, const std::vector<uint32_t>& concurrentQueueFamilies, VmaPool pool)
     : allocator (allocator)
     , handle (VK_NULL_HANDLE)
     , allocationHandle (VK_NULL_HANDLE)
     , size (bufferSize)
+    , usageFlags (usageFlags)
+    , concurrentQueueFamilies (concurrentQueueFamilies)
 {
-    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufferInfo.size               = bufferSize;
-    bufferInfo.usage              = usageFlags;
+    const VkBufferCreateInfo bufferInfo = GetCreateInfo ();
 
     VmaAllocationCreateInfo allocInfo = {};
     allocInfo.usage                   = (loc == MemoryLocation::GPU) ? VMA_MEMORY_USAGE_GPU_ONLY : VMA_MEMORY_USAGE_CPU_COPY;
+    allocInfo.flags                   = VMA_ALLOCATION_CREATE_USER_DATA_COPY_STRING_BIT;
 
     if (loc == MemoryLocation::CPU) {
         allocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
     }
 
+    if (pool != VK_NULL_HANDLE) {
+        VmaAllocationCreateInfo poolAllocInfo = allocInfo;
+        poolAllocInfo.pool                    = pool;
+
+        // fails when the memory type of the pool is not allowed for this buffer
+        if (vmaCreateBuffer (allocator, &bufferInfo, &poolAllocInfo, &handle, &allocationHandle, nullptr) == VK_SUCCESS) {
+            spdlog::trace ("VkBuffer created in pool: {}, uuid: {}.", handle, GetUUID ().GetValue ());
+            return;
+        }
+    }
+
     if (GVK_ERROR (vmaCreateBuffer (allocator, &bufferInfo, &allocInfo, &handle, &allocationHandle, nullptr) != VK_SUCCESS)) {
         spdlog::critical ("VkBuffer creation failed.");
         throw std::runtime_error ("failed to create vma buffer");
@@ -41,4 +53,39 @@ Buffer::~Buffer ()
     handle = nullptr;
 }
 
-} // namespace GVK
\ No newline at end of file
+
+VkBufferCreateInfo Buffer::GetCreateInfo () const
+{
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferInfo.size               = size;
+    bufferInfo.usage              = usageFlags;
+
+    if (concurrentQueueFamilies.size () > 1) {
+        bufferInfo.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = static_cast<uint32_t> (concurrentQueueFamilies.size ());
+        bufferInfo.pQueueFamilyIndices   = concurrentQueueFamilies.data ();
+    }
+
+    return bufferInfo;
+}
+
+
+void Buffer::BindMovedAllocation (VkDevice device)
+{
+    vkDestroyBuffer (device, handle, nullptr);
+    handle = nullptr;
+
+    const VkBufferCreateInfo bufferInfo = GetCreateInfo ();
+
+    if (GVK_ERROR (vkCreateBuffer (device, &bufferInfo, nullptr, &handle) != VK_SUCCESS)) {
+        throw std::runtime_error ("failed to recreate buffer");
+    }
+
+    if (GVK_ERROR (vmaBindBufferMemory (allocator, allocationHandle, handle) != VK_SUCCESS)) {
+        throw std::runtime_error ("failed to bind moved allocation");
+    }
+
+    spdlog::trace ("VkBuffer recreated after defragmentation: {}, uuid: {}.", handle, GetUUID ().GetValue ());
+}
+
+} // namespace GVK
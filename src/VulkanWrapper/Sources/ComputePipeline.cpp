@@ -1,15 +1,20 @@
 #include "ComputePipeline.hpp"
 #include "ShaderModule.hpp"
 
+#include "Utils/Trace.hpp"
+
 #include "spdlog/spdlog.h"
 
 namespace GVK {
 
 ComputePipeline::ComputePipeline (VkDevice            device,
                                   VkPipelineLayout    pipelineLayout,
-                                  const ShaderModule& shaderModule)
+                                  const ShaderModule& shaderModule,
+                                  VkPipelineCache     pipelineCache)
     : device (device)
 {
+    Utils::TraceScope traceScope ("Compute pipeline creation", "Pipeline");
+
     VkComputePipelineCreateInfo createInfo = {};
     createInfo.sType                       = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     createInfo.pNext                       = nullptr;
@@ -19,7 +24,7 @@ ComputePipeline::ComputePipeline (VkDevice            device,
     createInfo.basePipelineHandle          = VK_NULL_HANDLE;
     createInfo.basePipelineIndex           = -1;
 
-    if (GVK_ERROR (vkCreateComputePipelines (device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &handle) != VK_SUCCESS)) {
+    if (GVK_ERROR (vkCreateComputePipelines (device, pipelineCache, 1, &createInfo, nullptr, &handle) != VK_SUCCESS)) {
         spdlog::critical ("VkPipeline creation failed.");
         throw std::runtime_error ("failed to create pipeline");
     }
@@ -0,0 +1,171 @@
+#include "DescriptorAllocator.hpp"
+
+#include "DescriptorPool.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace GVK {
+
+// used until SetPoolSizes is called, descriptor count per descriptor set
+static const std::vector<VkDescriptorPoolSize> defaultPoolSizeRatios {
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 },
+    { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 },
+    { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1 },
+};
+
+constexpr uint32_t PoolGrowthFactor = 2;
+
+
+DescriptorAllocator::DescriptorAllocator (VkDevice device, uint32_t arenaCount, uint32_t setsPerPool)
+    : device (device)
+    , arenas (arenaCount)
+    , setsPerPool (setsPerPool)
+{
+    GVK_ASSERT (arenaCount > 0);
+    GVK_ASSERT (setsPerPool > 0);
+
+    for (const VkDescriptorPoolSize& ratio : defaultPoolSizeRatios) {
+        poolSizes.push_back ({ ratio.type, ratio.descriptorCount * setsPerPool });
+    }
+}
+
+
+DescriptorAllocator::~DescriptorAllocator () = default;
+
+
+void DescriptorAllocator::SetPoolSizes (const std::vector<VkDescriptorPoolSize>& aggregateSizes, uint32_t setCount)
+{
+    std::vector<VkDescriptorPoolSize> newPoolSizes;
+
+    for (const VkDescriptorPoolSize& size : aggregateSizes) {
+        if (size.descriptorCount == 0) {
+            continue;
+        }
+
+        auto it = std::find_if (newPoolSizes.begin (), newPoolSizes.end (), [&] (const VkDescriptorPoolSize& s) { return s.type == size.type; });
+        if (it != newPoolSizes.end ()) {
+            it->descriptorCount += size.descriptorCount;
+        } else {
+            newPoolSizes.push_back (size);
+        }
+    }
+
+    if (newPoolSizes.empty () || setCount == 0) {
+        return;
+    }
+
+    poolSizes   = newPoolSizes;
+    setsPerPool = setCount;
+}
+
+
+DescriptorPool& DescriptorAllocator::CreatePool (Arena& arena)
+{
+    // every new pool of an arena is bigger than the previous one, so the pool count grows logarithmically
+    uint32_t growth = 1;
+    for (size_t i = 0; i < arena.pools.size () && growth < 64; ++i) {
+        growth *= PoolGrowthFactor;
+    }
+
+    std::vector<VkDescriptorPoolSize> scaledPoolSizes = poolSizes;
+    for (VkDescriptorPoolSize& size : scaledPoolSizes) {
+        size.descriptorCount *= growth;
+    }
+
+    arena.pools.push_back (std::make_unique<DescriptorPool> (device, scaledPoolSizes, setsPerPool * growth));
+
+    spdlog::trace ("DescriptorAllocator: created descriptor pool with {} sets, pool count: {}.", setsPerPool * growth, GetPoolCount ());
+
+    return *arena.pools.back ();
+}
+
+
+DescriptorAllocator::Allocation DescriptorAllocator::Allocate (uint32_t arenaIndex, VkDescriptorSetLayout layout)
+{
+    if (GVK_ERROR (arenaIndex >= arenas.size ())) {
+        throw std::runtime_error ("invalid descriptor allocator arena index");
+    }
+
+    Arena& arena = arenas[arenaIndex];
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType                       = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorSetCount          = 1;
+    allocInfo.pSetLayouts                 = &layout;
+
+    // try the current pool, then the pools kept from the last reset, then a new pool
+    // a new pool is only tried once, failing to allocate from an empty pool is an error
+    while (true) {
+        const bool isNewPool = arena.currentPool >= arena.pools.size ();
+
+        DescriptorPool& pool = isNewPool ? CreatePool (arena) : *arena.pools[arena.currentPool];
+
+        allocInfo.descriptorPool = pool;
+
+        VkDescriptorSet handle = VK_NULL_HANDLE;
+        const VkResult  result = vkAllocateDescriptorSets (device, &allocInfo, &handle);
+
+        if (result == VK_SUCCESS) {
+            ++arena.allocatedSetCount;
+            return { pool, handle };
+        }
+
+        if (GVK_ERROR (isNewPool || (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL))) {
+            throw std::runtime_error ("failed to allocate descriptor set");
+        }
+
+        ++arena.currentPool;
+    }
+}
+
+
+void DescriptorAllocator::Reset (uint32_t arenaIndex)
+{
+    GVK_ASSERT (arenaIndex < arenas.size ());
+
+    Arena& arena = arenas[arenaIndex];
+
+    for (std::unique_ptr<DescriptorPool>& pool : arena.pools) {
+        pool->Reset ();
+    }
+
+    arena.currentPool       = 0;
+    arena.allocatedSetCount = 0;
+}
+
+
+void DescriptorAllocator::Reset ()
+{
+    for (uint32_t arenaIndex = 0; arenaIndex < arenas.size (); ++arenaIndex) {
+        Reset (arenaIndex);
+    }
+}
+
+
+uint32_t DescriptorAllocator::GetPoolCount () const
+{
+    uint32_t result = 0;
+    for (const Arena& arena : arenas) {
+        result += static_cast<uint32_t> (arena.pools.size ());
+    }
+    return result;
+}
+
+
+uint32_t DescriptorAllocator::GetAllocatedSetCount () const
+{
+    uint32_t result = 0;
+    for (const Arena& arena : arenas) {
+        result += arena.allocatedSetCount;
+    }
+    return result;
+}
+
+} // namespace GVK
@@ -1,5 +1,8 @@
 #include "Device.hpp"
+#include "VulkanFunctionGetter.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <stdexcept>
 
@@ -25,10 +28,111 @@ uint32_t DeviceObject::FindMemoryType (uint32_t typeFilter, VkMemoryPropertyFlag
 }
 
 
+static bool IsTimelineSemaphoreSupported (VkPhysicalDevice physicalDevice)
+{
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties (physicalDevice, &properties);
+
+    if (properties.apiVersion < VK_API_VERSION_1_2) {
+        return false;
+    }
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {};
+    timelineFeatures.sType                                     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType                     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext                     = &timelineFeatures;
+
+    vkGetPhysicalDeviceFeatures2 (physicalDevice, &features);
+
+    return timelineFeatures.timelineSemaphore == VK_TRUE;
+}
+
+
+static bool IsDeviceExtensionSupported (VkPhysicalDevice physicalDevice, const char* extensionName)
+{
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties (physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions (extensionCount);
+    vkEnumerateDeviceExtensionProperties (physicalDevice, nullptr, &extensionCount, extensions.data ());
+
+    return std::any_of (extensions.begin (), extensions.end (), [&] (const VkExtensionProperties& extension) {
+        return std::strcmp (extension.extensionName, extensionName) == 0;
+    });
+}
+
+
+static void AddDeviceExtension (std::vector<const char*>& extensions, const char* extensionName)
+{
+    const bool alreadyAdded = std::any_of (extensions.begin (), extensions.end (), [&] (const char* extension) {
+        return std::strcmp (extension, extensionName) == 0;
+    });
+
+    if (!alreadyAdded) {
+        extensions.push_back (extensionName);
+    }
+}
+
+
+static bool IsDynamicRenderingSupported (VkPhysicalDevice physicalDevice)
+{
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties (physicalDevice, &properties);
+
+    // the extensions it depends on are core in 1.2
+    if (properties.apiVersion < VK_API_VERSION_1_2) {
+        return false;
+    }
+
+    if (!IsDeviceExtensionSupported (physicalDevice, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+        return false;
+    }
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures = {};
+    dynamicRenderingFeatures.sType                                       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType                     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext                     = &dynamicRenderingFeatures;
+
+    vkGetPhysicalDeviceFeatures2 (physicalDevice, &features);
+
+    return dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+}
+
+
+static bool IsMemoryBudgetSupported (VkPhysicalDevice physicalDevice)
+{
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties (physicalDevice, &properties);
+
+    // the allocator queries the budget with vkGetPhysicalDeviceMemoryProperties2, core in 1.1
+    if (properties.apiVersion < VK_API_VERSION_1_1) {
+        return false;
+    }
+
+    return IsDeviceExtensionSupported (physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+}
+
+
 DeviceObject::DeviceObject (VkPhysicalDevice physicalDevice, std::vector<uint32_t> queueFamilyIndices, std::vector<const char*> requestedDeviceExtensions)
     : physicalDevice (physicalDevice)
     , handle (VK_NULL_HANDLE)
+    , timelineSemaphoreEnabled (IsTimelineSemaphoreSupported (physicalDevice))
+    , memoryBudgetEnabled (IsMemoryBudgetSupported (physicalDevice))
+    , dynamicRenderingFunctions { nullptr, nullptr }
 {
+    const bool dynamicRenderingSupported = IsDynamicRenderingSupported (physicalDevice);
+
+    if (dynamicRenderingSupported) {
+        AddDeviceExtension (requestedDeviceExtensions, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    }
+
+    if (memoryBudgetEnabled) {
+        AddDeviceExtension (requestedDeviceExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
     const float queuePriority = 1.0f;
     
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
@@ -45,8 +149,27 @@ DeviceObject::DeviceObject (VkPhysicalDevice physicalDevice, std::vector<uint32_
     VkPhysicalDeviceFeatures deviceFeatures = {};
     deviceFeatures.shaderInt64 = VK_TRUE;
 
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {};
+    timelineFeatures.sType                                     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    timelineFeatures.timelineSemaphore                         = VK_TRUE;
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures = {};
+    dynamicRenderingFeatures.sType                                       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    dynamicRenderingFeatures.dynamicRendering                            = VK_TRUE;
+
+    void* enabledFeatures = nullptr;
+    if (dynamicRenderingSupported) {
+        dynamicRenderingFeatures.pNext = enabledFeatures;
+        enabledFeatures                = &dynamicRenderingFeatures;
+    }
+    if (timelineSemaphoreEnabled) {
+        timelineFeatures.pNext = enabledFeatures;
+        enabledFeatures        = &timelineFeatures;
+    }
+
     VkDeviceCreateInfo createInfo      = {};
     createInfo.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext                   = enabledFeatures;
     createInfo.queueCreateInfoCount    = static_cast<uint32_t> (queueCreateInfos.size ());
     createInfo.pQueueCreateInfos       = queueCreateInfos.data ();
     createInfo.pEnabledFeatures        = &deviceFeatures;
@@ -58,6 +181,11 @@ DeviceObject::DeviceObject (VkPhysicalDevice physicalDevice, std::vector<uint32_
     if (GVK_ERROR (vkCreateDevice (physicalDevice, &createInfo, nullptr, &handle) != VK_SUCCESS)) {
         throw std::runtime_error ("failed to create device");
     }
+
+    if (dynamicRenderingSupported) {
+        dynamicRenderingFunctions.cmdBeginRendering = GetVulkanDeviceFunction<PFN_vkCmdBeginRenderingKHR> (handle, "vkCmdBeginRenderingKHR");
+        dynamicRenderingFunctions.cmdEndRendering   = GetVulkanDeviceFunction<PFN_vkCmdEndRenderingKHR> (handle, "vkCmdEndRenderingKHR");
+    }
 }
 
 
@@ -1,5 +1,7 @@
 #include "GraphicsPipeline.hpp"
 
+#include "Utils/Trace.hpp"
+
 #include "spdlog/spdlog.h"
 
 namespace GVK {
@@ -14,9 +16,14 @@ GraphicsPipeline::GraphicsPipeline (VkDevice
                     const std::vector<VkVertexInputBindingDescription>&   vertexBindingDescriptions,
                     const std::vector<VkVertexInputAttributeDescription>& vertexAttributeDescriptions,
                     VkPrimitiveTopology                                   topology,
-                    bool                                                  blendEnabled)
+                    bool                                                  blendEnabled,
+                    VkPipelineCache                                       pipelineCache,
+                    uint32_t                                              subpass,
+                    const std::vector<VkFormat>&                          colorAttachmentFormats)
     : device (device)
 {
+    Utils::TraceScope traceScope ("Graphics pipeline creation", "Pipeline");
+
     VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
     vertexInputInfo.sType                                = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertexInputInfo.vertexBindingDescriptionCount        = static_cast<uint32_t> (vertexBindingDescriptions.size ());
@@ -95,10 +102,13 @@ GraphicsPipeline::GraphicsPipeline (VkDevice
     colorBlending.blendConstants[2]                   = 0.0f; // Optional
     colorBlending.blendConstants[3]                   = 0.0f; // Optional
 
+    // viewport and scissor are set when recording, so the values in viewportState are ignored
+    const std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
     VkPipelineDynamicStateCreateInfo dynamicState = {};
     dynamicState.sType                            = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount                = 0;
-    dynamicState.pDynamicStates                   = nullptr;
+    dynamicState.dynamicStateCount                = static_cast<uint32_t> (dynamicStates.size ());
+    dynamicState.pDynamicStates                   = dynamicStates.data ();
 
     VkPipelineDepthStencilStateCreateInfo depthStencil = {};
     depthStencil.sType                                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
@@ -112,8 +122,18 @@ GraphicsPipeline::GraphicsPipeline (VkDevice
     depthStencil.front                                 = VkStencilOpState (); // Optional
     depthStencil.back                                  = VkStencilOpState (); // Optional
 
+    GVK_ASSERT (renderPass != VK_NULL_HANDLE || colorAttachmentFormats.size () == attachmentCount);
+
+    VkPipelineRenderingCreateInfoKHR renderingInfo = {};
+    renderingInfo.sType                            = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    renderingInfo.colorAttachmentCount             = static_cast<uint32_t> (colorAttachmentFormats.size ());
+    renderingInfo.pColorAttachmentFormats          = colorAttachmentFormats.data ();
+    renderingInfo.depthAttachmentFormat            = VK_FORMAT_UNDEFINED;
+    renderingInfo.stencilAttachmentFormat          = VK_FORMAT_UNDEFINED;
+
     VkGraphicsPipelineCreateInfo pipelineInfo = {};
     pipelineInfo.sType                        = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext                        = (renderPass == VK_NULL_HANDLE) ? &renderingInfo : nullptr;
     pipelineInfo.stageCount                   = static_cast<uint32_t> (shaderStages.size ());
     pipelineInfo.pStages                      = shaderStages.data ();
     pipelineInfo.pVertexInputState            = &vertexInputInfo;
@@ -123,14 +143,14 @@ GraphicsPipeline::GraphicsPipeline (VkDevice
     pipelineInfo.pMultisampleState            = &multisampling;
     pipelineInfo.pDepthStencilState           = nullptr;
     pipelineInfo.pColorBlendState             = &colorBlending;
-    pipelineInfo.pDynamicState                = nullptr; // Optional
+    pipelineInfo.pDynamicState                = &dynamicState;
     pipelineInfo.layout                       = pipelineLayout;
     pipelineInfo.renderPass                   = renderPass;
-    pipelineInfo.subpass                      = 0;
+    pipelineInfo.subpass                      = subpass;
     pipelineInfo.basePipelineHandle           = VK_NULL_HANDLE; // Optional
     pipelineInfo.basePipelineIndex            = -1;             // Optional
 
-    if (GVK_ERROR (vkCreateGraphicsPipelines (device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &handle) != VK_SUCCESS)) {
+    if (GVK_ERROR (vkCreateGraphicsPipelines (device, pipelineCache, 1, &pipelineInfo, nullptr, &handle) != VK_SUCCESS)) {
         spdlog::critical ("VkPipeline creation failed.");
         throw std::runtime_error ("failed to create pipeline");
     }
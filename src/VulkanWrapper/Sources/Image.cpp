@@ -1,5 +1,6 @@
 #include "Image.hpp"
 #include "Commands.hpp"
+#include "SharedAllocation.hpp"
 
 #include "Utils/Assert.hpp"
 
@@ -19,6 +20,7 @@ Image::Image (VkImage handle, VkDevice device, uint32_t width, uint32_t height,
     , height (height)
     , depth (depth)
     , arrayLayers (arrayLayers)
+    , mipLevels (1)
 {
 }
 
@@ -32,7 +34,9 @@ Image::Image (VmaAllocator      allocator,
               VkImageTiling     tiling,
               VkImageUsageFlags usage,
               uint32_t          arrayLayers,
-              MemoryLocation    loc)
+              MemoryLocation    loc,
+              uint32_t          mipLevels,
+              VmaPool           pool)
     : device (VK_NULL_HANDLE)
     , handle (VK_NULL_HANDLE)
     , allocator (allocator)
@@ -42,7 +46,10 @@ Image::Image (VmaAllocator      allocator,
     , height (height)
     , depth (depth)
     , arrayLayers (arrayLayers)
+    , mipLevels (mipLevels)
 {
+    GVK_ASSERT (mipLevels >= 1);
+
     VkImageCreateInfo imageInfo = {};
     imageInfo.sType             = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.flags             = 0;
@@ -50,7 +57,7 @@ Image::Image (VmaAllocator      allocator,
     imageInfo.extent.width      = width;
     imageInfo.extent.height     = height;
     imageInfo.extent.depth      = depth;
-    imageInfo.mipLevels         = 1;
+    imageInfo.mipLevels         = mipLevels;
     imageInfo.arrayLayers       = arrayLayers;
     imageInfo.format            = format;
     imageInfo.tiling            = tiling;
@@ -60,12 +67,36 @@ Image::Image (VmaAllocator      allocator,
     imageInfo.sharingMode       = VK_SHARING_MODE_EXCLUSIVE;
 
     VmaAllocationCreateInfo allocInfo = {};
-    allocInfo.usage                   = (loc == MemoryLocation::GPU) ? VMA_MEMORY_USAGE_GPU_ONLY : VMA_MEMORY_USAGE_CPU_COPY;
+    allocInfo.usage                   = (loc == MemoryLocation::CPU) ? VMA_MEMORY_USAGE_CPU_COPY : VMA_MEMORY_USAGE_GPU_ONLY;
+    allocInfo.flags                   = VMA_ALLOCATION_CREATE_USER_DATA_COPY_STRING_BIT;
     
     if (loc == MemoryLocation::CPU) {
         allocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
     }
 
+    if (loc == MemoryLocation::GPULazilyAllocated) {
+        VmaAllocationCreateInfo lazyAllocInfo = {};
+        lazyAllocInfo.usage                   = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+        lazyAllocInfo.flags                   = VMA_ALLOCATION_CREATE_USER_DATA_COPY_STRING_BIT;
+
+        // fails with VK_ERROR_FEATURE_NOT_PRESENT when there is no lazily allocated memory type
+        if (vmaCreateImage (allocator, &imageInfo, &lazyAllocInfo, &handle, &allocationHandle, nullptr) == VK_SUCCESS) {
+            spdlog::trace ("VkImage created with lazily allocated memory: {}, uuid: {}.", handle, GetUUID ().GetValue ());
+            return;
+        }
+    }
+
+    if (pool != VK_NULL_HANDLE && loc != MemoryLocation::GPULazilyAllocated) {
+        VmaAllocationCreateInfo poolAllocInfo = allocInfo;
+        poolAllocInfo.pool                    = pool;
+
+        // fails when the memory type of the pool is not allowed for this image
+        if (vmaCreateImage (allocator, &imageInfo, &poolAllocInfo, &handle, &allocationHandle, nullptr) == VK_SUCCESS) {
+            spdlog::trace ("VkImage created in pool: {}, uuid: {}.", handle, GetUUID ().GetValue ());
+            return;
+        }
+    }
+
     if (GVK_ERROR (vmaCreateImage (allocator, &imageInfo, &allocInfo, &handle, &allocationHandle, nullptr) != VK_SUCCESS)) {
         spdlog::critical ("VkImage creation failed.");
         throw std::runtime_error ("failed to create image!");
@@ -129,7 +160,7 @@ VkImageMemoryBarrier Image::GetBarrier (VkImageLayout oldLayout, VkImageLayout n
     barrier.image                           = handle;
     barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseMipLevel   = 0;
-    barrier.subresourceRange.levelCount     = 1;
+    barrier.subresourceRange.levelCount     = mipLevels;
     barrier.subresourceRange.baseArrayLayer = baseArrayLayer;
     barrier.subresourceRange.layerCount     = arrayLayers;
     barrier.srcAccessMask                   = srcAccessMask;
@@ -211,4 +242,55 @@ void Image::CmdCopyBufferPartToImage (CommandBuffer& commandBuffer, VkBuffer buf
                                                     std::vector<VkBufferImageCopy> { region });
 }
 
+static VkImage CreateImageWithoutMemory (VkDevice device, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, uint32_t arrayLayers)
+{
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType             = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.flags             = 0;
+    imageInfo.imageType         = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width      = width;
+    imageInfo.extent.height     = height;
+    imageInfo.extent.depth      = 1;
+    imageInfo.mipLevels         = 1;
+    imageInfo.arrayLayers       = arrayLayers;
+    imageInfo.format            = format;
+    imageInfo.tiling            = tiling;
+    imageInfo.initialLayout     = Image::INITIAL_LAYOUT;
+    imageInfo.usage             = usage;
+    imageInfo.samples           = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode       = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkImage handle = VK_NULL_HANDLE;
+    if (GVK_ERROR (vkCreateImage (device, &imageInfo, nullptr, &handle) != VK_SUCCESS)) {
+        spdlog::critical ("VkImage creation failed.");
+        throw std::runtime_error ("failed to create image!");
+    }
+
+    return handle;
+}
+
+
+AliasedImage2D::AliasedImage2D (VkDevice device, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, uint32_t arrayLayers)
+    : Image (CreateImageWithoutMemory (device, width, height, format, tiling, usage, arrayLayers), device, width, height, 1, format, arrayLayers)
+    , device (device)
+{
+    spdlog::trace ("VkImage created without memory: {}, uuid: {}.", handle, GetUUID ().GetValue ());
+}
+
+
+VkMemoryRequirements AliasedImage2D::GetMemoryRequirements () const
+{
+    VkMemoryRequirements requirements = {};
+    vkGetImageMemoryRequirements (device, handle, &requirements);
+    return requirements;
+}
+
+
+void AliasedImage2D::BindMemory (const SharedAllocation& allocation, VkDeviceSize offset)
+{
+    if (GVK_ERROR (vmaBindImageMemory2 (allocation.GetAllocator (), allocation, offset, handle, nullptr) != VK_SUCCESS)) {
+        throw std::runtime_error ("failed to bind image memory");
+    }
+}
+
 } // namespace GVK
@@ -1,9 +1,11 @@
 #include "ImageView.hpp"
 
+#include "ObjectCache.hpp"
+
 
 namespace GVK {
 
-ImageViewBase::ImageViewBase (VkDevice device, VkImage image, VkFormat format, VkImageViewType viewType, uint32_t layerIndex, uint32_t layerCount)
+ImageViewBase::ImageViewBase (VkDevice device, VkImage image, VkFormat format, VkImageViewType viewType, uint32_t layerIndex, uint32_t layerCount, uint32_t levelCount)
     : device (device)
     , format (format)
     , handle (VK_NULL_HANDLE)
@@ -20,7 +22,7 @@ ImageViewBase::ImageViewBase (VkDevice device, VkImage image, VkFormat format, V
     createInfo.components.a                    = VK_COMPONENT_SWIZZLE_IDENTITY;
     createInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
     createInfo.subresourceRange.baseMipLevel   = 0;
-    createInfo.subresourceRange.levelCount     = 1;
+    createInfo.subresourceRange.levelCount     = levelCount;
     createInfo.subresourceRange.baseArrayLayer = layerIndex;
     createInfo.subresourceRange.layerCount     = layerCount;
 
@@ -39,6 +41,8 @@ ImageViewBase::ImageViewBase (VkDevice device, const Image2D& image, VkImageView
 
 ImageViewBase::~ImageViewBase ()
 {
+    ObjectCache::ForgetImageView (handle);
+
     vkDestroyImageView (device, handle, nullptr);
     handle = nullptr;
 }
@@ -62,8 +66,9 @@ ImageView2D::ImageView2D (VkDevice device, VkImage image, VkFormat format, uint3
 }
 
 
+// all mip levels of the image are visible
 ImageView2D::ImageView2D (VkDevice device, const Image& image, uint32_t layerIndex, uint32_t layerCount)
-    : ImageView2D (device, image, image.GetFormat (), layerIndex, layerCount)
+    : ImageViewBase (device, image, image.GetFormat (), VK_IMAGE_VIEW_TYPE_2D, layerIndex, layerCount, image.GetMipLevels ())
 {
 }
 
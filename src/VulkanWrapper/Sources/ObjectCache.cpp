@@ -0,0 +1,299 @@
+#include "ObjectCache.hpp"
+
+#include "Framebuffer.hpp"
+#include "RenderPass.hpp"
+#include "Sampler.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+
+namespace GVK {
+
+namespace {
+
+// attachment descriptions, references and subpass dependencies are hashed by their bytes
+static_assert (sizeof (VkAttachmentDescription) == 9 * sizeof (uint32_t), "VkAttachmentDescription has padding");
+static_assert (sizeof (VkAttachmentReference) == 2 * sizeof (uint32_t), "VkAttachmentReference has padding");
+static_assert (sizeof (VkSubpassDependency) == 7 * sizeof (uint32_t), "VkSubpassDependency has padding");
+
+
+class KeyBuilder {
+private:
+    std::string key;
+
+public:
+    template<typename T>
+    void Append (const T& value)
+    {
+        static_assert (std::is_trivially_copyable<T>::value, "only trivially copyable values can be appended to a key");
+        key.append (reinterpret_cast<const char*> (&value), sizeof (T));
+    }
+
+    template<typename T>
+    void AppendArray (const T* values, uint32_t count)
+    {
+        Append (count);
+        for (uint32_t i = 0; i < count; ++i) {
+            Append (values[i]);
+        }
+    }
+
+    template<typename T>
+    void AppendOptional (const T* value)
+    {
+        Append (value != nullptr);
+        if (value != nullptr) {
+            Append (*value);
+        }
+    }
+
+    std::string&& Get () { return std::move (key); }
+};
+
+
+struct Registry {
+    std::mutex                mutex;
+    std::vector<ObjectCache*> caches;
+};
+
+
+Registry& GetRegistry ()
+{
+    static Registry registry;
+    return registry;
+}
+
+
+template<typename T, typename CreatorType>
+std::shared_ptr<T> GetOrCreate (std::unordered_map<std::string, std::weak_ptr<T>>& entries, size_t& purgeThreshold, std::string&& key, bool& created, const CreatorType& creator)
+{
+    std::weak_ptr<T>& entry = entries[std::move (key)];
+
+    if (std::shared_ptr<T> existing = entry.lock ()) {
+        created = false;
+        return existing;
+    }
+
+    std::shared_ptr<T> result = creator ();
+    entry                     = result;
+    created                   = true;
+
+    // entries of released objects are only removed when the map grows, so lookups stay cheap
+    if (entries.size () >= purgeThreshold) {
+        for (auto it = entries.begin (); it != entries.end ();) {
+            if (it->second.expired ()) {
+                it = entries.erase (it);
+            } else {
+                ++it;
+            }
+        }
+        purgeThreshold = std::max<size_t> (64, entries.size () * 2);
+    }
+
+    return result;
+}
+
+
+template<typename T>
+uint32_t CountAlive (const std::unordered_map<std::string, std::weak_ptr<T>>& entries)
+{
+    return static_cast<uint32_t> (std::count_if (entries.begin (), entries.end (), [] (const auto& entry) { return !entry.second.expired (); }));
+}
+
+} // namespace
+
+
+ObjectCache::ObjectCache (VkDevice device)
+    : device (device)
+    , framebufferPurgeThreshold (64)
+    , requestCount (0)
+    , createdCount (0)
+{
+    Registry& registry = GetRegistry ();
+
+    std::lock_guard<std::mutex> guard (registry.mutex);
+    registry.caches.push_back (this);
+}
+
+
+ObjectCache::~ObjectCache ()
+{
+    Registry& registry = GetRegistry ();
+
+    std::lock_guard<std::mutex> guard (registry.mutex);
+    registry.caches.erase (std::remove (registry.caches.begin (), registry.caches.end (), this), registry.caches.end ());
+}
+
+
+std::shared_ptr<Sampler> ObjectCache::GetSampler (const VkSamplerCreateInfo& createInfo)
+{
+    GVK_ASSERT (createInfo.pNext == nullptr);
+
+    KeyBuilder key;
+    key.Append (createInfo.flags);
+    key.Append (createInfo.magFilter);
+    key.Append (createInfo.minFilter);
+    key.Append (createInfo.mipmapMode);
+    key.Append (createInfo.addressModeU);
+    key.Append (createInfo.addressModeV);
+    key.Append (createInfo.addressModeW);
+    key.Append (createInfo.mipLodBias);
+    key.Append (createInfo.anisotropyEnable);
+    key.Append (createInfo.maxAnisotropy);
+    key.Append (createInfo.compareEnable);
+    key.Append (createInfo.compareOp);
+    key.Append (createInfo.minLod);
+    key.Append (createInfo.maxLod);
+    key.Append (createInfo.borderColor);
+    key.Append (createInfo.unnormalizedCoordinates);
+
+    std::lock_guard<std::mutex> guard (mutex);
+
+    bool created = false;
+
+    std::shared_ptr<Sampler> result = GetOrCreate (samplers.entries, samplers.purgeThreshold, key.Get (), created, [&] {
+        return std::make_shared<Sampler> (device, createInfo);
+    });
+
+    ++requestCount;
+    createdCount += created ? 1 : 0;
+
+    return result;
+}
+
+
+std::shared_ptr<Sampler> ObjectCache::GetSampler (VkFilter filter, VkSamplerAddressMode addressMode)
+{
+    return GetSampler (Sampler::GetCreateInfo (filter, addressMode));
+}
+
+
+std::shared_ptr<RenderPass> ObjectCache::GetRenderPass (const std::vector<VkAttachmentDescription>& attachments,
+                                                        const std::vector<VkSubpassDescription>&    subpasses,
+                                                        const std::vector<VkSubpassDependency>&     subpassDependencies)
+{
+    KeyBuilder key;
+    key.AppendArray (attachments.data (), static_cast<uint32_t> (attachments.size ()));
+    key.AppendArray (subpassDependencies.data (), static_cast<uint32_t> (subpassDependencies.size ()));
+
+    key.Append (static_cast<uint32_t> (subpasses.size ()));
+    for (const VkSubpassDescription& subpass : subpasses) {
+        key.Append (subpass.flags);
+        key.Append (subpass.pipelineBindPoint);
+        key.AppendArray (subpass.pInputAttachments, subpass.inputAttachmentCount);
+        key.AppendArray (subpass.pColorAttachments, subpass.colorAttachmentCount);
+        key.AppendArray (subpass.pResolveAttachments, subpass.pResolveAttachments != nullptr ? subpass.colorAttachmentCount : 0);
+        key.AppendOptional (subpass.pDepthStencilAttachment);
+        key.AppendArray (subpass.pPreserveAttachments, subpass.preserveAttachmentCount);
+    }
+
+    std::lock_guard<std::mutex> guard (mutex);
+
+    bool created = false;
+
+    std::shared_ptr<RenderPass> result = GetOrCreate (renderPasses.entries, renderPasses.purgeThreshold, key.Get (), created, [&] {
+        return std::make_shared<RenderPass> (device, attachments, subpasses, subpassDependencies);
+    });
+
+    ++requestCount;
+    createdCount += created ? 1 : 0;
+
+    return result;
+}
+
+
+std::shared_ptr<Framebuffer> ObjectCache::GetFramebuffer (const std::shared_ptr<RenderPass>& renderPass,
+                                                          const std::vector<VkImageView>&    attachments,
+                                                          uint32_t                           width,
+                                                          uint32_t                           height)
+{
+    GVK_ASSERT (renderPass != nullptr);
+
+    // the render pass handle cannot be reused while the framebuffer is alive, because the framebuffer owns a reference to it
+    KeyBuilder key;
+    key.Append (static_cast<VkRenderPass> (*renderPass));
+    key.Append (width);
+    key.Append (height);
+    key.AppendArray (attachments.data (), static_cast<uint32_t> (attachments.size ()));
+
+    std::lock_guard<std::mutex> guard (mutex);
+
+    ++requestCount;
+
+    FramebufferEntry& entry = framebuffers[key.Get ()];
+
+    if (std::shared_ptr<Framebuffer> existing = entry.framebuffer.lock ()) {
+        return existing;
+    }
+
+    std::shared_ptr<Framebuffer> result (new Framebuffer (device, *renderPass, attachments, width, height), [renderPass] (Framebuffer* framebuffer) {
+        delete framebuffer;
+    });
+
+    entry.attachments = attachments;
+    entry.framebuffer = result;
+
+    ++createdCount;
+
+    if (framebuffers.size () >= framebufferPurgeThreshold) {
+        for (auto it = framebuffers.begin (); it != framebuffers.end ();) {
+            if (it->second.framebuffer.expired ()) {
+                it = framebuffers.erase (it);
+            } else {
+                ++it;
+            }
+        }
+        framebufferPurgeThreshold = std::max<size_t> (64, framebuffers.size () * 2);
+    }
+
+    return result;
+}
+
+
+ObjectCache::Statistics ObjectCache::GetStatistics () const
+{
+    std::lock_guard<std::mutex> guard (mutex);
+
+    Statistics result       = {};
+    result.samplerCount     = CountAlive (samplers.entries);
+    result.renderPassCount  = CountAlive (renderPasses.entries);
+    result.framebufferCount = static_cast<uint32_t> (std::count_if (framebuffers.begin (), framebuffers.end (), [] (const auto& entry) { return !entry.second.framebuffer.expired (); }));
+    result.requestCount     = requestCount;
+    result.createdCount     = createdCount;
+    return result;
+}
+
+
+void ObjectCache::ForgetImageView (VkImageView imageView)
+{
+    if (imageView == VK_NULL_HANDLE) {
+        return;
+    }
+
+    Registry& registry = GetRegistry ();
+
+    std::lock_guard<std::mutex> guard (registry.mutex);
+    for (ObjectCache* cache : registry.caches) {
+        cache->ForgetImageViewImpl (imageView);
+    }
+}
+
+
+void ObjectCache::ForgetImageViewImpl (VkImageView imageView)
+{
+    std::lock_guard<std::mutex> guard (mutex);
+
+    for (auto it = framebuffers.begin (); it != framebuffers.end ();) {
+        const std::vector<VkImageView>& attachments = it->second.attachments;
+        if (std::find (attachments.begin (), attachments.end (), imageView) != attachments.end ()) {
+            it = framebuffers.erase (it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace GVK
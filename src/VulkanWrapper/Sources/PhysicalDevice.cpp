@@ -69,6 +69,21 @@ static auto AcceptFirstWithFlag (VkQueueFlagBits flagbits)
 }
 
 
+static std::optional<uint32_t> AcceptFirstComputeWithoutGraphics (VkPhysicalDevice, VkSurfaceKHR, const std::vector<VkQueueFamilyProperties>& queueFamilies)
+{
+    uint32_t i = 0;
+    for (const VkQueueFamilyProperties& queueFamily : queueFamilies) {
+        if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            return i;
+        }
+
+        i++;
+    }
+
+    return std::nullopt;
+}
+
+
 static PhysicalDevice::QueueFamilies FindQueueFamilyIndices (VkPhysicalDevice physicalDevice, VkSurfaceKHR surface)
 {
     PhysicalDevice::QueueFamilies result;
@@ -82,6 +97,7 @@ static PhysicalDevice::QueueFamilies FindQueueFamilyIndices (VkPhysicalDevice ph
     result.presentation = AcceptFirstPresentSupport (physicalDevice, surface, queueFamilies);
     result.compute      = AcceptFirstWithFlag (VK_QUEUE_COMPUTE_BIT) (physicalDevice, surface, queueFamilies);
     result.transfer     = AcceptFirstWithFlag (VK_QUEUE_TRANSFER_BIT) (physicalDevice, surface, queueFamilies);
+    result.asyncCompute = AcceptFirstComputeWithoutGraphics (physicalDevice, surface, queueFamilies);
 
     if (result.presentation) {
         GVK_ASSERT (result.graphics == result.presentation); // TODO handle different queue indices ...
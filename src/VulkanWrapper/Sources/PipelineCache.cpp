@@ -0,0 +1,79 @@
+#include "PipelineCache.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <stdexcept>
+
+namespace GVK {
+
+static VkPipelineCache CreatePipelineCacheImpl (VkDevice device, const std::vector<uint8_t>& initialData)
+{
+    VkPipelineCacheCreateInfo createInfo = {};
+    createInfo.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.pNext                     = nullptr;
+    createInfo.flags                     = 0;
+    createInfo.initialDataSize           = initialData.size ();
+    createInfo.pInitialData              = initialData.empty () ? nullptr : initialData.data ();
+
+    VkPipelineCache result = VK_NULL_HANDLE;
+    if (GVK_ERROR (vkCreatePipelineCache (device, &createInfo, nullptr, &result) != VK_SUCCESS)) {
+        throw std::runtime_error ("failed to create pipeline cache");
+    }
+
+    return result;
+}
+
+
+PipelineCache::PipelineCache (VkDevice device, const std::vector<uint8_t>& initialData)
+    : device (device)
+    , handle (CreatePipelineCacheImpl (device, initialData))
+{
+}
+
+
+PipelineCache::~PipelineCache ()
+{
+    vkDestroyPipelineCache (device, handle, nullptr);
+    handle = nullptr;
+}
+
+
+std::vector<uint8_t> PipelineCache::GetData () const
+{
+    size_t dataSize = 0;
+    if (GVK_ERROR (vkGetPipelineCacheData (device, handle, &dataSize, nullptr) != VK_SUCCESS)) {
+        return {};
+    }
+
+    std::vector<uint8_t> data (dataSize);
+    if (GVK_ERROR (vkGetPipelineCacheData (device, handle, &dataSize, data.data ()) != VK_SUCCESS)) {
+        return {};
+    }
+
+    data.resize (dataSize);
+    return data;
+}
+
+
+void PipelineCache::Merge (const std::vector<uint8_t>& data)
+{
+    if (data.empty ()) {
+        return;
+    }
+
+    const VkPipelineCache source = CreatePipelineCacheImpl (device, data);
+
+    {
+        // the destination of a merge must be externally synchronized
+        std::lock_guard<std::mutex> lock (mergeMutex);
+        GVK_VERIFY (vkMergePipelineCaches (device, handle, 1, &source) == VK_SUCCESS);
+    }
+
+    vkDestroyPipelineCache (device, source, nullptr);
+
+    spdlog::trace ("Merged {} bytes of pipeline cache data.", data.size ());
+}
+
+} // namespace GVK
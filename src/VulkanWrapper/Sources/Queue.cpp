@@ -76,4 +76,47 @@ void Queue::Submit (const std::vector<VkSemaphore>&          waitSemaphores,
     }
 }
 
+
+void Queue::Submit (const std::vector<VkSemaphore>&          waitSemaphores,
+                    const std::vector<uint64_t>&             waitValues,
+                    const std::vector<VkPipelineStageFlags>& waitDstStageMasks,
+                    const std::vector<CommandBuffer*>&       commandBuffers,
+                    const std::vector<VkSemaphore>&          signalSemaphores,
+                    const std::vector<uint64_t>&             signalValues,
+                    VkFence                                  fenceToSignal) const
+{
+    GVK_ASSERT (waitSemaphores.size () == waitValues.size ());
+    GVK_ASSERT (signalSemaphores.size () == signalValues.size ());
+
+    std::vector<VkCommandBuffer> submittedCmdBufferHandles;
+    submittedCmdBufferHandles.reserve (commandBuffers.size ());
+
+    for (CommandBuffer* cmd : commandBuffers) {
+        GVK_ASSERT (cmd != nullptr);
+        submittedCmdBufferHandles.push_back (cmd->GetHandle ());
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+    timelineInfo.sType                         = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount       = static_cast<uint32_t> (waitValues.size ());
+    timelineInfo.pWaitSemaphoreValues          = waitValues.data ();
+    timelineInfo.signalSemaphoreValueCount     = static_cast<uint32_t> (signalValues.size ());
+    timelineInfo.pSignalSemaphoreValues        = signalValues.data ();
+
+    VkSubmitInfo result         = {};
+    result.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    result.pNext                = &timelineInfo;
+    result.waitSemaphoreCount   = static_cast<uint32_t> (waitSemaphores.size ());
+    result.pWaitSemaphores      = waitSemaphores.data ();
+    result.pWaitDstStageMask    = waitDstStageMasks.data ();
+    result.commandBufferCount   = static_cast<uint32_t> (submittedCmdBufferHandles.size ());
+    result.pCommandBuffers      = submittedCmdBufferHandles.data ();
+    result.signalSemaphoreCount = static_cast<uint32_t> (signalSemaphores.size ());
+    result.pSignalSemaphores    = signalSemaphores.data ();
+
+    vkQueueSubmit (handle, 1, &result, fenceToSignal);
+
+    spdlog::trace ("VkQueue: Submitted {} command buffers with {} timeline waits and {} timeline signals.", commandBuffers.size (), waitValues.size (), signalValues.size ());
+}
+
 }
\ No newline at end of file
@@ -7,8 +7,22 @@
 namespace GVK {
 
 Sampler::Sampler (VkDevice device, VkFilter filter, VkSamplerAddressMode addressMode)
+    : Sampler (device, GetCreateInfo (filter, addressMode))
+{
+}
+
+
+Sampler::Sampler (VkDevice device, const VkSamplerCreateInfo& createInfo)
     : device (device)
-    , filter (filter)
+    , filter (createInfo.magFilter)
+{
+    if (GVK_ERROR (vkCreateSampler (device, &createInfo, nullptr, &handle) != VK_SUCCESS)) {
+        throw std::runtime_error ("failed to create texture sampler!");
+    }
+}
+
+
+VkSamplerCreateInfo Sampler::GetCreateInfo (VkFilter filter, VkSamplerAddressMode addressMode)
 {
     VkSamplerCreateInfo createInfo     = {};
     createInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -27,10 +41,7 @@ Sampler::Sampler (VkDevice device, VkFilter filter, VkSamplerAddressMode address
     createInfo.mipLodBias              = 0.0f;
     createInfo.minLod                  = 0.0f;
     createInfo.maxLod                  = 0.0f;
-
-    if (GVK_ERROR (vkCreateSampler (device, &createInfo, nullptr, &handle) != VK_SUCCESS)) {
-        throw std::runtime_error ("failed to create texture sampler!");
-    }
+    return createInfo;
 }
 
 
@@ -5,6 +5,8 @@
 #include "Utils/BuildType.hpp"
 #include "Utils/CommandLineFlag.hpp"
 #include "Utils/FileSystemUtils.hpp"
+#include "Utils/Hasher.hpp"
+#include "Utils/Trace.hpp"
 
 // from VulkanWrapper
 #include "ResourceLimits.hpp"
@@ -12,6 +14,7 @@
 
 // from std
 #include <array>
+#include <cstring>
 
 // from glslang
 #include "glslang/SPIRV/GlslangToSpv.h"
@@ -341,11 +344,9 @@ extern Utils::CommandLineOnOffFlag enableShaderPrintfFlag;
 
 static std::vector<uint32_t> CompileWithGlslangCppInterface (CompileParameters params)
 {
-    static bool init = false;
-    if (!init) {
-        init = true;
-        glslang::InitializeProcess ();
-    }
+    // shaders are compiled from worker threads too
+    static const bool initialized = glslang::InitializeProcess ();
+    GVK_ASSERT (initialized);
 
     if (enableShaderPrintfFlag.IsFlagOn ())
         params.defines.push_back ("SHADERPRINTF");
@@ -419,27 +420,45 @@ static std::vector<uint32_t> CompileWithGlslangCppInterface (CompileParameters p
 }
 
 
+static ShaderBinaryCache::Key GetShaderBinaryCacheKey (const CompileParameters& params)
+{
+    Utils::Hasher hasher;
+
+    hasher.Add (params.shaderKindDescriptor.has_value () ? params.shaderKindDescriptor->shaderKind : ShaderKind::Vertex);
+    hasher.Add (params.sourceCode);
+
+    hasher.Add (static_cast<uint64_t> (params.defines.size ()));
+    for (const std::string& def : params.defines)
+        hasher.Add (def);
+
+    hasher.Add (static_cast<uint64_t> (params.undefines.size ()));
+    for (const std::string& undef : params.undefines)
+        hasher.Add (undef);
+
+    // these change the generated code too
+    hasher.Add (enableShaderPrintfFlag.IsFlagOn ());
+    hasher.Add (IsDebugBuild);
+
+    return hasher.Get ();
+}
+
+
 static std::vector<uint32_t> CompileFromSourceCode (const CompileParameters& params)
 {
-#if 0
-    ShaderCache& shaderCache = IsDebugBuild ? debugShaderCache : releaseShaderCache;
+    Utils::TraceScope traceScope ("Shader compilation", "ShaderModule");
 
-    std::optional<std::vector<uint32_t>> cachedBinary = shaderCache.Load (shaderSource);
+    const ShaderBinaryCache::Key cacheKey = GetShaderBinaryCacheKey (params);
+
+    std::optional<std::vector<uint32_t>> cachedBinary = ShaderBinaryCache::Get ().Find (cacheKey);
     if (cachedBinary.has_value ()) {
-        return *cachedBinary;
+        return std::move (*cachedBinary);
     }
-#endif
 
-    try {
-        const std::vector<uint32_t> result = CompileWithGlslangCppInterface (params);
-#if 0
-        shaderCache.Save (shaderSource, result);
-#endif
-        return result;
+    std::vector<uint32_t> result = CompileWithGlslangCppInterface (params);
 
-    } catch (ShaderCompileException& ex) {
-        throw;
-    }
+    ShaderBinaryCache::Get ().Add (cacheKey, result);
+
+    return result;
 }
 
 
@@ -477,6 +496,88 @@ static VkShaderModule CreateShaderModuleImpl (VkDevice device, const std::vector
 }
 
 
+ShaderBinaryCache::ShaderBinaryCache ()
+    : statistics {}
+{
+}
+
+
+ShaderBinaryCache& ShaderBinaryCache::Get ()
+{
+    static ShaderBinaryCache cache;
+    return cache;
+}
+
+
+std::optional<std::vector<uint32_t>> ShaderBinaryCache::Find (Key key)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    auto it = binaries.find (key);
+    if (it == binaries.end ()) {
+        ++statistics.missCount;
+        return std::nullopt;
+    }
+
+    ++statistics.hitCount;
+    return it->second;
+}
+
+
+void ShaderBinaryCache::Add (Key key, const std::vector<uint32_t>& binary)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    binaries[key] = binary;
+}
+
+
+std::map<ShaderBinaryCache::Key, std::vector<uint32_t>> ShaderBinaryCache::GetBinaries () const
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    return std::map<Key, std::vector<uint32_t>> (binaries.begin (), binaries.end ());
+}
+
+
+void ShaderBinaryCache::Clear ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    binaries.clear ();
+}
+
+
+ShaderBinaryCache::Statistics ShaderBinaryCache::GetStatistics () const
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    return statistics;
+}
+
+
+void SpecializationConstants::Set (const std::string& name, float value)
+{
+    uint32_t bits = 0;
+    static_assert (sizeof (bits) == sizeof (value));
+    std::memcpy (&bits, &value, sizeof (bits));
+
+    values[name] = bits;
+}
+
+
+void SpecializationConstants::Set (const std::string& name, int32_t value)
+{
+    values[name] = static_cast<uint32_t> (value);
+}
+
+
+void SpecializationConstants::Set (const std::string& name, uint32_t value)
+{
+    values[name] = value;
+}
+
+
 ShaderModule::ShaderModule (ShaderKind                      shaderKind,
                             ReadMode                        readMode,
                             VkDevice                        device,
@@ -496,6 +597,7 @@ ShaderModule::ShaderModule (ShaderKind                      shaderKind,
     , sourceCode (sourceCode)
     , defines (defines)
     , undefines (undefines)
+    , specializationInfo {}
 {
     spdlog::trace ("VkShaderModule created: {}, uuid: {}.", this->handle, GetUUID ().GetValue ());
 }
@@ -586,6 +688,23 @@ std::unique_ptr<ShaderModule> ShaderModule::CreateFromGLSLString (VkDevice devic
 }
 
 
+void ShaderModule::PrecompileGLSLString (ShaderKind shaderKind, const std::string& shaderSource, const std::vector<std::string>& defines, const std::vector<std::string>& undefines)
+{
+    std::optional<ShaderKindDescriptor> shaderKindDescriptor = ShaderKindDescriptor::FromShaderKind (shaderKind);
+    if (GVK_ERROR (!shaderKindDescriptor.has_value ())) {
+        throw std::runtime_error ("Unknown shaderkind.");
+    }
+
+    CompileParameters parameters;
+    parameters.sourceCode           = shaderSource;
+    parameters.shaderKindDescriptor = *shaderKindDescriptor;
+    parameters.defines              = defines;
+    parameters.undefines            = undefines;
+
+    CompileFromSourceCode (parameters);
+}
+
+
 ShaderModule::~ShaderModule ()
 {
     vkDestroyShaderModule (device, handle, nullptr);
@@ -602,15 +721,56 @@ VkPipelineShaderStageCreateInfo ShaderModule::GetShaderStageCreateInfo () const
     result.stage                           = ShaderKindDescriptor::FromShaderKind (shaderKind)->vkflag;
     result.module                          = handle;
     result.pName                           = "main";
-    result.pSpecializationInfo             = nullptr;
+    result.pSpecializationInfo             = specializationMapEntries.empty () ? nullptr : &specializationInfo;
     return result;
 }
 
 
-ShaderModule::Reflection::Reflection (const std::vector<uint32_t>& binary)
+void ShaderModule::SetSpecializationConstants (const SpecializationConstants& values)
+{
+    specializationConstants = values;
+
+    specializationMapEntries.clear ();
+    specializationData.clear ();
+
+    std::map<uint32_t, uint32_t> valuesById;
+
+    for (const SR::SpecializationConstant& specializationConstant : reflection.specializationConstants) {
+        const auto value = specializationConstants.GetValues ().find (specializationConstant.name);
+        if (value == specializationConstants.GetValues ().end ()) {
+            continue;
+        }
+
+        VkSpecializationMapEntry mapEntry = {};
+        mapEntry.constantID               = specializationConstant.constantId;
+        mapEntry.offset                   = static_cast<uint32_t> (specializationData.size () * sizeof (uint32_t));
+        mapEntry.size                     = sizeof (uint32_t);
+
+        specializationMapEntries.push_back (mapEntry);
+        specializationData.push_back (value->second);
+
+        valuesById[specializationConstant.constantId] = value->second;
+    }
+
+    specializationInfo               = {};
+    specializationInfo.mapEntryCount = static_cast<uint32_t> (specializationMapEntries.size ());
+    specializationInfo.pMapEntries   = specializationMapEntries.data ();
+    specializationInfo.dataSize      = specializationData.size () * sizeof (uint32_t);
+    specializationInfo.pData         = specializationData.data ();
+
+    reflection = Reflection (binary, valuesById);
+}
+
+
+ShaderModule::Reflection::Reflection (const std::vector<uint32_t>& binary, const std::map<uint32_t, uint32_t>& specializationValues)
 {
     SR::SpirvParser c (binary);
 
+    // the default values are reported, the given values only change the array sizes
+    specializationConstants = SR::GetSpecializationConstantsFromBinary (c);
+
+    SR::SetSpecializationConstantValues (c, specializationValues);
+
     ubos           = SR::GetUBOsFromBinary (c);
     samplers       = SR::GetSamplersFromBinary (c);
     storageBuffers = SR::GetStorageBuffersFromBinary (c);
@@ -654,6 +814,9 @@ void ShaderModule::Reload ()
 
         sourceCode = *fileContents;
 
+        // constant ids may have changed
+        SetSpecializationConstants (SpecializationConstants (specializationConstants));
+
     } else if (readMode == ReadMode::SPVFilePath) {
         vkDestroyShaderModule (device, handle, nullptr);
 
@@ -668,9 +831,11 @@ void ShaderModule::Reload ()
 
         handle = CreateShaderModuleImpl (device, *binaryC);
 
+        binary = code;
+
         reflection = Reflection (binary);
 
-        binary = code;
+        SetSpecializationConstants (SpecializationConstants (specializationConstants));
 
     } else if (readMode == ReadMode::GLSLString) {
         GVK_BREAK_STR ("cannot reload shaders from hard coded strings");
@@ -355,6 +355,17 @@ static FieldType BaseTypeNMToSRFieldType (spirv_cross::SPIRType::BaseType b, uin
 }
 
 
+// arrays can be sized by specialization constants, the size is the current value of the constant
+static uint32_t GetArraySize (const spirv_cross::Compiler& compiler, const spirv_cross::SPIRType& type, const size_t dimension)
+{
+    if (type.array_size_literal[dimension]) {
+        return type.array[dimension];
+    }
+
+    return compiler.get_constant (type.array[dimension]).scalar ();
+}
+
+
 static void IterateTypeTree (spirv_cross::Compiler& compiler, spirv_cross::TypeID typeId, std::vector<std::unique_ptr<Field>>& parentFields, const uint32_t depth = 0)
 {
     const spirv_cross::SPIRType& type = compiler.get_type (typeId);
@@ -374,7 +385,7 @@ static void IterateTypeTree (spirv_cross::Compiler& compiler, spirv_cross::TypeI
 
 
         for (size_t i = 0; i < Mtype.array.size (); ++i) {
-            f->arraySize.push_back (Mtype.array[i]);
+            f->arraySize.push_back (GetArraySize (compiler, Mtype, i));
         }
 
         if (typeMemDecorA.ArrayStride) {
@@ -433,7 +444,7 @@ static std::vector<std::shared_ptr<BufferObject>> GetBufferObjectsFromBinary (Sp
     for (auto& resource : bufferResourceSelector (resources)) {
         AllDecorations decorations (compiler, resource.id);
         auto           resType   = compiler.get_type (resource.type_id);
-        const uint32_t arraySize = !resType.array.empty () ? resType.array[0] : 1;
+        const uint32_t arraySize = !resType.array.empty () ? GetArraySize (compiler, resType, 0) : 1;
 
         // using arrays on ubos will create seperate bindings,
         // eg. array of 4 on binding 2 will create 4 different bindings: 2, 3, 4, 5
@@ -497,7 +508,7 @@ std::vector<Output> GetOutputsFromBinary (SpirvParser& compiler_)
         output.name      = resource.name;
         output.location  = *decorations.Location;
         output.type      = BaseTypeNMToSRFieldType (type.basetype, type.vecsize, type.columns);
-        output.arraySize = !type.array.empty () ? type.array[0] : 1;
+        output.arraySize = !type.array.empty () ? GetArraySize (compiler, type, 0) : 1;
 
         result.push_back (output);
     }
@@ -577,7 +588,7 @@ std::vector<SubpassInput> GetSubpassInputsFromBinary (SpirvParser& compiler_)
         inp.binding      = *decorations.Binding;
         inp.subpassIndex = *decorations.InputAttachmentIndex;
         inp.type         = BaseTypeNMToSRFieldType (type.basetype, type.vecsize, type.columns);
-        inp.arraySize    = !type.array.empty () ? type.array[0] : 1;
+        inp.arraySize    = !type.array.empty () ? GetArraySize (compiler, type, 0) : 1;
 
         result.push_back (inp);
     }
@@ -607,7 +618,7 @@ std::vector<Input> GetInputsFromBinary (SpirvParser& compiler_)
         inp.name        = resource.name;
         inp.location    = *decorations.Location;
         inp.type        = BaseTypeNMToSRFieldType (type.basetype, type.vecsize, type.columns);
-        inp.arraySize   = !type.array.empty () ? type.array[0] : 1;
+        inp.arraySize   = !type.array.empty () ? GetArraySize (compiler, type, 0) : 1;
         inp.sizeInBytes = BaseTypeNMToByteSize (type.basetype, type.vecsize, type.columns);
 
         result.push_back (inp);
@@ -653,7 +664,7 @@ std::vector<Sampler> GetSamplersFromBinary (SpirvParser& compiler_)
         sampler.binding       = *decorations.Binding;
         sampler.descriptorSet = *decorations.DescriptorSet;
         sampler.type          = SpvDimToSamplerType (type.image.dim);
-        sampler.arraySize     = !type.array.empty () ? type.array[0] : 1;
+        sampler.arraySize     = !type.array.empty () ? GetArraySize (compiler, type, 0) : 1;
 
         GVK_ASSERT (type.array.empty () || type.array.size () == 1);
 
@@ -668,6 +679,52 @@ std::vector<Sampler> GetSamplersFromBinary (SpirvParser& compiler_)
 }
 
 
+std::vector<SpecializationConstant> GetSpecializationConstantsFromBinary (SpirvParser& compiler_)
+{
+    spirv_cross::Compiler& compiler = compiler_.impl->compiler;
+
+    std::vector<SpecializationConstant> result;
+
+    for (const spirv_cross::SpecializationConstant& specializationConstant : compiler.get_specialization_constants ()) {
+        const spirv_cross::SPIRConstant& constant = compiler.get_constant (specializationConstant.id);
+        const spirv_cross::SPIRType&     type     = compiler.get_type (constant.constant_type);
+
+        const bool is32BitScalar = type.vecsize == 1 && type.columns == 1 && (type.basetype == spirv_cross::SPIRType::Boolean || type.width == 32);
+        if (GVK_ERROR (!is32BitScalar)) {
+            spdlog::error ("Specialization constant \"{}\" is not a 32 bit scalar.", compiler.get_name (specializationConstant.id));
+            continue;
+        }
+
+        SpecializationConstant sc;
+        sc.name         = compiler.get_name (specializationConstant.id);
+        sc.constantId   = specializationConstant.constant_id;
+        sc.type         = BaseTypeNMToSRFieldType (type.basetype, type.vecsize, type.columns);
+        sc.defaultValue = constant.scalar ();
+
+        result.push_back (sc);
+    }
+
+    std::sort (result.begin (), result.end (), [] (const SpecializationConstant& first, const SpecializationConstant& second) {
+        return first.constantId < second.constantId;
+    });
+
+    return result;
+}
+
+
+void SetSpecializationConstantValues (SpirvParser& compiler_, const std::map<uint32_t, uint32_t>& values)
+{
+    spirv_cross::Compiler& compiler = compiler_.impl->compiler;
+
+    for (const spirv_cross::SpecializationConstant& specializationConstant : compiler.get_specialization_constants ()) {
+        const auto value = values.find (specializationConstant.constant_id);
+        if (value != values.end ()) {
+            compiler.get_constant (specializationConstant.id).m.c[0].r[0].u32 = value->second;
+        }
+    }
+}
+
+
 #define ENUM_TO_STRING_CASE(enumname, type) \
     case enumname::type:                    \
         return #type;
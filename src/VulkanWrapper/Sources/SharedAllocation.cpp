@@ -0,0 +1,37 @@
+#include "SharedAllocation.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <stdexcept>
+
+namespace GVK {
+
+SharedAllocation::SharedAllocation (VmaAllocator allocator, const VkMemoryRequirements& requirements)
+    : allocator (allocator)
+    , handle (VK_NULL_HANDLE)
+    , size (requirements.size)
+{
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage                   = VMA_MEMORY_USAGE_GPU_ONLY;
+    allocInfo.flags                   = VMA_ALLOCATION_CREATE_USER_DATA_COPY_STRING_BIT;
+
+    if (GVK_ERROR (vmaAllocateMemory (allocator, &requirements, &allocInfo, &handle, nullptr) != VK_SUCCESS)) {
+        spdlog::critical ("Shared memory allocation of {} bytes failed.", requirements.size);
+        throw std::runtime_error ("failed to allocate shared memory");
+    }
+
+    spdlog::trace ("Shared memory allocated: {} bytes.", size);
+}
+
+
+SharedAllocation::~SharedAllocation ()
+{
+    if (handle != VK_NULL_HANDLE) {
+        vmaFreeMemory (allocator, handle);
+        handle = nullptr;
+    }
+}
+
+} // namespace GVK
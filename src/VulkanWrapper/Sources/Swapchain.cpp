@@ -247,10 +247,85 @@ FakeSwapchain::FakeSwapchain (const DeviceExtra& device, uint32_t width, uint32_
     : device (device)
     , width (width)
     , height (height)
-    , image (std::make_unique<Image2D> (device.GetAllocator (), Image::MemoryLocation::GPU, width, height, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, RealSwapchain::ImageUsage, 1))
+    , requestedWidth (width)
+    , requestedHeight (height)
 {
+    CreateImage ();
+}
+
+
+void FakeSwapchain::CreateImage ()
+{
+    imageViews.clear ();
+
+    image = std::make_unique<Image2D> (device.GetAllocator (), Image::MemoryLocation::GPU, width, height, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, RealSwapchain::ImageUsage, 1);
     imageViews.push_back (std::make_unique<ImageView2D> (device, *image));
     TransitionImageLayout (device, *image, Image2D::INITIAL_LAYOUT, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 }
 
+
+void FakeSwapchain::SetRequestedExtent (uint32_t width_, uint32_t height_)
+{
+    requestedWidth  = width_;
+    requestedHeight = height_;
+}
+
+
+void FakeSwapchain::Recreate ()
+{
+    if (requestedWidth == width && requestedHeight == height) {
+        return;
+    }
+
+    width  = requestedWidth;
+    height = requestedHeight;
+
+    CreateImage ();
+}
+
+
+std::vector<std::unique_ptr<InheritedImage>> FakeSwapchain::GetImageObjects () const
+{
+    std::vector<std::unique_ptr<InheritedImage>> result;
+    result.push_back (std::make_unique<InheritedImage> (*image, width, height, 1, GetImageFormat (), 1));
+    return result;
+}
+
+
+uint32_t FakeSwapchain::GetNextImageIndex (VkSemaphore signalSemaphore, VkFence fenceToSignal) const
+{
+    std::vector<VkSemaphore> signalSemaphores;
+    if (signalSemaphore != VK_NULL_HANDLE) {
+        signalSemaphores.push_back (signalSemaphore);
+    }
+
+    if (!signalSemaphores.empty () || fenceToSignal != VK_NULL_HANDLE) {
+        device.GetGraphicsQueue ().Submit ({}, {}, std::vector<CommandBuffer*> {}, signalSemaphores, fenceToSignal);
+    }
+
+    return 0;
+}
+
+
+void FakeSwapchain::Present (VkQueue queue, uint32_t imageIndex, const std::vector<VkSemaphore>& waitSemaphores) const
+{
+    GVK_ASSERT (imageIndex == 0);
+
+    if (waitSemaphores.empty ()) {
+        return;
+    }
+
+    const std::vector<VkPipelineStageFlags> waitDstStageMasks (waitSemaphores.size (), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+    VkSubmitInfo submitInfo       = {};
+    submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t> (waitSemaphores.size ());
+    submitInfo.pWaitSemaphores    = waitSemaphores.data ();
+    submitInfo.pWaitDstStageMask  = waitDstStageMasks.data ();
+
+    if (GVK_ERROR (vkQueueSubmit (queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)) {
+        throw std::runtime_error ("failed to submit fake present");
+    }
+}
+
 } // namespace GVK
@@ -129,10 +129,13 @@ Image1DTransferable::Image1DTransferable (const DeviceExtra& device, VkFormat fo
 }
 
 
-Image2DTransferable::Image2DTransferable (const DeviceExtra& device, VkFormat format, uint32_t width, uint32_t height, VkImageUsageFlags usageFlags, uint32_t arrayLayers)
+Image2DTransferable::Image2DTransferable (const DeviceExtra& device, VkFormat format, uint32_t width, uint32_t height, VkImageUsageFlags usageFlags, uint32_t arrayLayers, uint32_t mipLevels)
     : ImageTransferable (device, width * height * GetCompontentCountFromFormat (format) * GetEachCompontentSizeFromFormat (format))
 {
-    imageGPU = std::make_unique<Image2D> (device.GetAllocator (), Image::MemoryLocation::GPU, width, height, format, VK_IMAGE_TILING_OPTIMAL, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usageFlags, arrayLayers);
+    // mip levels are generated by blitting from the previous level
+    const VkImageUsageFlags mipUsageFlags = (mipLevels > 1) ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0;
+
+    imageGPU = std::make_unique<Image2D> (device.GetAllocator (), Image::MemoryLocation::GPU, width, height, format, VK_IMAGE_TILING_OPTIMAL, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usageFlags | mipUsageFlags, arrayLayers, mipLevels);
 }
 
 
@@ -68,4 +68,14 @@ void MemoryMapping::Copy (const void* data, size_t copiedSize) const
 }
 
 
+void MemoryMapping::Copy (const void* data, size_t copiedSize, size_t dstOffset) const
+{
+    if (GVK_ERROR (dstOffset + copiedSize > size)) {
+        throw std::runtime_error ("overflow");
+    }
+
+    memcpy (reinterpret_cast<uint8_t*> (mappedMemory.Get ()) + dstOffset, reinterpret_cast<const uint8_t*> (data), copiedSize);
+}
+
+
 } // namespace GVK
@@ -24,4 +24,18 @@ FunctionType GetVulkanFunction (VkInstance instance, const char* functionName)
     return func;
 }
 
+
+template<typename FunctionType>
+FunctionType GetVulkanDeviceFunction (VkDevice device, const char* functionName)
+{
+    FunctionType func = reinterpret_cast<FunctionType> (vkGetDeviceProcAddr (device, functionName));
+
+    if (GVK_ERROR (func == nullptr)) {
+        spdlog::error ("Failed to load Vulkan function \"{}\".", functionName);
+        throw std::runtime_error ("Function not loaded.");
+    }
+
+    return func;
+}
+
 #endif
\ No newline at end of file